@@ -90,6 +90,12 @@ public:
       return (objForAPI_.find(ident)->second) ;
     }
   }
+  /// Change the object implementing an %API already in the set
+  inline void setAPIPtr (const char *apiID, void *obj)
+  {
+    std::map<std::string,void*>::iterator iter = objForAPI_.find(apiID) ;
+    if (iter != objForAPI_.end()) iter->second = obj ;
+  }
   /// Add an %API to the set of supported APIs
   inline void addAPIID (const char *apiID, void *obj)
   {
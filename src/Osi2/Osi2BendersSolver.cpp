@@ -0,0 +1,377 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::BendersSolver.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2ModelBuilder.hpp"
+#include "Osi2Parallel.hpp"
+#include "Osi2BendersSolver.hpp"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock ;
+
+inline double secsSince (const Clock::time_point &start)
+{
+  return (std::chrono::duration<double>(Clock::now()-start).count()) ;
+}
+
+/// Clp takes any bound beyond 1.0e27 in magnitude as infinite
+inline bool isFinite (double value) { return (std::fabs(value) < 1.0e27) ; }
+
+/// Ray and aggregated coefficients smaller than this are taken as zero
+const double zeroTol = 1.0e-9 ;
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+BendersSolver::BendersSolver (ControlAPI &ctrl, int numThreads)
+  : ctrl_(ctrl),
+    numThreads_(numThreads),
+    maxIterations_(100),
+    tol_(1.0e-6),
+    gapTol_(1.0e-6),
+    thetaLb_(-1.0e6),
+    lowerBound_(-std::numeric_limits<double>::max()),
+    upperBound_(std::numeric_limits<double>::max())
+{ }
+
+BendersSolver::~BendersSolver ()
+{
+  clearSubproblems() ;
+}
+
+void BendersSolver::clearSubproblems ()
+{
+  for (Sub &sub : subs_)
+    if (sub.obj_ != nullptr) ctrl_.destroyObject(sub.obj_) ;
+  subs_.clear() ;
+}
+
+/*
+  The row bounds are read back from the solver after the load, so that
+  missing and infinite bounds are in the form Clp keeps them.
+*/
+int BendersSolver::addSubproblem (const Subproblem &sub,
+				  const std::string *shortName)
+{
+  API *obj = nullptr ;
+  if (ctrl_.createObject(obj,ClpSimplexAPI::getAPIIDString(),shortName) != 0 ||
+      obj == nullptr) {
+    std::cout
+      << "BendersSolver::addSubproblem: failed to create a solver for "
+      << "subproblem " << subs_.size() << "." << std::endl ;
+    return (-1) ;
+  }
+  subs_.push_back(Sub()) ;
+  Sub &added = subs_.back() ;
+  added.obj_ = obj ;
+  added.clp_ = static_cast<ClpSimplexAPI *>
+      (obj->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  added.theta_ = -1 ;
+  added.status_ = -1 ;
+  added.value_ = 0.0 ;
+  ClpSimplexAPI &clp = *added.clp_ ;
+  clp.setLogLevel(0) ;
+  clp.loadProblem(sub.numCols_,sub.numRows_,sub.starts_,sub.indices_,
+		  sub.elements_,sub.colLower_,sub.colUpper_,sub.obj_,
+		  sub.rowLower_,sub.rowUpper_) ;
+  const int m = sub.numRows_ ;
+  added.rowLower_.assign(clp.rowLower(),clp.rowLower()+m) ;
+  added.rowUpper_.assign(clp.rowUpper(),clp.rowUpper()+m) ;
+  added.techStarts_.assign(m+1,0) ;
+  if (sub.techStarts_ != nullptr) {
+    const CoinBigIndex numElems = sub.techStarts_[m]-sub.techStarts_[0] ;
+    for (int i = 0 ; i <= m ; i++)
+      added.techStarts_[i] = sub.techStarts_[i]-sub.techStarts_[0] ;
+    added.techIndices_.assign(sub.techIndices_+sub.techStarts_[0],
+			      sub.techIndices_+sub.techStarts_[0]+numElems) ;
+    added.techElements_.assign(sub.techElements_+sub.techStarts_[0],
+			       sub.techElements_+sub.techStarts_[0]+numElems) ;
+  }
+  added.lower_.resize(m) ;
+  added.upper_.resize(m) ;
+  return (static_cast<int>(subs_.size())-1) ;
+}
+
+/*
+  The optimal value as a function of the row bounds has pi as a
+  subgradient, and the row bounds move by -T dx, so Q(x') >= Q(x) -
+  pi T (x'-x). The column bounds don't move and need no term.
+*/
+void BendersSolver::optimalityCut (Sub &sub, int numMaster, const double *x)
+{
+  const double *pi = sub.clp_->getRowPrice() ;
+  const int m = static_cast<int>(sub.rowLower_.size()) ;
+  std::vector<double> &coeffs = sub.coeffs_ ;
+  coeffs.assign(numMaster,0.0) ;
+  for (int i = 0 ; i < m ; i++) {
+    if (pi[i] == 0.0) continue ;
+    for (CoinBigIndex ndx = sub.techStarts_[i] ;
+	 ndx < sub.techStarts_[i+1] ; ndx++)
+      coeffs[sub.techIndices_[ndx]] += pi[i]*sub.techElements_[ndx] ;
+  }
+  std::vector<int> indices ;
+  std::vector<double> elements ;
+  double lb = sub.value_ ;
+  for (int j = 0 ; j < numMaster ; j++) {
+    if (coeffs[j] == 0.0) continue ;
+    indices.push_back(j) ;
+    elements.push_back(coeffs[j]) ;
+    lb += coeffs[j]*x[j] ;
+  }
+  indices.push_back(sub.theta_) ;
+  elements.push_back(1.0) ;
+  sub.cuts_.addCut(static_cast<int>(indices.size()),indices.data(),
+		   elements.data(),lb,std::numeric_limits<double>::max()) ;
+}
+
+/*
+  Aggregate the rows with the ray r. Over the column bounds, rWy lies in
+  [boxMin,boxMax]; the row bounds put it in [L(x),U(x)] with L(x) = constL -
+  rTx and U(x) = constU - rTx. The ray proves the two don't meet at x, on
+  one side or the other depending on the sign convention of the solver, so
+  both sides are tried and whichever is violated gives the cut, rTx' >=
+  constL - boxMax or rTx' <= constU - boxMin.
+*/
+bool BendersSolver::feasibilityCut (Sub &sub, int numMaster, const double *x)
+{
+  ClpSimplexAPI &clp = *sub.clp_ ;
+  if (clp.fetchInfeasibilityRay(sub.ray_) < 1) return (false) ;
+  const int m = sub.ray_.getDim() ;
+  const int n = clp.numberColumns() ;
+  std::vector<double> ray(m) ;
+  sub.ray_.expand(0,ray.data()) ;
+  const double inf = std::numeric_limits<double>::max() ;
+/*
+  The row side: constL, constU and rT.
+*/
+  double constL = 0.0 ;
+  double constU = 0.0 ;
+  std::vector<double> &coeffs = sub.coeffs_ ;
+  coeffs.assign(numMaster,0.0) ;
+  for (int i = 0 ; i < m ; i++) {
+    const double r = ray[i] ;
+    if (std::fabs(r) < zeroTol) continue ;
+    const double forL = (r > 0.0)?sub.rowLower_[i]:sub.rowUpper_[i] ;
+    const double forU = (r > 0.0)?sub.rowUpper_[i]:sub.rowLower_[i] ;
+    constL = (isFinite(forL) && constL > -inf)?constL+r*forL:-inf ;
+    constU = (isFinite(forU) && constU < inf)?constU+r*forU:inf ;
+    for (CoinBigIndex ndx = sub.techStarts_[i] ;
+	 ndx < sub.techStarts_[i+1] ; ndx++)
+      coeffs[sub.techIndices_[ndx]] += r*sub.techElements_[ndx] ;
+  }
+/*
+  The column side: boxMin and boxMax. The matrix may have gaps.
+*/
+  const CoinBigIndex *starts = clp.getVectorStarts() ;
+  const int *lengths = clp.getVectorLengths() ;
+  const int *rows = clp.getIndices() ;
+  const double *elems = clp.getElements() ;
+  const double *colLower = clp.columnLower() ;
+  const double *colUpper = clp.columnUpper() ;
+  double boxMin = 0.0 ;
+  double boxMax = 0.0 ;
+  for (int j = 0 ; j < n ; j++) {
+    const CoinBigIndex last = (lengths)?starts[j]+lengths[j]:starts[j+1] ;
+    double a = 0.0 ;
+    for (CoinBigIndex ndx = starts[j] ; ndx < last ; ndx++)
+      a += ray[rows[ndx]]*elems[ndx] ;
+    if (std::fabs(a) < zeroTol) continue ;
+    const double forMin = (a > 0.0)?colLower[j]:colUpper[j] ;
+    const double forMax = (a > 0.0)?colUpper[j]:colLower[j] ;
+    boxMin = (isFinite(forMin) && boxMin > -inf)?boxMin+a*forMin:-inf ;
+    boxMax = (isFinite(forMax) && boxMax < inf)?boxMax+a*forMax:inf ;
+  }
+  std::vector<int> indices ;
+  std::vector<double> elements ;
+  double rTx = 0.0 ;
+  for (int j = 0 ; j < numMaster ; j++) {
+    if (std::fabs(coeffs[j]) < zeroTol) continue ;
+    indices.push_back(j) ;
+    elements.push_back(coeffs[j]) ;
+    rTx += coeffs[j]*x[j] ;
+  }
+  if (indices.empty()) return (false) ;
+  const int len = static_cast<int>(indices.size()) ;
+  if (constL > -inf && boxMax < inf && constL-rTx > boxMax+tol_) {
+    sub.cuts_.addCut(len,indices.data(),elements.data(),constL-boxMax,inf) ;
+    return (true) ;
+  }
+  if (constU < inf && boxMin > -inf && constU-rTx < boxMin-tol_) {
+    sub.cuts_.addCut(len,indices.data(),elements.data(),-inf,constU-boxMin) ;
+    return (true) ;
+  }
+  return (false) ;
+}
+
+/*
+  Runs in a worker thread; touches nothing but sub and its solver. Dual
+  simplex even for the first solve, from a slack basis: initialSolve may
+  presolve, and an infeasibility found in presolve leaves no ray.
+*/
+void BendersSolver::solveSubproblem (Sub &sub, int numMaster, const double *x)
+{
+  ClpSimplexAPI &clp = *sub.clp_ ;
+  const int m = static_cast<int>(sub.rowLower_.size()) ;
+  for (int i = 0 ; i < m ; i++) {
+    double tx = 0.0 ;
+    for (CoinBigIndex ndx = sub.techStarts_[i] ;
+	 ndx < sub.techStarts_[i+1] ; ndx++)
+      tx += sub.techElements_[ndx]*x[sub.techIndices_[ndx]] ;
+    sub.lower_[i] = (isFinite(sub.rowLower_[i]))?sub.rowLower_[i]-tx:
+						  sub.rowLower_[i] ;
+    sub.upper_[i] = (isFinite(sub.rowUpper_[i]))?sub.rowUpper_[i]-tx:
+						  sub.rowUpper_[i] ;
+  }
+  clp.chgRowLower(sub.lower_.data()) ;
+  clp.chgRowUpper(sub.upper_.data()) ;
+  clp.dual() ;
+  sub.cuts_.clear() ;
+  sub.status_ = -1 ;
+  if (clp.status() == 0) {
+    sub.status_ = 0 ;
+    sub.value_ = clp.objectiveValue() ;
+    optimalityCut(sub,numMaster,x) ;
+  } else if (clp.status() == 1 && feasibilityCut(sub,numMaster,x)) {
+    sub.status_ = 1 ;
+  }
+}
+
+/*
+  The master solution is copied once per iteration so that the subproblems
+  read storage the master won't touch while they run.
+*/
+int BendersSolver::solve (ClpSimplexAPI &master)
+{
+  iterations_.clear() ;
+  const double inf = std::numeric_limits<double>::max() ;
+  lowerBound_ = -inf ;
+  upperBound_ = inf ;
+  const int numSubs = static_cast<int>(subs_.size()) ;
+/*
+  Add the theta columns still missing. They have no coefficients yet.
+*/
+  {
+    ModelBuilder thetas(ModelBuilder::colWise) ;
+    int next = master.numberColumns() ;
+    for (Sub &sub : subs_) {
+      if (sub.theta_ >= 0) continue ;
+      thetas.addCol(0,nullptr,nullptr,thetaLb_,inf,1.0) ;
+      sub.theta_ = next++ ;
+    }
+    if (next > master.numberColumns()) thetas.addTo(master) ;
+  }
+
+  std::vector<double> x ;
+  int retval = 1 ;
+  for (int it = 0 ; it < maxIterations_ ; it++) {
+    Iteration iter ;
+    Clock::time_point start = Clock::now() ;
+    if (!master.statusExists())
+      master.initialSolve() ;
+    else
+      master.dual() ;
+    iter.masterSecs_ = secsSince(start) ;
+    if (master.status() != 0) {
+      std::cout
+	<< "BendersSolver::solve: master status " << master.status()
+	<< " at iteration " << it << "." << std::endl ;
+      retval = -1 ;
+      break ;
+    }
+    const int n = master.numberColumns() ;
+    x.assign(master.getColSolution(),master.getColSolution()+n) ;
+    lowerBound_ = master.objectiveValue() ;
+/*
+  Solve the subproblems.
+*/
+    start = Clock::now() ;
+    parallelFor(numSubs,numThreads_,
+		[&] (int first, int last, int)
+		{
+		  for (int k = first ; k < last ; k++)
+		    solveSubproblem(subs_[k],n,x.data()) ;
+		}) ;
+    iter.subproblemSecs_ = secsSince(start) ;
+/*
+  Merge the violated cuts in subproblem order. If every subproblem is
+  feasible, x with the subproblem values is a solution. Cuts are added only
+  if the bounds haven't met, so that the master solution stays current.
+*/
+    start = Clock::now() ;
+    merged_.clear() ;
+    iter.optimalityCuts_ = 0 ;
+    iter.feasibilityCuts_ = 0 ;
+    bool allFeasible = true ;
+    int failed = -1 ;
+    double value = lowerBound_ ;
+    for (int k = 0 ; k < numSubs ; k++) {
+      const Sub &sub = subs_[k] ;
+      if (sub.status_ < 0 && failed < 0) failed = k ;
+      if (sub.status_ == 0)
+	value += sub.value_-x[sub.theta_] ;
+      else
+	allFeasible = false ;
+      const CutBatch &batch = sub.cuts_ ;
+      const int *starts = batch.getStarts() ;
+      for (int c = 0 ; c < batch.getNumCuts() ; c++) {
+	if (batch.violation(c,x.data()) <= tol_) continue ;
+	merged_.addCut(starts[c+1]-starts[c],batch.getIndices()+starts[c],
+		       batch.getElements()+starts[c],batch.getLower()[c],
+		       batch.getUpper()[c]) ;
+	if (sub.status_ == 0)
+	  iter.optimalityCuts_++ ;
+	else
+	  iter.feasibilityCuts_++ ;
+      }
+    }
+    if (failed >= 0) {
+      std::cout
+	<< "BendersSolver::solve: subproblem " << failed << " status "
+	<< subs_[failed].clp_->status() << " at iteration " << it
+	<< "." << std::endl ;
+      retval = -1 ;
+      break ;
+    }
+    if (allFeasible && value < upperBound_) upperBound_ = value ;
+    iter.lowerBound_ = lowerBound_ ;
+    iter.upperBound_ = upperBound_ ;
+    const bool closed = (upperBound_ < inf &&
+			 upperBound_-lowerBound_ <=
+			   gapTol_*std::max(1.0,std::fabs(upperBound_))) ;
+    const int added = (closed)?0:merged_.applyTo(master) ;
+    iter.cutSecs_ = secsSince(start) ;
+    iterations_.push_back(iter) ;
+    if (added == 0) {
+      retval = 0 ;
+      break ;
+    }
+  }
+/*
+  At the iteration limit the last cuts are in but not yet solved.
+*/
+  if (retval == 1) master.dual() ;
+  return (retval) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,248 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2BendersSolver.hpp
+    \brief Benders decomposition with the subproblems solved in parallel.
+*/
+#ifndef Osi2BendersSolver_HPP
+#define Osi2BendersSolver_HPP
+
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2CutBatch.hpp"
+#include "Osi2RayBuffer.hpp"
+
+namespace Osi2 {
+
+class API ;
+class ControlAPI ;
+class ClpSimplexAPI ;
+
+/*! \brief Benders decomposition driver
+
+  Solves min cx + sum(k) q(k)y(k) over the rows of a master problem in x
+  and, for each subproblem k,
+    rowLower(k) - T(k)x <= W(k)y(k) <= rowUpper(k) - T(k)x
+  with the column bounds of y(k). The master is the model held by a
+  ClpSimplexAPI object; #solve adds to it one column theta(k) per
+  subproblem, cost 1, bounded below by #setThetaLowerBound, which stands
+  for the cost of subproblem k.
+
+  Each subproblem is loaded once into its own ClpSimplexAPI object, made
+  with ControlAPI::createObject, and kept for the life of the driver. Only
+  its row bounds change from one iteration to the next, so each solve is a
+  dual simplex from the basis of the previous one.
+
+  An iteration solves the master, then every subproblem at the master's x,
+  spread over up to #setNumThreads threads, each subproblem with its own
+  CutBatch. From a subproblem with optimal value Q and row duals pi
+  (ClpSimplexAPI::getRowPrice) comes the optimality cut
+    theta(k) + pi T(k) x' >= Q + pi T(k) x.
+  From an infeasible subproblem comes a feasibility cut on x, the
+  aggregation of its rows by the infeasibility ray
+  (ClpSimplexAPI::fetchInfeasibilityRay) that no y(k) within its column
+  bounds can meet. The batches are merged in subproblem order, filtered
+  for violation (#setTolerance), and added to the master with a single
+  addRows call, so the master is the same for any number of threads.
+
+  The master objective is a lower bound. When every subproblem is
+  feasible, cx + sum(k) Q(k) is an upper bound. The loop ends when no cut
+  is violated or the bounds are within #setGapTolerance. Each iteration
+  records the bounds, the cuts made, and the time spent in each step.
+
+  Both the master and the subproblems are minimised.
+*/
+class BendersSolver {
+
+public:
+
+  /*! \brief A subproblem, in the form loadProblem takes, with its links
+
+    W(k) is column-major and packed: column j's coefficients are entries
+    starts_[j] to starts_[j+1]-1. T(k) is row-major and packed: row i's
+    coefficients are entries techStarts_[i] to techStarts_[i+1]-1, with
+    column indices in the master. Any of the bound and objective arrays may
+    be null, meaning the loadProblem defaults; techStarts_ null means the
+    subproblem doesn't depend on x. The arrays are copied by
+    #addSubproblem.
+  */
+  struct Subproblem {
+    Subproblem ()
+      : numRows_(0), numCols_(0),
+	starts_(nullptr), indices_(nullptr), elements_(nullptr),
+	colLower_(nullptr), colUpper_(nullptr), obj_(nullptr),
+	rowLower_(nullptr), rowUpper_(nullptr),
+	techStarts_(nullptr), techIndices_(nullptr), techElements_(nullptr)
+    { }
+    int numRows_ ;
+    int numCols_ ;
+    const CoinBigIndex *starts_ ;
+    const int *indices_ ;
+    const double *elements_ ;
+    const double *colLower_ ;
+    const double *colUpper_ ;
+    const double *obj_ ;
+    const double *rowLower_ ;
+    const double *rowUpper_ ;
+    const CoinBigIndex *techStarts_ ;
+    const int *techIndices_ ;
+    const double *techElements_ ;
+  } ;
+
+  /// Result of one iteration
+  struct Iteration {
+    /// Master objective
+    double lowerBound_ ;
+    /// Best upper bound so far (infinite until every subproblem is feasible)
+    double upperBound_ ;
+    /// Optimality cuts added
+    int optimalityCuts_ ;
+    /// Feasibility cuts added
+    int feasibilityCuts_ ;
+    /// Wall clock seconds for the master solve
+    double masterSecs_ ;
+    /// Wall clock seconds for the subproblem solves and cuts
+    double subproblemSecs_ ;
+    /// Wall clock seconds to merge, filter and add the cuts
+    double cutSecs_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor; subproblem objects are made with \p ctrl
+  BendersSolver (ControlAPI &ctrl, int numThreads = 1) ;
+  /// Destructor; destroys the subproblem objects
+  ~BendersSolver () ;
+  //@}
+
+  /*! \name Subproblems */
+  //@{
+  /*! \brief Add a subproblem
+
+    Creates a ClpSimplexAPI object, from the plugin library \p shortName if
+    given, and loads \p sub into it. Returns the index of the subproblem,
+    or -1 if the object could not be created.
+  */
+  int addSubproblem (const Subproblem &sub,
+		     const std::string *shortName = nullptr) ;
+  /// Destroy the subproblem objects
+  void clearSubproblems () ;
+  /// Number of subproblems
+  inline int getNumSubproblems () const
+  { return (static_cast<int>(subs_.size())) ; }
+  /// The solver object for subproblem \p k
+  inline ClpSimplexAPI *getSubproblem (int k) const
+  { return (subs_[k].clp_) ; }
+  /// Master column of theta(k), or -1 until #solve has added it
+  inline int getThetaColumn (int k) const { return (subs_[k].theta_) ; }
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Number of threads for the subproblem solves
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /// Most iterations (default 100)
+  inline void setMaxIterations (int maxIterations)
+  { maxIterations_ = maxIterations ; }
+  /// Least violation for a cut to be added (default 1.0e-6)
+  inline void setTolerance (double tol) { tol_ = tol ; }
+  /// Relative gap between the bounds at which to stop (default 1.0e-6)
+  inline void setGapTolerance (double gapTol) { gapTol_ = gapTol ; }
+  /// Lower bound for the theta columns added by #solve (default -1.0e6)
+  inline void setThetaLowerBound (double thetaLb) { thetaLb_ = thetaLb ; }
+  //@}
+
+  /*! \brief Run Benders decomposition on the master \p master
+
+    Adds the theta columns for subproblems that don't have one yet. The
+    master is solved first if it has no basis. Returns -1 if the master
+    or a subproblem can't be solved (unbounded, or infeasible with no
+    usable ray), 0 if the bounds met or no cut was violated, 1 if the
+    iteration limit was reached. The final master solution is left in
+    \p master and the subproblem solutions at its x in the subproblem
+    objects.
+  */
+  int solve (ClpSimplexAPI &master) ;
+
+  /*! \name Results */
+  //@{
+  /// Number of iterations
+  inline int getNumIterations () const
+  { return (static_cast<int>(iterations_.size())) ; }
+  /// Result of iteration \p k
+  inline const Iteration &getIteration (int k) const
+  { return (iterations_[k]) ; }
+  /// Final lower bound
+  inline double getLowerBound () const { return (lowerBound_) ; }
+  /// Final upper bound
+  inline double getUpperBound () const { return (upperBound_) ; }
+  //@}
+
+private:
+
+  /// A subproblem as the driver keeps it
+  struct Sub {
+    /// The object and its ClpSimplexAPI
+    API *obj_ ;
+    ClpSimplexAPI *clp_ ;
+    /// Master column of theta
+    int theta_ ;
+    /// Row bounds at x = 0
+    std::vector<double> rowLower_ ;
+    std::vector<double> rowUpper_ ;
+    /// T, row-major
+    std::vector<CoinBigIndex> techStarts_ ;
+    std::vector<int> techIndices_ ;
+    std::vector<double> techElements_ ;
+    /// Result of the last solve: 0 optimal, 1 infeasible, -1 failed
+    int status_ ;
+    /// Objective of the last solve
+    double value_ ;
+    /// Working storage
+    std::vector<double> lower_ ;
+    std::vector<double> upper_ ;
+    std::vector<double> coeffs_ ;
+    RayBuffer ray_ ;
+    CutBatch cuts_ ;
+  } ;
+
+  /// Solve subproblem \p sub at the master solution \p x and make its cut
+  void solveSubproblem (Sub &sub, int numMaster, const double *x) ;
+
+  /// Add the optimality cut of \p sub
+  void optimalityCut (Sub &sub, int numMaster, const double *x) ;
+
+  /// Add the feasibility cut of \p sub; false if the ray gives none
+  bool feasibilityCut (Sub &sub, int numMaster, const double *x) ;
+
+  /// Copies would share the subproblem objects
+  BendersSolver (const BendersSolver &) ;
+  BendersSolver &operator= (const BendersSolver &) ;
+
+  /// Source of the subproblem objects
+  ControlAPI &ctrl_ ;
+  /// Subproblems
+  std::vector<Sub> subs_ ;
+  /// Parameters
+  int numThreads_ ;
+  int maxIterations_ ;
+  double tol_ ;
+  double gapTol_ ;
+  double thetaLb_ ;
+  /// The merged batch
+  CutBatch merged_ ;
+  /// Results
+  std::vector<Iteration> iterations_ ;
+  double lowerBound_ ;
+  double upperBound_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,358 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::BlockDecomposer.
+*/
+
+#include <atomic>
+#include <iostream>
+#include <utility>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2SolveResult.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2BlockDecomposer.hpp"
+
+namespace {
+
+/// Columns per block; smaller blocks aren't worth a thread
+const int minBlock = 4096 ;
+
+typedef std::atomic<int> Link ;
+
+/*
+  Root of x, with path halving. Links only ever point to smaller indices,
+  and halving replaces a link with one that is smaller still, so a
+  concurrent update can only shorten the path.
+*/
+int findRoot (Link *parent, int x)
+{
+  for (;;) {
+    int px = parent[x].load(std::memory_order_relaxed) ;
+    if (px == x) return (x) ;
+    const int ppx = parent[px].load(std::memory_order_relaxed) ;
+    if (ppx != px)
+      parent[x].compare_exchange_weak(px,ppx,std::memory_order_relaxed) ;
+    x = ppx ;
+  }
+}
+
+/*
+  Join the trees holding a and b by linking the larger root to the smaller.
+  If another thread moves the larger root first, the exchange fails and we
+  start over from the new roots.
+*/
+void unite (Link *parent, int a, int b)
+{
+  for (;;) {
+    a = findRoot(parent,a) ;
+    b = findRoot(parent,b) ;
+    if (a == b) return ;
+    if (a < b) std::swap(a,b) ;
+    int expected = a ;
+    if (parent[a].compare_exchange_strong(expected,b)) return ;
+  }
+}
+
+/*
+  Group the items 0..num-1 by block: starts[b] is the first position of
+  block b in items.
+*/
+void groupByBlock (int num, int numBlocks, const std::vector<int> &block,
+		   std::vector<int> &starts, std::vector<int> &items)
+{
+  starts.assign(numBlocks+1,0) ;
+  for (int k = 0 ; k < num ; k++) starts[block[k]+1]++ ;
+  for (int b = 0 ; b < numBlocks ; b++) starts[b+1] += starts[b] ;
+  items.resize(num) ;
+  std::vector<int> pos(starts.begin(),starts.end()-1) ;
+  for (int k = 0 ; k < num ; k++) {
+    const int b = block[k] ;
+    items[pos[b]++] = k ;
+  }
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+BlockDecomposer::BlockDecomposer (int numThreads)
+  : numThreads_(numThreads),
+    numRows_(0),
+    numCols_(0),
+    numBlocks_(0),
+    blkRowStarts_(1,0),
+    blkColStarts_(1,0)
+{ }
+
+BlockDecomposer::~BlockDecomposer () { }
+
+/*
+  Columns are nodes [0,n), rows are nodes [n,n+m). Each column is united
+  with every row it touches. Since components are rooted at their smallest
+  node, any component with a column is rooted at a column; a row that is
+  its own root has no coefficients.
+*/
+int BlockDecomposer::analyse (int m, int n, const CoinBigIndex *starts,
+			      const int *lengths, const int *indices)
+{
+  numRows_ = m ;
+  numCols_ = n ;
+  std::vector<Link> parent(n+m) ;
+  Link *links = parent.data() ;
+  parallelFor(n+m,numThreads_,
+	      [links](int first, int last, int) {
+		for (int k = first ; k < last ; k++)
+		  links[k].store(k,std::memory_order_relaxed) ;
+	      },minBlock) ;
+  parallelFor(n,numThreads_,
+	      [&](int first, int last, int) {
+		for (int j = first ; j < last ; j++) {
+		  const CoinBigIndex end =
+		    (lengths)?starts[j]+lengths[j]:starts[j+1] ;
+		  for (CoinBigIndex k = starts[j] ; k < end ; k++)
+		    unite(links,j,n+indices[k]) ;
+		}
+	      },minBlock) ;
+/*
+  All links are in place. Number the components rooted at nonempty columns
+  in column order; everything else goes in the trailing block of empties.
+*/
+  std::vector<int> root(n+m) ;
+  parallelFor(n+m,numThreads_,
+	      [&](int first, int last, int) {
+		for (int k = first ; k < last ; k++)
+		  root[k] = findRoot(links,k) ;
+	      },minBlock) ;
+  std::vector<int> blockOfRoot(n,-1) ;
+  numBlocks_ = 0 ;
+  bool haveEmpty = false ;
+  for (int j = 0 ; j < n ; j++) {
+    const CoinBigIndex len =
+      (lengths)?lengths[j]:starts[j+1]-starts[j] ;
+    if (root[j] == j) {
+      if (len > 0)
+	blockOfRoot[j] = numBlocks_++ ;
+      else
+	haveEmpty = true ;
+    }
+  }
+  for (int i = 0 ; i < m && !haveEmpty ; i++)
+    if (root[n+i] == n+i) haveEmpty = true ;
+  const int emptyBlock = numBlocks_ ;
+  if (haveEmpty) numBlocks_++ ;
+  colBlock_.resize(n) ;
+  rowBlock_.resize(m) ;
+  for (int j = 0 ; j < n ; j++) {
+    const int b = blockOfRoot[root[j]] ;
+    colBlock_[j] = (b >= 0)?b:emptyBlock ;
+  }
+  for (int i = 0 ; i < m ; i++) {
+    const int r = root[n+i] ;
+    rowBlock_[i] = (r < n)?blockOfRoot[r]:emptyBlock ;
+  }
+  groupByBlock(n,numBlocks_,colBlock_,blkColStarts_,blkCols_) ;
+  groupByBlock(m,numBlocks_,rowBlock_,blkRowStarts_,blkRows_) ;
+  return (numBlocks_) ;
+}
+
+int BlockDecomposer::analyse (ClpSimplexAPI &clp)
+{
+  return (analyse(clp.numberRows(),clp.numberColumns(),
+		  clp.getVectorStarts(),clp.getVectorLengths(),
+		  clp.getIndices())) ;
+}
+
+/*
+  Each block gets a fresh object from ctrl, loaded with the block's rows and
+  columns only, straight from the column-major arrays of clp. The objects
+  are made in this thread (ControlAPI is not thread safe, and an empty
+  object costs little); extraction, load, and solve run in parallel, one
+  block at a time per thread, so only the blocks in flight have staging
+  arrays. The block's part of an optimal basis of the whole is an optimal
+  basis of the block, so a basis in clp is passed on.
+*/
+int BlockDecomposer::solve (ClpSimplexAPI &clp, ControlAPI &ctrl,
+			    SolveResult &result)
+{
+  const int m = clp.numberRows() ;
+  const int n = clp.numberColumns() ;
+  if (m != numRows_ || n != numCols_ || numBlocks_ == 0) {
+    std::cout
+      << "BlockDecomposer::solve: blocks do not match the model; call "
+      << "analyse first." << std::endl ;
+    return (-1) ;
+  }
+  if (numBlocks_ == 1) {
+    clp.initialSolve() ;
+    return ((clp.fetchResult(result) == 0)?0:-1) ;
+  }
+/*
+  Make the block objects.
+*/
+  std::vector<API *> objs(numBlocks_,nullptr) ;
+  std::vector<ClpSimplexAPI *> blockClp(numBlocks_,nullptr) ;
+  int retval = 0 ;
+  for (int b = 0 ; b < numBlocks_ ; b++) {
+    if (ctrl.createObject(objs[b],ClpSimplexAPI::getAPIIDString()) != 0 ||
+	objs[b] == nullptr) {
+      std::cout
+	<< "BlockDecomposer::solve: failed to create a solver for block "
+	<< b << "." << std::endl ;
+      retval = -1 ;
+      break ;
+    }
+    blockClp[b] = static_cast<ClpSimplexAPI *>
+	(objs[b]->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  }
+/*
+  Everything the workers read from clp is fetched here. Rows are renumbered
+  within their block.
+*/
+  if (retval == 0) {
+    const CoinBigIndex *starts = clp.getVectorStarts() ;
+    const int *lengths = clp.getVectorLengths() ;
+    const int *indices = clp.getIndices() ;
+    const double *elements = clp.getElements() ;
+    const double *collb = clp.columnLower() ;
+    const double *colub = clp.columnUpper() ;
+    const double *obj = clp.objective() ;
+    const double *rowlb = clp.rowLower() ;
+    const double *rowub = clp.rowUpper() ;
+    const unsigned char *status =
+	(clp.statusExists())?clp.statusArray():nullptr ;
+    const double objSense = clp.objSense() ;
+    const double objOffset = clp.objectiveOffset() ;
+    const double primalTol = clp.primalTolerance() ;
+    const double dualTol = clp.dualTolerance() ;
+    std::vector<int> rowLocal(m) ;
+    for (int b = 0 ; b < numBlocks_ ; b++) {
+      const int *rows = getBlockRows(b) ;
+      for (int t = 0 ; t < getBlockNumRows(b) ; t++) rowLocal[rows[t]] = t ;
+    }
+    parallelFor(numBlocks_,numThreads_,
+		[&](int first, int last, int) {
+		  std::vector<CoinBigIndex> bStarts ;
+		  std::vector<int> bIndices ;
+		  std::vector<double> bElements ;
+		  std::vector<double> bCollb, bColub, bObj, bRowlb, bRowub ;
+		  std::vector<unsigned char> bStatus ;
+		  for (int b = first ; b < last ; b++) {
+		    const int nb = getBlockNumCols(b) ;
+		    const int mb = getBlockNumRows(b) ;
+		    const int *cols = getBlockCols(b) ;
+		    const int *rows = getBlockRows(b) ;
+		    bStarts.assign(1,0) ;
+		    bIndices.clear() ;
+		    bElements.clear() ;
+		    bCollb.resize(nb) ;
+		    bColub.resize(nb) ;
+		    bObj.resize(nb) ;
+		    for (int t = 0 ; t < nb ; t++) {
+		      const int j = cols[t] ;
+		      const CoinBigIndex end =
+			(lengths)?starts[j]+lengths[j]:starts[j+1] ;
+		      for (CoinBigIndex k = starts[j] ; k < end ; k++) {
+			bIndices.push_back(rowLocal[indices[k]]) ;
+			bElements.push_back(elements[k]) ;
+		      }
+		      bStarts.push_back(bIndices.size()) ;
+		      bCollb[t] = collb[j] ;
+		      bColub[t] = colub[j] ;
+		      bObj[t] = obj[j] ;
+		    }
+		    bRowlb.resize(mb) ;
+		    bRowub.resize(mb) ;
+		    for (int t = 0 ; t < mb ; t++) {
+		      bRowlb[t] = rowlb[rows[t]] ;
+		      bRowub[t] = rowub[rows[t]] ;
+		    }
+		    ClpSimplexAPI &bclp = *blockClp[b] ;
+		    bclp.setLogLevel(0) ;
+		    bclp.loadProblem(nb,mb,bStarts.data(),bIndices.data(),
+				     bElements.data(),bCollb.data(),
+				     bColub.data(),bObj.data(),bRowlb.data(),
+				     bRowub.data()) ;
+		    bclp.setObjSense(objSense) ;
+		    bclp.setObjectiveOffset((b == 0)?objOffset:0.0) ;
+		    bclp.setPrimalTolerance(primalTol) ;
+		    bclp.setDualTolerance(dualTol) ;
+		    if (status != nullptr) {
+		      bStatus.resize(nb+mb) ;
+		      for (int t = 0 ; t < nb ; t++)
+			bStatus[t] = status[cols[t]] ;
+		      for (int t = 0 ; t < mb ; t++)
+			bStatus[nb+t] = status[n+rows[t]] ;
+		      bclp.copyinStatus(bStatus.data()) ;
+		    }
+		    bclp.initialSolve() ;
+		  }
+		}) ;
+  }
+/*
+  Scatter the block results into the original indexing. The objective
+  offset of the whole model went to block 0 alone, so the sum of the block
+  objectives includes it once, with the sign clp gives it. If any block's
+  result can't be fetched, the combined result is left with no valid
+  fields.
+*/
+  if (retval == 0) {
+    result.startFill(m,n) ;
+    double *x = result.colSolutionBuffer() ;
+    double *d = result.reducedCostBuffer() ;
+    double *act = result.rowActivityBuffer() ;
+    double *y = result.rowPriceBuffer() ;
+    double objValue = 0.0 ;
+    int iters = 0 ;
+    int status = 0 ;
+    bool infeas = false ;
+    bool unbdd = false ;
+    SolveResult blkResult ;
+    for (int b = 0 ; b < numBlocks_ ; b++) {
+      if (blockClp[b]->fetchResult(blkResult) != 0) {
+	retval = -1 ;
+	break ;
+      }
+      const int *cols = getBlockCols(b) ;
+      const int *rows = getBlockRows(b) ;
+      for (int t = 0 ; t < getBlockNumCols(b) ; t++) {
+	x[cols[t]] = blkResult.getColSolution()[t] ;
+	d[cols[t]] = blkResult.getReducedCost()[t] ;
+      }
+      for (int t = 0 ; t < getBlockNumRows(b) ; t++) {
+	act[rows[t]] = blkResult.getRowActivity()[t] ;
+	y[rows[t]] = blkResult.getRowPrice()[t] ;
+      }
+      objValue += blkResult.objectiveValue() ;
+      iters += blkResult.iterations() ;
+      if (status == 0) status = blkResult.status() ;
+      infeas = infeas || (blkResult.status() == 1) ;
+      unbdd = unbdd || (blkResult.status() == 2) ;
+    }
+    if (retval != 0) {
+      result.startFill(m,n) ;
+    } else {
+      if (infeas)
+	status = 1 ;
+      else if (unbdd)
+	status = 2 ;
+      result.setStatus(status,0,iters) ;
+      result.setObjectiveValue(objValue) ;
+    }
+  }
+  for (int b = 0 ; b < numBlocks_ ; b++)
+    if (objs[b] != nullptr) ctrl.destroyObject(objs[b]) ;
+  return (retval) ;
+}
+
+}  // end namespace Osi2
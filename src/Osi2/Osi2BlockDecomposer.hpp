@@ -0,0 +1,141 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2BlockDecomposer.hpp
+    \brief Detect independent blocks in an LP and solve them separately.
+*/
+#ifndef Osi2BlockDecomposer_HPP
+#define Osi2BlockDecomposer_HPP
+
+#include <vector>
+
+#include "CoinTypes.h"
+
+namespace Osi2 {
+
+class ClpSimplexAPI ;
+class ControlAPI ;
+class SolveResult ;
+
+/*! \brief Block decomposition of a constraint matrix
+
+  Two rows belong to the same block if some column has a coefficient in
+  both; a column belongs to the block of its rows. Blocks are the connected
+  components of the bipartite row/column graph. If the matrix can be
+  permuted to block-diagonal form, the LP separates into independent LPs,
+  one per block, whose solutions (primal and dual) together form a
+  solution of the whole.
+
+  #analyse finds the components with a union-find over rows and columns,
+  run in parallel over blocks of columns. Links always point from the
+  larger node index to the smaller, so every component ends up rooted at
+  its smallest node no matter how the threads interleave, and the blocks
+  are the same for any number of threads. Blocks are numbered in order of
+  their first column. Empty rows and columns are independent of
+  everything; rather than make a trivial block of each, they're gathered
+  into one block, numbered last.
+
+  #solve makes one ClpSimplexAPI object per block, loads into it the
+  block's rows and columns, extracted straight from the matrix of the
+  model, solves the blocks in parallel, and scatters the block solutions
+  back into the original row and column indices.
+*/
+class BlockDecomposer {
+
+public:
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  BlockDecomposer (int numThreads = 1) ;
+  /// Destructor
+  ~BlockDecomposer () ;
+  //@}
+
+  /// Number of threads
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+
+  /*! \name Analysis */
+  //@{
+  /*! \brief Find the blocks of a column-major matrix
+
+    \p lengths may be null if the matrix has no gaps. Returns the number of
+    blocks.
+  */
+  int analyse (int m, int n, const CoinBigIndex *starts, const int *lengths,
+	       const int *indices) ;
+  /// Find the blocks of the matrix held by \p clp
+  int analyse (ClpSimplexAPI &clp) ;
+  //@}
+
+  /*! \name Blocks
+
+    Rows and columns of a block are listed in ascending order.
+  */
+  //@{
+  /// Number of blocks
+  inline int getNumBlocks () const { return (numBlocks_) ; }
+  /// Block holding row \p i
+  inline int getRowBlock (int i) const { return (rowBlock_[i]) ; }
+  /// Block holding column \p j
+  inline int getColBlock (int j) const { return (colBlock_[j]) ; }
+  /// Number of rows in block \p b
+  inline int getBlockNumRows (int b) const
+  { return (blkRowStarts_[b+1]-blkRowStarts_[b]) ; }
+  /// Rows of block \p b
+  inline const int *getBlockRows (int b) const
+  { return (&blkRows_[blkRowStarts_[b]]) ; }
+  /// Number of columns in block \p b
+  inline int getBlockNumCols (int b) const
+  { return (blkColStarts_[b+1]-blkColStarts_[b]) ; }
+  /// Columns of block \p b
+  inline const int *getBlockCols (int b) const
+  { return (&blkCols_[blkColStarts_[b]]) ; }
+  //@}
+
+  /*! \brief Solve the LP held by \p clp block by block
+
+    The blocks must come from a call to #analyse for the current matrix of
+    \p clp. Block objects are made with \p ctrl, then loaded and solved in
+    parallel. Each takes the objective sense, the primal and dual
+    tolerances, and the matching part of the basis (if any) of \p clp, and
+    runs with logging turned off; other parameters are left at their
+    defaults. The combined solution goes into \p result: objective (with
+    the objective offset of \p clp) and iterations are sums over blocks,
+    and the status is infeasible (1) if any block is infeasible, else
+    unbounded (2) if any block is unbounded, else the first nonzero block
+    status. Any integrality information is ignored.
+
+    If there's only one block, \p clp is solved directly; otherwise \p clp
+    itself is not changed. Returns -1 if the blocks don't match \p clp, a
+    block object can't be created, or a block result can't be fetched; in
+    the last case nothing in \p result is valid. Returns 0 otherwise.
+  */
+  int solve (ClpSimplexAPI &clp, ControlAPI &ctrl, SolveResult &result) ;
+
+private:
+
+  /// Number of threads
+  int numThreads_ ;
+  /// Dimensions of the analysed matrix
+  int numRows_ ;
+  int numCols_ ;
+  /// Number of blocks
+  int numBlocks_ ;
+
+  /// Block of each row and column
+  std::vector<int> rowBlock_ ;
+  std::vector<int> colBlock_ ;
+  /// Rows (columns) of each block, block b in [starts[b],starts[b+1])
+  std::vector<int> blkRowStarts_ ;
+  std::vector<int> blkRows_ ;
+  std::vector<int> blkColStarts_ ;
+  std::vector<int> blkCols_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
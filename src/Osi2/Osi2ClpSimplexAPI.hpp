@@ -5,6 +5,10 @@
 
 #include "Clp_C_Interface.h"
 
+#include "Osi2RayBuffer.hpp"
+#include "Osi2RowMajorView.hpp"
+#include "Osi2SolveResult.hpp"
+
 namespace Osi2 {
 
 class RunParamsAPI ;
@@ -55,6 +59,24 @@ public:
 
   /// Destructor
   virtual ~ClpSimplexAPI() { }
+
+  /*! \brief Clone
+
+    The clone is a full copy: a separate object with its own copy of the
+    model, parameter settings, and basis, sharing nothing with the original,
+    and can be modified and solved independently of it. It costs as much
+    memory as the original, and at least as much time as loading the model.
+    Cached views (see #getRowMajorView) are not copied; the clone builds its
+    own when first asked.
+
+    Copy-on-write sharing of the matrix and vectors is not supported by any
+    shim: neither Clp's C interface nor ClpSimplex can hold a model it
+    doesn't own, so sharing would need changes in Clp itself.
+
+    The clone does not come from ControlAPI; the caller owns it and destroys
+    it with delete. Returns null on failure.
+  */
+  virtual ClpSimplexAPI *clone() const = 0 ;
   //@}
 
   /*! \name Methods to load, modify, and retrieve a problem */
@@ -151,6 +173,16 @@ public:
   /// Modify one element of a matrix
   virtual void modifyCoefficient(int row, int column, double newElement,
     bool keepZero = false) = 0 ;
+  /*! \brief Row-major copy of the matrix
+
+    Built on first request from the column-major matrix, using up to
+    \p numThreads threads, and cached. The cache is invalidated by any
+    method that changes the matrix (loading or reading a problem,
+    #addRows, #deleteRows, #addColumns, #deleteColumns, #modifyCoefficient,
+    #resize). The view may be read concurrently by any number of threads;
+    it must not be used across a change to the matrix.
+  */
+  virtual const RowMajorView &getRowMajorView(int numThreads = 1) const = 0 ;
 
   /// Check if status array exists
   virtual bool statusExists() const = 0 ;
@@ -390,6 +422,21 @@ public:
   */
   virtual void freeRay(double *ray) const = 0 ;
 
+  /*! \brief Unbounded ray into caller storage
+
+    Load the unbounded ray (length numberColumns) into \p ray, in the format
+    selected in \p ray. There's nothing to free. Returns the number of rays
+    loaded (0 if the problem is not known to be unbounded), -1 on error.
+  */
+  virtual int fetchUnboundedRay(RayBuffer &ray) const = 0 ;
+  /*! \brief Infeasibility ray into caller storage
+
+    Load the infeasibility ray (length numberRows) into \p ray, in the format
+    selected in \p ray. There's nothing to free. Returns the number of rays
+    loaded (0 if the problem is not known to be infeasible), -1 on error.
+  */
+  virtual int fetchInfeasibilityRay(RayBuffer &ray) const = 0 ;
+
   /// Number of primal infeasibilities
   virtual int numberPrimalInfeasibilities() const = 0 ;
   /// Sum of primal infeasibilities
@@ -405,6 +452,19 @@ public:
     Sets sum of infeasibilities, etc.
   */
   virtual void checkSolution() = 0 ;
+
+  /*! \brief Fetch the solution in one operation
+
+    Fill \p result with the fields specified by \p fields (see
+    SolveResult::Field). This is much cheaper than calling the individual
+    solution methods one at a time, and the buffers in \p result are reused
+    when the same object is passed in after each of a sequence of solves.
+
+    Returns 0 if all requested fields were filled, -1 otherwise. Fields that
+    could not be filled are marked invalid in \p result.
+  */
+  virtual int fetchResult(SolveResult &result,
+			  unsigned int fields = SolveResult::allFields) const = 0 ;
   //@}
   
   /*! \name User pointer
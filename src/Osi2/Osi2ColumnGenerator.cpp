@@ -0,0 +1,115 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::ColumnGenerator.
+*/
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2ColumnGenerator.hpp"
+
+namespace Osi2 {
+
+ColumnGenerator::ColumnGenerator (int numThreads)
+  : numThreads_(numThreads),
+    maxRounds_(1000),
+    maxIdle_(10),
+    firstGenerated_(0),
+    numAdded_(0),
+    numPurged_(0)
+{ }
+
+ColumnGenerator::~ColumnGenerator () { }
+
+/*
+  A generated column is busy if it is basic or away from zero; otherwise it
+  ages by a round. Deleting nonbasic columns leaves the rest of the basis
+  as it was.
+*/
+int ColumnGenerator::purgeIdle (ClpSimplexAPI &clp)
+{
+  if (maxIdle_ < 0) return (0) ;
+  const double *x = clp.getColSolution() ;
+  const int numGen = static_cast<int>(idle_.size()) ;
+  std::vector<int> which ;
+  int kept = 0 ;
+  for (int k = 0 ; k < numGen ; k++) {
+    const int j = firstGenerated_+k ;
+    if (clp.getColumnStatus(j) == ClpSimplexAPI::basic || x[j] != 0.0)
+      idle_[k] = 0 ;
+    else
+      idle_[k]++ ;
+    if (idle_[k] > maxIdle_)
+      which.push_back(j) ;
+    else
+      idle_[kept++] = idle_[k] ;
+  }
+  idle_.resize(kept) ;
+  if (!which.empty())
+    clp.deleteColumns(static_cast<int>(which.size()),which.data()) ;
+  return (static_cast<int>(which.size())) ;
+}
+
+/*
+  The duals are copied once per round so that the oracles read storage the
+  solver won't touch while they run.
+*/
+int ColumnGenerator::solve (ClpSimplexAPI &clp)
+{
+  rounds_.clear() ;
+  numAdded_ = 0 ;
+  numPurged_ = 0 ;
+  firstGenerated_ = clp.numberColumns() ;
+  idle_.clear() ;
+  if (!clp.statusExists())
+    clp.initialSolve() ;
+  else
+    clp.primal() ;
+
+  const int numPricers = static_cast<int>(pricers_.size()) ;
+  std::vector<ModelBuilder> cols(numPricers,
+				 ModelBuilder(ModelBuilder::colWise)) ;
+  std::vector<double> duals ;
+  for (int r = 0 ; r < maxRounds_ ; r++) {
+    if (clp.status() != 0) return (-1) ;
+    const int m = clp.numberRows() ;
+    duals.assign(clp.getRowPrice(),clp.getRowPrice()+m) ;
+    parallelFor(numPricers,numThreads_,
+		[&] (int first, int last, int)
+		{
+		  for (int k = first ; k < last ; k++)
+		    pricers_[k]->price(m,duals.data(),cols[k]) ;
+		}) ;
+    for (int k = 1 ; k < numPricers ; k++) {
+      cols[0].append(cols[k]) ;
+      cols[k].clear() ;
+    }
+    Round round ;
+    round.objValue_ = clp.objectiveValue() ;
+    round.added_ = (numPricers > 0)?cols[0].addTo(clp):0 ;
+    round.purged_ = 0 ;
+    round.iterations_ = 0 ;
+    if (round.added_ == 0) {
+      rounds_.push_back(round) ;
+      return (0) ;
+    }
+    idle_.resize(idle_.size()+round.added_,0) ;
+    clp.primal() ;
+    round.iterations_ = clp.numberIterations() ;
+    if (clp.status() == 0) round.purged_ = purgeIdle(clp) ;
+    numAdded_ += round.added_ ;
+    numPurged_ += round.purged_ ;
+    rounds_.push_back(round) ;
+  }
+  return ((clp.status() != 0)?-1:1) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,144 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ColumnGenerator.hpp
+    \brief Column generation over a ClpSimplexAPI master problem.
+*/
+#ifndef Osi2ColumnGenerator_HPP
+#define Osi2ColumnGenerator_HPP
+
+#include <vector>
+
+#include "Osi2ModelBuilder.hpp"
+
+namespace Osi2 {
+
+class ClpSimplexAPI ;
+
+/*! \brief Column generation driver
+
+  Runs the master loop of column generation on the model held by a
+  ClpSimplexAPI object: solve the master, give its duals to the pricing
+  oracles, add the columns they return, and repeat until no oracle returns
+  a column.
+
+  Each round calls every oracle (see Pricer) against the same copy of the
+  duals, spread over up to #setNumThreads threads, each oracle with its own
+  column-wise ModelBuilder. The builders are merged in oracle order and the
+  columns go into the master with a single addColumns call, so the master
+  is the same for any number of threads. The master is then re-solved with
+  primal simplex from the previous basis, which stays primal feasible when
+  columns are added.
+
+  Generated columns that stay nonbasic at value zero for more than
+  #setMaxIdle consecutive rounds are purged, with one deleteColumns call per
+  round. The columns of the model as given are never purged. Purged columns
+  may be generated again.
+
+  The oracles decide what is worth returning; the driver doesn't check
+  reduced costs. An oracle that returns a column with nonnegative reduced
+  cost every round keeps the loop going until #setMaxRounds.
+*/
+class ColumnGenerator {
+
+public:
+
+  /*! \brief A pricing oracle
+
+    #price is given the duals of the master (ClpSimplexAPI::getRowPrice)
+    and adds any columns it finds to \p cols, with row indices in the
+    master. It returns the number of columns added. Different oracles may
+    run at the same time in different threads; one oracle is only ever
+    called by one thread at a time.
+  */
+  class Pricer {
+  public:
+    virtual ~Pricer () { }
+    virtual int price (int numRows, const double *duals,
+		       ModelBuilder &cols) = 0 ;
+  } ;
+
+  /// Result of one round
+  struct Round {
+    /// Master objective before pricing
+    double objValue_ ;
+    /// Columns added
+    int added_ ;
+    /// Columns purged after the re-solve
+    int purged_ ;
+    /// Primal simplex iterations for the re-solve
+    int iterations_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  ColumnGenerator (int numThreads = 1) ;
+  /// Destructor
+  ~ColumnGenerator () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Add a pricing oracle; not owned, must outlive #solve
+  inline void addPricer (Pricer *pricer) { pricers_.push_back(pricer) ; }
+  /// Forget the pricing oracles
+  inline void clearPricers () { pricers_.clear() ; }
+  /// Number of threads for pricing
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /// Most rounds of pricing (default 1000)
+  inline void setMaxRounds (int maxRounds) { maxRounds_ = maxRounds ; }
+  /// Rounds a generated column may sit idle before it is purged (default
+  /// 10; negative to never purge)
+  inline void setMaxIdle (int maxIdle) { maxIdle_ = maxIdle ; }
+  //@}
+
+  /*! \brief Run column generation on \p clp
+
+    The master is solved first if it has no basis. Returns -1 if the
+    master is not optimal at some round, 0 if pricing found no more
+    columns, 1 if the round limit was reached. The final master solution
+    is left in \p clp.
+  */
+  int solve (ClpSimplexAPI &clp) ;
+
+  /*! \name Results */
+  //@{
+  /// Number of rounds of pricing, including the last one if it found nothing
+  inline int getNumRounds () const
+  { return (static_cast<int>(rounds_.size())) ; }
+  /// Result of round \p k
+  inline const Round &getRound (int k) const { return (rounds_[k]) ; }
+  /// Total columns added
+  inline int getNumAdded () const { return (numAdded_) ; }
+  /// Total columns purged
+  inline int getNumPurged () const { return (numPurged_) ; }
+  //@}
+
+private:
+
+  /// Age the generated columns and purge the idle ones; returns the number
+  int purgeIdle (ClpSimplexAPI &clp) ;
+
+  /// Pricing oracles
+  std::vector<Pricer *> pricers_ ;
+  /// Parameters
+  int numThreads_ ;
+  int maxRounds_ ;
+  int maxIdle_ ;
+  /// Index of the first generated column
+  int firstGenerated_ ;
+  /// Rounds idle, for each generated column
+  std::vector<int> idle_ ;
+  /// Results
+  std::vector<Round> rounds_ ;
+  int numAdded_ ;
+  int numPurged_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -121,6 +121,36 @@ public:
 
     //@}
 
+    /*! \name Object pools
+        \brief Keep destroyed objects for reuse
+
+      A plugin library that knows how to reset its objects can have them
+      pooled: #destroyObject resets the object and keeps it, and a later
+      #createObject for the same API hands it out again. Nothing is pooled
+      until a limit is set.
+    */
+    //@{
+
+    /*! \brief Keep up to \p limit destroyed objects of API \p apiName
+
+      The limit applies to each plugin library separately. A limit set for
+      "*" applies to all APIs without a limit of their own.
+    */
+    virtual void setPoolLimit(const std::string &apiName, int limit) = 0 ;
+
+    /// Destroy pooled objects until at most \p keep remain in each pool
+    virtual int trimPools(int keep = 0) = 0 ;
+
+    /*! \brief Pool statistics for API \p apiName
+
+      \p hits counts create requests satisfied from a pool, \p misses those
+      that needed a new object, and \p pooled the objects now held.
+    */
+    virtual void getPoolStats(const std::string &apiName, int &hits,
+                              int &misses, int &pooled) const = 0 ;
+
+    //@}
+
     /*! \name Control API control methods
 
       Miscellaneous methods that control the behaviour of a ControlAPI object.
@@ -408,8 +408,11 @@ int ControlAPI_Imp::destroyObject (API *&obj)
   const PluginUniqueID &libID = apiCtrl->libID_ ;
   const std::string &apiName = apiCtrl->apiName_ ;
 /*
-  Invoke the plugin manager's destroyObject.
+  Invoke the plugin manager's destroyObject. The object may survive in a
+  pool, so detach the control information first; createObject will attach
+  new information if the object is handed out again.
 */
+  obj->setCtrlInfo(nullptr) ;
   retval = pluginMgr_->destroyObject(apiName,libID,obj) ;
   if (retval != 0) {
     msgHandler_->message(CTRLAPI_DESTROYFAIL, msgs_) << apiName ;
@@ -431,6 +434,15 @@ int ControlAPI_Imp::destroyObject (API *&obj)
   return (retval) ;
 }
 
+void ControlAPI_Imp::getPoolStats (const std::string &apiName, int &hits,
+				   int &misses, int &pooled) const
+{
+  PluginManager::PoolStats stats = pluginMgr_->getPoolStats(apiName) ;
+  hits = stats.hits_ ;
+  misses = stats.misses_ ;
+  pooled = stats.pooled_ ;
+}
+
 /*
   Utility methods
 */
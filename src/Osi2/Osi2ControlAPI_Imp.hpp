@@ -142,6 +142,29 @@ public:
 
     //@}
 
+    /*! \name Object pools
+        \brief Keep destroyed objects for reuse
+
+      Forwarded to the plugin manager. See PluginManager for details.
+    */
+    //@{
+
+    /// Keep up to \p limit destroyed objects of API \p apiName
+    inline void setPoolLimit(const std::string &apiName, int limit) {
+        pluginMgr_->setPoolLimit(apiName,limit) ;
+    }
+
+    /// Destroy pooled objects until at most \p keep remain in each pool
+    inline int trimPools(int keep = 0) {
+        return (pluginMgr_->trimPools(keep)) ;
+    }
+
+    /// Pool statistics for API \p apiName
+    void getPoolStats(const std::string &apiName, int &hits,
+                      int &misses, int &pooled) const ;
+
+    //@}
+
     /*! \name Control API control methods
 
       Miscellaneous methods that control the behaviour of a ControlAPI object.
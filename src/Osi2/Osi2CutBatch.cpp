@@ -0,0 +1,275 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::CutBatch.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2CutBatch.hpp"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock ;
+
+/// Seconds elapsed since \p start
+inline double secsSince (const Clock::time_point &start)
+{
+  return (std::chrono::duration<double>(Clock::now()-start).count()) ;
+}
+
+/*
+  The C interface takes CoinBigIndex row starts, the batch holds int. When the
+  two are the same type no copy is needed.
+*/
+template <class IndexType>
+const IndexType *asIndexType (const std::vector<int> &src,
+			      std::vector<IndexType> &scratch)
+{
+  scratch.assign(src.begin(),src.end()) ;
+  return (scratch.data()) ;
+}
+
+template <>
+const int *asIndexType<int> (const std::vector<int> &src,
+			     std::vector<int> &)
+{
+  return (src.data()) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+CutBatch::CutBatch ()
+  : starts_(1,0)
+{
+  clear() ;
+}
+
+CutBatch::~CutBatch () { }
+
+void CutBatch::reserve (int numCuts, int numElements)
+{
+  starts_.reserve(numCuts+1) ;
+  lower_.reserve(numCuts) ;
+  upper_.reserve(numCuts) ;
+  keep_.reserve(numCuts) ;
+  indices_.reserve(numElements) ;
+  elements_.reserve(numElements) ;
+}
+
+void CutBatch::clear ()
+{
+  starts_.resize(1) ;
+  indices_.clear() ;
+  elements_.clear() ;
+  lower_.clear() ;
+  upper_.clear() ;
+  stats_.added_ = 0 ;
+  stats_.satisfied_ = 0 ;
+  stats_.duplicates_ = 0 ;
+  stats_.applied_ = 0 ;
+  stats_.filterSecs_ = 0.0 ;
+  stats_.dedupSecs_ = 0.0 ;
+  stats_.applySecs_ = 0.0 ;
+}
+
+/*
+  Add a cut. Coefficients are stored sorted by index; most generators produce
+  sorted cuts already, so check before paying for a sort.
+*/
+int CutBatch::addCut (int len, const int *indices, const double *elements,
+		      double lb, double ub)
+{
+  bool sorted = true ;
+  for (int i = 1 ; i < len && sorted ; i++)
+    sorted = (indices[i-1] < indices[i]) ;
+  if (sorted) {
+    indices_.insert(indices_.end(),indices,indices+len) ;
+    elements_.insert(elements_.end(),elements,elements+len) ;
+  } else {
+    perm_.resize(len) ;
+    for (int i = 0 ; i < len ; i++) perm_[i] = i ;
+    std::sort(perm_.begin(),perm_.end(),
+	      [indices](int a, int b) { return (indices[a] < indices[b]) ; }) ;
+    for (int i = 0 ; i < len ; i++) {
+      indices_.push_back(indices[perm_[i]]) ;
+      elements_.push_back(elements[perm_[i]]) ;
+    }
+  }
+  starts_.push_back(static_cast<int>(indices_.size())) ;
+  lower_.push_back(lb) ;
+  upper_.push_back(ub) ;
+  stats_.added_++ ;
+  return (getNumCuts()-1) ;
+}
+
+double CutBatch::violation (int k, const double *x) const
+{
+  double activity = 0.0 ;
+  for (int ndx = starts_[k] ; ndx < starts_[k+1] ; ndx++)
+    activity += elements_[ndx]*x[indices_[ndx]] ;
+  return (std::max(lower_[k]-activity,activity-upper_[k])) ;
+}
+
+/*
+  Remove the cuts whose keep flag is zero. Cuts only ever move toward the
+  front, so this can be done in place.
+*/
+void CutBatch::compact ()
+{
+  const int numCuts = getNumCuts() ;
+  int dst = 0 ;
+  int dstElem = 0 ;
+  for (int k = 0 ; k < numCuts ; k++) {
+    if (!keep_[k]) continue ;
+    const int first = starts_[k] ;
+    const int len = starts_[k+1]-first ;
+    if (dstElem != first) {
+      std::copy(indices_.begin()+first,indices_.begin()+first+len,
+		indices_.begin()+dstElem) ;
+      std::copy(elements_.begin()+first,elements_.begin()+first+len,
+		elements_.begin()+dstElem) ;
+    }
+    lower_[dst] = lower_[k] ;
+    upper_[dst] = upper_[k] ;
+    starts_[dst] = dstElem ;
+    dstElem += len ;
+    dst++ ;
+  }
+  starts_[dst] = dstElem ;
+  starts_.resize(dst+1) ;
+  indices_.resize(dstElem) ;
+  elements_.resize(dstElem) ;
+  lower_.resize(dst) ;
+  upper_.resize(dst) ;
+}
+
+/*
+  Evaluate violations in parallel (each chunk writes only its own keep flags),
+  then compact serially.
+*/
+int CutBatch::filterViolated (const double *x, double tol, int numThreads)
+{
+  Clock::time_point start = Clock::now() ;
+  const int numCuts = getNumCuts() ;
+  keep_.resize(numCuts) ;
+  parallelFor(numCuts,numThreads,
+	      [this,x,tol](int first, int last, int) {
+		for (int k = first ; k < last ; k++)
+		  keep_[k] = (violation(k,x) > tol) ;
+	      },256) ;
+  compact() ;
+  stats_.satisfied_ += numCuts-getNumCuts() ;
+  stats_.filterSecs_ += secsSince(start) ;
+  return (getNumCuts()) ;
+}
+
+/*
+  Hash each cut's coefficients, sort the cuts by hash, and compare cuts only
+  within runs of equal hash. Ties are broken by cut index so the earliest of a
+  set of duplicates is the one kept.
+*/
+int CutBatch::removeDuplicates ()
+{
+  Clock::time_point start = Clock::now() ;
+  const int numCuts = getNumCuts() ;
+  std::vector<std::pair<size_t,int> > hashes(numCuts) ;
+  std::hash<double> dblHash ;
+  for (int k = 0 ; k < numCuts ; k++) {
+    size_t h = static_cast<size_t>(starts_[k+1]-starts_[k]) ;
+    for (int ndx = starts_[k] ; ndx < starts_[k+1] ; ndx++) {
+      h ^= static_cast<size_t>(indices_[ndx])+0x9e3779b9+(h<<6)+(h>>2) ;
+      h ^= dblHash(elements_[ndx])+0x9e3779b9+(h<<6)+(h>>2) ;
+    }
+    hashes[k] = std::make_pair(h,k) ;
+  }
+  std::sort(hashes.begin(),hashes.end()) ;
+
+  keep_.assign(numCuts,1) ;
+  for (int run = 0 ; run < numCuts ; ) {
+    int runEnd = run+1 ;
+    while (runEnd < numCuts && hashes[runEnd].first == hashes[run].first)
+      runEnd++ ;
+    for (int i = run ; i < runEnd ; i++) {
+      const int ki = hashes[i].second ;
+      if (!keep_[ki]) continue ;
+      const int leni = starts_[ki+1]-starts_[ki] ;
+      for (int j = i+1 ; j < runEnd ; j++) {
+	const int kj = hashes[j].second ;
+	if (!keep_[kj] || starts_[kj+1]-starts_[kj] != leni) continue ;
+	if (std::equal(indices_.begin()+starts_[ki],
+		       indices_.begin()+starts_[ki+1],
+		       indices_.begin()+starts_[kj]) &&
+	    std::equal(elements_.begin()+starts_[ki],
+		       elements_.begin()+starts_[ki+1],
+		       elements_.begin()+starts_[kj])) {
+	  lower_[ki] = std::max(lower_[ki],lower_[kj]) ;
+	  upper_[ki] = std::min(upper_[ki],upper_[kj]) ;
+	  keep_[kj] = 0 ;
+	}
+      }
+    }
+    run = runEnd ;
+  }
+  compact() ;
+  stats_.duplicates_ += numCuts-getNumCuts() ;
+  stats_.dedupSecs_ += secsSince(start) ;
+  return (getNumCuts()) ;
+}
+
+int CutBatch::applyTo (Osi1API &si)
+{
+  Clock::time_point start = Clock::now() ;
+  const int numCuts = getNumCuts() ;
+  if (numCuts > 0) {
+    si.addRows(numCuts,starts_.data(),indices_.data(),elements_.data(),
+	       lower_.data(),upper_.data()) ;
+  }
+  stats_.applied_ += numCuts ;
+  stats_.applySecs_ += secsSince(start) ;
+  return (numCuts) ;
+}
+
+int CutBatch::applyTo (ClpSimplexAPI &clp)
+{
+  Clock::time_point start = Clock::now() ;
+  const int numCuts = getNumCuts() ;
+  if (numCuts > 0) {
+    std::vector<CoinBigIndex> bigStarts ;
+    const CoinBigIndex *starts = asIndexType(starts_,bigStarts) ;
+    clp.addRows(numCuts,lower_.data(),upper_.data(),
+		starts,indices_.data(),elements_.data()) ;
+  }
+  stats_.applied_ += numCuts ;
+  stats_.applySecs_ += secsSince(start) ;
+  return (numCuts) ;
+}
+
+void CutBatch::printStats (std::ostream &os) const
+{
+  os
+    << "Cut round: " << stats_.added_ << " added, "
+    << stats_.satisfied_ << " satisfied, "
+    << stats_.duplicates_ << " duplicate, "
+    << stats_.applied_ << " applied; filter " << stats_.filterSecs_
+    << "s, dedup " << stats_.dedupSecs_
+    << "s, apply " << stats_.applySecs_ << "s." << std::endl ;
+}
+
+}  // end namespace Osi2
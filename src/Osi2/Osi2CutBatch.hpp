@@ -0,0 +1,167 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2CutBatch.hpp
+    \brief A contiguous batch of row cuts, applied with one call.
+
+  Osi1API::applyCuts works one cut at a time, and applyRowCuts wants an
+  array of OsiRowCut objects. A cut generation round that produces thousands
+  of cuts is better served by collecting them in a single row-major (CSR)
+  block and handing the whole block to the solver's addRows.
+*/
+#ifndef Osi2CutBatch_HPP
+#define Osi2CutBatch_HPP
+
+#include <iosfwd>
+#include <vector>
+
+namespace Osi2 {
+
+class Osi1API ;
+class ClpSimplexAPI ;
+
+/*! \brief A batch of row cuts held in CSR form
+
+  Cuts are added one at a time with #addCut; the coefficients of each cut are
+  held sorted by column index. A typical round is
+    - #clear (storage is retained from the previous round)
+    - #addCut for each cut produced by the generators
+    - optionally #filterViolated and / or #removeDuplicates
+    - #applyTo the solver (a single addRows call)
+
+  Time spent in the filter, duplicate removal, and apply steps is accumulated
+  in a RoundStats structure, reset by #clear.
+*/
+class CutBatch {
+
+public:
+
+  /// Statistics for one round (since the last #clear)
+  struct RoundStats {
+    /// Cuts added to the batch
+    int added_ ;
+    /// Cuts dropped as not violated
+    int satisfied_ ;
+    /// Cuts dropped as duplicates
+    int duplicates_ ;
+    /// Cuts passed to the solver
+    int applied_ ;
+    /// Wall clock seconds spent in #filterViolated
+    double filterSecs_ ;
+    /// Wall clock seconds spent in #removeDuplicates
+    double dedupSecs_ ;
+    /// Wall clock seconds spent in #applyTo
+    double applySecs_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  CutBatch () ;
+  /// Destructor
+  ~CutBatch () ;
+  //@}
+
+  /*! \name Building the batch */
+  //@{
+  /// Reserve space for \p numCuts cuts with \p numElements coefficients
+  void reserve (int numCuts, int numElements) ;
+
+  /// Remove all cuts (storage is retained) and reset the statistics
+  void clear () ;
+
+  /*! \brief Add a cut lb <= ax <= ub
+
+    Returns the index of the cut in the batch.
+  */
+  int addCut (int len, const int *indices, const double *elements,
+  	      double lb, double ub) ;
+  //@}
+
+  /*! \name Access to the batch */
+  //@{
+  /// Number of cuts
+  inline int getNumCuts () const
+  { return (static_cast<int>(lower_.size())) ; }
+  /// Number of coefficients
+  inline int getNumElements () const
+  { return (static_cast<int>(indices_.size())) ; }
+  /// Row starts (#getNumCuts()+1 entries)
+  inline const int *getStarts () const { return (starts_.data()) ; }
+  /// Column indices
+  inline const int *getIndices () const { return (indices_.data()) ; }
+  /// Coefficients
+  inline const double *getElements () const { return (elements_.data()) ; }
+  /// Row lower bounds
+  inline const double *getLower () const { return (lower_.data()) ; }
+  /// Row upper bounds
+  inline const double *getUpper () const { return (upper_.data()) ; }
+
+  /// Violation of cut \p k at \p x (positive if violated)
+  double violation (int k, const double *x) const ;
+  //@}
+
+  /*! \name Processing and application */
+  //@{
+  /*! \brief Drop cuts that are not violated by more than \p tol at \p x
+
+    Violations are evaluated in parallel using up to \p numThreads threads.
+    The relative order of the surviving cuts is preserved. Returns the number
+    of cuts remaining.
+  */
+  int filterViolated (const double *x, double tol = 1.0e-6,
+  		      int numThreads = 1) ;
+
+  /*! \brief Drop cuts with coefficients identical to an earlier cut
+
+    When two cuts have the same coefficients, the first is kept and its
+    bounds are tightened to the intersection of the two. Returns the number
+    of cuts remaining.
+  */
+  int removeDuplicates () ;
+
+  /// Add the cuts to \p si with one addRows call; returns the number added
+  int applyTo (Osi1API &si) ;
+  /// Add the cuts to \p clp with one addRows call; returns the number added
+  int applyTo (ClpSimplexAPI &clp) ;
+  //@}
+
+  /*! \name Statistics */
+  //@{
+  /// Statistics for the current round
+  inline const RoundStats &getStats () const { return (stats_) ; }
+  /// Print a one-line summary of the current round
+  void printStats (std::ostream &os) const ;
+  //@}
+
+private:
+
+  /// Remove cuts with keep_[k] == 0, preserving order
+  void compact () ;
+
+  /// Row starts
+  std::vector<int> starts_ ;
+  /// Column indices
+  std::vector<int> indices_ ;
+  /// Coefficients
+  std::vector<double> elements_ ;
+  /// Row lower bounds
+  std::vector<double> lower_ ;
+  /// Row upper bounds
+  std::vector<double> upper_ ;
+
+  /// Scratch: keep flag for each cut
+  std::vector<char> keep_ ;
+  /// Scratch: sort permutation for #addCut
+  std::vector<int> perm_ ;
+
+  /// Statistics for the current round
+  RoundStats stats_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,354 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::CutPool.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2CutPool.hpp"
+
+namespace {
+
+/*
+  Bounds at or beyond this magnitude are taken to be infinite and are not
+  scaled during normalisation. Scaling -1e30 by 0.5 would otherwise produce a
+  finite bound as far as the solver is concerned.
+*/
+const double infBound = 1.0e20 ;
+
+inline double scaleBound (double bound, double scale)
+{
+  if (std::fabs(bound) >= infBound)
+    return ((scale > 0)?bound:-bound) ;
+  else
+    return (bound*scale) ;
+}
+
+/*
+  Sparse dot product with four independent accumulators. Breaking the
+  dependency chain lets the compiler overlap the gathers and multiplies
+  (and vectorise where the target supports gathers). The summation order is
+  fixed, so the result does not depend on how cuts are divided among threads.
+*/
+inline double sparseDot (int len, const int *idx, const double *elem,
+			 const double *x)
+{
+  double s0 = 0.0 ;
+  double s1 = 0.0 ;
+  double s2 = 0.0 ;
+  double s3 = 0.0 ;
+  int i = 0 ;
+  for ( ; i+4 <= len ; i += 4) {
+    s0 += elem[i]*x[idx[i]] ;
+    s1 += elem[i+1]*x[idx[i+1]] ;
+    s2 += elem[i+2]*x[idx[i+2]] ;
+    s3 += elem[i+3]*x[idx[i+3]] ;
+  }
+  for ( ; i < len ; i++) s0 += elem[i]*x[idx[i]] ;
+  return ((s0+s1)+(s2+s3)) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+CutPool::CutPool (int numThreads)
+  : numLive_(0),
+    numInSolver_(0),
+    deadElements_(0),
+    numThreads_(numThreads),
+    maxAge_(3),
+    maxPoolAge_(10),
+    dupTol_(1.0e-9)
+{ }
+
+CutPool::~CutPool () { }
+
+/*
+  Normalise the cut, then look for a duplicate among the cuts with the same
+  hash. Only the column indices go into the hash. Quantising the coefficients
+  to the duplicate tolerance would put two coefficients that straddle a
+  rounding boundary in different buckets; instead, the coefficients of each
+  candidate with the same columns are compared within the tolerance.
+*/
+int CutPool::addCut (int len, const int *indices, const double *elements,
+		     double lb, double ub)
+{
+  if (len <= 0) return (-1) ;
+
+  std::vector<std::pair<int,double> > coeffs(len) ;
+  for (int i = 0 ; i < len ; i++)
+    coeffs[i] = std::make_pair(indices[i],elements[i]) ;
+  std::sort(coeffs.begin(),coeffs.end()) ;
+  double maxAbs = 0.0 ;
+  for (int i = 0 ; i < len ; i++)
+    maxAbs = std::max(maxAbs,std::fabs(coeffs[i].second)) ;
+  if (maxAbs == 0.0) return (-1) ;
+  const double scale = ((coeffs[0].second < 0)?-1.0:1.0)/maxAbs ;
+
+  scratchIndices_.resize(len) ;
+  scratchElements_.resize(len) ;
+  size_t hash = static_cast<size_t>(len) ;
+  for (int i = 0 ; i < len ; i++) {
+    scratchIndices_[i] = coeffs[i].first ;
+    scratchElements_[i] = coeffs[i].second*scale ;
+    hash ^= static_cast<size_t>(coeffs[i].first)+0x9e3779b9+(hash<<6)+(hash>>2) ;
+  }
+  double nlb = scaleBound(lb,scale) ;
+  double nub = scaleBound(ub,scale) ;
+  if (scale < 0) std::swap(nlb,nub) ;
+
+  auto range = byHash_.equal_range(hash) ;
+  for (auto iter = range.first ; iter != range.second ; iter++) {
+    CutRec &rec = cuts_[iter->second] ;
+    if (rec.len_ != len) continue ;
+    bool same = true ;
+    for (int i = 0 ; i < len && same ; i++) {
+      same = (indices_[rec.start_+i] == scratchIndices_[i]) &&
+	     (std::fabs(elements_[rec.start_+i]-scratchElements_[i]) <= dupTol_) ;
+    }
+    if (same) {
+      rec.lb_ = std::max(rec.lb_,nlb) ;
+      rec.ub_ = std::min(rec.ub_,nub) ;
+      rec.age_ = 0 ;
+      return (iter->second) ;
+    }
+  }
+
+  CutRec rec ;
+  rec.start_ = static_cast<int>(indices_.size()) ;
+  rec.len_ = len ;
+  rec.lb_ = nlb ;
+  rec.ub_ = nub ;
+  rec.hash_ = hash ;
+  rec.age_ = 0 ;
+  rec.row_ = -1 ;
+  rec.live_ = true ;
+  indices_.insert(indices_.end(),scratchIndices_.begin(),scratchIndices_.end()) ;
+  elements_.insert(elements_.end(),
+		   scratchElements_.begin(),scratchElements_.end()) ;
+  int k ;
+  if (freeSlots_.empty()) {
+    k = static_cast<int>(cuts_.size()) ;
+    cuts_.push_back(rec) ;
+  } else {
+    k = freeSlots_.back() ;
+    freeSlots_.pop_back() ;
+    cuts_[k] = rec ;
+  }
+  byHash_.insert(std::make_pair(hash,k)) ;
+  numLive_++ ;
+  return (k) ;
+}
+
+int CutPool::addCuts (const CutBatch &batch)
+{
+  const int before = numLive_ ;
+  const int *starts = batch.getStarts() ;
+  for (int k = 0 ; k < batch.getNumCuts() ; k++) {
+    addCut(starts[k+1]-starts[k],batch.getIndices()+starts[k],
+	   batch.getElements()+starts[k],
+	   batch.getLower()[k],batch.getUpper()[k]) ;
+  }
+  return (numLive_-before) ;
+}
+
+void CutPool::discard (int k)
+{
+  CutRec &rec = cuts_[k] ;
+  auto range = byHash_.equal_range(rec.hash_) ;
+  for (auto iter = range.first ; iter != range.second ; iter++) {
+    if (iter->second == k) {
+      byHash_.erase(iter) ;
+      break ;
+    }
+  }
+  rec.live_ = false ;
+  deadElements_ += rec.len_ ;
+  numLive_-- ;
+  freeSlots_.push_back(k) ;
+}
+
+/*
+  Squeeze the coefficients of discarded cuts out of the arena once they hold
+  half of it. Live cuts keep their pool index; only their start in the arena
+  moves. Cuts are visited in arena order, so nothing is overwritten before
+  it's been moved. A discarded cut in a free slot keeps an empty range.
+*/
+void CutPool::compact ()
+{
+  if (2*static_cast<size_t>(deadElements_) <= indices_.size()) return ;
+
+  std::vector<int> order ;
+  order.reserve(numLive_) ;
+  for (int k = 0 ; k < static_cast<int>(cuts_.size()) ; k++) {
+    CutRec &rec = cuts_[k] ;
+    if (rec.live_) {
+      order.push_back(k) ;
+    } else {
+      rec.start_ = 0 ;
+      rec.len_ = 0 ;
+    }
+  }
+  std::sort(order.begin(),order.end(),
+	    [this](int a, int b) { return (cuts_[a].start_ < cuts_[b].start_) ; }) ;
+  int dst = 0 ;
+  for (int k : order) {
+    CutRec &rec = cuts_[k] ;
+    std::copy(indices_.begin()+rec.start_,
+	      indices_.begin()+rec.start_+rec.len_,indices_.begin()+dst) ;
+    std::copy(elements_.begin()+rec.start_,
+	      elements_.begin()+rec.start_+rec.len_,elements_.begin()+dst) ;
+    rec.start_ = dst ;
+    dst += rec.len_ ;
+  }
+  indices_.resize(dst) ;
+  elements_.resize(dst) ;
+  deadElements_ = 0 ;
+}
+
+/*
+  Evaluation proper runs in parallel; each thread writes only the violations
+  for its own range of cuts. Ageing runs afterward, serially.
+*/
+int CutPool::evaluate (const double *x, double tol)
+{
+  compact() ;
+  const int numCuts = static_cast<int>(cuts_.size()) ;
+  viol_.resize(numCuts) ;
+  parallelFor(numCuts,numThreads_,
+	      [this,x](int first, int last, int) {
+		for (int k = first ; k < last ; k++) {
+		  const CutRec &rec = cuts_[k] ;
+		  if (!rec.live_) {
+		    viol_[k] = 0.0 ;
+		    continue ;
+		  }
+		  double act = sparseDot(rec.len_,&indices_[rec.start_],
+					 &elements_[rec.start_],x) ;
+		  viol_[k] = std::max(rec.lb_-act,act-rec.ub_) ;
+		}
+	      },512) ;
+
+  int numViolated = 0 ;
+  for (int k = 0 ; k < numCuts ; k++) {
+    CutRec &rec = cuts_[k] ;
+    if (!rec.live_ || rec.row_ >= 0) continue ;
+    if (viol_[k] > tol) {
+      rec.age_ = 0 ;
+      numViolated++ ;
+    } else if (++rec.age_ > maxPoolAge_) {
+      discard(k) ;
+    }
+  }
+  return (numViolated) ;
+}
+
+int CutPool::selectViolated (int maxCuts, double tol,
+			     std::vector<int> &which) const
+{
+  which.clear() ;
+  const int numCuts = static_cast<int>(viol_.size()) ;
+  for (int k = 0 ; k < numCuts ; k++) {
+    const CutRec &rec = cuts_[k] ;
+    if (rec.live_ && rec.row_ < 0 && viol_[k] > tol) which.push_back(k) ;
+  }
+  auto moreViolated = [this](int a, int b) {
+    return ((viol_[a] > viol_[b]) || (viol_[a] == viol_[b] && a < b)) ;
+  } ;
+  if (maxCuts < static_cast<int>(which.size())) {
+    std::partial_sort(which.begin(),which.begin()+maxCuts,which.end(),
+		      moreViolated) ;
+    which.resize(maxCuts) ;
+  } else {
+    std::sort(which.begin(),which.end(),moreViolated) ;
+  }
+  return (static_cast<int>(which.size())) ;
+}
+
+/*
+  The selected cuts go into the solver as a single CSR block, appended after
+  the existing rows in selection order.
+*/
+int CutPool::separate (Osi1API &si, int maxCuts, double tol)
+{
+  evaluate(si.getColSolution(),tol) ;
+  std::vector<int> which ;
+  int numSelected = selectViolated(maxCuts,tol,which) ;
+  if (numSelected == 0) return (0) ;
+
+  batch_.clear() ;
+  for (int k : which) {
+    const CutRec &rec = cuts_[k] ;
+    batch_.addCut(rec.len_,&indices_[rec.start_],&elements_[rec.start_],
+		  rec.lb_,rec.ub_) ;
+  }
+  const int firstRow = si.getNumRows() ;
+  batch_.applyTo(si) ;
+  for (int i = 0 ; i < numSelected ; i++) {
+    CutRec &rec = cuts_[which[i]] ;
+    rec.row_ = firstRow+i ;
+    rec.age_ = 0 ;
+  }
+  numInSolver_ += numSelected ;
+  return (numSelected) ;
+}
+
+/*
+  Osi basis status for rows: 1 is basic. A basic row is slack, hence the cut
+  is not doing anything at present.
+*/
+int CutPool::ageCuts (Osi1API &si)
+{
+  if (numInSolver_ == 0) return (0) ;
+  const int m = si.getNumRows() ;
+  std::vector<int> cstat(si.getNumCols()) ;
+  std::vector<int> rstat(m) ;
+  si.getBasisStatus(cstat.data(),rstat.data()) ;
+
+  std::vector<int> victims ;
+  for (CutRec &rec : cuts_) {
+    if (!rec.live_ || rec.row_ < 0 || rec.row_ >= m) continue ;
+    if (rstat[rec.row_] != 1) {
+      rec.age_ = 0 ;
+    } else if (++rec.age_ > maxAge_) {
+      victims.push_back(rec.row_) ;
+      rec.row_ = -1 ;
+      rec.age_ = 0 ;
+      numInSolver_-- ;
+    }
+  }
+  if (victims.empty()) return (0) ;
+/*
+  Remove the rows in one call, then shift the row index of each remaining cut
+  down by the number of deleted rows that preceded it.
+*/
+  std::sort(victims.begin(),victims.end()) ;
+  si.deleteRows(static_cast<int>(victims.size()),victims.data()) ;
+  for (CutRec &rec : cuts_) {
+    if (!rec.live_ || rec.row_ < 0) continue ;
+    rec.row_ -= static_cast<int>(std::lower_bound(victims.begin(),
+    				 victims.end(),rec.row_)-victims.begin()) ;
+  }
+  return (static_cast<int>(victims.size())) ;
+}
+
+void CutPool::forgetSolverRows ()
+{
+  for (CutRec &rec : cuts_) rec.row_ = -1 ;
+  numInSolver_ = 0 ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,217 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2CutPool.hpp
+    \brief A cut management layer over Osi1API.
+
+  Osi2::CutPool keeps row cuts between separation rounds. It removes
+  duplicates as cuts arrive, picks the most violated cuts for a given primal
+  solution, moves them into the solver in one batch, and takes them out again
+  once they've been slack for long enough.
+*/
+#ifndef Osi2CutPool_HPP
+#define Osi2CutPool_HPP
+
+#include <unordered_map>
+#include <vector>
+
+#include "Osi2CutBatch.hpp"
+
+namespace Osi2 {
+
+class Osi1API ;
+
+/*! \brief A pool of row cuts
+
+  Cuts are stored in an arena: coefficients for all cuts live in two
+  contiguous vectors, with a small record per cut. Each cut is stored in
+  normalised form: scaled so that the largest coefficient has absolute value
+  1 and the first coefficient is positive (the bounds are scaled, and swapped
+  if necessary, to match). Two cuts that differ only by a scale factor have
+  the same normalised form and are recognised as duplicates; the pool keeps
+  one copy with the intersection of the bounds.
+
+  The index returned by #addCut names the cut for as long as it stays in the
+  pool. Discarded cuts leave a free slot behind, and the arena space they
+  held is reclaimed now and then, but neither renumbers the cuts that remain.
+  A free slot is reused by a later #addCut.
+
+  A cut is either in the solver (it's been added as a row and the pool knows
+  the row index) or waiting in the pool. The pool assumes that it is the only
+  party that deletes its rows from the solver; if the client does anything
+  that renumbers rows, it should call #forgetSolverRows.
+
+  Ageing works on both sides:
+    - a cut in the solver whose row is basic (i.e., slack) at the end of a
+      round ages; when its age exceeds #setMaxAge it is removed from the
+      solver and returns to the pool.
+    - a cut waiting in the pool that is not violated when the pool is
+      evaluated ages; when its age exceeds #setMaxPoolAge it is discarded.
+  Any activity resets the age to zero.
+*/
+class CutPool {
+
+public:
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor; violations are evaluated with up to \p numThreads threads
+  CutPool (int numThreads = 1) ;
+  /// Destructor
+  ~CutPool () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Number of threads used to evaluate violations
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /// Rounds a solver row may stay slack before it is removed (default 3)
+  inline void setMaxAge (int maxAge) { maxAge_ = maxAge ; }
+  /// Rounds a pool cut may stay satisfied before it is discarded (default 10)
+  inline void setMaxPoolAge (int maxAge) { maxPoolAge_ = maxAge ; }
+  /// Tolerance used to compare normalised coefficients (default 1.0e-9)
+  inline void setDupTol (double tol) { dupTol_ = tol ; }
+  //@}
+
+  /*! \name Adding cuts */
+  //@{
+  /*! \brief Add the cut lb <= ax <= ub
+
+    Returns the index of the cut in the pool, which stays valid until the cut
+    is discarded. If the cut duplicates a cut already in the pool, the
+    existing index is returned and the bounds of the existing cut are
+    tightened. Returns -1 for an empty cut. If a duplicate
+    is already in the solver, tightened bounds are not passed to the solver.
+  */
+  int addCut (int len, const int *indices, const double *elements,
+  	      double lb, double ub) ;
+
+  /// Add all cuts in \p batch; returns the number that were new
+  int addCuts (const CutBatch &batch) ;
+  //@}
+
+  /*! \name Information */
+  //@{
+  /// Number of cuts in the pool (in the solver or waiting)
+  inline int getNumCuts () const { return (numLive_) ; }
+  /// Number of cuts currently in the solver
+  inline int getNumInSolver () const { return (numInSolver_) ; }
+  /// True if \p k is the index of a cut in the pool
+  inline bool isLive (int k) const
+  { return (k >= 0 && k < static_cast<int>(cuts_.size()) && cuts_[k].live_) ; }
+  /// Violation of pool cut \p k at the last evaluation
+  inline double getViolation (int k) const { return (viol_[k]) ; }
+  //@}
+
+  /*! \name Separation and ageing */
+  //@{
+  /*! \brief Evaluate the violation of all waiting cuts at \p x
+
+    Violations of the normalised cuts are evaluated in parallel. Waiting cuts
+    that are violated by more than \p tol have their age reset; the others
+    age, and are discarded when too old. Returns the number of violated
+    cuts.
+  */
+  int evaluate (const double *x, double tol = 1.0e-6) ;
+
+  /*! \brief Select the \p maxCuts most violated waiting cuts
+
+    Uses the violations from the last #evaluate. Ties are broken by pool
+    index so the selection is deterministic. Returns the number selected.
+  */
+  int selectViolated (int maxCuts, double tol, std::vector<int> &which) const ;
+
+  /*! \brief Add the most violated waiting cuts to the solver
+
+    Evaluate at \p si.getColSolution(), select at most \p maxCuts violated
+    cuts, and add them to \p si with a single addRows call. Returns the
+    number of cuts added.
+  */
+  int separate (Osi1API &si, int maxCuts, double tol = 1.0e-6) ;
+
+  /*! \brief Age the cuts in the solver and remove the old ones
+
+    Must be called after a solve, while the basis is available. Rows that are
+    basic age; rows that are not get their age reset. Rows that exceed the
+    maximum age are removed from \p si with a single deleteRows call and the
+    cuts go back to waiting in the pool. Returns the number of rows removed.
+  */
+  int ageCuts (Osi1API &si) ;
+
+  /// Treat all cuts as waiting; use after the solver's rows are renumbered
+  void forgetSolverRows () ;
+  //@}
+
+  /// Statistics for the most recent batch passed to the solver
+  inline const CutBatch::RoundStats &getStats () const
+  { return (batch_.getStats()) ; }
+
+private:
+
+  /// Per-cut record in the arena
+  struct CutRec {
+    /// Start of the coefficients in the arena
+    int start_ ;
+    /// Number of coefficients
+    int len_ ;
+    /// Lower bound (normalised)
+    double lb_ ;
+    /// Upper bound (normalised)
+    double ub_ ;
+    /// Hash of the column indices
+    size_t hash_ ;
+    /// Age (see class documentation)
+    int age_ ;
+    /// Row index in the solver, or -1 if waiting
+    int row_ ;
+    /// False once the cut is discarded
+    bool live_ ;
+  } ;
+
+  /// Discard cut \p k
+  void discard (int k) ;
+  /// Reclaim the arena space of discarded cuts when it's too much
+  void compact () ;
+
+  /// Records, indexed by pool index
+  std::vector<CutRec> cuts_ ;
+  /// Arena: column indices
+  std::vector<int> indices_ ;
+  /// Arena: normalised coefficients
+  std::vector<double> elements_ ;
+  /// Hash of column indices to pool index
+  std::unordered_multimap<size_t,int> byHash_ ;
+  /// Indices of discarded cuts, for reuse
+  std::vector<int> freeSlots_ ;
+  /// Violation of each cut at the last evaluation
+  std::vector<double> viol_ ;
+
+  /// Number of live cuts
+  int numLive_ ;
+  /// Number of live cuts in the solver
+  int numInSolver_ ;
+  /// Coefficients held by discarded cuts
+  int deadElements_ ;
+
+  /// Threads for evaluation
+  int numThreads_ ;
+  /// Maximum age of a slack solver row
+  int maxAge_ ;
+  /// Maximum age of a satisfied waiting cut
+  int maxPoolAge_ ;
+  /// Tolerance for comparing normalised coefficients
+  double dupTol_ ;
+
+  /// Scratch: normalisation
+  std::vector<int> scratchIndices_ ;
+  std::vector<double> scratchElements_ ;
+  /// Batch used to pass cuts to the solver
+  CutBatch batch_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,192 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::LexiSolver.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2ModelBuilder.hpp"
+#include "Osi2LexiSolver.hpp"
+
+namespace {
+
+/*
+  Collect the objective rows for stages 0..numStages-2, free, in a
+  row-wise builder.
+*/
+void objectiveRows (int n, int numStages, const double *objs, double inf,
+		    Osi2::ModelBuilder &rows)
+{
+  std::vector<int> ndx ;
+  std::vector<double> coeff ;
+  for (int s = 0 ; s < numStages-1 ; s++) {
+    const double *c = objs+static_cast<size_t>(s)*n ;
+    ndx.clear() ;
+    coeff.clear() ;
+    for (int j = 0 ; j < n ; j++) {
+      if (c[j] != 0.0) {
+	ndx.push_back(j) ;
+	coeff.push_back(c[j]) ;
+      }
+    }
+    rows.addRow(static_cast<int>(ndx.size()),ndx.data(),coeff.data(),
+		-inf,inf) ;
+  }
+}
+
+/// c'x
+double dot (int n, const double *c, const double *x)
+{
+  double val = 0.0 ;
+  for (int j = 0 ; j < n ; j++) val += c[j]*x[j] ;
+  return (val) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+LexiSolver::LexiSolver ()
+  : absTol_(1.0e-6),
+    relTol_(1.0e-9),
+    keepRows_(false),
+    firstObjRow_(-1)
+{ }
+
+LexiSolver::~LexiSolver () { }
+
+double LexiSolver::tolerance (double z) const
+{
+  return (std::max(absTol_,relTol_*std::fabs(z))) ;
+}
+
+/*
+  ClpSimplexAPI changes row bounds a whole vector at a time, so keep a
+  copy of the upper and lower bounds and patch the objective row for each
+  stage. The optimal value is recomputed as c(s)x so that it doesn't
+  include the objective offset.
+
+  Whether there's a basis to start from is decided before the objective
+  rows go in. The new rows are free, hence basic, so a basis from before
+  stays a basis; stage 0 changes only the objective, so it's primal
+  feasible and primal simplex picks up from it.
+*/
+int LexiSolver::solve (ClpSimplexAPI &clp, int numStages, const double *objs)
+{
+  const int n = clp.numberColumns() ;
+  const int m0 = clp.numberRows() ;
+  const double inf = std::numeric_limits<double>::max() ;
+  const double sense = clp.objSense() ;
+  const std::vector<double> baseObj(clp.objective(),clp.objective()+n) ;
+  const bool warm = clp.statusExists() ;
+  stages_.clear() ;
+  firstObjRow_ = m0 ;
+  if (numStages <= 0) return (0) ;
+
+  ModelBuilder rows ;
+  objectiveRows(n,numStages,objs,inf,rows) ;
+  rows.addTo(clp) ;
+  const int m = clp.numberRows() ;
+  std::vector<double> rowlb(clp.rowLower(),clp.rowLower()+m) ;
+  std::vector<double> rowub(clp.rowUpper(),clp.rowUpper()+m) ;
+
+  int numOptimal = 0 ;
+  for (int s = 0 ; s < numStages ; s++) {
+    const double *c = objs+static_cast<size_t>(s)*n ;
+    clp.chgObjCoefficients(c) ;
+    if (s == 0 && !warm)
+      clp.initialSolve() ;
+    else
+      clp.primal() ;
+    Stage stage ;
+    stage.status_ = clp.status() ;
+    stage.objValue_ = dot(n,c,clp.getColSolution()) ;
+    stage.iterations_ = clp.numberIterations() ;
+    stages_.push_back(stage) ;
+    if (stage.status_ != 0) break ;
+    numOptimal++ ;
+    if (s < numStages-1) {
+      const double tol = tolerance(stage.objValue_) ;
+      if (sense > 0) {
+	rowub[m0+s] = stage.objValue_+tol ;
+	clp.chgRowUpper(rowub.data()) ;
+      } else {
+	rowlb[m0+s] = stage.objValue_-tol ;
+	clp.chgRowLower(rowlb.data()) ;
+      }
+    }
+  }
+
+  clp.chgObjCoefficients(baseObj.data()) ;
+  if (!keepRows_ && m > m0) {
+    std::vector<int> which(m-m0) ;
+    for (int k = 0 ; k < m-m0 ; k++) which[k] = m0+k ;
+    clp.deleteRows(m-m0,which.data()) ;
+  }
+  return (numOptimal) ;
+}
+
+int LexiSolver::solve (Osi1API &si, int numStages, const double *objs)
+{
+  const int n = si.getNumCols() ;
+  const int m0 = si.getNumRows() ;
+  const double sense = si.getObjSense() ;
+  const std::vector<double> baseObj(si.getObjCoefficients(),
+				    si.getObjCoefficients()+n) ;
+  const bool warm = si.basisIsAvailable() ;
+  stages_.clear() ;
+  firstObjRow_ = m0 ;
+  if (numStages <= 0) return (0) ;
+
+  ModelBuilder rows ;
+  objectiveRows(n,numStages,objs,si.getInfinity(),rows) ;
+  rows.addTo(si) ;
+  const int m = si.getNumRows() ;
+
+  int numOptimal = 0 ;
+  for (int s = 0 ; s < numStages ; s++) {
+    const double *c = objs+static_cast<size_t>(s)*n ;
+    si.setObjective(c) ;
+    if (s == 0 && !warm)
+      si.initialSolve() ;
+    else
+      si.resolve() ;
+    Stage stage ;
+    stage.status_ = (si.isProvenOptimal())?0:1 ;
+    stage.objValue_ = dot(n,c,si.getColSolution()) ;
+    stage.iterations_ = si.getIterationCount() ;
+    stages_.push_back(stage) ;
+    if (stage.status_ != 0) break ;
+    numOptimal++ ;
+    if (s < numStages-1) {
+      const double tol = tolerance(stage.objValue_) ;
+      if (sense > 0)
+	si.setRowUpper(m0+s,stage.objValue_+tol) ;
+      else
+	si.setRowLower(m0+s,stage.objValue_-tol) ;
+    }
+  }
+
+  si.setObjective(baseObj.data()) ;
+  if (!keepRows_ && m > m0) {
+    std::vector<int> which(m-m0) ;
+    for (int k = 0 ; k < m-m0 ; k++) which[k] = m0+k ;
+    si.deleteRows(m-m0,which.data()) ;
+  }
+  return (numOptimal) ;
+}
+
+}  // end namespace Osi2
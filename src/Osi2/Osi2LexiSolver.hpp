@@ -0,0 +1,121 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2LexiSolver.hpp
+    \brief Lexicographic optimisation over a sequence of objectives.
+*/
+#ifndef Osi2LexiSolver_HPP
+#define Osi2LexiSolver_HPP
+
+#include <vector>
+
+namespace Osi2 {
+
+class Osi1API ;
+class ClpSimplexAPI ;
+
+/*! \brief Lexicographic multi-objective driver
+
+  Optimises a sequence of objectives c(0), ..., c(K-1) in priority order:
+  stage s optimises c(s) over the solutions that are (nearly) optimal for
+  every earlier stage.
+
+  Everything happens in place in the solver object. Before the first stage,
+  one row per stage but the last, a(s)x = c(s)x, is added in a single call,
+  with no bounds; a free row is basic and changes nothing. After stage s is
+  solved with optimal value z(s), the row for s is bounded by
+  z(s) + tol(s) (minimisation) or z(s) - tol(s) (maximisation), where
+  tol(s) = max(absTol, relTol*|z(s)|). The relaxation keeps later stages
+  from being starved by round-off in z(s).
+
+  The current solution satisfies the new bound, so the basis stays primal
+  feasible from stage to stage and each stage after the first is a warm
+  started primal simplex with a new objective (for Osi1API, a resolve).
+  Stage 0 is warm started the same way if the solver has a basis on entry;
+  otherwise it's an initial solve. The matrix is never rebuilt.
+
+  When done, the original objective is put back and, unless #setKeepRows
+  was called, the objective rows are deleted. The solution of the last
+  stage solved is left in the solver.
+*/
+class LexiSolver {
+
+public:
+
+  /// Result of one stage
+  struct Stage {
+    /// Status (ClpSimplexAPI::status; for Osi1API, 0 if optimal, else 1)
+    int status_ ;
+    /// Optimal value c(s)x
+    double objValue_ ;
+    /// Simplex iterations
+    int iterations_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  LexiSolver () ;
+  /// Destructor
+  ~LexiSolver () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Relaxation of the objective rows: max(absTol, relTol*|z|)
+  inline void setTolerances (double absTol, double relTol)
+  { absTol_ = absTol ; relTol_ = relTol ; }
+  /// Leave the objective rows in the model (default false)
+  inline void setKeepRows (bool keep) { keepRows_ = keep ; }
+  //@}
+
+  /*! \name Solve
+
+    \p objs holds the \p numStages objectives, n coefficients each, in
+    priority order. Stages stop at the first one that does not end optimal.
+    Returns the number of stages solved to optimality.
+  */
+  //@{
+  /// Lexicographic solve on \p clp
+  int solve (ClpSimplexAPI &clp, int numStages, const double *objs) ;
+  /// Lexicographic solve on \p si
+  int solve (Osi1API &si, int numStages, const double *objs) ;
+  //@}
+
+  /*! \name Results */
+  //@{
+  /// Number of stages attempted
+  inline int getNumStages () const
+  { return (static_cast<int>(stages_.size())) ; }
+  /// Result of stage \p s
+  inline const Stage &getStage (int s) const { return (stages_[s]) ; }
+  /*! \brief Index of the first objective row
+
+    The objective row for stage s is getFirstObjRow()+s. Meaningful only
+    if the rows were kept.
+  */
+  inline int getFirstObjRow () const { return (firstObjRow_) ; }
+  //@}
+
+private:
+
+  /// Relaxation for optimal value \p z
+  double tolerance (double z) const ;
+
+  /// Relaxation
+  double absTol_ ;
+  double relTol_ ;
+  /// Keep the objective rows?
+  bool keepRows_ ;
+  /// Index of the first objective row
+  int firstObjRow_ ;
+  /// Stage results
+  std::vector<Stage> stages_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
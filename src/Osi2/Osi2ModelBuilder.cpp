@@ -0,0 +1,346 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::ModelBuilder.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2ModelBuilder.hpp"
+
+namespace {
+
+/*
+  Osi1API::addRows and addCols take int starts. Convert only if
+  CoinBigIndex is something else.
+*/
+template <typename IndexType>
+const int *asInt (const std::vector<IndexType> &src, std::vector<int> &scratch)
+{
+  scratch.assign(src.begin(),src.end()) ;
+  return (scratch.data()) ;
+}
+
+template <>
+const int *asInt<int> (const std::vector<int> &src, std::vector<int> &)
+{
+  return (src.data()) ;
+}
+
+/*
+  Copy src to dst, padded to size with fill, with every entry clamped to
+  [-inf,inf].
+*/
+const double *padded (const std::vector<double> &src, int size, double fill,
+		      double inf, std::vector<double> &dst)
+{
+  dst.assign(src.begin(),src.begin()+std::min<size_t>(src.size(),size)) ;
+  dst.resize(size,fill) ;
+  for (double &v : dst) v = std::max(-inf,std::min(v,inf)) ;
+  return (dst.data()) ;
+}
+
+/*
+  Set dst to n entries of src, or n copies of fill if src is null.
+*/
+void copyOrFill (int n, const double *src, double fill,
+		 std::vector<double> &dst)
+{
+  if (src)
+    dst.assign(src,src+n) ;
+  else
+    dst.assign(n,fill) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+ModelBuilder::ModelBuilder (Orientation orient)
+  : orient_(orient),
+    minorDim_(0),
+    haveNames_(false),
+    starts_(1,0),
+    names_(1,'\0')
+{ }
+
+ModelBuilder::~ModelBuilder () { }
+
+void ModelBuilder::reserve (int numVectors, CoinBigIndex numElements)
+{
+  starts_.reserve(numVectors+1) ;
+  indices_.reserve(numElements) ;
+  elements_.reserve(numElements) ;
+  lower_.reserve(numVectors) ;
+  upper_.reserve(numVectors) ;
+  if (orient_ == colWise) obj_.reserve(numVectors) ;
+  nameStarts_.reserve(numVectors) ;
+}
+
+int ModelBuilder::addVector (int len, const int *indices,
+			     const double *elements, double lb, double ub,
+			     double obj, const char *name)
+{
+  indices_.insert(indices_.end(),indices,indices+len) ;
+  elements_.insert(elements_.end(),elements,elements+len) ;
+  starts_.push_back(starts_.back()+len) ;
+  for (int k = 0 ; k < len ; k++)
+    if (indices[k] >= minorDim_) minorDim_ = indices[k]+1 ;
+  lower_.push_back(lb) ;
+  upper_.push_back(ub) ;
+  if (orient_ == colWise) obj_.push_back(obj) ;
+  if (name && name[0] != '\0') {
+    nameStarts_.push_back(names_.size()) ;
+    names_.insert(names_.end(),name,name+strlen(name)+1) ;
+    haveNames_ = true ;
+  } else {
+    nameStarts_.push_back(0) ;
+  }
+  return (getNumVectors()-1) ;
+}
+
+int ModelBuilder::addRow (int len, const int *cols, const double *elements,
+			  double lb, double ub, const char *name)
+{
+  if (orient_ != rowWise) {
+    std::cout
+      << "ModelBuilder::addRow: builder collects columns." << std::endl ;
+    return (-1) ;
+  }
+  return (addVector(len,cols,elements,lb,ub,0.0,name)) ;
+}
+
+int ModelBuilder::addCol (int len, const int *rows, const double *elements,
+			  double lb, double ub, double obj, const char *name)
+{
+  if (orient_ != colWise) {
+    std::cout
+      << "ModelBuilder::addCol: builder collects rows." << std::endl ;
+    return (-1) ;
+  }
+  return (addVector(len,rows,elements,lb,ub,obj,name)) ;
+}
+
+/*
+  Starts and name offsets from other are shifted by the size of what's
+  already here. An unnamed vector has offset 0, and must keep it: addTo and
+  loadInto take offset 0 to mean no name.
+*/
+int ModelBuilder::append (const ModelBuilder &other)
+{
+  if (orient_ != other.orient_) {
+    std::cout
+      << "ModelBuilder::append: builders have different orientations."
+      << std::endl ;
+    return (-1) ;
+  }
+  const int num = other.getNumVectors() ;
+  const CoinBigIndex elemBase = getNumElements() ;
+  const size_t nameBase = names_.size() ;
+  for (int k = 1 ; k <= num ; k++)
+    starts_.push_back(elemBase+other.starts_[k]) ;
+  indices_.insert(indices_.end(),other.indices_.begin(),other.indices_.end()) ;
+  elements_.insert(elements_.end(),
+		   other.elements_.begin(),other.elements_.end()) ;
+  lower_.insert(lower_.end(),other.lower_.begin(),other.lower_.end()) ;
+  upper_.insert(upper_.end(),other.upper_.begin(),other.upper_.end()) ;
+  obj_.insert(obj_.end(),other.obj_.begin(),other.obj_.end()) ;
+  if (other.haveNames_) {
+    names_.insert(names_.end(),other.names_.begin(),other.names_.end()) ;
+    for (size_t start : other.nameStarts_)
+      nameStarts_.push_back((start == 0)?0:nameBase+start) ;
+    haveNames_ = true ;
+  } else {
+    nameStarts_.insert(nameStarts_.end(),num,0) ;
+  }
+  minorDim_ = std::max(minorDim_,other.minorDim_) ;
+  return (num) ;
+}
+
+void ModelBuilder::setColumnData (int n, const double *collb,
+				  const double *colub, const double *obj)
+{
+  copyOrFill(n,collb,0.0,otherLower_) ;
+  copyOrFill(n,colub,HUGE_VAL,otherUpper_) ;
+  copyOrFill(n,obj,0.0,otherObj_) ;
+}
+
+void ModelBuilder::setRowData (int m, const double *rowlb,
+			       const double *rowub)
+{
+  copyOrFill(m,rowlb,-HUGE_VAL,otherLower_) ;
+  copyOrFill(m,rowub,HUGE_VAL,otherUpper_) ;
+  otherObj_.clear() ;
+}
+
+void ModelBuilder::clear ()
+{
+  starts_.resize(1) ;
+  indices_.clear() ;
+  elements_.clear() ;
+  lower_.clear() ;
+  upper_.clear() ;
+  obj_.clear() ;
+  names_.resize(1) ;
+  nameStarts_.clear() ;
+  haveNames_ = false ;
+  minorDim_ = 0 ;
+  otherLower_.clear() ;
+  otherUpper_.clear() ;
+  otherObj_.clear() ;
+}
+
+/*
+  The other dimension is the larger of what was declared and what the
+  collected vectors reference. A row-wise builder holds its rows as a
+  column-major matrix with the rows as columns; transposing that with
+  RowMajorView gives the column-major matrix loadProblem wants.
+*/
+void ModelBuilder::prepareLoad (double inf, LoadArrays &args)
+{
+  const int num = getNumVectors() ;
+  const int other =
+    std::max(minorDim_,static_cast<int>(otherLower_.size())) ;
+  if (orient_ == colWise) {
+    args.numCols_ = num ;
+    args.numRows_ = other ;
+    args.starts_ = starts_.data() ;
+    args.indices_ = indices_.data() ;
+    args.elements_ = elements_.data() ;
+    args.collb_ = lower_.data() ;
+    args.colub_ = upper_.data() ;
+    args.obj_ = obj_.data() ;
+    args.rowlb_ = padded(otherLower_,other,-inf,inf,loadLower_) ;
+    args.rowub_ = padded(otherUpper_,other,inf,inf,loadUpper_) ;
+  } else {
+    transposed_.build(other,num,starts_.data(),nullptr,
+		      indices_.data(),elements_.data()) ;
+    args.numCols_ = other ;
+    args.numRows_ = num ;
+    args.starts_ = transposed_.getStarts() ;
+    args.indices_ = transposed_.getIndices() ;
+    args.elements_ = transposed_.getElements() ;
+    args.collb_ = padded(otherLower_,other,0.0,inf,loadLower_) ;
+    args.colub_ = padded(otherUpper_,other,inf,inf,loadUpper_) ;
+    args.obj_ = padded(otherObj_,other,0.0,inf,loadObj_) ;
+    args.rowlb_ = lower_.data() ;
+    args.rowub_ = upper_.data() ;
+  }
+}
+
+/*
+  ClpSimplexAPI has no call to set a run of names (copyNames wants names
+  for every row and column), so names go in one at a time.
+*/
+int ModelBuilder::addTo (ClpSimplexAPI &clp)
+{
+  const int num = getNumVectors() ;
+  if (num == 0) return (0) ;
+  int first ;
+  if (orient_ == rowWise) {
+    first = clp.numberRows() ;
+    clp.addRows(num,lower_.data(),upper_.data(),
+		starts_.data(),indices_.data(),elements_.data()) ;
+  } else {
+    first = clp.numberColumns() ;
+    clp.addColumns(num,lower_.data(),upper_.data(),obj_.data(),
+		   starts_.data(),indices_.data(),elements_.data()) ;
+  }
+  if (haveNames_) {
+    for (int k = 0 ; k < num ; k++) {
+      if (nameStarts_[k] == 0) continue ;
+      if (orient_ == rowWise)
+	clp.setRowName(first+k,name(k)) ;
+      else
+	clp.setColumnName(first+k,name(k)) ;
+    }
+  }
+  clear() ;
+  return (num) ;
+}
+
+int ModelBuilder::addTo (Osi1API &si)
+{
+  const int num = getNumVectors() ;
+  if (num == 0) return (0) ;
+  std::vector<int> intStarts ;
+  const int *starts = asInt(starts_,intStarts) ;
+  int first ;
+  if (orient_ == rowWise) {
+    first = si.getNumRows() ;
+    si.addRows(num,starts,indices_.data(),elements_.data(),
+	       lower_.data(),upper_.data()) ;
+  } else {
+    first = si.getNumCols() ;
+    si.addCols(num,starts,indices_.data(),elements_.data(),
+	       lower_.data(),upper_.data(),obj_.data()) ;
+  }
+  if (haveNames_) {
+    Osi1API::OsiNameVec names(num) ;
+    for (int k = 0 ; k < num ; k++) names[k] = name(k) ;
+    if (orient_ == rowWise)
+      si.setRowNames(names,0,num,first) ;
+    else
+      si.setColNames(names,0,num,first) ;
+  }
+  clear() ;
+  return (num) ;
+}
+
+int ModelBuilder::loadInto (ClpSimplexAPI &clp)
+{
+  const int num = getNumVectors() ;
+  LoadArrays args ;
+  prepareLoad(std::numeric_limits<double>::max(),args) ;
+  clp.loadProblem(args.numCols_,args.numRows_,args.starts_,args.indices_,
+		  args.elements_,args.collb_,args.colub_,args.obj_,
+		  args.rowlb_,args.rowub_) ;
+  if (haveNames_) {
+    for (int k = 0 ; k < num ; k++) {
+      if (nameStarts_[k] == 0) continue ;
+      if (orient_ == rowWise)
+	clp.setRowName(k,name(k)) ;
+      else
+	clp.setColumnName(k,name(k)) ;
+    }
+  }
+  clear() ;
+  return (num) ;
+}
+
+int ModelBuilder::loadInto (Osi1API &si)
+{
+  const int num = getNumVectors() ;
+  LoadArrays args ;
+  prepareLoad(si.getInfinity(),args) ;
+  si.loadProblem(args.numCols_,args.numRows_,args.starts_,args.indices_,
+		 args.elements_,args.collb_,args.colub_,args.obj_,
+		 args.rowlb_,args.rowub_) ;
+  if (haveNames_) {
+    Osi1API::OsiNameVec names(num) ;
+    for (int k = 0 ; k < num ; k++) names[k] = name(k) ;
+    if (orient_ == rowWise)
+      si.setRowNames(names,0,num,0) ;
+    else
+      si.setColNames(names,0,num,0) ;
+  }
+  clear() ;
+  return (num) ;
+}
+
+}  // end namespace Osi2
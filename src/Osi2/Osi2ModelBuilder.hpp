@@ -0,0 +1,212 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelBuilder.hpp
+    \brief Accumulate rows or columns and pass them to a solver in bulk.
+*/
+#ifndef Osi2ModelBuilder_HPP
+#define Osi2ModelBuilder_HPP
+
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2RowMajorView.hpp"
+
+namespace Osi2 {
+
+class Osi1API ;
+class ClpSimplexAPI ;
+
+/*! \brief Incremental model builder
+
+  Adding rows or columns to a solver one at a time makes the solver resize
+  its storage each time. A ModelBuilder collects them instead, in packed
+  form in a few growable arrays (the arena: starts, indices, coefficients,
+  bounds, objective, and names packed into one character buffer), and hands
+  the lot to the solver in a single call when flushed.
+
+  A builder is either row-wise (it collects rows; #addRow) or column-wise
+  (it collects columns; #addCol). There are two ways to flush:
+    - #addTo appends the collected vectors to a solver's existing model
+      with one addRows or addColumns/addCols call;
+    - #loadInto replaces the solver's model with one loadProblem call. The
+      other dimension is described by #setColumnData (row-wise builder) or
+      #setRowData (column-wise builder); missing bounds default to [0,inf)
+      for columns and (-inf,inf) for rows.
+  Either way the builder is cleared afterward, keeping its capacity.
+
+  A builder is not thread-safe, but builders are cheap. To build in
+  parallel, give each thread its own builder and #append them, in a fixed
+  order, into one before flushing.
+*/
+class ModelBuilder {
+
+public:
+
+  /// What the builder collects
+  enum Orientation {
+    rowWise = 0,
+    colWise
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  ModelBuilder (Orientation orient = rowWise) ;
+  /// Destructor
+  ~ModelBuilder () ;
+  //@}
+
+  /*! \name Building */
+  //@{
+  /// Reserve space for \p numVectors vectors holding \p numElements coefficients
+  void reserve (int numVectors, CoinBigIndex numElements) ;
+
+  /*! \brief Add a row (row-wise builder only)
+
+    Returns the index of the row within the builder, or -1 if the builder
+    is column-wise. \p name may be null.
+  */
+  int addRow (int len, const int *cols, const double *elements,
+	      double lb, double ub, const char *name = nullptr) ;
+
+  /*! \brief Add a column (column-wise builder only)
+
+    Returns the index of the column within the builder, or -1 if the
+    builder is row-wise. \p name may be null.
+  */
+  int addCol (int len, const int *rows, const double *elements,
+	      double lb, double ub, double obj, const char *name = nullptr) ;
+
+  /*! \brief Append the contents of \p other
+
+    Both builders must have the same orientation; returns -1 otherwise,
+    else the number of vectors appended. \p other is not changed.
+  */
+  int append (const ModelBuilder &other) ;
+
+  /*! \brief Bounds and objective for the columns of a row-wise model
+
+    Used by #loadInto. Any of the arrays may be null, in which case the
+    default is used.
+  */
+  void setColumnData (int n, const double *collb, const double *colub,
+		      const double *obj) ;
+  /*! \brief Bounds for the rows of a column-wise model
+
+    Used by #loadInto. Either array may be null, in which case the default
+    is used.
+  */
+  void setRowData (int m, const double *rowlb, const double *rowub) ;
+
+  /// Discard the contents, keeping capacity
+  void clear () ;
+  //@}
+
+  /*! \name Flushing to a solver
+
+    Each returns the number of vectors passed to the solver.
+  */
+  //@{
+  /// Append the vectors to the model held by \p clp
+  int addTo (ClpSimplexAPI &clp) ;
+  /// Append the vectors to the model held by \p si
+  int addTo (Osi1API &si) ;
+  /// Replace the model held by \p clp
+  int loadInto (ClpSimplexAPI &clp) ;
+  /// Replace the model held by \p si
+  int loadInto (Osi1API &si) ;
+  //@}
+
+  /*! \name Information */
+  //@{
+  /// Orientation
+  inline Orientation getOrientation () const { return (orient_) ; }
+  /// Number of vectors collected
+  inline int getNumVectors () const
+  { return (static_cast<int>(starts_.size())-1) ; }
+  /// Number of coefficients collected
+  inline CoinBigIndex getNumElements () const { return (starts_.back()) ; }
+  /// Largest minor index seen, plus one
+  inline int getMinorDim () const { return (minorDim_) ; }
+  //@}
+
+private:
+
+  /// Common part of addRow and addCol
+  int addVector (int len, const int *indices, const double *elements,
+		 double lb, double ub, double obj, const char *name) ;
+
+  /// Arguments for loadProblem
+  struct LoadArrays {
+    int numCols_ ;
+    int numRows_ ;
+    const CoinBigIndex *starts_ ;
+    const int *indices_ ;
+    const double *elements_ ;
+    const double *collb_ ;
+    const double *colub_ ;
+    const double *obj_ ;
+    const double *rowlb_ ;
+    const double *rowub_ ;
+  } ;
+
+  /*! \brief Assemble the arguments for loadProblem
+
+    Pads the other dimension with defaults (\p inf is the solver's
+    infinity) and, for a row-wise builder, transposes the rows.
+  */
+  void prepareLoad (double inf, LoadArrays &args) ;
+
+  /// Name of vector \p k (empty if none)
+  inline const char *name (int k) const
+  { return (&names_[nameStarts_[k]]) ; }
+
+  /// Orientation
+  Orientation orient_ ;
+  /// Largest minor index plus one
+  int minorDim_ ;
+  /// True if any vector was given a name
+  bool haveNames_ ;
+
+  /*! \name Arena */
+  //@{
+  std::vector<CoinBigIndex> starts_ ;
+  std::vector<int> indices_ ;
+  std::vector<double> elements_ ;
+  std::vector<double> lower_ ;
+  std::vector<double> upper_ ;
+  /// Objective coefficients (column-wise builder)
+  std::vector<double> obj_ ;
+  /// Names, each null-terminated
+  std::vector<char> names_ ;
+  std::vector<size_t> nameStarts_ ;
+  //@}
+
+  /*! \name The other dimension, for loadInto
+
+    Bounds beyond the solver's infinity (in particular the defaults, held
+    as +/-HUGE_VAL) are clamped to it when the model is loaded.
+  */
+  //@{
+  std::vector<double> otherLower_ ;
+  std::vector<double> otherUpper_ ;
+  std::vector<double> otherObj_ ;
+  //@}
+
+  /*! \name Scratch for loadInto */
+  //@{
+  RowMajorView transposed_ ;
+  std::vector<double> loadLower_ ;
+  std::vector<double> loadUpper_ ;
+  std::vector<double> loadObj_ ;
+  //@}
+} ;
+
+}  // end namespace Osi2
+
+#endif
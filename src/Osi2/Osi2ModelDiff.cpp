@@ -0,0 +1,405 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::ModelDiff.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RowMajorView.hpp"
+
+#include "Osi2ModelDiff.hpp"
+
+namespace {
+
+/*
+  Clp takes any bound beyond 1.0e27 in magnitude as infinite and stores it
+  as COIN_DBL_MAX, so two such bounds of the same sign are the same bound.
+*/
+bool sameValue (double a, double b)
+{
+  if (a == b) return (true) ;
+  const double big = 1.0e27 ;
+  return ((a >= big && b >= big) || (a <= -big && b <= -big)) ;
+}
+
+/// Entry k of \p vec, or \p dflt if \p vec is null
+inline double valueOr (const double *vec, int k, double dflt)
+{
+  return ((vec)?vec[k]:dflt) ;
+}
+
+/// Names of the loaded rows or columns
+void loadedNames (const Osi2::ClpSimplexAPI &clp, bool rows, int num,
+		  std::vector<std::string> &names)
+{
+  std::vector<char> buf(clp.lengthNames()+1) ;
+  names.resize(num) ;
+  for (int k = 0 ; k < num ; k++) {
+    if (rows)
+      clp.rowName(k,buf.data()) ;
+    else
+      clp.columnName(k,buf.data()) ;
+    names[k] = buf.data() ;
+  }
+}
+
+/// Status for an added column: nonbasic at a finite bound if it has one
+Osi2::ClpSimplexAPI::Status addedColStatus (double lb, double ub)
+{
+  if (!sameValue(lb,-HUGE_VAL)) return (Osi2::ClpSimplexAPI::atLowerBound) ;
+  if (!sameValue(ub,HUGE_VAL)) return (Osi2::ClpSimplexAPI::atUpperBound) ;
+  return (Osi2::ClpSimplexAPI::isFree) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+ModelDiff::ModelDiff ()
+  : addedCols_(ModelBuilder::colWise),
+    addedRows_(ModelBuilder::rowWise)
+{
+  clear() ;
+}
+
+ModelDiff::~ModelDiff () { }
+
+void ModelDiff::clear ()
+{
+  compared_ = false ;
+  oldRows_ = 0 ;
+  oldCols_ = 0 ;
+  rowOld_.clear() ;
+  colOld_.clear() ;
+  rowPos_.clear() ;
+  colPos_.clear() ;
+  delRows_.clear() ;
+  delCols_.clear() ;
+  numRowsAdded_ = 0 ;
+  numColsAdded_ = 0 ;
+  coeffChgs_.clear() ;
+  addedCols_.clear() ;
+  addedRows_.clear() ;
+  rowLower_.clear() ;
+  rowUpper_.clear() ;
+  colLower_.clear() ;
+  colUpper_.clear() ;
+  obj_.clear() ;
+  numRowLbChg_ = 0 ;
+  numRowUbChg_ = 0 ;
+  numColLbChg_ = 0 ;
+  numColUbChg_ = 0 ;
+  numObjChg_ = 0 ;
+}
+
+int ModelDiff::getNumChanges () const
+{
+  return (getNumRowsAdded()+getNumRowsDeleted()+getNumColsAdded()+
+	  getNumColsDeleted()+getNumBoundChanges()+getNumObjChanges()+
+	  getNumCoeffChanges()) ;
+}
+
+/*
+  Matched old entries keep their relative order, so the position of a
+  survivor after deletion is the number of survivors before it. Added
+  entries follow the survivors in the order of the new model.
+*/
+int ModelDiff::match (int numOld, const std::vector<std::string> &oldNames,
+		      int numNew, const char *const *newNames,
+		      const char *what, std::vector<int> &newToOld,
+		      std::vector<int> &oldToKept, std::vector<int> &del,
+		      std::vector<int> &pos)
+{
+  std::unordered_map<std::string,int> oldNdx ;
+  oldNdx.reserve(numOld) ;
+  for (int k = 0 ; k < numOld ; k++) {
+    if (!oldNdx.insert(std::make_pair(oldNames[k],k)).second) {
+      std::cout
+	<< "ModelDiff::compare: loaded " << what << " name \"" << oldNames[k]
+	<< "\" is not unique." << std::endl ;
+      return (-1) ;
+    }
+  }
+  newToOld.assign(numNew,-1) ;
+  std::vector<int> oldToNew(numOld,-1) ;
+  std::unordered_map<std::string,int> newNdx ;
+  newNdx.reserve(numNew) ;
+  for (int k = 0 ; k < numNew ; k++) {
+    const char *name = (newNames)?newNames[k]:nullptr ;
+    if (name == nullptr || name[0] == '\0') {
+      std::cout
+	<< "ModelDiff::compare: new " << what << " " << k << " has no name."
+	<< std::endl ;
+      return (-1) ;
+    }
+    if (!newNdx.insert(std::make_pair(std::string(name),k)).second) {
+      std::cout
+	<< "ModelDiff::compare: new " << what << " name \"" << name
+	<< "\" is not unique." << std::endl ;
+      return (-1) ;
+    }
+    std::unordered_map<std::string,int>::const_iterator it =
+	oldNdx.find(name) ;
+    if (it != oldNdx.end()) {
+      newToOld[k] = it->second ;
+      oldToNew[it->second] = k ;
+    }
+  }
+  oldToKept.assign(numOld,-1) ;
+  del.clear() ;
+  int numKept = 0 ;
+  for (int k = 0 ; k < numOld ; k++) {
+    if (oldToNew[k] < 0)
+      del.push_back(k) ;
+    else
+      oldToKept[k] = numKept++ ;
+  }
+  pos.resize(numNew) ;
+  int numAdded = 0 ;
+  for (int k = 0 ; k < numNew ; k++) {
+    if (newToOld[k] >= 0)
+      pos[k] = oldToKept[newToOld[k]] ;
+    else
+      pos[k] = numKept+numAdded++ ;
+  }
+  return (numAdded) ;
+}
+
+int ModelDiff::compare (ClpSimplexAPI &clp, const Model &model)
+{
+  clear() ;
+  if (clp.lengthNames() == 0) {
+    std::cout
+      << "ModelDiff::compare: the loaded model has no names." << std::endl ;
+    return (-1) ;
+  }
+  const double inf = std::numeric_limits<double>::max() ;
+  const int m0 = clp.numberRows() ;
+  const int n0 = clp.numberColumns() ;
+  const int m = model.numRows_ ;
+  const int n = model.numCols_ ;
+/*
+  Match rows and columns by name.
+*/
+  std::vector<std::string> names ;
+  std::vector<int> rowKept, colKept ;
+  loadedNames(clp,true,m0,names) ;
+  numRowsAdded_ = match(m0,names,m,model.rowNames_,"row",
+			rowOld_,rowKept,delRows_,rowPos_) ;
+  if (numRowsAdded_ < 0) {
+    clear() ;
+    return (-1) ;
+  }
+  loadedNames(clp,false,n0,names) ;
+  numColsAdded_ = match(n0,names,n,model.colNames_,"column",
+			colOld_,colKept,delCols_,colPos_) ;
+  if (numColsAdded_ < 0) {
+    clear() ;
+    return (-1) ;
+  }
+/*
+  Bounds and objective of the updated model, counting differences for the
+  matched entries.
+*/
+  const double *oldRowLb = clp.rowLower() ;
+  const double *oldRowUb = clp.rowUpper() ;
+  rowLower_.resize(m) ;
+  rowUpper_.resize(m) ;
+  for (int i = 0 ; i < m ; i++) {
+    const double lb = valueOr(model.rowLower_,i,-inf) ;
+    const double ub = valueOr(model.rowUpper_,i,inf) ;
+    rowLower_[rowPos_[i]] = lb ;
+    rowUpper_[rowPos_[i]] = ub ;
+    const int old = rowOld_[i] ;
+    if (old < 0) continue ;
+    if (!sameValue(lb,oldRowLb[old])) numRowLbChg_++ ;
+    if (!sameValue(ub,oldRowUb[old])) numRowUbChg_++ ;
+  }
+  const double *oldColLb = clp.columnLower() ;
+  const double *oldColUb = clp.columnUpper() ;
+  const double *oldObj = clp.objective() ;
+  colLower_.resize(n) ;
+  colUpper_.resize(n) ;
+  obj_.resize(n) ;
+  for (int j = 0 ; j < n ; j++) {
+    const double lb = valueOr(model.colLower_,j,0.0) ;
+    const double ub = valueOr(model.colUpper_,j,inf) ;
+    const double c = valueOr(model.obj_,j,0.0) ;
+    colLower_[colPos_[j]] = lb ;
+    colUpper_[colPos_[j]] = ub ;
+    obj_[colPos_[j]] = c ;
+    const int old = colOld_[j] ;
+    if (old < 0) continue ;
+    if (!sameValue(lb,oldColLb[old])) numColLbChg_++ ;
+    if (!sameValue(ub,oldColUb[old])) numColUbChg_++ ;
+    if (c != oldObj[old]) numObjChg_++ ;
+  }
+/*
+  Coefficients. A matched column is compared against its loaded self over
+  the matched rows, using a dense scratch copy of the loaded column marked
+  with the column's stamp. Coefficients in added rows go with those rows;
+  an added column carries only its coefficients in matched rows. Explicit
+  zeros in the new model are treated as absent.
+*/
+  const CoinBigIndex *oldStarts = clp.getVectorStarts() ;
+  const int *oldLens = clp.getVectorLengths() ;
+  const int *oldNdxs = clp.getIndices() ;
+  const double *oldElems = clp.getElements() ;
+  std::vector<double> dense(m0,0.0) ;
+  std::vector<int> inOld(m0,-1) ;
+  std::vector<int> seen(m0,-1) ;
+  for (int j = 0 ; j < n ; j++) {
+    const int oldj = colOld_[j] ;
+    if (oldj < 0) continue ;
+    const CoinBigIndex start = oldStarts[oldj] ;
+    const CoinBigIndex end = start+oldLens[oldj] ;
+    for (CoinBigIndex k = start ; k < end ; k++) {
+      const int old = oldNdxs[k] ;
+      if (rowKept[old] < 0) continue ;
+      inOld[old] = j ;
+      dense[old] = oldElems[k] ;
+    }
+    for (CoinBigIndex k = model.starts_[j] ; k < model.starts_[j+1] ; k++) {
+      const double val = model.elements_[k] ;
+      const int old = rowOld_[model.indices_[k]] ;
+      if (old < 0 || val == 0.0) continue ;
+      seen[old] = j ;
+      if (inOld[old] != j || dense[old] != val) {
+	CoeffChange chg = { rowKept[old], colKept[oldj], val } ;
+	coeffChgs_.push_back(chg) ;
+      }
+    }
+    for (CoinBigIndex k = start ; k < end ; k++) {
+      const int old = oldNdxs[k] ;
+      if (rowKept[old] < 0 || seen[old] == j) continue ;
+      CoeffChange chg = { rowKept[old], colKept[oldj], 0.0 } ;
+      coeffChgs_.push_back(chg) ;
+    }
+  }
+/*
+  Added columns and rows go into builders, in the order they were found,
+  so that they land at the positions recorded by match. Added rows need
+  the new model row by row.
+*/
+  std::vector<int> addRows ;
+  std::vector<double> addElems ;
+  for (int j = 0 ; j < n ; j++) {
+    if (colOld_[j] >= 0) continue ;
+    addRows.clear() ;
+    addElems.clear() ;
+    for (CoinBigIndex k = model.starts_[j] ; k < model.starts_[j+1] ; k++) {
+      const int old = rowOld_[model.indices_[k]] ;
+      if (old < 0 || model.elements_[k] == 0.0) continue ;
+      addRows.push_back(rowKept[old]) ;
+      addElems.push_back(model.elements_[k]) ;
+    }
+    const int pos = colPos_[j] ;
+    addedCols_.addCol(static_cast<int>(addRows.size()),addRows.data(),
+		      addElems.data(),colLower_[pos],colUpper_[pos],obj_[pos],
+		      model.colNames_[j]) ;
+  }
+  if (numRowsAdded_ > 0) {
+    RowMajorView byRow ;
+    byRow.build(m,n,model.starts_,nullptr,model.indices_,model.elements_) ;
+    std::vector<int> cols ;
+    std::vector<double> elems ;
+    for (int i = 0 ; i < m ; i++) {
+      if (rowOld_[i] >= 0) continue ;
+      cols.clear() ;
+      elems.clear() ;
+      for (CoinBigIndex k = byRow.getStarts()[i] ;
+	   k < byRow.getStarts()[i+1] ; k++) {
+	if (byRow.getElements()[k] == 0.0) continue ;
+	cols.push_back(colPos_[byRow.getIndices()[k]]) ;
+	elems.push_back(byRow.getElements()[k]) ;
+      }
+      const int pos = rowPos_[i] ;
+      addedRows_.addRow(static_cast<int>(cols.size()),cols.data(),
+			elems.data(),rowLower_[pos],rowUpper_[pos],
+			model.rowNames_[i]) ;
+    }
+  }
+  oldRows_ = m0 ;
+  oldCols_ = n0 ;
+  compared_ = true ;
+  return (getNumChanges()) ;
+}
+
+/*
+  The basis is captured before anything changes, since Clp's status array
+  moves as rows and columns come and go, and put back at the end. Clp keeps
+  column status first, then row status.
+*/
+int ModelDiff::apply (ClpSimplexAPI &clp)
+{
+  if (!compared_) {
+    std::cout << "ModelDiff::apply: no changes to apply." << std::endl ;
+    return (-1) ;
+  }
+  if (clp.numberRows() != oldRows_ || clp.numberColumns() != oldCols_) {
+    std::cout
+      << "ModelDiff::apply: the model has changed since it was compared."
+      << std::endl ;
+    clear() ;
+    return (-1) ;
+  }
+  const int m = static_cast<int>(rowPos_.size()) ;
+  const int n = static_cast<int>(colPos_.size()) ;
+  std::vector<unsigned char> status ;
+  if (clp.statusExists()) {
+    const unsigned char *oldStatus = clp.statusArray() ;
+    status.resize(n+m) ;
+    for (int j = 0 ; j < n ; j++) {
+      const int pos = colPos_[j] ;
+      if (colOld_[j] >= 0)
+	status[pos] = oldStatus[colOld_[j]] ;
+      else
+	status[pos] = addedColStatus(colLower_[pos],colUpper_[pos]) ;
+    }
+    for (int i = 0 ; i < m ; i++) {
+      const int pos = n+rowPos_[i] ;
+      if (rowOld_[i] >= 0)
+	status[pos] = oldStatus[oldCols_+rowOld_[i]] ;
+      else
+	status[pos] = ClpSimplexAPI::basic ;
+    }
+  }
+  if (!delRows_.empty())
+    clp.deleteRows(static_cast<int>(delRows_.size()),delRows_.data()) ;
+  if (!delCols_.empty())
+    clp.deleteColumns(static_cast<int>(delCols_.size()),delCols_.data()) ;
+  for (const CoeffChange &chg : coeffChgs_)
+    clp.modifyCoefficient(chg.row_,chg.col_,chg.value_) ;
+  addedCols_.addTo(clp) ;
+  addedRows_.addTo(clp) ;
+  if (numRowLbChg_ > 0) clp.chgRowLower(rowLower_.data()) ;
+  if (numRowUbChg_ > 0) clp.chgRowUpper(rowUpper_.data()) ;
+  if (numColLbChg_ > 0) clp.chgColumnLower(colLower_.data()) ;
+  if (numColUbChg_ > 0) clp.chgColumnUpper(colUpper_.data()) ;
+  if (numObjChg_ > 0) clp.chgObjCoefficients(obj_.data()) ;
+  if (!status.empty()) clp.copyinStatus(status.data()) ;
+  compared_ = false ;
+  return (0) ;
+}
+
+int ModelDiff::update (ClpSimplexAPI &clp, const Model &model)
+{
+  const int numChanges = compare(clp,model) ;
+  if (numChanges < 0) return (-1) ;
+  if (apply(clp) != 0) return (-1) ;
+  return (numChanges) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,210 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ModelDiff.hpp
+    \brief Update a loaded model in place to match a new one.
+*/
+#ifndef Osi2ModelDiff_HPP
+#define Osi2ModelDiff_HPP
+
+#include <string>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2ModelBuilder.hpp"
+
+namespace Osi2 {
+
+class ClpSimplexAPI ;
+
+/*! \brief Model diff engine
+
+  Compares a new model against the one loaded in a ClpSimplexAPI object and
+  turns the loaded model into the new one with the fewest changes, instead
+  of reloading it and losing the basis.
+
+  Rows and columns are matched by name: a row of the new model whose name
+  is the name of a loaded row is the same row, whatever its position. Any
+  stable key will do as a name, but every row and every column of both
+  models must have one, and names must be unique within rows and within
+  columns.
+
+  #compare works out the changes:
+    - loaded rows and columns with no match are deleted;
+    - rows and columns of the new model with no match are added;
+    - bounds and objective coefficients of matched rows and columns that
+      differ are changed;
+    - coefficients of matched rows and columns that differ are changed
+      one at a time.
+  #apply makes them: one deleteRows and one deleteColumns call, the
+  coefficient changes, one addColumns and one addRows call (through
+  ModelBuilder), and one call per bound or objective array that changed.
+
+  Matched rows and columns keep their basis status. Added columns are
+  nonbasic at a finite bound (free if they have none) and added rows are
+  basic. If deletions leave the basis with the wrong number of basic
+  variables, Clp repairs it when it next factorises.
+
+  The solver keeps the loaded order: after #apply the matched rows and
+  columns are first, in their old order, followed by the added ones in the
+  order of the new model. #getRowIndex and #getColIndex give the position
+  of each row and column of the new model.
+
+  Integer information and the objective sense are not compared.
+*/
+class ModelDiff {
+
+public:
+
+  /*! \brief A model, in the form loadProblem takes, with names
+
+    The matrix is column-major and packed: column j's coefficients are
+    entries starts_[j] to starts_[j+1]-1. Any of the bound and objective
+    arrays may be null, meaning the loadProblem defaults. The name arrays
+    are required.
+  */
+  struct Model {
+    Model ()
+      : numRows_(0), numCols_(0),
+	starts_(nullptr), indices_(nullptr), elements_(nullptr),
+	colLower_(nullptr), colUpper_(nullptr), obj_(nullptr),
+	rowLower_(nullptr), rowUpper_(nullptr),
+	rowNames_(nullptr), colNames_(nullptr)
+    { }
+    int numRows_ ;
+    int numCols_ ;
+    const CoinBigIndex *starts_ ;
+    const int *indices_ ;
+    const double *elements_ ;
+    const double *colLower_ ;
+    const double *colUpper_ ;
+    const double *obj_ ;
+    const double *rowLower_ ;
+    const double *rowUpper_ ;
+    const char *const *rowNames_ ;
+    const char *const *colNames_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  ModelDiff () ;
+  /// Destructor
+  ~ModelDiff () ;
+  //@}
+
+  /*! \name Diff and update */
+  //@{
+  /*! \brief Work out the changes that turn the model in \p clp into
+	     \p model
+
+    \p clp is not changed. Returns -1 if the models can't be matched
+    (missing or duplicate names), otherwise the number of changes (see
+    #getNumChanges).
+  */
+  int compare (ClpSimplexAPI &clp, const Model &model) ;
+  /*! \brief Make the changes found by the last #compare
+
+    \p clp must be the object given to #compare, unchanged since. Returns
+    -1 on error, 0 otherwise. The changes are used up.
+  */
+  int apply (ClpSimplexAPI &clp) ;
+  /// #compare, then #apply; -1 on error, otherwise the number of changes
+  int update (ClpSimplexAPI &clp, const Model &model) ;
+  /// Forget the last #compare
+  void clear () ;
+  //@}
+
+  /*! \name Changes found by the last #compare */
+  //@{
+  inline int getNumRowsAdded () const { return (numRowsAdded_) ; }
+  inline int getNumRowsDeleted () const
+  { return (static_cast<int>(delRows_.size())) ; }
+  inline int getNumColsAdded () const { return (numColsAdded_) ; }
+  inline int getNumColsDeleted () const
+  { return (static_cast<int>(delCols_.size())) ; }
+  /// Changed row and column bounds (each bound counts)
+  inline int getNumBoundChanges () const
+  { return (numRowLbChg_+numRowUbChg_+numColLbChg_+numColUbChg_) ; }
+  inline int getNumObjChanges () const { return (numObjChg_) ; }
+  inline int getNumCoeffChanges () const
+  { return (static_cast<int>(coeffChgs_.size())) ; }
+  /// Total of all the above
+  int getNumChanges () const ;
+  /// Position in the solver, after #apply, of row \p i of the new model
+  inline int getRowIndex (int i) const { return (rowPos_[i]) ; }
+  /// Position in the solver, after #apply, of column \p j of the new model
+  inline int getColIndex (int j) const { return (colPos_[j]) ; }
+  //@}
+
+private:
+
+  /// A coefficient change, in the indices left after deletion
+  struct CoeffChange {
+    int row_ ;
+    int col_ ;
+    double value_ ;
+  } ;
+
+  /*! \brief Match one dimension by name
+
+    Fills \p newToOld (-1 for unmatched), \p oldToKept (position after
+    deletion, -1 for deleted), \p del (unmatched old indices), and \p pos
+    (position after #apply). Returns the number added, or -1 if a name is
+    missing or duplicated.
+  */
+  int match (int numOld, const std::vector<std::string> &oldNames,
+	     int numNew, const char *const *newNames, const char *what,
+	     std::vector<int> &newToOld, std::vector<int> &oldToKept,
+	     std::vector<int> &del, std::vector<int> &pos) ;
+
+  /// True after a successful #compare
+  bool compared_ ;
+  /// Dimensions of the loaded model at #compare
+  int oldRows_ ;
+  int oldCols_ ;
+
+  /*! \name Matching */
+  //@{
+  /// Row i of the new model is loaded row rowOld_[i] (-1 if added)
+  std::vector<int> rowOld_ ;
+  std::vector<int> colOld_ ;
+  /// Position in the solver after #apply
+  std::vector<int> rowPos_ ;
+  std::vector<int> colPos_ ;
+  /// Loaded rows and columns to delete, ascending
+  std::vector<int> delRows_ ;
+  std::vector<int> delCols_ ;
+  int numRowsAdded_ ;
+  int numColsAdded_ ;
+  //@}
+
+  /*! \name Changes */
+  //@{
+  std::vector<CoeffChange> coeffChgs_ ;
+  /// Added columns, with their coefficients in matched rows
+  ModelBuilder addedCols_ ;
+  /// Added rows, with all their coefficients
+  ModelBuilder addedRows_ ;
+  /// Bounds and objective of the updated model, in solver order
+  std::vector<double> rowLower_ ;
+  std::vector<double> rowUpper_ ;
+  std::vector<double> colLower_ ;
+  std::vector<double> colUpper_ ;
+  std::vector<double> obj_ ;
+  /// Counts of changed entries among matched rows and columns
+  int numRowLbChg_ ;
+  int numRowUbChg_ ;
+  int numColLbChg_ ;
+  int numColUbChg_ ;
+  int numObjChg_ ;
+  //@}
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -26,6 +26,7 @@
 #include "OsiSolverParameters.hpp"
 
 #include "Osi2API.hpp"
+#include "Osi2RayBuffer.hpp"
 
 class CoinPackedMatrix;
 class CoinWarmStart;
@@ -635,6 +636,49 @@ public:
     */
     virtual std::vector<double*> getPrimalRays(int maxNumRays) const = 0;
 
+    /** Get as many dual rays as the solver can provide, into caller storage.
+
+	Same rays as #getDualRays, loaded into \p rays in the format selected
+	there. Nothing needs to be freed, and a buffer that is reused
+	allocates only when it must grow. Returns the number of rays loaded.
+
+	\note
+	The default implementation is written in terms of #getDualRays and
+	copies out of the solver's arrays, skipping null entries (some
+	solvers return one when no ray exists). Solver interfaces that can
+	hand over their internal ray should override it.
+    */
+    virtual int fetchDualRays(RayBuffer &rays, int maxNumRays,
+			      bool fullRay = false) const
+    {
+      std::vector<double*> raw = getDualRays(maxNumRays,fullRay) ;
+      rays.startFill(fullRay?getNumRows()+getNumCols():getNumRows()) ;
+      for (size_t k = 0 ; k < raw.size() ; k++) {
+        if (raw[k] == nullptr) continue ;
+        rays.appendRay(raw[k]) ;
+	delete[] raw[k] ;
+      }
+      return (rays.getNumRays()) ;
+    }
+
+    /** Get as many primal rays as the solver can provide, into caller
+	storage.
+
+	Same rays as #getPrimalRays, loaded into \p rays in the format
+	selected there. See #fetchDualRays.
+    */
+    virtual int fetchPrimalRays(RayBuffer &rays, int maxNumRays) const
+    {
+      std::vector<double*> raw = getPrimalRays(maxNumRays) ;
+      rays.startFill(getNumCols()) ;
+      for (size_t k = 0 ; k < raw.size() ; k++) {
+        if (raw[k] == nullptr) continue ;
+        rays.appendRay(raw[k]) ;
+	delete[] raw[k] ;
+      }
+      return (rays.getNumRays()) ;
+    }
+
     /** Get vector of indices of primal variables which are integer variables 
 	but have fractional values in the current solution. */
     virtual OsiVectorInt getFractionalIndices(const double etol=1.e-05) const = 0 ;
@@ -0,0 +1,84 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2Parallel.hpp
+    \brief Minimal support for data-parallel loops.
+
+  The utilities layered over the Osi2 APIs (cut batches, verifiers, etc.)
+  parallelise simple loops over rows, columns, or cuts. This file holds the
+  one primitive they share. Work is split into contiguous chunks assigned in
+  a fixed order, so results that are combined chunk by chunk come out the
+  same regardless of scheduling.
+*/
+#ifndef Osi2Parallel_HPP
+#define Osi2Parallel_HPP
+
+#include <thread>
+#include <vector>
+
+namespace Osi2 {
+
+/*! \brief Number of threads to use when the client says `as many as useful'
+
+  Returns the hardware concurrency, or 1 if that can't be determined.
+*/
+inline int defaultNumThreads ()
+{
+  unsigned int hw = std::thread::hardware_concurrency() ;
+  return ((hw > 0)?static_cast<int>(hw):1) ;
+}
+
+/*! \brief Number of chunks that will be used to cover \p n items
+
+  Never more than \p numThreads, never more than one chunk per \p minChunk
+  items, never less than one.
+*/
+inline int numChunks (int n, int numThreads, int minChunk = 1)
+{
+  if (minChunk < 1) minChunk = 1 ;
+  int chunks = n/minChunk ;
+  if (chunks > numThreads) chunks = numThreads ;
+  if (chunks < 1) chunks = 1 ;
+  return (chunks) ;
+}
+
+/*! \brief Apply \p body to [0,n) in contiguous chunks
+
+  The range is divided into numChunks(n,numThreads,minChunk) chunks of
+  near-equal size and \p body is called as body(first,last,chunk) for each,
+  where [first,last) is the chunk's range and chunk its ordinal. Chunk 0 runs
+  in the calling thread. With one chunk no threads are created.
+
+  \p body must be safe to run concurrently on disjoint ranges. Anything it
+  writes per chunk should be indexed by \p chunk so that the caller can
+  combine the results in chunk order.
+*/
+template <class Body>
+void parallelFor (int n, int numThreads, Body body, int minChunk = 1)
+{
+  const int chunks = numChunks(n,numThreads,minChunk) ;
+  if (chunks == 1) {
+    body(0,n,0) ;
+    return ;
+  }
+  const int base = n/chunks ;
+  const int extra = n%chunks ;
+  std::vector<int> bounds(chunks+1) ;
+  bounds[0] = 0 ;
+  for (int k = 0 ; k < chunks ; k++)
+    bounds[k+1] = bounds[k]+base+((k < extra)?1:0) ;
+
+  std::vector<std::thread> workers ;
+  workers.reserve(chunks-1) ;
+  for (int k = 1 ; k < chunks ; k++)
+    workers.push_back(std::thread(body,bounds[k],bounds[k+1],k)) ;
+  body(bounds[0],bounds[1],0) ;
+  for (std::thread &worker : workers) worker.join() ;
+}
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,277 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::ParametricSweep.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2ParametricSweep.hpp"
+
+namespace {
+
+/// Row activity within this of a bound is at the bound
+const double boundTol = 1.0e-7 ;
+
+/*
+  Same basis? Only the low three bits of a Clp status entry hold the
+  status; the rest are flags the solver uses internally.
+*/
+bool sameBasis (const std::vector<unsigned char> &a,
+		const std::vector<unsigned char> &b)
+{
+  if (a.size() != b.size()) return (false) ;
+  for (size_t k = 0 ; k < a.size() ; k++)
+    if ((a[k]&7) != (b[k]&7)) return (false) ;
+  return (true) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+ParametricSweep::ParametricSweep ()
+  : target_(objTarget),
+    numRows_(0),
+    numCols_(0),
+    numSolves_(0)
+{ }
+
+ParametricSweep::~ParametricSweep () { }
+
+int ParametricSweep::sweepObjective (ClpSimplexAPI &clp, int numT,
+				     const double *t, const double *objDir)
+{
+  return (sweep(clp,objTarget,numT,t,objDir,nullptr)) ;
+}
+
+int ParametricSweep::sweepRowBounds (ClpSimplexAPI &clp, int numT,
+				     const double *t, const double *lowerDir,
+				     const double *upperDir)
+{
+  return (sweep(clp,rowTarget,numT,t,lowerDir,upperDir)) ;
+}
+
+void ParametricSweep::setData (ClpSimplexAPI &clp, double t)
+{
+  if (target_ == objTarget) {
+    for (int j = 0 ; j < numCols_ ; j++)
+      work1_[j] = baseObj_[j]+t*dir1_[j] ;
+    clp.chgObjCoefficients(work1_.data()) ;
+  } else {
+    for (int i = 0 ; i < numRows_ ; i++) {
+      work1_[i] = baseRowLower_[i]+t*dir1_[i] ;
+      work2_[i] = baseRowUpper_[i]+t*dir2_[i] ;
+    }
+    clp.chgRowLower(work1_.data()) ;
+    clp.chgRowUpper(work2_.data()) ;
+  }
+}
+
+/*
+  The slope of the objective at a fixed basis: d'x for an objective sweep;
+  for a row bound sweep, the dual of each row times the rate at which its
+  active bound moves. Only used for pieces with a single solved point.
+*/
+void ParametricSweep::solveAt (ClpSimplexAPI &clp, int k,
+			       const std::vector<unsigned char> &basis)
+{
+  const int m = numRows_ ;
+  const int n = numCols_ ;
+  setData(clp,t_[k]) ;
+  if (basis.empty()) {
+    clp.initialSolve() ;
+  } else {
+    clp.copyinStatus(basis.data()) ;
+    if (target_ == objTarget)
+      clp.primal() ;
+    else
+      clp.dual() ;
+  }
+  numSolves_++ ;
+  status_[k] = clp.status() ;
+  objValue_[k] = clp.objectiveValue() ;
+  solved_[k] = 1 ;
+  const double *x = clp.getColSolution() ;
+  std::copy(x,x+n,colSolution_.begin()+static_cast<size_t>(k)*n) ;
+  double slope = 0.0 ;
+  if (target_ == objTarget) {
+    for (int j = 0 ; j < n ; j++) slope += dir1_[j]*x[j] ;
+  } else {
+    const double *y = clp.getRowPrice() ;
+    const double *act = clp.getRowActivity() ;
+    for (int i = 0 ; i < m ; i++) {
+      if (std::fabs(act[i]-work1_[i]) <= boundTol)
+	slope += y[i]*dir1_[i] ;
+      else if (std::fabs(act[i]-work2_[i]) <= boundTol)
+	slope += y[i]*dir2_[i] ;
+    }
+  }
+  slope_[k] = slope ;
+  const unsigned char *stat = clp.statusArray() ;
+  trialBasis_.assign(stat,stat+(static_cast<size_t>(n)+m)) ;
+}
+
+void ParametricSweep::interpolate (int a, int b)
+{
+  const int n = numCols_ ;
+  const double span = t_[b]-t_[a] ;
+  const double *xa = &colSolution_[static_cast<size_t>(a)*n] ;
+  const double *xb = &colSolution_[static_cast<size_t>(b)*n] ;
+  for (int k = a+1 ; k < b ; k++) {
+    const double w = (span > 0.0)?(t_[k]-t_[a])/span:0.0 ;
+    objValue_[k] = (1.0-w)*objValue_[a]+w*objValue_[b] ;
+    double *xk = &colSolution_[static_cast<size_t>(k)*n] ;
+    for (int j = 0 ; j < n ; j++) xk[j] = (1.0-w)*xa[j]+w*xb[j] ;
+    status_[k] = status_[a] ;
+    solved_[k] = 0 ;
+    slope_[k] = slope_[a] ;
+    group_[k] = group_[a] ;
+  }
+}
+
+/*
+  Walk forward from the last solved point a. If the solve at b = a+step
+  ends in a's basis, the basis is optimal over [t(a),t(b)]: fill in the
+  points between, move to b, and double the step. Otherwise, if b is next
+  to a there's a breakpoint between them, so start a new basis group at b;
+  if not, halve the step and try again from a.
+*/
+int ParametricSweep::sweep (ClpSimplexAPI &clp, Target target, int numT,
+			    const double *t, const double *dir1,
+			    const double *dir2)
+{
+  for (int k = 1 ; k < numT ; k++) {
+    if (t[k] < t[k-1]) {
+      std::cout
+	<< "ParametricSweep: values of t must be in ascending order."
+	<< std::endl ;
+      return (-1) ;
+    }
+  }
+  const int m = clp.numberRows() ;
+  const int n = clp.numberColumns() ;
+  target_ = target ;
+  numRows_ = m ;
+  numCols_ = n ;
+  numSolves_ = 0 ;
+  baseObj_.assign(clp.objective(),clp.objective()+n) ;
+  baseRowLower_.assign(clp.rowLower(),clp.rowLower()+m) ;
+  baseRowUpper_.assign(clp.rowUpper(),clp.rowUpper()+m) ;
+  if (clp.statusExists())
+    baseStatus_.assign(clp.statusArray(),
+		       clp.statusArray()+(static_cast<size_t>(n)+m)) ;
+  else
+    baseStatus_.clear() ;
+  const int len = (target == objTarget)?n:m ;
+  if (dir1) dir1_.assign(dir1,dir1+len) ; else dir1_.assign(len,0.0) ;
+  if (dir2) dir2_.assign(dir2,dir2+len) ; else dir2_.assign(len,0.0) ;
+  work1_.resize(len) ;
+  work2_.resize(len) ;
+
+  t_.assign(t,t+numT) ;
+  objValue_.assign(numT,0.0) ;
+  status_.assign(numT,-1) ;
+  solved_.assign(numT,0) ;
+  slope_.assign(numT,0.0) ;
+  group_.assign(numT,0) ;
+  colSolution_.resize(static_cast<size_t>(numT)*n) ;
+  pieces_.clear() ;
+  if (numT == 0) return (0) ;
+
+  solveAt(clp,0,baseStatus_) ;
+  basis_.swap(trialBasis_) ;
+  int numGroups = 1 ;
+  int a = 0 ;
+  int step = 1 ;
+  while (a < numT-1) {
+    const int b = std::min(a+step,numT-1) ;
+    solveAt(clp,b,basis_) ;
+    if (status_[a] == 0 && status_[b] == 0 &&
+	sameBasis(trialBasis_,basis_)) {
+      group_[b] = group_[a] ;
+      interpolate(a,b) ;
+      a = b ;
+      step *= 2 ;
+    } else if (b == a+1) {
+      group_[b] = numGroups++ ;
+      basis_.swap(trialBasis_) ;
+      a = b ;
+      step = 1 ;
+    } else {
+      step = std::max(1,(b-a)/2) ;
+    }
+  }
+  buildProfile() ;
+/*
+  Put the object back as it was.
+*/
+  clp.chgObjCoefficients(baseObj_.data()) ;
+  clp.chgRowLower(baseRowLower_.data()) ;
+  clp.chgRowUpper(baseRowUpper_.data()) ;
+  if (!baseStatus_.empty()) clp.copyinStatus(baseStatus_.data()) ;
+  return (0) ;
+}
+
+/*
+  One piece per run of optimal points in the same basis group. A piece
+  spanning two or more values of t takes its line through its end points;
+  a piece with a single point uses the slope computed by solveAt. Where two
+  pieces are adjacent, the breakpoint is where their lines cross, if that
+  falls between them (it should, up to tolerances), else halfway.
+*/
+void ParametricSweep::buildProfile ()
+{
+  const int numT = getNumPoints() ;
+  int k = 0 ;
+  while (k < numT) {
+    if (status_[k] != 0) {
+      k++ ;
+      continue ;
+    }
+    int last = k ;
+    while (last+1 < numT && status_[last+1] == 0 &&
+	   group_[last+1] == group_[k])
+      last++ ;
+    Piece piece ;
+    piece.first_ = k ;
+    piece.last_ = last ;
+    piece.tStart_ = t_[k] ;
+    piece.tEnd_ = t_[last] ;
+    piece.objStart_ = objValue_[k] ;
+    piece.slope_ = (t_[last] > t_[k])?
+      (objValue_[last]-objValue_[k])/(t_[last]-t_[k]):slope_[k] ;
+    if (!pieces_.empty() && pieces_.back().last_+1 == k) {
+      Piece &prev = pieces_.back() ;
+      const double tLo = t_[prev.last_] ;
+      const double tHi = t_[k] ;
+      double tCross = 0.5*(tLo+tHi) ;
+      if (prev.slope_ != piece.slope_) {
+	const double tc =
+	  (piece.objStart_-piece.slope_*piece.tStart_-
+	   prev.objStart_+prev.slope_*prev.tStart_)/
+	  (prev.slope_-piece.slope_) ;
+	if (tc >= tLo && tc <= tHi) tCross = tc ;
+      }
+      prev.tEnd_ = tCross ;
+      piece.objStart_ += piece.slope_*(tCross-piece.tStart_) ;
+      piece.tStart_ = tCross ;
+    }
+    pieces_.push_back(piece) ;
+    k = last+1 ;
+  }
+}
+
+}  // end namespace Osi2
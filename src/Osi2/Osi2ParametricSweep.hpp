@@ -0,0 +1,179 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ParametricSweep.hpp
+    \brief Solve along a line in objective or row bound space.
+*/
+#ifndef Osi2ParametricSweep_HPP
+#define Osi2ParametricSweep_HPP
+
+#include <vector>
+
+namespace Osi2 {
+
+class ClpSimplexAPI ;
+
+/*! \brief Parametric sweep driver
+
+  Solves the model held by a ClpSimplexAPI object for the objective
+  c + t*d (#sweepObjective) or the row bounds rowlb + t*dl, rowub + t*du
+  (#sweepRowBounds), for an ascending list of values of t.
+
+  For a fixed basis, the values of t for which it is optimal form an
+  interval, and over that interval the solution is affine in t (for an
+  objective sweep, x is constant; for a row bound sweep, the duals are).
+  So if the solves at two values of t end in the same optimal basis,
+  every value between them can be filled in by interpolation, without a
+  solve. The sweep walks forward from the last solved point, trying to
+  jump twice as far after each successful jump, and backs off by halves
+  when the basis at the far end differs. Each solve is warm started from
+  the basis of the last solved point: primal simplex for an objective
+  sweep, dual simplex for a row bound sweep.
+
+  The result is the optimal value at every t, the primal solution at every
+  t, and a piecewise-linear objective profile: one piece per basis, each
+  with its own line, with the breakpoints between adjacent pieces placed
+  where those lines cross. A point whose solve doesn't end optimal is
+  never interpolated across, and the profile has a gap there.
+*/
+class ParametricSweep {
+
+public:
+
+  /*! \brief One linear piece of the objective profile
+
+    Over [tStart_,tEnd_], the objective is objStart_ + slope_*(t-tStart_).
+  */
+  struct Piece {
+    /// Start of the piece (breakpoint, or first value of t)
+    double tStart_ ;
+    /// End of the piece (breakpoint, or last value of t)
+    double tEnd_ ;
+    /// Objective at tStart_
+    double objStart_ ;
+    /// Rate of change of the objective
+    double slope_ ;
+    /// Index of the first value of t in the piece
+    int first_ ;
+    /// Index of the last value of t in the piece
+    int last_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  ParametricSweep () ;
+  /// Destructor
+  ~ParametricSweep () ;
+  //@}
+
+  /*! \name Sweeps
+
+    \p t holds \p numT values in ascending order. On return the objective,
+    row bounds, and basis of \p clp are as they were on entry. Each returns
+    -1 if \p t is not ascending, 0 otherwise.
+  */
+  //@{
+  /// Sweep the objective c + t*\p objDir
+  int sweepObjective (ClpSimplexAPI &clp, int numT, const double *t,
+		      const double *objDir) ;
+  /*! \brief Sweep the row bounds rowlb + t*\p lowerDir, rowub + t*\p upperDir
+
+    Either direction may be null, meaning that bound doesn't move.
+  */
+  int sweepRowBounds (ClpSimplexAPI &clp, int numT, const double *t,
+		      const double *lowerDir, const double *upperDir) ;
+  //@}
+
+  /*! \name Results */
+  //@{
+  /// Number of values of t
+  inline int getNumPoints () const { return (static_cast<int>(t_.size())) ; }
+  /// Objective at each t
+  inline const double *getObjValues () const { return (objValue_.data()) ; }
+  /// Status at each t (for interpolated points, that of the solves around it)
+  inline const int *getStatus () const { return (status_.data()) ; }
+  /// 1 if the point was solved, 0 if it was interpolated
+  inline const char *getSolved () const { return (solved_.data()) ; }
+  /// Number of solves
+  inline int getNumSolves () const { return (numSolves_) ; }
+  /// Primal solutions, n per point
+  inline const double *getColSolutions () const
+  { return (colSolution_.data()) ; }
+  /// Number of pieces in the objective profile
+  inline int getNumPieces () const
+  { return (static_cast<int>(pieces_.size())) ; }
+  /// Piece \p k of the objective profile
+  inline const Piece &getPiece (int k) const { return (pieces_[k]) ; }
+  //@}
+
+private:
+
+  /// Which data moves
+  enum Target {
+    objTarget = 0,
+    rowTarget
+  } ;
+
+  /// Common part of the two sweeps
+  int sweep (ClpSimplexAPI &clp, Target target, int numT, const double *t,
+	     const double *dir1, const double *dir2) ;
+
+  /// Install the data for t = \p t in \p clp
+  void setData (ClpSimplexAPI &clp, double t) ;
+
+  /// Solve at point \p k, warm started from \p basis
+  void solveAt (ClpSimplexAPI &clp, int k,
+		const std::vector<unsigned char> &basis) ;
+
+  /// Fill points (a,b) by interpolation between a and b
+  void interpolate (int a, int b) ;
+
+  /// Build the objective profile
+  void buildProfile () ;
+
+  /// Target of the current sweep
+  Target target_ ;
+  /// Dimensions
+  int numRows_ ;
+  int numCols_ ;
+  /// Number of solves
+  int numSolves_ ;
+
+  /*! \name The model's own data, and the directions */
+  //@{
+  std::vector<double> baseObj_ ;
+  std::vector<double> baseRowLower_ ;
+  std::vector<double> baseRowUpper_ ;
+  std::vector<unsigned char> baseStatus_ ;
+  std::vector<double> dir1_ ;
+  std::vector<double> dir2_ ;
+  /// Scratch for the current data
+  std::vector<double> work1_ ;
+  std::vector<double> work2_ ;
+  //@}
+
+  /*! \name Results */
+  //@{
+  std::vector<double> t_ ;
+  std::vector<double> objValue_ ;
+  std::vector<int> status_ ;
+  std::vector<char> solved_ ;
+  std::vector<double> colSolution_ ;
+  /// Objective slope at each solved point
+  std::vector<double> slope_ ;
+  /// Basis group of each point; same group means same basis
+  std::vector<int> group_ ;
+  /// Final basis of the last solved point, and of the trial point
+  std::vector<unsigned char> basis_ ;
+  std::vector<unsigned char> trialBasis_ ;
+  std::vector<Piece> pieces_ ;
+  //@}
+} ;
+
+}  // end namespace Osi2
+
+#endif
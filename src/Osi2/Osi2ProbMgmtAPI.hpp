@@ -26,6 +26,14 @@ public:
   /// Virtual destructor
   virtual ~ProbMgmtAPI() {}
 
+  /*! \brief Clone
+
+    The clone holds its own full copy of the problem; nothing is shared
+    with the original, copy-on-write or otherwise. The caller owns it and
+    destroys it with delete. Implementations that can't clone return null.
+  */
+  virtual ProbMgmtAPI *clone() const { return (nullptr) ; }
+
   /// Read an mps file from the given filename
   virtual
   int readMps(const char *filename, bool keepNames = false,
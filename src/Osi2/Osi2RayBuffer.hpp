@@ -0,0 +1,166 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2RayBuffer.hpp
+    \brief Caller-owned, reusable storage for primal and dual rays.
+
+  Osi2::RayBuffer is the target for the ray extraction methods that write
+  into caller storage (ClpSimplexAPI::fetchUnboundedRay,
+  Osi1API::fetchDualRays, etc.). Rays can be held in dense form or in a
+  sparse index / value form; the latter is the one to use when rays are
+  mostly zero.
+*/
+#ifndef Osi2RayBuffer_HPP
+#define Osi2RayBuffer_HPP
+
+#include <cmath>
+#include <vector>
+
+namespace Osi2 {
+
+/*! \brief Storage for a set of rays
+
+  A RayBuffer holds zero or more rays of a common dimension. The storage is
+  contiguous: dense rays are laid end to end, sparse rays are held in row-major
+  (CSR) form. Storage is never released by a refill, so a buffer that's reused
+  across a sequence of solves allocates only when it needs to grow.
+
+  In sparse format, entries with absolute value no larger than the zero
+  tolerance are dropped.
+*/
+class RayBuffer {
+
+public:
+
+  /// Storage format
+  enum Format { dense = 0, sparse } ;
+
+  /*! \name Constructors, destructor, and copy */
+  //@{
+  /// Constructor
+  RayBuffer (Format format = dense, double zeroTol = 0.0)
+    : format_(format),
+      zeroTol_(zeroTol),
+      dim_(0),
+      numRays_(0),
+      starts_(1,0)
+  { }
+
+  /// Copy constructor
+  RayBuffer (const RayBuffer &rhs) = default ;
+  /// Move constructor
+  RayBuffer (RayBuffer &&rhs) = default ;
+  /// Copy assignment
+  RayBuffer &operator= (const RayBuffer &rhs) = default ;
+  /// Move assignment
+  RayBuffer &operator= (RayBuffer &&rhs) = default ;
+
+  /// Destructor
+  ~RayBuffer () { }
+  //@}
+
+  /*! \name Format control */
+  //@{
+  /// Set the storage format; takes effect at the next fill
+  inline void setFormat (Format format) { format_ = format ; }
+  /// Get the storage format
+  inline Format getFormat () const { return (format_) ; }
+  /// Set the zero tolerance used for sparse storage
+  inline void setZeroTol (double zeroTol) { zeroTol_ = zeroTol ; }
+  /// Get the zero tolerance used for sparse storage
+  inline double getZeroTol () const { return (zeroTol_) ; }
+  //@}
+
+  /*! \name Access to the rays */
+  //@{
+  /// Number of rays held
+  inline int getNumRays () const { return (numRays_) ; }
+  /// Dimension of the rays held
+  inline int getDim () const { return (dim_) ; }
+
+  /// Dense ray \p k; nullptr if the buffer is in sparse format
+  inline const double *getDense (int k) const
+  { return ((format_ == dense)?&dense_[k*static_cast<size_t>(dim_)]:nullptr) ; }
+
+  /*! \brief Sparse ray \p k
+
+    Returns the number of nonzeros and sets \p indices and \p values. Returns
+    -1 if the buffer is in dense format.
+  */
+  inline int getSparse (int k, const int *&indices,
+  			const double *&values) const
+  { if (format_ != sparse) return (-1) ;
+    indices = indices_.data()+starts_[k] ;
+    values = values_.data()+starts_[k] ;
+    return (starts_[k+1]-starts_[k]) ; }
+
+  /// Expand ray \p k into \p ray (length #getDim()) in either format
+  inline void expand (int k, double *ray) const
+  { if (format_ == dense) {
+      const double *src = getDense(k) ;
+      for (int i = 0 ; i < dim_ ; i++) ray[i] = src[i] ;
+    } else {
+      for (int i = 0 ; i < dim_ ; i++) ray[i] = 0.0 ;
+      for (int ndx = starts_[k] ; ndx < starts_[k+1] ; ndx++)
+	ray[indices_[ndx]] = values_[ndx] ;
+    } }
+  //@}
+
+  /*! \name Methods used by an API to fill the buffer
+
+    Call #startFill with the dimension of the rays, then #appendRay once for
+    each ray.
+  */
+  //@{
+  /// Discard the rays held (but not the storage) and set the dimension
+  inline void startFill (int dim)
+  { dim_ = dim ;
+    numRays_ = 0 ;
+    dense_.clear() ;
+    indices_.clear() ;
+    values_.clear() ;
+    starts_.resize(1) ; }
+
+  /// Append a ray of length #getDim(), converting to the storage format
+  inline void appendRay (const double *ray)
+  { if (format_ == dense) {
+      dense_.insert(dense_.end(),ray,ray+dim_) ;
+    } else {
+      for (int i = 0 ; i < dim_ ; i++) {
+	if (std::fabs(ray[i]) > zeroTol_) {
+	  indices_.push_back(i) ;
+	  values_.push_back(ray[i]) ;
+	}
+      }
+      starts_.push_back(static_cast<int>(indices_.size())) ;
+    }
+    numRays_++ ; }
+  //@}
+
+private:
+
+  /// Storage format
+  Format format_ ;
+  /// Zero tolerance for sparse format
+  double zeroTol_ ;
+  /// Dimension of the rays
+  int dim_ ;
+  /// Number of rays
+  int numRays_ ;
+
+  /// Dense storage, rays laid end to end
+  std::vector<double> dense_ ;
+  /// Sparse storage: start of each ray in #indices_ and #values_
+  std::vector<int> starts_ ;
+  /// Sparse storage: indices
+  std::vector<int> indices_ ;
+  /// Sparse storage: values
+  std::vector<double> values_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
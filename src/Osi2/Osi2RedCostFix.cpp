@@ -0,0 +1,182 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::RedCostFixer.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2RedCostFix.hpp"
+
+namespace {
+
+/*
+  Gaps at or beyond this are infinite (no incumbent yet); nothing can be
+  fixed.
+*/
+const double infGap = 1.0e20 ;
+
+/*
+  Implied bounds for every column. The conditionals are selects between
+  values that have already been computed, and the restrict qualifiers say
+  the outputs don't overlap the inputs.
+*/
+void impliedBounds (int n, const double *__restrict x,
+		    const double *__restrict dj,
+		    const double *__restrict lb, const double *__restrict ub,
+		    const char *__restrict colType, double gap, int considerAll,
+		    double primalTol, double dualTol,
+		    double *__restrict newLb, double *__restrict newUb)
+{
+  for (int j = 0 ; j < n ; j++) {
+    const double d = dj[j] ;
+    const double l = lb[j] ;
+    const double u = ub[j] ;
+    const int consider = considerAll|(colType[j] != 0) ;
+    const int atLb = (x[j]-l <= primalTol)&(d > dualTol)&consider ;
+    const int atUb = (u-x[j] <= primalTol)&(d < -dualTol)&consider ;
+    const double absD = std::fabs(d) ;
+    const double range = gap/((absD > dualTol)?absD:dualTol) ;
+    const double impliedUb = l+range ;
+    const double impliedLb = u-range ;
+    const double tightUb = (impliedUb < u)?impliedUb:u ;
+    const double tightLb = (impliedLb > l)?impliedLb:l ;
+    newUb[j] = (atLb)?tightUb:u ;
+    newLb[j] = (atUb)?tightLb:l ;
+  }
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+RedCostFixer::RedCostFixer ()
+  : primalTol_(1.0e-7),
+    dualTol_(1.0e-7),
+    intTol_(1.0e-6),
+    numFixed_(0)
+{ }
+
+RedCostFixer::~RedCostFixer () { }
+
+/*
+  Compute implied bounds for all columns, then collect the ones that
+  changed. Rounding for integer columns is done while collecting. An
+  integer column's bounds may be fractional, so a rounded bound is kept
+  between the rounded-in original bounds: flooring an implied upper bound
+  of 0.5 on a column with lb 0.3 gives 0, below the lower bound, when the
+  right answer is 1.
+*/
+int RedCostFixer::compute (int n, const double *x, const double *dj,
+			   const double *lb, const double *ub,
+			   const char *colType, double gap, bool justInteger)
+{
+  changed_.clear() ;
+  numFixed_ = 0 ;
+  if (gap < 0 || gap >= infGap || n <= 0) return (0) ;
+  if (colType == nullptr && justInteger) return (0) ;
+  std::vector<char> noType ;
+  if (colType == nullptr) {
+    noType.assign(n,0) ;
+    colType = noType.data() ;
+  }
+  newLb_.resize(n) ;
+  newUb_.resize(n) ;
+  double *newLb = newLb_.data() ;
+  double *newUb = newUb_.data() ;
+  const double primalTol = primalTol_ ;
+  const double intTol = intTol_ ;
+
+  impliedBounds(n,x,dj,lb,ub,colType,gap,(justInteger)?0:1,
+		primalTol_,dualTol_,newLb,newUb) ;
+
+  for (int j = 0 ; j < n ; j++) {
+    if (colType[j]) {
+      if (newUb[j] < ub[j]) {
+	newUb[j] = std::max(std::floor(newUb[j]+intTol),
+			    std::ceil(lb[j]-intTol)) ;
+	newUb[j] = std::min(newUb[j],ub[j]) ;
+      }
+      if (newLb[j] > lb[j]) {
+	newLb[j] = std::min(std::ceil(newLb[j]-intTol),
+			    std::floor(ub[j]+intTol)) ;
+	newLb[j] = std::max(newLb[j],lb[j]) ;
+      }
+    }
+    if (newUb[j] < ub[j]-primalTol || newLb[j] > lb[j]+primalTol) {
+      changed_.push_back(j) ;
+      if (newUb[j]-newLb[j] <= primalTol) numFixed_++ ;
+    }
+  }
+  return (static_cast<int>(changed_.size())) ;
+}
+
+int RedCostFixer::compute (const Osi1API &si, double gap, bool justInteger)
+{
+  const int n = si.getNumCols() ;
+  const double sense = si.getObjSense() ;
+  const double *dj = si.getReducedCost() ;
+  djScratch_.resize(n) ;
+  for (int j = 0 ; j < n ; j++) djScratch_[j] = sense*dj[j] ;
+  return (compute(n,si.getColSolution(),djScratch_.data(),
+		  si.getColLower(),si.getColUpper(),si.getColType(),
+		  gap,justInteger)) ;
+}
+
+int RedCostFixer::compute (ClpSimplexAPI &clp, double gap, bool justInteger)
+{
+  const int n = clp.numberColumns() ;
+  const double sense = clp.objSense() ;
+  const double *dj = clp.getReducedCost() ;
+  djScratch_.resize(n) ;
+  for (int j = 0 ; j < n ; j++) djScratch_[j] = sense*dj[j] ;
+  return (compute(n,clp.getColSolution(),djScratch_.data(),
+		  clp.columnLower(),clp.columnUpper(),clp.integerInformation(),
+		  gap,justInteger)) ;
+}
+
+int RedCostFixer::applyTo (Osi1API &si) const
+{
+  const int num = getNumChanged() ;
+  if (num == 0) return (0) ;
+  std::vector<double> bounds(2*num) ;
+  for (int k = 0 ; k < num ; k++) {
+    bounds[2*k] = getNewLower(k) ;
+    bounds[2*k+1] = getNewUpper(k) ;
+  }
+  si.setColSetBounds(changed_.data(),changed_.data()+num,bounds.data()) ;
+  return (num) ;
+}
+
+/*
+  ClpSimplexAPI only takes whole bound vectors. Copy, patch, and hand them
+  back.
+*/
+int RedCostFixer::applyTo (ClpSimplexAPI &clp) const
+{
+  const int num = getNumChanged() ;
+  if (num == 0) return (0) ;
+  const int n = clp.numberColumns() ;
+  std::vector<double> lower(clp.columnLower(),clp.columnLower()+n) ;
+  std::vector<double> upper(clp.columnUpper(),clp.columnUpper()+n) ;
+  for (int k = 0 ; k < num ; k++) {
+    lower[changed_[k]] = getNewLower(k) ;
+    upper[changed_[k]] = getNewUpper(k) ;
+  }
+  clp.chgColumnLower(lower.data()) ;
+  clp.chgColumnUpper(upper.data()) ;
+  return (num) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,128 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2RedCostFix.hpp
+    \brief Solver-independent reduced cost fixing and bound tightening.
+*/
+#ifndef Osi2RedCostFix_HPP
+#define Osi2RedCostFix_HPP
+
+#include <vector>
+
+namespace Osi2 {
+
+class Osi1API ;
+class ClpSimplexAPI ;
+
+/*! \brief Reduced cost fixing
+
+  Given an optimal LP solution with objective z and a gap g = |cutoff - z|
+  (the amount by which the objective may degrade before the node can be
+  pruned), a column at its lower bound l with reduced cost d > 0 cannot
+  exceed l + g/d in any improving solution; symmetrically, a column at its
+  upper bound u with d < 0 cannot go below u - g/|d|. When the implied
+  bound reaches the opposite bound the column is fixed; otherwise the bound
+  is tightened. Implied bounds on integer columns are rounded.
+  Osi1API::reducedCostFix does the fixing half of this, per solver, with
+  delta 1.
+
+  The calculation runs over plain arrays, so it gives the same answer, at
+  the same speed, for every plugin. Changes are collected and applied with
+  one batched bound update (Osi1API::setColSetBounds, or one
+  chgColumnLower / chgColumnUpper pair for ClpSimplexAPI).
+
+  Reduced costs are taken in minimisation form: multiply by the objective
+  sense before calling the array version if the problem is a maximisation.
+  The solver versions do this themselves.
+*/
+class RedCostFixer {
+
+public:
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  RedCostFixer () ;
+  /// Destructor
+  ~RedCostFixer () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// A column within this distance of a bound is at the bound (default 1e-7)
+  inline void setPrimalTol (double tol) { primalTol_ = tol ; }
+  /// Reduced costs at or below this are treated as zero (default 1e-7)
+  inline void setDualTol (double tol) { dualTol_ = tol ; }
+  /// Tolerance used when rounding integer bounds (default 1e-6)
+  inline void setIntegerTol (double tol) { intTol_ = tol ; }
+  //@}
+
+  /*! \name Computing bound changes
+
+    Each method returns the number of columns whose bounds change. Nothing
+    is done if \p gap is negative or infinite. With \p justInteger true,
+    only integer columns are considered.
+  */
+  //@{
+  /*! \brief Array version
+
+    \p colType may be null (all columns continuous); otherwise nonzero marks
+    an integer column, as returned by Osi1API::getColType or
+    ClpSimplexAPI::integerInformation. \p dj is in minimisation form.
+  */
+  int compute (int n, const double *x, const double *dj,
+	       const double *lb, const double *ub, const char *colType,
+	       double gap, bool justInteger = true) ;
+  /// Use the current solution of an Osi1API object
+  int compute (const Osi1API &si, double gap, bool justInteger = true) ;
+  /// Use the current solution of a ClpSimplexAPI object
+  int compute (ClpSimplexAPI &clp, double gap, bool justInteger = true) ;
+  //@}
+
+  /*! \name Applying bound changes */
+  //@{
+  /// Apply the changes from the last #compute; returns the number applied
+  int applyTo (Osi1API &si) const ;
+  /// Apply the changes from the last #compute; returns the number applied
+  int applyTo (ClpSimplexAPI &clp) const ;
+  //@}
+
+  /*! \name Results */
+  //@{
+  /// Number of columns with changed bounds
+  inline int getNumChanged () const
+  { return (static_cast<int>(changed_.size())) ; }
+  /// Number of those columns that are now fixed
+  inline int getNumFixed () const { return (numFixed_) ; }
+  /// Indices of the changed columns, ascending
+  inline const int *getIndices () const { return (changed_.data()) ; }
+  /// New lower bound of changed column k (k indexes getIndices())
+  inline double getNewLower (int k) const { return (newLb_[changed_[k]]) ; }
+  /// New upper bound of changed column k
+  inline double getNewUpper (int k) const { return (newUb_[changed_[k]]) ; }
+  //@}
+
+private:
+
+  /// Tolerances
+  double primalTol_ ;
+  double dualTol_ ;
+  double intTol_ ;
+
+  /// Number of columns fixed
+  int numFixed_ ;
+  /// Changed columns
+  std::vector<int> changed_ ;
+  /// Dense new bounds (valid for the changed columns)
+  std::vector<double> newLb_ ;
+  std::vector<double> newUb_ ;
+  /// Scratch: minimisation-form reduced costs for the solver versions
+  std::vector<double> djScratch_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,209 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::RowGenerator.
+*/
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2RowGenerator.hpp"
+
+namespace {
+
+/*
+  The few places where ClpSimplexAPI and Osi1API differ. A solve after rows
+  are added is a dual simplex for both (Osi1API::resolve).
+*/
+bool haveBasis (Osi2::ClpSimplexAPI &clp) { return (clp.statusExists()) ; }
+bool haveBasis (Osi2::Osi1API &si) { return (si.basisIsAvailable()) ; }
+
+void firstSolve (Osi2::ClpSimplexAPI &clp) { clp.initialSolve() ; }
+void firstSolve (Osi2::Osi1API &si) { si.initialSolve() ; }
+
+void reSolve (Osi2::ClpSimplexAPI &clp) { clp.dual() ; }
+void reSolve (Osi2::Osi1API &si) { si.resolve() ; }
+
+bool isOptimal (Osi2::ClpSimplexAPI &clp) { return (clp.status() == 0) ; }
+bool isOptimal (Osi2::Osi1API &si) { return (si.isProvenOptimal()) ; }
+
+int numRows (Osi2::ClpSimplexAPI &clp) { return (clp.numberRows()) ; }
+int numRows (Osi2::Osi1API &si) { return (si.getNumRows()) ; }
+
+int numCols (Osi2::ClpSimplexAPI &clp) { return (clp.numberColumns()) ; }
+int numCols (Osi2::Osi1API &si) { return (si.getNumCols()) ; }
+
+double objValue (Osi2::ClpSimplexAPI &clp) { return (clp.objectiveValue()) ; }
+double objValue (Osi2::Osi1API &si) { return (si.getObjValue()) ; }
+
+int iterations (Osi2::ClpSimplexAPI &clp)
+{ return (clp.numberIterations()) ; }
+int iterations (Osi2::Osi1API &si) { return (si.getIterationCount()) ; }
+
+const double *colSolution (Osi2::ClpSimplexAPI &clp)
+{ return (clp.getColSolution()) ; }
+const double *colSolution (Osi2::Osi1API &si)
+{ return (si.getColSolution()) ; }
+
+void deleteRows (Osi2::ClpSimplexAPI &clp, int num, const int *which)
+{ clp.deleteRows(num,which) ; }
+void deleteRows (Osi2::Osi1API &si, int num, const int *which)
+{ si.deleteRows(num,which) ; }
+
+/// Which rows from \p first on have a basic slack
+void basicRows (Osi2::ClpSimplexAPI &clp, int first, std::vector<char> &basic)
+{
+  const int m = clp.numberRows() ;
+  basic.resize(m-first) ;
+  for (int i = first ; i < m ; i++)
+    basic[i-first] = (clp.getRowStatus(i) == Osi2::ClpSimplexAPI::basic) ;
+}
+
+/// Osi1API codes basic as 1 (see Osi1API::getBasisStatus)
+void basicRows (Osi2::Osi1API &si, int first, std::vector<char> &basic)
+{
+  const int m = si.getNumRows() ;
+  std::vector<int> cstat(si.getNumCols()) ;
+  std::vector<int> rstat(m) ;
+  si.getBasisStatus(cstat.data(),rstat.data()) ;
+  basic.resize(m-first) ;
+  for (int i = first ; i < m ; i++) basic[i-first] = (rstat[i] == 1) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+RowGenerator::RowGenerator (int numThreads)
+  : numThreads_(numThreads),
+    maxRounds_(1000),
+    maxSlack_(10),
+    tol_(1.0e-6),
+    firstGenerated_(0),
+    numAdded_(0),
+    numRemoved_(0)
+{ }
+
+RowGenerator::~RowGenerator () { }
+
+/*
+  Each separator fills its own batch; the batches are then copied into
+  merged_ in separator order.
+*/
+int RowGenerator::separate (int n, const double *x)
+{
+  const int numSeps = static_cast<int>(separators_.size()) ;
+  batches_.resize(numSeps) ;
+  parallelFor(numSeps,numThreads_,
+	      [&] (int first, int last, int)
+	      {
+		for (int k = first ; k < last ; k++) {
+		  batches_[k].clear() ;
+		  separators_[k]->separate(n,x,batches_[k]) ;
+		}
+	      }) ;
+  merged_.clear() ;
+  for (const CutBatch &batch : batches_) {
+    const int *starts = batch.getStarts() ;
+    for (int k = 0 ; k < batch.getNumCuts() ; k++) {
+      merged_.addCut(starts[k+1]-starts[k],batch.getIndices()+starts[k],
+		     batch.getElements()+starts[k],batch.getLower()[k],
+		     batch.getUpper()[k]) ;
+    }
+  }
+  return (merged_.getNumCuts()) ;
+}
+
+void RowGenerator::ageRows (const std::vector<char> &basic,
+			    std::vector<int> &which)
+{
+  which.clear() ;
+  if (maxSlack_ < 0) return ;
+  const int numGen = static_cast<int>(slack_.size()) ;
+  int kept = 0 ;
+  for (int k = 0 ; k < numGen ; k++) {
+    if (basic[k])
+      slack_[k]++ ;
+    else
+      slack_[k] = 0 ;
+    if (slack_[k] > maxSlack_)
+      which.push_back(firstGenerated_+k) ;
+    else
+      slack_[kept++] = slack_[k] ;
+  }
+  slack_.resize(kept) ;
+}
+
+/*
+  The solution is copied once per round so that the separators read
+  storage the solver won't touch while they run.
+*/
+template <class Solver>
+int RowGenerator::solveLoop (Solver &solver)
+{
+  rounds_.clear() ;
+  numAdded_ = 0 ;
+  numRemoved_ = 0 ;
+  firstGenerated_ = numRows(solver) ;
+  slack_.clear() ;
+  if (!haveBasis(solver))
+    firstSolve(solver) ;
+  else
+    reSolve(solver) ;
+
+  const int n = numCols(solver) ;
+  std::vector<double> x ;
+  std::vector<char> basic ;
+  std::vector<int> which ;
+  for (int r = 0 ; r < maxRounds_ ; r++) {
+    if (!isOptimal(solver)) return (-1) ;
+    x.assign(colSolution(solver),colSolution(solver)+n) ;
+    Round round ;
+    round.objValue_ = objValue(solver) ;
+    round.separated_ = separate(n,x.data()) ;
+    merged_.filterViolated(x.data(),tol_,numThreads_) ;
+    merged_.removeDuplicates() ;
+    round.added_ = merged_.applyTo(solver) ;
+    round.removed_ = 0 ;
+    round.iterations_ = 0 ;
+    if (round.added_ == 0) {
+      rounds_.push_back(round) ;
+      return (0) ;
+    }
+    slack_.resize(slack_.size()+round.added_,0) ;
+    reSolve(solver) ;
+    round.iterations_ = iterations(solver) ;
+    if (isOptimal(solver)) {
+      basicRows(solver,firstGenerated_,basic) ;
+      ageRows(basic,which) ;
+      if (!which.empty())
+	deleteRows(solver,static_cast<int>(which.size()),which.data()) ;
+      round.removed_ = static_cast<int>(which.size()) ;
+    }
+    numAdded_ += round.added_ ;
+    numRemoved_ += round.removed_ ;
+    rounds_.push_back(round) ;
+  }
+  return ((isOptimal(solver))?1:-1) ;
+}
+
+int RowGenerator::solve (ClpSimplexAPI &clp)
+{
+  return (solveLoop(clp)) ;
+}
+
+int RowGenerator::solve (Osi1API &si)
+{
+  return (solveLoop(si)) ;
+}
+
+}  // end namespace Osi2
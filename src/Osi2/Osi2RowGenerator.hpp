@@ -0,0 +1,164 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2RowGenerator.hpp
+    \brief Lazy constraint generation over ClpSimplexAPI and Osi1API.
+*/
+#ifndef Osi2RowGenerator_HPP
+#define Osi2RowGenerator_HPP
+
+#include <vector>
+
+#include "Osi2CutBatch.hpp"
+
+namespace Osi2 {
+
+class Osi1API ;
+class ClpSimplexAPI ;
+
+/*! \brief Row generation (lazy constraint) driver
+
+  For models with too many constraints to load at once, of which only a
+  few will bind (subtour elimination, for example). The model is solved
+  with a subset of its rows; separators (see Separator) then look for rows
+  the solution violates, the violated rows are added, and the model is
+  re-solved with dual simplex from the previous basis, which stays dual
+  feasible when rows are added. The loop ends when no violated row is
+  found.
+
+  Each separator handles one family of constraints. Each round calls every
+  separator against the same copy of the solution, spread over up to
+  #setNumThreads threads, each separator with its own CutBatch. The batches
+  are merged in separator order, filtered for violation (#setTolerance),
+  cleared of duplicates, and added with a single addRows call, so the model
+  is the same for any number of threads.
+
+  A generated row whose slack is basic is not binding. Generated rows that
+  stay so for more than #setMaxSlack consecutive rounds are removed, with
+  one deleteRows call per round; the rest of the basis stays valid. The
+  rows of the model as given are never removed. Removed rows may be
+  generated again.
+*/
+class RowGenerator {
+
+public:
+
+  /*! \brief A separator for one family of constraints
+
+    #separate is given the primal solution and adds rows of its family to
+    \p cuts, as lb <= ax <= ub. The driver drops rows that aren't violated,
+    so a separator may be generous. Returns the number of rows added.
+    Different separators may run at the same time in different threads; one
+    separator is only ever called by one thread at a time.
+  */
+  class Separator {
+  public:
+    virtual ~Separator () { }
+    virtual int separate (int numCols, const double *x, CutBatch &cuts) = 0 ;
+  } ;
+
+  /// Result of one round
+  struct Round {
+    /// Objective before separation
+    double objValue_ ;
+    /// Rows returned by the separators
+    int separated_ ;
+    /// Violated rows added
+    int added_ ;
+    /// Slack rows removed after the re-solve
+    int removed_ ;
+    /// Dual simplex iterations for the re-solve
+    int iterations_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  RowGenerator (int numThreads = 1) ;
+  /// Destructor
+  ~RowGenerator () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Add a separator; not owned, must outlive #solve
+  inline void addSeparator (Separator *sep) { separators_.push_back(sep) ; }
+  /// Forget the separators
+  inline void clearSeparators () { separators_.clear() ; }
+  /// Number of threads for separation and the violation filter
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /// Most rounds of separation (default 1000)
+  inline void setMaxRounds (int maxRounds) { maxRounds_ = maxRounds ; }
+  /// Rounds a generated row may be slack before it is removed (default
+  /// 10; negative to never remove)
+  inline void setMaxSlack (int maxSlack) { maxSlack_ = maxSlack ; }
+  /// Least violation for a row to be added (default 1.0e-6)
+  inline void setTolerance (double tol) { tol_ = tol ; }
+  //@}
+
+  /*! \name Solve
+
+    The model is solved first if it has no basis. Returns -1 if the model
+    is not optimal at some round, 0 if no violated row was found, 1 if the
+    round limit was reached. The final solution is left in the solver.
+  */
+  //@{
+  /// Row generation on \p clp
+  int solve (ClpSimplexAPI &clp) ;
+  /// Row generation on \p si
+  int solve (Osi1API &si) ;
+  //@}
+
+  /*! \name Results */
+  //@{
+  /// Number of rounds of separation, including the last one if it found
+  /// nothing
+  inline int getNumRounds () const
+  { return (static_cast<int>(rounds_.size())) ; }
+  /// Result of round \p k
+  inline const Round &getRound (int k) const { return (rounds_[k]) ; }
+  /// Total rows added
+  inline int getNumAdded () const { return (numAdded_) ; }
+  /// Total rows removed
+  inline int getNumRemoved () const { return (numRemoved_) ; }
+  //@}
+
+private:
+
+  /// The loop, for either solver
+  template <class Solver>
+  int solveLoop (Solver &solver) ;
+
+  /// Run the separators and merge their rows into merged_; returns the
+  /// number of rows returned
+  int separate (int n, const double *x) ;
+
+  /// Age the generated rows given which are basic; returns the rows to remove
+  void ageRows (const std::vector<char> &basic, std::vector<int> &which) ;
+
+  /// Separators
+  std::vector<Separator *> separators_ ;
+  /// Parameters
+  int numThreads_ ;
+  int maxRounds_ ;
+  int maxSlack_ ;
+  double tol_ ;
+  /// Index of the first generated row
+  int firstGenerated_ ;
+  /// Rounds slack, for each generated row
+  std::vector<int> slack_ ;
+  /// One batch per separator, and the merged batch
+  std::vector<CutBatch> batches_ ;
+  CutBatch merged_ ;
+  /// Results
+  std::vector<Round> rounds_ ;
+  int numAdded_ ;
+  int numRemoved_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
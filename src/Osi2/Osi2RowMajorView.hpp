@@ -0,0 +1,169 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2RowMajorView.hpp
+    \brief A row-major (CSR) copy of a column-major constraint matrix.
+*/
+#ifndef Osi2RowMajorView_HPP
+#define Osi2RowMajorView_HPP
+
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2Parallel.hpp"
+
+namespace Osi2 {
+
+/*! \brief Row-major view of a constraint matrix
+
+  Holds a gap-free CSR copy of a column-major matrix: row i occupies
+  positions [getStarts()[i],getStarts()[i+1]) of getIndices() (column
+  indices, ascending) and getElements().
+
+  The transpose is a counting sort done in parallel over blocks of columns:
+  each block counts the entries it holds in each row, the counts are turned
+  into per-block write positions (in parallel over rows), and each block
+  then scatters its columns into place. Blocks cover contiguous column
+  ranges in order, so every row comes out sorted by column and the result
+  does not depend on the number of threads.
+
+  A view is typically owned by a solver object, which builds it on first
+  request and marks it invalid whenever the matrix changes (see
+  ClpSimplexAPI::getRowMajorView). Once built it is only read, and can be
+  shared by any number of threads.
+
+  This class is header-only so that it can be used by plugins that don't
+  link with libOsi2.
+*/
+class RowMajorView {
+
+public:
+
+  /// Constructor
+  RowMajorView () : valid_(false), numRows_(0), numCols_(0), starts_(1,0) { }
+
+  /// Is the view current?
+  inline bool isValid () const { return (valid_) ; }
+  /// Mark the view out of date; the storage is kept for reuse
+  inline void invalidate () { valid_ = false ; }
+
+  /*! \brief Build the view from a column-major matrix
+
+    \p lengths may be null if the matrix has no gaps. Column blocks smaller
+    than \p minBlock columns aren't worth a thread.
+  */
+  void build (int m, int n, const CoinBigIndex *colStarts,
+	      const int *colLengths, const int *rowIndices,
+	      const double *elements, int numThreads = 1,
+	      int minBlock = 4096)
+  {
+    numRows_ = m ;
+    numCols_ = n ;
+    const int blocks = numChunks(n,numThreads,minBlock) ;
+    blockCnt_.assign(static_cast<size_t>(blocks)*m,0) ;
+/*
+  Count the entries of each block by row.
+*/
+    parallelFor(n,numThreads,
+		[&](int first, int last, int blk) {
+		  CoinBigIndex *cnt = &blockCnt_[static_cast<size_t>(blk)*m] ;
+		  for (int j = first ; j < last ; j++) {
+		    const CoinBigIndex end = colEnd(colStarts,colLengths,j) ;
+		    for (CoinBigIndex k = colStarts[j] ; k < end ; k++)
+		      cnt[rowIndices[k]]++ ;
+		  }
+		},minBlock) ;
+/*
+  Row lengths, then row starts (a serial prefix sum), then convert the
+  counts in place to each block's first write position in each row.
+*/
+    starts_.resize(m+1) ;
+    parallelFor(m,numThreads,
+		[&](int first, int last, int) {
+		  for (int i = first ; i < last ; i++) {
+		    CoinBigIndex len = 0 ;
+		    for (int b = 0 ; b < blocks ; b++)
+		      len += blockCnt_[static_cast<size_t>(b)*m+i] ;
+		    starts_[i+1] = len ;
+		  }
+		},minBlock) ;
+    starts_[0] = 0 ;
+    for (int i = 0 ; i < m ; i++) starts_[i+1] += starts_[i] ;
+    parallelFor(m,numThreads,
+		[&](int first, int last, int) {
+		  for (int i = first ; i < last ; i++) {
+		    CoinBigIndex pos = starts_[i] ;
+		    for (int b = 0 ; b < blocks ; b++) {
+		      CoinBigIndex &cnt = blockCnt_[static_cast<size_t>(b)*m+i] ;
+		      const CoinBigIndex len = cnt ;
+		      cnt = pos ;
+		      pos += len ;
+		    }
+		  }
+		},minBlock) ;
+/*
+  Scatter. Each block writes only into its own reserved slots.
+*/
+    indices_.resize(starts_[m]) ;
+    elements_.resize(starts_[m]) ;
+    parallelFor(n,numThreads,
+		[&](int first, int last, int blk) {
+		  CoinBigIndex *pos = &blockCnt_[static_cast<size_t>(blk)*m] ;
+		  for (int j = first ; j < last ; j++) {
+		    const CoinBigIndex end = colEnd(colStarts,colLengths,j) ;
+		    for (CoinBigIndex k = colStarts[j] ; k < end ; k++) {
+		      const CoinBigIndex dst = pos[rowIndices[k]]++ ;
+		      indices_[dst] = j ;
+		      elements_[dst] = elements[k] ;
+		    }
+		  }
+		},minBlock) ;
+    valid_ = true ;
+  }
+
+  /*! \name Accessors */
+  //@{
+  /// Number of rows
+  inline int getNumRows () const { return (numRows_) ; }
+  /// Number of columns
+  inline int getNumCols () const { return (numCols_) ; }
+  /// Number of coefficients
+  inline CoinBigIndex getNumElements () const { return (starts_.back()) ; }
+  /// Row starts (getNumRows()+1 entries)
+  inline const CoinBigIndex *getStarts () const { return (starts_.data()) ; }
+  /// Column indices
+  inline const int *getIndices () const { return (indices_.data()) ; }
+  /// Coefficients
+  inline const double *getElements () const { return (elements_.data()) ; }
+  /// Length of row \p i
+  inline int getRowLength (int i) const
+  { return (static_cast<int>(starts_[i+1]-starts_[i])) ; }
+  //@}
+
+private:
+
+  /// End of column \p j in a possibly gappy column-major matrix
+  static inline CoinBigIndex colEnd (const CoinBigIndex *starts,
+				     const int *lengths, int j)
+  { return ((lengths)?starts[j]+lengths[j]:starts[j+1]) ; }
+
+  /// Is the view current?
+  bool valid_ ;
+  /// Dimensions
+  int numRows_ ;
+  int numCols_ ;
+  /// CSR storage
+  std::vector<CoinBigIndex> starts_ ;
+  std::vector<int> indices_ ;
+  std::vector<double> elements_ ;
+  /// Scratch: per-block counts, then per-block write positions
+  std::vector<CoinBigIndex> blockCnt_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
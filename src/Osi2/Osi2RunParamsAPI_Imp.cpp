@@ -86,6 +86,7 @@ static Osi2::ExitFunc initPlugin (Osi2::PlatformServices *services)
   reginfo.ctrlObj_ = nullptr ;
   reginfo.createFunc_ = create ;
   reginfo.destroyFunc_ = destroy ;
+  reginfo.resetFunc_ = nullptr ;
   const char *apiName = Osi2::RunParamsAPI::getAPIIDString() ;
   int retval =
     services->registerAPI_(reinterpret_cast<const Osi2::CharString *>(apiName),
@@ -0,0 +1,194 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::ScenarioBatch.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2ScenarioBatch.hpp"
+
+namespace {
+
+/// L1 distance between two vectors of length len
+double l1Dist (int len, const double *a, const double *b)
+{
+  double dist = 0.0 ;
+  for (int i = 0 ; i < len ; i++) dist += std::fabs(a[i]-b[i]) ;
+  return (dist) ;
+}
+
+/// Copy len entries from src (if valid) to dst[k*len]
+void keep (bool valid, int k, int len, const double *src,
+	   std::vector<double> &dst)
+{
+  if (valid && src) std::copy(src,src+len,dst.begin()+k*len) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+ScenarioBatch::ScenarioBatch (int numThreads)
+  : numThreads_(numThreads),
+    fields_(SolveResult::colSolutionField),
+    numScenarios_(0),
+    numRows_(0),
+    numCols_(0)
+{ }
+
+ScenarioBatch::~ScenarioBatch () { }
+
+double ScenarioBatch::distance (int k, int p, const double *rowLower,
+				const double *rowUpper, const double *obj) const
+{
+  const int m = numRows_ ;
+  const int n = numCols_ ;
+  double dist = 0.0 ;
+  if (rowLower)
+    dist += l1Dist(m,rowLower+k*m,(p < 0)?baseRowLower_.data():rowLower+p*m) ;
+  if (rowUpper)
+    dist += l1Dist(m,rowUpper+k*m,(p < 0)?baseRowUpper_.data():rowUpper+p*m) ;
+  if (obj)
+    dist += l1Dist(n,obj+k*n,(p < 0)?baseObj_.data():obj+p*n) ;
+  return (dist) ;
+}
+
+/*
+  The closest candidate basis is found by a linear scan over the scenarios
+  already solved in this run, so a run of length r costs O(r^2(m+n)) in
+  distance computations; fine for the hundreds of scenarios this is meant
+  for, and still small next to the solves.
+*/
+void ScenarioBatch::solveRun (ClpSimplexAPI &clp, int first, int last,
+			      const double *rowLower, const double *rowUpper,
+			      const double *obj)
+{
+  const int m = numRows_ ;
+  const int n = numCols_ ;
+  const size_t statLen = static_cast<size_t>(n)+m ;
+  const bool useDual = (rowLower != nullptr || rowUpper != nullptr) ;
+  for (int k = first ; k < last ; k++) {
+    int from = -1 ;
+    double best = distance(k,-1,rowLower,rowUpper,obj) ;
+    for (int p = first ; p < k && best > 0.0 ; p++) {
+      const double dist = distance(k,p,rowLower,rowUpper,obj) ;
+      if (dist < best) {
+	best = dist ;
+	from = p ;
+      }
+    }
+    warmFrom_[k] = from ;
+    if (from >= 0) {
+      if (haveFinal_[from]) clp.copyinStatus(&finalStatus_[from*statLen]) ;
+    } else if (!baseStatus_.empty()) {
+      clp.copyinStatus(baseStatus_.data()) ;
+    }
+    clp.chgRowLower((rowLower)?rowLower+k*m:baseRowLower_.data()) ;
+    clp.chgRowUpper((rowUpper)?rowUpper+k*m:baseRowUpper_.data()) ;
+    clp.chgObjCoefficients((obj)?obj+k*n:baseObj_.data()) ;
+    if (useDual)
+      clp.dual() ;
+    else
+      clp.primal() ;
+    status_[k] = clp.status() ;
+    objValue_[k] = clp.objectiveValue() ;
+    iterations_[k] = clp.numberIterations() ;
+    const unsigned char *stat = clp.statusArray() ;
+    haveFinal_[k] = (stat != nullptr) ;
+    if (stat)
+      std::copy(stat,stat+statLen,finalStatus_.begin()+k*statLen) ;
+    keep(fields_&SolveResult::colSolutionField,k,n,
+	 clp.getColSolution(),colSolution_) ;
+    keep(fields_&SolveResult::rowActivityField,k,m,
+	 clp.getRowActivity(),rowActivity_) ;
+    keep(fields_&SolveResult::rowPriceField,k,m,
+	 clp.getRowPrice(),rowPrice_) ;
+    keep(fields_&SolveResult::reducedCostField,k,n,
+	 clp.getReducedCost(),reducedCost_) ;
+  }
+}
+
+/*
+  Solver objects for all runs but the first are cloned here, in the calling
+  thread; only the solves themselves run in parallel.
+*/
+int ScenarioBatch::solve (ClpSimplexAPI &clp, int numScenarios,
+			  const double *rowLower, const double *rowUpper,
+			  const double *obj)
+{
+  const int m = clp.numberRows() ;
+  const int n = clp.numberColumns() ;
+  const size_t statLen = static_cast<size_t>(n)+m ;
+  numScenarios_ = numScenarios ;
+  numRows_ = m ;
+  numCols_ = n ;
+  baseRowLower_.assign(clp.rowLower(),clp.rowLower()+m) ;
+  baseRowUpper_.assign(clp.rowUpper(),clp.rowUpper()+m) ;
+  baseObj_.assign(clp.objective(),clp.objective()+n) ;
+  if (clp.statusExists())
+    baseStatus_.assign(clp.statusArray(),clp.statusArray()+statLen) ;
+  else
+    baseStatus_.clear() ;
+
+  const int K = numScenarios ;
+  status_.assign(K,-1) ;
+  objValue_.assign(K,0.0) ;
+  iterations_.assign(K,0) ;
+  warmFrom_.assign(K,-1) ;
+  finalStatus_.resize(K*statLen) ;
+  haveFinal_.assign(K,0) ;
+  if (fields_&SolveResult::colSolutionField) colSolution_.resize(K*n) ;
+  if (fields_&SolveResult::rowActivityField) rowActivity_.resize(K*m) ;
+  if (fields_&SolveResult::rowPriceField) rowPrice_.resize(K*m) ;
+  if (fields_&SolveResult::reducedCostField) reducedCost_.resize(K*n) ;
+/*
+  Clone the solver objects for the other runs. A clone brings the model,
+  the objective sense, and the basis.
+*/
+  const int runs = numChunks(K,numThreads_) ;
+  std::vector<ClpSimplexAPI *> solvers(runs,&clp) ;
+  int retval = 0 ;
+  for (int r = 1 ; r < runs ; r++) {
+    solvers[r] = clp.clone() ;
+    if (solvers[r] == nullptr) {
+      std::cout
+	<< "ScenarioBatch::solve: failed to clone the model for run "
+	<< r << "." << std::endl ;
+      retval = -1 ;
+      break ;
+    }
+    solvers[r]->setLogLevel(0) ;
+  }
+  if (retval == 0) {
+    parallelFor(K,numThreads_,
+		[&](int first, int last, int run) {
+		  solveRun(*solvers[run],first,last,rowLower,rowUpper,obj) ;
+		}) ;
+  }
+  for (int r = 1 ; r < runs ; r++)
+    if (solvers[r] != &clp) delete solvers[r] ;
+/*
+  Put the original object back as it was.
+*/
+  clp.chgRowLower(baseRowLower_.data()) ;
+  clp.chgRowUpper(baseRowUpper_.data()) ;
+  clp.chgObjCoefficients(baseObj_.data()) ;
+  if (!baseStatus_.empty()) clp.copyinStatus(baseStatus_.data()) ;
+  return (retval) ;
+}
+
+}  // end namespace Osi2
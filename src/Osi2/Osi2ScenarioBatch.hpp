@@ -0,0 +1,166 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2ScenarioBatch.hpp
+    \brief Re-solve one constraint matrix for many right-hand sides and
+	   objectives.
+*/
+#ifndef Osi2ScenarioBatch_HPP
+#define Osi2ScenarioBatch_HPP
+
+#include <vector>
+
+#include "Osi2SolveResult.hpp"
+
+namespace Osi2 {
+
+class ClpSimplexAPI ;
+
+/*! \brief Batch of scenarios over a common constraint matrix
+
+  A scenario replaces the row bounds, the objective, or both, of the model
+  held by a ClpSimplexAPI object. Scenario data is given packed, scenario
+  by scenario: the row lower bounds of scenario k are
+  rowLower[k*m .. k*m+m-1], and similarly for row upper bounds (m entries)
+  and objectives (n entries). Any of the three may be null, in which case
+  every scenario uses the model's own vector.
+
+  Each scenario is warm started from the closest basis seen so far: the
+  model's own basis or the final basis of a scenario already solved by the
+  same solver object, whichever has the smallest L1 distance in scenario
+  data. A change in row bounds keeps a basis dual feasible, so those
+  scenarios are solved with dual simplex; a change in objective alone
+  keeps the basis primal feasible, so primal simplex is used.
+
+  Scenarios are split into contiguous runs, one per thread. The first run
+  is solved by the original object. Each other run is solved by a clone
+  (ClpSimplexAPI::clone) of the original, which starts from its basis.
+  Results do not depend on scheduling, but with several threads a scenario
+  may be warm started from a different basis than in a serial run.
+
+  Results are stored columnar: for each field, one array over all
+  scenarios (for vectors, scenario k at offset k*m or k*n). Which vectors
+  are kept is chosen with #setFields, using the SolveResult::Field mask;
+  status, objective, and iteration count are always kept.
+*/
+class ScenarioBatch {
+
+public:
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  ScenarioBatch (int numThreads = 1) ;
+  /// Destructor
+  ~ScenarioBatch () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Number of threads
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /// Vectors to keep (default: primal column solution only)
+  inline void setFields (unsigned int fields) { fields_ = fields ; }
+  //@}
+
+  /*! \brief Solve \p numScenarios scenarios
+
+    On return the row bounds, objective, and basis of \p clp are as they
+    were on entry; its solution is that of the last scenario in the first
+    run. Returns -1 if a clone for another run can't be made, 0 otherwise.
+  */
+  int solve (ClpSimplexAPI &clp, int numScenarios, const double *rowLower,
+	     const double *rowUpper, const double *obj) ;
+
+  /*! \name Results */
+  //@{
+  /// Number of scenarios solved
+  inline int getNumScenarios () const { return (numScenarios_) ; }
+  /// Number of rows
+  inline int getNumRows () const { return (numRows_) ; }
+  /// Number of columns
+  inline int getNumCols () const { return (numCols_) ; }
+  /// Status of each scenario (see ClpSimplexAPI::status)
+  inline const int *getStatus () const { return (status_.data()) ; }
+  /// Objective value of each scenario
+  inline const double *getObjValues () const { return (objValue_.data()) ; }
+  /// Iteration count of each scenario
+  inline const int *getIterations () const { return (iterations_.data()) ; }
+  /*! \brief Warm start used by each scenario
+
+    The index of the scenario whose final basis was used, or -1 for the
+    model's own basis.
+  */
+  inline const int *getWarmStartFrom () const
+  { return (warmFrom_.data()) ; }
+  /// Primal column solutions, n per scenario (null if not kept)
+  inline const double *getColSolutions () const
+  { return (kept(colSolution_,SolveResult::colSolutionField)) ; }
+  /// Row activities, m per scenario (null if not kept)
+  inline const double *getRowActivities () const
+  { return (kept(rowActivity_,SolveResult::rowActivityField)) ; }
+  /// Row duals, m per scenario (null if not kept)
+  inline const double *getRowPrices () const
+  { return (kept(rowPrice_,SolveResult::rowPriceField)) ; }
+  /// Reduced costs, n per scenario (null if not kept)
+  inline const double *getReducedCosts () const
+  { return (kept(reducedCost_,SolveResult::reducedCostField)) ; }
+  //@}
+
+private:
+
+  /// Storage for a field, or null if the field wasn't kept
+  inline const double *kept (const std::vector<double> &vec,
+			     unsigned int field) const
+  { return ((fields_&field)?vec.data():nullptr) ; }
+
+  /// Solve scenarios [first,last) on \p clp
+  void solveRun (ClpSimplexAPI &clp, int first, int last,
+		 const double *rowLower, const double *rowUpper,
+		 const double *obj) ;
+
+  /// L1 distance in scenario data from scenario k to p (-1 for the model)
+  double distance (int k, int p, const double *rowLower,
+		   const double *rowUpper, const double *obj) const ;
+
+  /// Number of threads
+  int numThreads_ ;
+  /// Vectors to keep
+  unsigned int fields_ ;
+  /// Dimensions
+  int numScenarios_ ;
+  int numRows_ ;
+  int numCols_ ;
+
+  /*! \name The model's own data, for distances and restore */
+  //@{
+  std::vector<double> baseRowLower_ ;
+  std::vector<double> baseRowUpper_ ;
+  std::vector<double> baseObj_ ;
+  /// Basis (empty if the model had none)
+  std::vector<unsigned char> baseStatus_ ;
+  //@}
+
+  /*! \name Results, columnar */
+  //@{
+  std::vector<int> status_ ;
+  std::vector<double> objValue_ ;
+  std::vector<int> iterations_ ;
+  std::vector<int> warmFrom_ ;
+  std::vector<double> colSolution_ ;
+  std::vector<double> rowActivity_ ;
+  std::vector<double> rowPrice_ ;
+  std::vector<double> reducedCost_ ;
+  /// Final basis of each scenario, n+m per scenario
+  std::vector<unsigned char> finalStatus_ ;
+  /// True if the solver had a basis to save for the scenario
+  std::vector<char> haveFinal_ ;
+  //@}
+} ;
+
+}  // end namespace Osi2
+
+#endif
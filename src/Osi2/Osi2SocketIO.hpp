@@ -0,0 +1,199 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SocketIO.hpp
+    \brief Whole-message socket transfers.
+
+  The solver host, the solver daemon, and its client talk over stream
+  sockets in fixed-size headers followed by arrays. These helpers move a
+  whole buffer or nothing, riding out signals. A peer that has gone away
+  shows up as a return value of -1, never as SIGPIPE. The solver host also
+  passes descriptors between processes (#sendWithFd, #recvWithFd).
+*/
+#ifndef Osi2SocketIO_HPP
+#define Osi2SocketIO_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+namespace Osi2 {
+
+/// Send \p len bytes from \p buf; 0 if all went, -1 otherwise
+inline int sendAll (int sock, const void *buf, size_t len)
+{
+  const char *p = static_cast<const char *>(buf) ;
+  while (len > 0) {
+    const ssize_t done = ::send(sock,p,len,MSG_NOSIGNAL) ;
+    if (done < 0 && errno == EINTR) continue ;
+    if (done <= 0) return (-1) ;
+    p += done ;
+    len -= done ;
+  }
+  return (0) ;
+}
+
+/// Receive exactly \p len bytes into \p buf; 0 if all came, -1 otherwise
+inline int recvAll (int sock, void *buf, size_t len)
+{
+  char *p = static_cast<char *>(buf) ;
+  while (len > 0) {
+    const ssize_t done = ::recv(sock,p,len,0) ;
+    if (done < 0 && errno == EINTR) continue ;
+    if (done <= 0) return (-1) ;
+    p += done ;
+    len -= done ;
+  }
+  return (0) ;
+}
+
+/*! \brief Receive exactly \p len bytes, giving up after \p timeoutMs
+
+  A negative \p timeoutMs means no limit. Returns 0 if all came, -1 if the
+  peer went away or the socket failed, -2 if time ran out first.
+*/
+inline int recvAllBy (int sock, void *buf, size_t len, int timeoutMs)
+{
+  if (timeoutMs < 0) return (recvAll(sock,buf,len)) ;
+  typedef std::chrono::steady_clock Clock ;
+  const Clock::time_point deadline =
+      Clock::now()+std::chrono::milliseconds(timeoutMs) ;
+  char *p = static_cast<char *>(buf) ;
+  while (len > 0) {
+    const long left = static_cast<long>
+      (std::chrono::duration_cast<std::chrono::milliseconds>
+	  (deadline-Clock::now()).count()) ;
+    if (left <= 0) return (-2) ;
+    struct pollfd pfd ;
+    pfd.fd = sock ;
+    pfd.events = POLLIN ;
+    pfd.revents = 0 ;
+    const int ready = ::poll(&pfd,1,static_cast<int>(left)) ;
+    if (ready < 0 && errno == EINTR) continue ;
+    if (ready < 0) return (-1) ;
+    if (ready == 0) continue ;
+    const ssize_t done = ::recv(sock,p,len,0) ;
+    if (done < 0 && errno == EINTR) continue ;
+    if (done <= 0) return (-1) ;
+    p += done ;
+    len -= done ;
+  }
+  return (0) ;
+}
+
+/*! \brief Send \p len bytes with the descriptor \p fd attached
+
+  The message must be small enough to go in one piece (a few hundred bytes
+  is safe on any stream socket). Returns 0 on success, -1 otherwise.
+*/
+inline int sendWithFd (int sock, const void *buf, size_t len, int fd)
+{
+  struct iovec iov ;
+  iov.iov_base = const_cast<void *>(buf) ;
+  iov.iov_len = len ;
+  union {
+    char buf_[CMSG_SPACE(sizeof(int))] ;
+    struct cmsghdr align_ ;
+  } ctl ;
+  std::memset(&ctl,0,sizeof(ctl)) ;
+  struct msghdr msg ;
+  std::memset(&msg,0,sizeof(msg)) ;
+  msg.msg_iov = &iov ;
+  msg.msg_iovlen = 1 ;
+  msg.msg_control = ctl.buf_ ;
+  msg.msg_controllen = sizeof(ctl.buf_) ;
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg) ;
+  cmsg->cmsg_level = SOL_SOCKET ;
+  cmsg->cmsg_type = SCM_RIGHTS ;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int)) ;
+  std::memcpy(CMSG_DATA(cmsg),&fd,sizeof(int)) ;
+  for (;;) {
+    const ssize_t done = ::sendmsg(sock,&msg,MSG_NOSIGNAL) ;
+    if (done < 0 && errno == EINTR) continue ;
+    return ((done == static_cast<ssize_t>(len))?0:-1) ;
+  }
+}
+
+/*! \brief Receive a message sent by #sendWithFd
+
+  \p fd is set to the descriptor that came with it, or -1 if none did.
+  Returns 0 if all \p len bytes came, -1 otherwise.
+*/
+inline int recvWithFd (int sock, void *buf, size_t len, int &fd)
+{
+  fd = -1 ;
+  struct iovec iov ;
+  iov.iov_base = buf ;
+  iov.iov_len = len ;
+  union {
+    char buf_[CMSG_SPACE(sizeof(int))] ;
+    struct cmsghdr align_ ;
+  } ctl ;
+  struct msghdr msg ;
+  std::memset(&msg,0,sizeof(msg)) ;
+  msg.msg_iov = &iov ;
+  msg.msg_iovlen = 1 ;
+  msg.msg_control = ctl.buf_ ;
+  msg.msg_controllen = sizeof(ctl.buf_) ;
+  ssize_t done ;
+  do {
+    done = ::recvmsg(sock,&msg,0) ;
+  } while (done < 0 && errno == EINTR) ;
+  if (done <= 0) return (-1) ;
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg) ; cmsg != nullptr ;
+       cmsg = CMSG_NXTHDR(&msg,cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+      std::memcpy(&fd,CMSG_DATA(cmsg),sizeof(int)) ;
+  }
+  if (static_cast<size_t>(done) == len) return (0) ;
+  return ((recvAll(sock,static_cast<char *>(buf)+done,len-done) == 0)?0:-1) ;
+}
+
+/// Send a string as its length followed by its characters
+inline int sendStr (int sock, const std::string &str)
+{
+  const int len = static_cast<int>(str.size()) ;
+  if (sendAll(sock,&len,sizeof(len)) != 0) return (-1) ;
+  return (sendAll(sock,str.data(),len)) ;
+}
+
+/// Receive a string sent by #sendStr
+inline int recvStr (int sock, std::string &str)
+{
+  int len ;
+  if (recvAll(sock,&len,sizeof(len)) != 0 || len < 0) return (-1) ;
+  str.resize(len) ;
+  return ((len > 0)?recvAll(sock,&str[0],len):0) ;
+}
+
+/// Send \p len elements of \p vec
+template <class T>
+inline int sendVec (int sock, const T *vec, size_t len)
+{
+  return (sendAll(sock,vec,len*sizeof(T))) ;
+}
+
+/// Receive \p len elements into \p vec, resizing it
+template <class T>
+inline int recvVec (int sock, std::vector<T> &vec, size_t len)
+{
+  vec.resize(len) ;
+  return ((len > 0)?recvAll(sock,vec.data(),len*sizeof(T)):0) ;
+}
+
+}  // end namespace Osi2
+
+#endif
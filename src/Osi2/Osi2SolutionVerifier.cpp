@@ -0,0 +1,259 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::SolutionVerifier.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2SolutionVerifier.hpp"
+
+namespace {
+
+typedef Osi2::SolutionVerifier::Norms Norms ;
+
+/// Bounds at or beyond this magnitude are infinite
+const double infBound = 1.0e20 ;
+
+inline void clearNorms (Norms &norms)
+{
+  norms.max_ = 0.0 ;
+  norms.sum_ = 0.0 ;
+  norms.worst_ = -1 ;
+}
+
+/// Add entry \p val (nonnegative) at index \p ndx
+inline void note (Norms &norms, double val, int ndx)
+{
+  norms.sum_ += val ;
+  if (val > norms.max_) {
+    norms.max_ = val ;
+    norms.worst_ = ndx ;
+  }
+}
+
+/*
+  Fold the norms for a later block into the running total. A strict
+  comparison keeps the earliest worst index on ties, as the serial loop
+  would.
+*/
+inline void combine (Norms &total, const Norms &block)
+{
+  total.sum_ += block.sum_ ;
+  if (block.max_ > total.max_) {
+    total.max_ = block.max_ ;
+    total.worst_ = block.worst_ ;
+  }
+}
+
+/*
+  Dual infeasibility and complementary slackness for a variable with value
+  v in [lb,ub] and minimisation-form dual dual. A positive dual holds the
+  variable at its lower bound, a negative one at its upper bound.
+*/
+inline void dualChecks (double v, double lb, double ub, double dual,
+			Norms &dualInf, Norms &compSlack, int ndx)
+{
+  const double pos = std::max(dual,0.0) ;
+  const double neg = std::max(-dual,0.0) ;
+  double inf = 0.0 ;
+  double slack = 0.0 ;
+  if (lb > -infBound)
+    slack += std::fabs(v-lb)*pos ;
+  else
+    inf += pos ;
+  if (ub < infBound)
+    slack += std::fabs(ub-v)*neg ;
+  else
+    inf += neg ;
+  note(dualInf,inf,ndx) ;
+  note(compSlack,slack,ndx) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+SolutionVerifier::SolutionVerifier (int numThreads)
+  : numThreads_(numThreads),
+    minBlock_(1024)
+{
+  clearNorms(report_.rowInf_) ;
+  clearNorms(report_.colInf_) ;
+  clearNorms(report_.dualResidual_) ;
+  clearNorms(report_.dualInf_) ;
+  clearNorms(report_.compSlack_) ;
+  clearNorms(report_.activityErr_) ;
+  report_.objective_ = 0.0 ;
+}
+
+SolutionVerifier::~SolutionVerifier () { }
+
+int SolutionVerifier::verify (int m, int n, const CoinBigIndex *starts,
+			      const int *lengths, const int *indices,
+			      const double *elements, const double *obj,
+			      const double *collb, const double *colub,
+			      const double *rowlb, const double *rowub,
+			      const double *x, const double *y, const double *d,
+			      const double *reportedAct, double sense)
+{
+  const int colBlocks = numChunks(n,numThreads_,minBlock_) ;
+  const int rowBlocks = numChunks(m,numThreads_,minBlock_) ;
+  act_.resize(m) ;
+  partialAct_.resize(colBlocks) ;
+  colBlocks_.resize(colBlocks) ;
+  rowBlocks_.resize(rowBlocks) ;
+/*
+  Column pass. Each block scatters x(j)a(j) into its own activity array
+  (block 0 uses act_ directly) and computes the column measures, which need
+  only column j and y.
+*/
+  parallelFor(n,numThreads_,
+	      [&](int first, int last, int blk) {
+		std::vector<double> &mine = (blk == 0)?act_:partialAct_[blk] ;
+		mine.assign(m,0.0) ;
+		double *act = mine.data() ;
+		BlockNorms &norms = colBlocks_[blk] ;
+		clearNorms(norms.primalInf_) ;
+		clearNorms(norms.dualResidual_) ;
+		clearNorms(norms.dualInf_) ;
+		clearNorms(norms.compSlack_) ;
+		norms.objective_ = 0.0 ;
+		for (int j = first ; j < last ; j++) {
+		  const double xj = x[j] ;
+		  const CoinBigIndex end =
+		    starts[j]+((lengths)?lengths[j]:(starts[j+1]-starts[j])) ;
+		  double aty = 0.0 ;
+		  for (CoinBigIndex k = starts[j] ; k < end ; k++) {
+		    const int i = indices[k] ;
+		    act[i] += elements[k]*xj ;
+		    aty += elements[k]*y[i] ;
+		  }
+		  norms.objective_ += obj[j]*xj ;
+		  note(norms.dualResidual_,std::fabs(obj[j]-aty-d[j]),j) ;
+		  note(norms.primalInf_,
+		       std::max(0.0,std::max(collb[j]-xj,xj-colub[j])),j) ;
+		  dualChecks(xj,collb[j],colub[j],sense*d[j],
+			     norms.dualInf_,norms.compSlack_,j) ;
+		}
+	      },minBlock_) ;
+/*
+  Row pass. Sum the block activities in block order, then the row
+  measures.
+*/
+  parallelFor(m,numThreads_,
+	      [&](int first, int last, int blk) {
+		double *act = act_.data() ;
+		for (int b = 1 ; b < colBlocks ; b++) {
+		  const double *part = partialAct_[b].data() ;
+		  for (int i = first ; i < last ; i++) act[i] += part[i] ;
+		}
+		BlockNorms &norms = rowBlocks_[blk] ;
+		clearNorms(norms.primalInf_) ;
+		clearNorms(norms.dualInf_) ;
+		clearNorms(norms.compSlack_) ;
+		clearNorms(norms.activityErr_) ;
+		for (int i = first ; i < last ; i++) {
+		  const double ri = act[i] ;
+		  note(norms.primalInf_,
+		       std::max(0.0,std::max(rowlb[i]-ri,ri-rowub[i])),i) ;
+		  if (reportedAct)
+		    note(norms.activityErr_,std::fabs(ri-reportedAct[i]),i) ;
+		  dualChecks(ri,rowlb[i],rowub[i],sense*y[i],
+			     norms.dualInf_,norms.compSlack_,n+i) ;
+		}
+	      },minBlock_) ;
+/*
+  Combine in block order: columns first, then rows.
+*/
+  Report &rpt = report_ ;
+  clearNorms(rpt.rowInf_) ;
+  clearNorms(rpt.colInf_) ;
+  clearNorms(rpt.dualResidual_) ;
+  clearNorms(rpt.dualInf_) ;
+  clearNorms(rpt.compSlack_) ;
+  clearNorms(rpt.activityErr_) ;
+  rpt.objective_ = 0.0 ;
+  for (const BlockNorms &norms : colBlocks_) {
+    combine(rpt.colInf_,norms.primalInf_) ;
+    combine(rpt.dualResidual_,norms.dualResidual_) ;
+    combine(rpt.dualInf_,norms.dualInf_) ;
+    combine(rpt.compSlack_,norms.compSlack_) ;
+    rpt.objective_ += norms.objective_ ;
+  }
+  for (const BlockNorms &norms : rowBlocks_) {
+    combine(rpt.rowInf_,norms.primalInf_) ;
+    combine(rpt.dualInf_,norms.dualInf_) ;
+    combine(rpt.compSlack_,norms.compSlack_) ;
+    combine(rpt.activityErr_,norms.activityErr_) ;
+  }
+  return (0) ;
+}
+
+int SolutionVerifier::verify (ClpSimplexAPI &clp)
+{
+  const int m = clp.numberRows() ;
+  const int n = clp.numberColumns() ;
+  const double *x = clp.getColSolution() ;
+  const double *y = clp.getRowPrice() ;
+  const double *d = clp.getReducedCost() ;
+  if (x == nullptr || y == nullptr || d == nullptr) {
+    std::cout
+      << "SolutionVerifier: no solution available to verify." << std::endl ;
+    return (-1) ;
+  }
+  return (verify(m,n,clp.getVectorStarts(),clp.getVectorLengths(),
+		 clp.getIndices(),clp.getElements(),clp.objective(),
+		 clp.columnLower(),clp.columnUpper(),
+		 clp.rowLower(),clp.rowUpper(),x,y,d,
+		 clp.getRowActivity(),clp.objSense())) ;
+}
+
+bool SolutionVerifier::isAcceptable (double primalTol, double dualTol) const
+{
+  const double slackTol =
+    std::max(primalTol,dualTol)*std::max(1.0,std::fabs(report_.objective_)) ;
+  return (report_.rowInf_.max_ <= primalTol &&
+	  report_.colInf_.max_ <= primalTol &&
+	  report_.activityErr_.max_ <= primalTol &&
+	  report_.dualResidual_.max_ <= dualTol &&
+	  report_.dualInf_.max_ <= dualTol &&
+	  report_.compSlack_.max_ <= slackTol) ;
+}
+
+void SolutionVerifier::printReport (std::ostream &os) const
+{
+  const struct {
+    const char *name_ ;
+    const Norms *norms_ ;
+  } lines[] = {
+    { "row infeasibility", &report_.rowInf_ },
+    { "column infeasibility", &report_.colInf_ },
+    { "row activity error", &report_.activityErr_ },
+    { "dual residual", &report_.dualResidual_ },
+    { "dual infeasibility", &report_.dualInf_ },
+    { "complementary slackness", &report_.compSlack_ }
+  } ;
+  os << "Solution check: objective " << report_.objective_ << std::endl ;
+  for (const auto &line : lines) {
+    os
+      << "  " << line.name_ << ": max " << line.norms_->max_
+      << " (index " << line.norms_->worst_ << "), sum "
+      << line.norms_->sum_ << std::endl ;
+  }
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,164 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolutionVerifier.hpp
+    \brief Independent check of primal and dual solutions.
+*/
+#ifndef Osi2SolutionVerifier_HPP
+#define Osi2SolutionVerifier_HPP
+
+#include <iosfwd>
+#include <vector>
+
+#include "CoinTypes.h"
+
+namespace Osi2 {
+
+class ClpSimplexAPI ;
+
+/*! \brief Solution verifier
+
+  Recompute the quality measures of a primal/dual solution from the model
+  data alone, without trusting anything the solver computed internally.
+  The model is given as the column-major matrix (starts, lengths, indices,
+  elements, as returned by ClpSimplexAPI::getVectorStarts and friends),
+  objective, and bounds; the solution as x, row duals y and reduced costs
+  d. All checks are done in minimisation form.
+
+  Measures (each with max and sum norms, and the index of the worst entry):
+    - primal infeasibility of rows (Ax outside [rowlb,rowub]) and columns
+      (x outside [collb,colub]);
+    - dual residual |c - A'y - d| by column;
+    - dual infeasibility: a reduced cost or row dual with the wrong sign for
+      a bound that is infinite;
+    - complementary slackness: distance from bound times the dual that
+      holds the variable there, for columns and rows.
+  Row indices in the dual and complementary slackness measures are offset
+  by the number of columns.
+
+  The work is done in two parallel passes: one over column blocks (Ax is
+  accumulated into a private array per block; the column measures need
+  only the column), one over row blocks (block arrays summed in block
+  order, then the row measures). The result for a given number of threads
+  is reproducible; a different number of threads may change the sums in
+  the last bits.
+*/
+class SolutionVerifier {
+
+public:
+
+  /// Max and sum norms of one measure
+  struct Norms {
+    /// Largest entry
+    double max_ ;
+    /// Sum of entries
+    double sum_ ;
+    /// Index of the largest entry (-1 if all are zero)
+    int worst_ ;
+  } ;
+
+  /// All measures from one verification
+  struct Report {
+    /// Row activity outside row bounds
+    Norms rowInf_ ;
+    /// Column value outside column bounds
+    Norms colInf_ ;
+    /// |c - A'y - d|
+    Norms dualResidual_ ;
+    /// Dual values of the wrong sign for an infinite bound
+    Norms dualInf_ ;
+    /// Complementary slackness violation
+    Norms compSlack_ ;
+    /// Difference between recomputed and reported row activity
+    Norms activityErr_ ;
+    /// Objective c'x (in the problem's own sense)
+    double objective_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  SolutionVerifier (int numThreads = 1) ;
+  /// Destructor
+  ~SolutionVerifier () ;
+  //@}
+
+  /// Number of threads
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /*! \brief Fewest columns (rows) in a block
+
+    Smaller blocks aren't worth a thread. The default is 1024.
+  */
+  inline void setMinBlock (int minBlock) { minBlock_ = minBlock ; }
+
+  /*! \brief Verify a solution given as arrays
+
+    \p lengths may be null if the matrix has no gaps. \p reportedAct, the
+    row activity reported by the solver, may be null, in which case
+    Report::activityErr_ is zero. \p sense is 1 for minimisation, -1 for
+    maximisation. Returns 0.
+  */
+  int verify (int m, int n, const CoinBigIndex *starts, const int *lengths,
+	      const int *indices, const double *elements,
+	      const double *obj, const double *collb, const double *colub,
+	      const double *rowlb, const double *rowub,
+	      const double *x, const double *y, const double *d,
+	      const double *reportedAct = nullptr, double sense = 1.0) ;
+
+  /*! \brief Verify the current solution of a ClpSimplexAPI object
+
+    Returns -1 if the object has no solution to check, 0 otherwise.
+  */
+  int verify (ClpSimplexAPI &clp) ;
+
+  /// Report from the last verification
+  inline const Report &getReport () const { return (report_) ; }
+
+  /// Recomputed row activity Ax from the last verification
+  inline const double *getRowActivity () const { return (act_.data()) ; }
+
+  /*! \brief True if every max norm is within tolerance
+
+    Primal measures are compared to \p primalTol, dual measures to
+    \p dualTol; complementary slackness is compared to the larger of the
+    two, scaled by the larger of 1 and |objective|.
+  */
+  bool isAcceptable (double primalTol = 1.0e-6, double dualTol = 1.0e-6) const ;
+
+  /// Print the report
+  void printReport (std::ostream &os) const ;
+
+private:
+
+  /// Measures accumulated by one block of columns or rows
+  struct BlockNorms {
+    Norms primalInf_ ;
+    Norms dualResidual_ ;
+    Norms dualInf_ ;
+    Norms compSlack_ ;
+    Norms activityErr_ ;
+    double objective_ ;
+  } ;
+
+  /// Number of threads
+  int numThreads_ ;
+  /// Fewest columns (rows) per block
+  int minBlock_ ;
+  /// Report
+  Report report_ ;
+  /// Recomputed row activity
+  std::vector<double> act_ ;
+  /// Per-block partial row activity (blocks after the first)
+  std::vector<std::vector<double> > partialAct_ ;
+  /// Per-block measures, column pass
+  std::vector<BlockNorms> colBlocks_ ;
+  /// Per-block measures, row pass
+  std::vector<BlockNorms> rowBlocks_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
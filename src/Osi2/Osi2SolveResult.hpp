@@ -0,0 +1,197 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolveResult.hpp
+    \brief A value type that holds a snapshot of a solution.
+
+  Osi2::SolveResult is filled in a single call by an API that supports bulk
+  solution export (e.g., ClpSimplexAPI::fetchResult). It owns its buffers and
+  is intended to be reused across a sequence of solves; buffers are resized
+  only when the problem grows, so steady-state reuse does not allocate.
+*/
+#ifndef Osi2SolveResult_HPP
+#define Osi2SolveResult_HPP
+
+#include <vector>
+
+namespace Osi2 {
+
+/*! \brief Snapshot of the status and solution of a solved problem
+
+  A SolveResult is a plain value: it can be copied, moved, and stored in
+  standard containers. Which parts are valid is recorded in a field mask; use
+  #has to check before using a particular field. Vectors that were not
+  requested in the most recent fetch are not touched (and not freed), so a
+  result object can be used to fetch different subsets without churning
+  memory.
+
+  The vector accessors return nullptr if the corresponding field is not
+  valid.
+*/
+class SolveResult {
+
+public:
+
+  /*! \brief Fields that can be requested from a fetch
+
+    Combine with bitwise or. The status field includes primary and secondary
+    status and the iteration count.
+  */
+  enum Field {
+    statusField = 0x01,
+    objectiveField = 0x02,
+    colSolutionField = 0x04,
+    rowActivityField = 0x08,
+    rowPriceField = 0x10,
+    reducedCostField = 0x20,
+    primalFields = statusField|objectiveField|colSolutionField|rowActivityField,
+    dualFields = rowPriceField|reducedCostField,
+    allFields = 0x3f
+  } ;
+
+  /*! \name Constructors, destructor, and copy */
+  //@{
+  /// Default constructor; nothing is valid.
+  SolveResult ()
+    : fields_(0),
+      status_(-1),
+      secondaryStatus_(0),
+      iterations_(0),
+      objValue_(0.0),
+      numRows_(0),
+      numCols_(0)
+  { }
+
+  /// Copy constructor
+  SolveResult (const SolveResult &rhs) = default ;
+  /// Move constructor
+  SolveResult (SolveResult &&rhs) = default ;
+  /// Copy assignment
+  SolveResult &operator= (const SolveResult &rhs) = default ;
+  /// Move assignment
+  SolveResult &operator= (SolveResult &&rhs) = default ;
+
+  /// Destructor
+  ~SolveResult () { }
+  //@}
+
+  /*! \name Status and scalar information */
+  //@{
+  /// Mask of valid fields
+  inline unsigned int fields () const { return (fields_) ; }
+  /// True if all fields in the mask \p which are valid
+  inline bool has (unsigned int which) const
+  { return ((fields_&which) == which) ; }
+
+  /// Primary status (see ClpSimplexAPI::status)
+  inline int status () const { return (status_) ; }
+  /// Secondary status (see ClpSimplexAPI::secondaryStatus)
+  inline int secondaryStatus () const { return (secondaryStatus_) ; }
+  /// Iteration count of the solve that produced this result
+  inline int iterations () const { return (iterations_) ; }
+  /// Objective value
+  inline double objectiveValue () const { return (objValue_) ; }
+
+  /// Number of rows in the problem when the result was fetched
+  inline int getNumRows () const { return (numRows_) ; }
+  /// Number of columns in the problem when the result was fetched
+  inline int getNumCols () const { return (numCols_) ; }
+  //@}
+
+  /*! \name Solution vectors */
+  //@{
+  /// Primal column solution
+  inline const double *getColSolution () const
+  { return (vecOrNull(colSolution_,colSolutionField)) ; }
+  /// Primal row activity
+  inline const double *getRowActivity () const
+  { return (vecOrNull(rowActivity_,rowActivityField)) ; }
+  /// Dual row solution
+  inline const double *getRowPrice () const
+  { return (vecOrNull(rowPrice_,rowPriceField)) ; }
+  /// Dual column solution (reduced costs)
+  inline const double *getReducedCost () const
+  { return (vecOrNull(reducedCost_,reducedCostField)) ; }
+  //@}
+
+  /*! \name Methods used by an API to fill the result
+
+    Call #startFill at the top of a fetch, then the setters for the requested
+    fields. The buffer methods size the buffer, mark the field valid, and
+    return a pointer to the storage for the API to fill.
+  */
+  //@{
+  /// Invalidate all fields and record the problem size
+  inline void startFill (int numRows, int numCols)
+  { fields_ = 0 ; numRows_ = numRows ; numCols_ = numCols ; }
+
+  /// Set status information
+  inline void setStatus (int status, int secondaryStatus, int iterations)
+  { status_ = status ;
+    secondaryStatus_ = secondaryStatus ;
+    iterations_ = iterations ;
+    fields_ |= statusField ; }
+
+  /// Set the objective value
+  inline void setObjectiveValue (double objValue)
+  { objValue_ = objValue ; fields_ |= objectiveField ; }
+
+  /// Buffer for the primal column solution
+  inline double *colSolutionBuffer ()
+  { return (prepBuffer(colSolution_,numCols_,colSolutionField)) ; }
+  /// Buffer for the primal row activity
+  inline double *rowActivityBuffer ()
+  { return (prepBuffer(rowActivity_,numRows_,rowActivityField)) ; }
+  /// Buffer for the dual row solution
+  inline double *rowPriceBuffer ()
+  { return (prepBuffer(rowPrice_,numRows_,rowPriceField)) ; }
+  /// Buffer for the dual column solution
+  inline double *reducedCostBuffer ()
+  { return (prepBuffer(reducedCost_,numCols_,reducedCostField)) ; }
+  //@}
+
+private:
+
+  /// Size a buffer (keeping capacity) and mark its field valid
+  inline double *prepBuffer (std::vector<double> &vec, int len,
+			     Field field)
+  { vec.resize(len) ;
+    fields_ |= field ;
+    return (vec.data()) ; }
+
+  /// Return the vector's storage if the field is valid, else nullptr
+  inline const double *vecOrNull (const std::vector<double> &vec,
+				  Field field) const
+  { return ((fields_&field)?vec.data():nullptr) ; }
+
+  /// Mask of valid fields
+  unsigned int fields_ ;
+  /// Primary status
+  int status_ ;
+  /// Secondary status
+  int secondaryStatus_ ;
+  /// Iteration count
+  int iterations_ ;
+  /// Objective value
+  double objValue_ ;
+  /// Number of rows
+  int numRows_ ;
+  /// Number of columns
+  int numCols_ ;
+
+  /// Primal column solution
+  std::vector<double> colSolution_ ;
+  /// Primal row activity
+  std::vector<double> rowActivity_ ;
+  /// Dual row solution
+  std::vector<double> rowPrice_ ;
+  /// Reduced costs
+  std::vector<double> reducedCost_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,247 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::SolverClient.
+*/
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Osi2Config.h"
+
+#include "Osi2SocketIO.hpp"
+#include "Osi2SolverDaemon.hpp"
+#include "Osi2SolverClient.hpp"
+
+namespace {
+
+/// Set \p id to \p val in \p params, replacing any earlier value
+template <class T>
+void setPair (std::vector<std::pair<std::string,T> > &params,
+	      const std::string &id, const T &val)
+{
+  for (std::pair<std::string,T> &param : params) {
+    if (param.first == id) {
+      param.second = val ;
+      return ;
+    }
+  }
+  params.push_back(std::make_pair(id,val)) ;
+}
+
+/// Send one setting: type, name, value
+template <class T>
+int sendSetting (int sock, int type, const std::pair<std::string,T> &param)
+{
+  if (Osi2::sendAll(sock,&type,sizeof(type)) != 0 ||
+      Osi2::sendStr(sock,param.first) != 0)
+    return (-1) ;
+  return (Osi2::sendAll(sock,&param.second,sizeof(T))) ;
+}
+
+int sendSetting (int sock, int type,
+		 const std::pair<std::string,std::string> &param)
+{
+  if (Osi2::sendAll(sock,&type,sizeof(type)) != 0 ||
+      Osi2::sendStr(sock,param.first) != 0)
+    return (-1) ;
+  return (Osi2::sendStr(sock,param.second)) ;
+}
+
+/// Send \p len doubles from \p vec if it's not null
+int sendOpt (int sock, const double *vec, int len)
+{
+  return ((vec)?Osi2::sendVec(sock,vec,len):0) ;
+}
+
+/// Receive \p len doubles into \p buf
+int recvInto (int sock, double *buf, int len)
+{
+  return (Osi2::recvAll(sock,buf,len*sizeof(double))) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+SolverClient::SolverClient ()
+  : sock_(-1)
+{ }
+
+SolverClient::~SolverClient ()
+{
+  disconnect() ;
+}
+
+int SolverClient::connect (const std::string &path)
+{
+  disconnect() ;
+  struct sockaddr_un addr ;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cout
+      << "SolverClient::connect: socket path " << path << " is too long."
+      << std::endl ;
+    return (-1) ;
+  }
+  std::memset(&addr,0,sizeof(addr)) ;
+  addr.sun_family = AF_UNIX ;
+  std::strcpy(addr.sun_path,path.c_str()) ;
+  sock_ = ::socket(AF_UNIX,SOCK_STREAM,0) ;
+  if (sock_ < 0 ||
+      ::connect(sock_,reinterpret_cast<struct sockaddr *>(&addr),
+		sizeof(addr)) != 0) {
+    std::cout
+      << "SolverClient::connect: cannot connect to " << path << ": "
+      << std::strerror(errno) << "." << std::endl ;
+    disconnect() ;
+    return (-1) ;
+  }
+  return (0) ;
+}
+
+void SolverClient::disconnect ()
+{
+  if (sock_ >= 0) ::close(sock_) ;
+  sock_ = -1 ;
+}
+
+int SolverClient::lost ()
+{
+  std::cout << "SolverClient: lost the connection to the daemon." << std::endl ;
+  disconnect() ;
+  return (-1) ;
+}
+
+int SolverClient::createObject (int &handle, const std::string &apiName,
+				const std::string *shortName)
+{
+  handle = 0 ;
+  if (sock_ < 0) return (-1) ;
+  SolverDaemon::Request req ;
+  std::memset(&req,0,sizeof(req)) ;
+  req.op_ = SolverDaemon::opCreate ;
+  SolverDaemon::Reply reply ;
+  if (sendAll(sock_,&req,sizeof(req)) != 0 ||
+      sendStr(sock_,apiName) != 0 ||
+      sendStr(sock_,(shortName)?*shortName:std::string()) != 0 ||
+      recvAll(sock_,&reply,sizeof(reply)) != 0)
+    return (lost()) ;
+  if (reply.retval_ != 0) return (-1) ;
+  handle = reply.handle_ ;
+  return (0) ;
+}
+
+int SolverClient::destroyObject (int &handle)
+{
+  if (sock_ < 0) return (-1) ;
+  SolverDaemon::Request req ;
+  std::memset(&req,0,sizeof(req)) ;
+  req.op_ = SolverDaemon::opDestroy ;
+  req.handle_ = handle ;
+  SolverDaemon::Reply reply ;
+  if (sendAll(sock_,&req,sizeof(req)) != 0 ||
+      recvAll(sock_,&reply,sizeof(reply)) != 0)
+    return (lost()) ;
+  handle = 0 ;
+  return (reply.retval_) ;
+}
+
+int SolverClient::solve (int handle, const Model &model, SolveResult &result,
+			 SolverHost::Method method, unsigned int fields)
+{
+  if (sock_ < 0) return (-1) ;
+  const int m = model.numRows_ ;
+  const int n = model.numCols_ ;
+  SolverDaemon::Request req ;
+  std::memset(&req,0,sizeof(req)) ;
+  req.op_ = SolverDaemon::opSolve ;
+  req.handle_ = handle ;
+  req.method_ = method ;
+  req.fields_ = fields ;
+  req.numRows_ = m ;
+  req.numCols_ = n ;
+  req.numElements_ = model.starts_[n] ;
+  req.present_ =
+    ((model.colLower_)?SolverDaemon::colLowerPresent:0)|
+    ((model.colUpper_)?SolverDaemon::colUpperPresent:0)|
+    ((model.obj_)?SolverDaemon::objPresent:0)|
+    ((model.rowLower_)?SolverDaemon::rowLowerPresent:0)|
+    ((model.rowUpper_)?SolverDaemon::rowUpperPresent:0) ;
+  req.objSense_ = model.objSense_ ;
+  req.numSettings_ = static_cast<int>(intParams_.size()+dblParams_.size()+
+				      strParams_.size()) ;
+  if (sendAll(sock_,&req,sizeof(req)) != 0 ||
+      sendVec(sock_,model.starts_,n+1) != 0 ||
+      sendVec(sock_,model.indices_,req.numElements_) != 0 ||
+      sendVec(sock_,model.elements_,req.numElements_) != 0 ||
+      sendOpt(sock_,model.colLower_,n) != 0 ||
+      sendOpt(sock_,model.colUpper_,n) != 0 ||
+      sendOpt(sock_,model.obj_,n) != 0 ||
+      sendOpt(sock_,model.rowLower_,m) != 0 ||
+      sendOpt(sock_,model.rowUpper_,m) != 0)
+    return (lost()) ;
+  for (const std::pair<std::string,int> &param : intParams_)
+    if (sendSetting(sock_,SolverDaemon::intSetting,param) != 0)
+      return (lost()) ;
+  for (const std::pair<std::string,double> &param : dblParams_)
+    if (sendSetting(sock_,SolverDaemon::dblSetting,param) != 0)
+      return (lost()) ;
+  for (const std::pair<std::string,std::string> &param : strParams_)
+    if (sendSetting(sock_,SolverDaemon::strSetting,param) != 0)
+      return (lost()) ;
+/*
+  The reply header says which vectors follow.
+*/
+  SolverDaemon::Reply reply ;
+  if (recvAll(sock_,&reply,sizeof(reply)) != 0) return (lost()) ;
+  result.startFill(reply.numRows_,reply.numCols_) ;
+  const unsigned int got = reply.fields_ ;
+  if (got&SolveResult::statusField)
+    result.setStatus(reply.status_,reply.secondaryStatus_,reply.iterations_) ;
+  if (got&SolveResult::objectiveField)
+    result.setObjectiveValue(reply.objValue_) ;
+  if (((got&SolveResult::colSolutionField) &&
+       recvInto(sock_,result.colSolutionBuffer(),reply.numCols_) != 0) ||
+      ((got&SolveResult::rowActivityField) &&
+       recvInto(sock_,result.rowActivityBuffer(),reply.numRows_) != 0) ||
+      ((got&SolveResult::rowPriceField) &&
+       recvInto(sock_,result.rowPriceBuffer(),reply.numRows_) != 0) ||
+      ((got&SolveResult::reducedCostField) &&
+       recvInto(sock_,result.reducedCostBuffer(),reply.numCols_) != 0))
+    return (lost()) ;
+  return (reply.retval_) ;
+}
+
+void SolverClient::setIntParam (const std::string &id, int val)
+{
+  setPair(intParams_,id,val) ;
+}
+
+void SolverClient::setDblParam (const std::string &id, double val)
+{
+  setPair(dblParams_,id,val) ;
+}
+
+void SolverClient::setStrParam (const std::string &id, const std::string &val)
+{
+  setPair(strParams_,id,val) ;
+}
+
+void SolverClient::clearParams ()
+{
+  intParams_.clear() ;
+  dblParams_.clear() ;
+  strParams_.clear() ;
+}
+
+}  // end namespace Osi2
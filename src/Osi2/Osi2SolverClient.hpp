@@ -0,0 +1,143 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolverClient.hpp
+    \brief Client for Osi2::SolverDaemon.
+*/
+#ifndef Osi2SolverClient_HPP
+#define Osi2SolverClient_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2SolveResult.hpp"
+#include "Osi2SolverHost.hpp"
+
+namespace Osi2 {
+
+/*! \brief Client for a solver daemon
+
+  Talks to a SolverDaemon over its Unix-domain socket. It loads no plugin
+  libraries and creates no solver objects of its own: #createObject asks
+  the daemon for a handle, and #solve ships a model to the daemon and
+  brings back the solution. A handle carries the basis of its last solve
+  from one solve to the next.
+
+  Settings made with #setIntParam, #setDblParam, and #setStrParam are sent
+  with every solve until #clearParams. The names are those of the solver's
+  RunParamsAPI parameters.
+
+  A client is not safe to use from several threads at once; use one client
+  per thread.
+*/
+class SolverClient {
+
+public:
+
+  /*! \brief A model, in the form loadProblem takes
+
+    The matrix is column-major and packed: column j's coefficients are
+    entries starts_[j] to starts_[j+1]-1. Any of the bound and objective
+    arrays may be null, meaning the loadProblem defaults.
+  */
+  struct Model {
+    Model ()
+      : numRows_(0), numCols_(0),
+	starts_(nullptr), indices_(nullptr), elements_(nullptr),
+	colLower_(nullptr), colUpper_(nullptr), obj_(nullptr),
+	rowLower_(nullptr), rowUpper_(nullptr),
+	objSense_(1.0)
+    { }
+    int numRows_ ;
+    int numCols_ ;
+    const CoinBigIndex *starts_ ;
+    const int *indices_ ;
+    const double *elements_ ;
+    const double *colLower_ ;
+    const double *colUpper_ ;
+    const double *obj_ ;
+    const double *rowLower_ ;
+    const double *rowUpper_ ;
+    /// 1 to minimise, -1 to maximise
+    double objSense_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  SolverClient () ;
+  /// Destructor; disconnects
+  ~SolverClient () ;
+  //@}
+
+  /*! \name Connection */
+  //@{
+  /// Connect to the daemon listening on \p path; -1 on error, 0 otherwise
+  int connect (const std::string &path) ;
+  /// Disconnect; the daemon forgets this client's handles
+  void disconnect () ;
+  /// Connected?
+  inline bool isConnected () const { return (sock_ >= 0) ; }
+  //@}
+
+  /*! \name Objects and solves
+
+    Any failure to talk to the daemon disconnects the client.
+  */
+  //@{
+  /*! \brief Get a handle for an object of the specified API
+
+    As ControlAPI::createObject. The daemon supplies only ClpSimplexAPI
+    objects, from the library it was opened with. Returns -1 on error, 0 if
+    \p handle is valid.
+  */
+  int createObject (int &handle, const std::string &apiName,
+		    const std::string *shortName = nullptr) ;
+  /// Release \p handle; -1 on error, 0 otherwise. \p handle is set to 0.
+  int destroyObject (int &handle) ;
+  /*! \brief Solve \p model with handle \p handle
+
+    \p fields (see SolveResult::Field) says which parts of the solution to
+    return in \p result. Returns -1 on error, 1 if the daemon refused the
+    request because it is busy, otherwise the daemon's fetchResult return
+    value (0 if all requested fields were filled).
+  */
+  int solve (int handle, const Model &model, SolveResult &result,
+	     SolverHost::Method method = SolverHost::initialSolveMethod,
+	     unsigned int fields = SolveResult::allFields) ;
+  //@}
+
+  /*! \name Settings */
+  //@{
+  /// Set an integer parameter for the following solves
+  void setIntParam (const std::string &id, int val) ;
+  /// Set a double parameter for the following solves
+  void setDblParam (const std::string &id, double val) ;
+  /// Set a string parameter for the following solves
+  void setStrParam (const std::string &id, const std::string &val) ;
+  /// Go back to the solver's defaults
+  void clearParams () ;
+  //@}
+
+private:
+
+  /// Disconnect and return -1
+  int lost () ;
+
+  /// Socket; -1 if not connected
+  int sock_ ;
+  /// Settings
+  std::vector<std::pair<std::string,int> > intParams_ ;
+  std::vector<std::pair<std::string,double> > dblParams_ ;
+  std::vector<std::pair<std::string,std::string> > strParams_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
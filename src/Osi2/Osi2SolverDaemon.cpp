@@ -0,0 +1,794 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for
+  Osi2::SolverDaemon.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2RunParamsAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2SocketIO.hpp"
+#include "Osi2SolverDaemon.hpp"
+
+namespace {
+
+/// Most bytes read from one connection in one pass of serve
+const size_t maxReadPerPass = 1<<20 ;
+
+/*
+  A cursor over the bytes received on a connection. Each take fails,
+  moving nothing, if the bytes asked for haven't all arrived.
+*/
+class Cursor {
+public:
+  Cursor (const std::vector<char> &buf, size_t pos)
+    : buf_(buf), pos_(pos)
+  { }
+  inline size_t pos () const { return (pos_) ; }
+  /// Copy \p len bytes to \p dst (if not null) and move past them
+  bool take (void *dst, size_t len)
+  { if (buf_.size()-pos_ < len) return (false) ;
+    if (dst != nullptr && len > 0) std::memcpy(dst,&buf_[pos_],len) ;
+    pos_ += len ;
+    return (true) ; }
+  /// Take a string sent by sendStr; the caller has checked it's all there
+  void takeStr (std::string &str)
+  { int len ;
+    take(&len,sizeof(len)) ;
+    str.assign(buf_.data()+pos_,len) ;
+    pos_ += len ; }
+  /// Take \p len elements into \p vec, resizing it
+  template <class T>
+  bool takeVec (std::vector<T> &vec, size_t len)
+  { vec.resize(len) ;
+    return (take((len > 0)?vec.data():nullptr,len*sizeof(T))) ; }
+private:
+  const std::vector<char> &buf_ ;
+  size_t pos_ ;
+} ;
+
+/*
+  Find the length of the request at the front of \p in without taking
+  anything from it. Returns 1 and sets \p len if the whole request is
+  there, 0 if more must arrive, -1 if the request is malformed or bigger
+  than \p limits allow. Only counts and string lengths are read, so a
+  request is sized before any memory is set aside for it.
+*/
+int measureRequest (Cursor in, const Osi2::SolverDaemon::Limits &limits,
+		    size_t &len)
+{
+  typedef Osi2::SolverDaemon SD ;
+  const size_t start = in.pos() ;
+  SD::Request hdr ;
+  if (!in.take(&hdr,sizeof(hdr))) return (0) ;
+  int strLen ;
+  switch (hdr.op_) {
+    case SD::opCreate:
+    { for (int k = 0 ; k < 2 ; k++) {
+	if (!in.take(&strLen,sizeof(strLen))) return (0) ;
+	if (strLen < 0 || strLen > limits.maxStrLen_) return (-1) ;
+	if (!in.take(nullptr,strLen)) return (0) ;
+      }
+      break ; }
+    case SD::opDestroy:
+    { break ; }
+    case SD::opSolve:
+    { if (hdr.numRows_ < 0 || hdr.numRows_ > limits.maxRows_ ||
+	  hdr.numCols_ < 0 || hdr.numCols_ > limits.maxCols_ ||
+	  hdr.numElements_ < 0 || hdr.numElements_ > limits.maxElements_ ||
+	  hdr.numSettings_ < 0 || hdr.numSettings_ > limits.maxSettings_)
+	return (-1) ;
+      const size_t m = hdr.numRows_ ;
+      const size_t n = hdr.numCols_ ;
+      const size_t nz = hdr.numElements_ ;
+      size_t arrays =
+	  (n+1)*sizeof(CoinBigIndex)+nz*(sizeof(int)+sizeof(double)) ;
+      const unsigned int present = hdr.present_ ;
+      if (present&SD::colLowerPresent) arrays += n*sizeof(double) ;
+      if (present&SD::colUpperPresent) arrays += n*sizeof(double) ;
+      if (present&SD::objPresent) arrays += n*sizeof(double) ;
+      if (present&SD::rowLowerPresent) arrays += m*sizeof(double) ;
+      if (present&SD::rowUpperPresent) arrays += m*sizeof(double) ;
+      if (!in.take(nullptr,arrays)) return (0) ;
+      for (int k = 0 ; k < hdr.numSettings_ ; k++) {
+	int type ;
+	if (!in.take(&type,sizeof(type)) || !in.take(&strLen,sizeof(strLen)))
+	  return (0) ;
+	if (strLen < 0 || strLen > limits.maxStrLen_) return (-1) ;
+	if (!in.take(nullptr,strLen)) return (0) ;
+	if (type == SD::intSetting) {
+	  if (!in.take(nullptr,sizeof(int))) return (0) ;
+	} else if (type == SD::dblSetting) {
+	  if (!in.take(nullptr,sizeof(double))) return (0) ;
+	} else if (type == SD::strSetting) {
+	  if (!in.take(&strLen,sizeof(strLen))) return (0) ;
+	  if (strLen < 0 || strLen > limits.maxStrLen_) return (-1) ;
+	  if (!in.take(nullptr,strLen)) return (0) ;
+	} else {
+	  return (-1) ;
+	}
+      }
+      break ; }
+    default:
+    { return (-1) ; }
+  }
+  len = in.pos()-start ;
+  return (1) ;
+}
+
+/// Take \p len doubles if \p bit is set in \p present
+void takeOpt (Cursor &in, unsigned int present, unsigned int bit,
+	      std::vector<double> &vec, int len)
+{
+  if (present&bit)
+    in.takeVec(vec,len) ;
+  else
+    vec.clear() ;
+}
+
+/// The array, or null if it wasn't sent
+inline const double *optPtr (const std::vector<double> &vec)
+{
+  return ((vec.empty())?nullptr:vec.data()) ;
+}
+
+/*
+  Check that a matrix from a client is well formed: packed, column starts
+  in order, row indices in range. Anything else could take the daemon down
+  in loadProblem.
+*/
+bool validMatrix (int m, int n, CoinBigIndex nz,
+		  const std::vector<CoinBigIndex> &starts,
+		  const std::vector<int> &indices)
+{
+  if (starts[0] != 0 || starts[n] != nz) return (false) ;
+  for (int j = 0 ; j < n ; j++)
+    if (starts[j+1] < starts[j]) return (false) ;
+  for (CoinBigIndex k = 0 ; k < nz ; k++)
+    if (indices[k] < 0 || indices[k] >= m) return (false) ;
+  return (true) ;
+}
+
+/// Make \p fd non-blocking; 0 on success, -1 otherwise
+int setNonBlocking (int fd)
+{
+  const int flags = ::fcntl(fd,F_GETFL) ;
+  if (flags < 0) return (-1) ;
+  return ((::fcntl(fd,F_SETFL,flags|O_NONBLOCK) == 0)?0:-1) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+SolverDaemon::SolverDaemon (ControlAPI &ctrl, int poolSize)
+  : ctrl_(ctrl),
+    poolObjs_(std::max(poolSize,1),nullptr),
+    pool_(std::max(poolSize,1),nullptr),
+    dirty_(std::max(poolSize,1),0),
+    shortName_(),
+    runParams_(nullptr),
+    maxQueued_(64),
+    numRefused_(0),
+    limits_(),
+    numBatches_(0),
+    largestBatch_(0),
+    path_(),
+    listenSock_(-1),
+    stopping_(false),
+    nextHandle_(1)
+{
+  wake_[0] = -1 ;
+  wake_[1] = -1 ;
+}
+
+SolverDaemon::~SolverDaemon ()
+{
+  close() ;
+}
+
+int SolverDaemon::open (const std::string &path, const std::string *shortName)
+{
+  if (shortName != nullptr) shortName_ = *shortName ;
+/*
+  Create and warm up the pool.
+*/
+  for (size_t k = 0 ; k < pool_.size() ; k++) {
+    if (ctrl_.createObject(poolObjs_[k],ClpSimplexAPI::getAPIIDString(),
+			   shortName) < 0 || poolObjs_[k] == nullptr) {
+      std::cout
+	<< "SolverDaemon::open: failed to create solver " << k << "."
+	<< std::endl ;
+      close() ;
+      return (-1) ;
+    }
+    pool_[k] = static_cast<ClpSimplexAPI *>
+	(poolObjs_[k]->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+    pool_[k]->setLogLevel(0) ;
+    dirty_[k] = 0 ;
+  }
+/*
+  Capture the default settings.
+*/
+  dfltInts_.clear() ;
+  dfltDbls_.clear() ;
+  dfltStrs_.clear() ;
+  if (runParams_ != nullptr) {
+    pool_[0]->exposeParams(*runParams_) ;
+    for (const std::string &id : runParams_->getIntParamIds())
+      dfltInts_.push_back(std::make_pair(id,runParams_->getIntParam(id))) ;
+    for (const std::string &id : runParams_->getDblParamIds())
+      dfltDbls_.push_back(std::make_pair(id,runParams_->getDblParam(id))) ;
+    for (const std::string &id : runParams_->getStrParamIds())
+      dfltStrs_.push_back(std::make_pair(id,runParams_->getStrParam(id))) ;
+  }
+/*
+  Open the socket. Both ends of the wake pipe are non-blocking, so neither
+  draining it nor poking it can stall.
+*/
+  struct sockaddr_un addr ;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cout
+      << "SolverDaemon::open: socket path " << path << " is too long."
+      << std::endl ;
+    close() ;
+    return (-1) ;
+  }
+  std::memset(&addr,0,sizeof(addr)) ;
+  addr.sun_family = AF_UNIX ;
+  std::strcpy(addr.sun_path,path.c_str()) ;
+  ::unlink(path.c_str()) ;
+  listenSock_ = ::socket(AF_UNIX,SOCK_STREAM,0) ;
+  if (listenSock_ < 0 ||
+      ::bind(listenSock_,reinterpret_cast<struct sockaddr *>(&addr),
+	     sizeof(addr)) != 0 ||
+      ::listen(listenSock_,SOMAXCONN) != 0 ||
+      ::pipe(wake_) != 0 ||
+      setNonBlocking(wake_[0]) != 0 || setNonBlocking(wake_[1]) != 0) {
+    std::cout
+      << "SolverDaemon::open: cannot listen on " << path << ": "
+      << std::strerror(errno) << "." << std::endl ;
+    close() ;
+    return (-1) ;
+  }
+  path_ = path ;
+  stopping_ = false ;
+  return (0) ;
+}
+
+/*
+  Each pass waits for activity (or, when requests are queued, just looks),
+  moves whatever input and output is ready, then runs one batch from the
+  front of the queue.
+*/
+int SolverDaemon::serve ()
+{
+  if (listenSock_ < 0) {
+    std::cout << "SolverDaemon::serve: daemon is not open." << std::endl ;
+    return (-1) ;
+  }
+  std::vector<Pending> batch ;
+  while (!stopping_) {
+    if (pollConnections((queue_.empty())?-1:0) != 0) return (-1) ;
+    if (stopping_) break ;
+    if (!queue_.empty()) {
+      batch.clear() ;
+      while (!queue_.empty() && batch.size() < pool_.size()) {
+	batch.push_back(std::move(queue_.front())) ;
+	queue_.pop_front() ;
+      }
+      numBatches_++ ;
+      largestBatch_ =
+	std::max(largestBatch_,static_cast<int>(batch.size())) ;
+      runBatch(batch) ;
+    }
+  }
+  stopping_ = false ;
+  return (0) ;
+}
+
+/*
+  Connections with replies still to go are watched for POLLOUT as well as
+  POLLIN. A poke on the wake pipe only interrupts the wait.
+*/
+int SolverDaemon::pollConnections (int timeoutMs)
+{
+  std::vector<struct pollfd> fds ;
+  struct pollfd pfd ;
+  pfd.events = POLLIN ;
+  pfd.revents = 0 ;
+  pfd.fd = wake_[0] ;
+  fds.push_back(pfd) ;
+  pfd.fd = listenSock_ ;
+  fds.push_back(pfd) ;
+  for (const std::pair<const int,Conn> &conn : conns_) {
+    pfd.fd = conn.first ;
+    pfd.events = POLLIN ;
+    if (conn.second.outPos_ < conn.second.out_.size()) pfd.events |= POLLOUT ;
+    fds.push_back(pfd) ;
+  }
+  const int ready = ::poll(fds.data(),fds.size(),timeoutMs) ;
+  if (ready < 0) {
+    if (errno == EINTR) return (0) ;
+    std::cout
+      << "SolverDaemon: poll failed: " << std::strerror(errno) << "."
+      << std::endl ;
+    return (-1) ;
+  }
+  if (fds[0].revents) {
+    char buf[16] ;
+    while (::read(wake_[0],buf,sizeof(buf)) > 0) ;
+    return (0) ;
+  }
+  if (fds[1].revents&POLLIN) {
+    const int sock = ::accept(listenSock_,nullptr,nullptr) ;
+    if (sock >= 0) conns_[sock] ;
+  }
+  for (size_t k = 2 ; k < fds.size() ; k++) {
+    const short revents = fds[k].revents ;
+    const int sock = fds[k].fd ;
+    if (revents == 0) continue ;
+    if ((revents&POLLOUT) && writeOutput(sock) != 0) {
+      dropConnection(sock) ;
+      continue ;
+    }
+    if ((revents&~POLLOUT) && readInput(sock) != 0) dropConnection(sock) ;
+  }
+  return (0) ;
+}
+
+int SolverDaemon::waitForQueued (int numReqs, int timeoutMs)
+{
+  if (listenSock_ < 0) return (-1) ;
+  typedef std::chrono::steady_clock Clock ;
+  const Clock::time_point deadline =
+      Clock::now()+std::chrono::milliseconds(timeoutMs) ;
+  while (static_cast<int>(queue_.size()) < numReqs) {
+    const long left = static_cast<long>
+      (std::chrono::duration_cast<std::chrono::milliseconds>
+	  (deadline-Clock::now()).count()) ;
+    if (left <= 0 || pollConnections(static_cast<int>(left)) != 0)
+      return (-1) ;
+  }
+  return (0) ;
+}
+
+void SolverDaemon::shutdown ()
+{
+  stopping_ = true ;
+  if (wake_[1] >= 0) {
+    const char poke = 0 ;
+    if (::write(wake_[1],&poke,1) < 0) return ;
+  }
+}
+
+void SolverDaemon::close ()
+{
+  for (const std::pair<const int,Conn> &conn : conns_)
+    ::close(conn.first) ;
+  conns_.clear() ;
+  queue_.clear() ;
+  handles_.clear() ;
+  if (listenSock_ >= 0) {
+    ::close(listenSock_) ;
+    ::unlink(path_.c_str()) ;
+  }
+  listenSock_ = -1 ;
+  for (int k = 0 ; k < 2 ; k++) {
+    if (wake_[k] >= 0) ::close(wake_[k]) ;
+    wake_[k] = -1 ;
+  }
+  for (size_t k = 0 ; k < pool_.size() ; k++) {
+    if (poolObjs_[k] != nullptr) ctrl_.destroyObject(poolObjs_[k]) ;
+    poolObjs_[k] = nullptr ;
+    pool_[k] = nullptr ;
+  }
+}
+
+/*
+  A reply to a connection that has gone is dropped. Running out of memory
+  for a reply leaves a partial one queued, so the caller must drop the
+  connection.
+*/
+int SolverDaemon::queueReply (int sock, const void *buf, size_t len)
+{
+  std::map<int,Conn>::iterator iter = conns_.find(sock) ;
+  if (iter == conns_.end() || len == 0) return (0) ;
+  std::vector<char> &out = iter->second.out_ ;
+  const char *p = static_cast<const char *>(buf) ;
+  try {
+    out.insert(out.end(),p,p+len) ;
+  }
+  catch (std::bad_alloc &) {
+    std::cout
+      << "SolverDaemon: out of memory for a reply; dropping the client."
+      << std::endl ;
+    return (-1) ;
+  }
+  return (0) ;
+}
+
+int SolverDaemon::queueOpt (int sock, bool valid, const double *vec, int len)
+{
+  return ((valid)?queueReply(sock,vec,len*sizeof(double)):0) ;
+}
+
+int SolverDaemon::replyEmpty (int sock, int retval, int handle)
+{
+  Reply reply ;
+  std::memset(&reply,0,sizeof(reply)) ;
+  reply.retval_ = retval ;
+  reply.handle_ = handle ;
+  return (queueReply(sock,&reply,sizeof(reply))) ;
+}
+
+/*
+  Send as much of the queued output as the socket will take without
+  waiting; the rest goes when poll next reports the socket writable.
+*/
+int SolverDaemon::writeOutput (int sock)
+{
+  Conn &conn = conns_[sock] ;
+  while (conn.outPos_ < conn.out_.size()) {
+    const ssize_t done = ::send(sock,&conn.out_[conn.outPos_],
+				conn.out_.size()-conn.outPos_,
+				MSG_DONTWAIT|MSG_NOSIGNAL) ;
+    if (done < 0 && errno == EINTR) continue ;
+    if (done < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return (0) ;
+    if (done <= 0) return (-1) ;
+    conn.outPos_ += done ;
+  }
+  conn.out_.clear() ;
+  conn.outPos_ = 0 ;
+  return (0) ;
+}
+
+void SolverDaemon::dropConnection (int sock)
+{
+  ::close(sock) ;
+  conns_.erase(sock) ;
+  for (std::map<int,HandleInfo>::iterator iter = handles_.begin() ;
+       iter != handles_.end() ; ) {
+    if (iter->second.sock_ == sock)
+      iter = handles_.erase(iter) ;
+    else
+      iter++ ;
+  }
+  for (std::deque<Pending>::iterator iter = queue_.begin() ;
+       iter != queue_.end() ; ) {
+    if (iter->sock_ == sock)
+      iter = queue_.erase(iter) ;
+    else
+      iter++ ;
+  }
+}
+
+/*
+  Take whatever has arrived without waiting for more (at most
+  maxReadPerPass bytes, so one busy client can't hold the loop), then act
+  on every whole request in the buffer. A partial request stays in the
+  buffer for the next pass.
+*/
+int SolverDaemon::readInput (int sock)
+{
+  std::vector<char> &buf = conns_[sock].in_ ;
+  bool gone = false ;
+  size_t pos = 0 ;
+  int retval = 0 ;
+  try {
+    char chunk[16384] ;
+    size_t got = 0 ;
+    while (got < maxReadPerPass) {
+      const ssize_t done = ::recv(sock,chunk,sizeof(chunk),MSG_DONTWAIT) ;
+      if (done < 0 && errno == EINTR) continue ;
+      if (done < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break ;
+      if (done <= 0) {
+	gone = true ;
+	break ;
+      }
+      buf.insert(buf.end(),chunk,chunk+done) ;
+      got += done ;
+    }
+    while ((retval = takeRequest(sock,buf,pos)) > 0) ;
+    buf.erase(buf.begin(),buf.begin()+pos) ;
+  }
+  catch (std::bad_alloc &) {
+    std::cout
+      << "SolverDaemon: out of memory reading from a client; dropping it."
+      << std::endl ;
+    return (-1) ;
+  }
+  return ((gone || retval < 0)?-1:0) ;
+}
+
+/*
+  The request is measured before anything is decided, so the stream stays
+  in step even when the request is refused or can't be stored.
+*/
+int SolverDaemon::takeRequest (int sock, const std::vector<char> &buf,
+			       size_t &pos)
+{
+  size_t len = 0 ;
+  const int whole = measureRequest(Cursor(buf,pos),limits_,len) ;
+  if (whole < 0) {
+    std::cout
+      << "SolverDaemon: malformed or oversized request; dropping the client."
+      << std::endl ;
+    return (-1) ;
+  }
+  if (whole == 0) return (0) ;
+  Cursor in(buf,pos) ;
+  pos += len ;
+  Request hdr ;
+  in.take(&hdr,sizeof(hdr)) ;
+  int sent = 0 ;
+  switch (hdr.op_) {
+    case opCreate:
+    { std::string apiName ;
+      std::string shortName ;
+      in.takeStr(apiName) ;
+      in.takeStr(shortName) ;
+      if (apiName != ClpSimplexAPI::getAPIIDString() ||
+	  !(shortName.empty() || shortName == shortName_)) {
+	std::cout
+	  << "SolverDaemon: cannot supply " << apiName << " from library "
+	  << ((shortName.empty())?"<any>":shortName) << "." << std::endl ;
+	sent = replyEmpty(sock,-1,0) ;
+	break ;
+      }
+      const int handle = nextHandle_++ ;
+      HandleInfo &info = handles_[handle] ;
+      info.sock_ = sock ;
+      info.numRows_ = -1 ;
+      info.numCols_ = -1 ;
+      sent = replyEmpty(sock,0,handle) ;
+      break ; }
+    case opDestroy:
+    { std::map<int,HandleInfo>::iterator iter = handles_.find(hdr.handle_) ;
+      if (iter == handles_.end() || iter->second.sock_ != sock) {
+	sent = replyEmpty(sock,-1,hdr.handle_) ;
+	break ;
+      }
+      handles_.erase(iter) ;
+      sent = replyEmpty(sock,0,0) ;
+      break ; }
+    case opSolve:
+    { std::map<int,HandleInfo>::iterator iter = handles_.find(hdr.handle_) ;
+      if (iter == handles_.end() || iter->second.sock_ != sock) {
+	sent = replyEmpty(sock,-1,hdr.handle_) ;
+	break ;
+      }
+      if (static_cast<int>(queue_.size()) >= maxQueued_) {
+	numRefused_++ ;
+	sent = replyEmpty(sock,1,hdr.handle_) ;
+	break ;
+      }
+/*
+  Unpack the model and settings. Running out of memory here costs only
+  this request.
+*/
+      const int m = hdr.numRows_ ;
+      const int n = hdr.numCols_ ;
+      const unsigned int present = hdr.present_ ;
+      try {
+	Pending req ;
+	req.sock_ = sock ;
+	req.hdr_ = hdr ;
+	in.takeVec(req.starts_,n+1) ;
+	in.takeVec(req.indices_,hdr.numElements_) ;
+	in.takeVec(req.elements_,hdr.numElements_) ;
+	takeOpt(in,present,colLowerPresent,req.colLower_,n) ;
+	takeOpt(in,present,colUpperPresent,req.colUpper_,n) ;
+	takeOpt(in,present,objPresent,req.obj_,n) ;
+	takeOpt(in,present,rowLowerPresent,req.rowLower_,m) ;
+	takeOpt(in,present,rowUpperPresent,req.rowUpper_,m) ;
+	for (int k = 0 ; k < hdr.numSettings_ ; k++) {
+	  int type ;
+	  std::string name ;
+	  in.take(&type,sizeof(type)) ;
+	  in.takeStr(name) ;
+	  if (type == intSetting) {
+	    int val ;
+	    in.take(&val,sizeof(val)) ;
+	    req.intSettings_.push_back(std::make_pair(name,val)) ;
+	  } else if (type == dblSetting) {
+	    double val ;
+	    in.take(&val,sizeof(val)) ;
+	    req.dblSettings_.push_back(std::make_pair(name,val)) ;
+	  } else {
+	    std::string val ;
+	    in.takeStr(val) ;
+	    req.strSettings_.push_back(std::make_pair(name,val)) ;
+	  }
+	}
+	if (!validMatrix(m,n,hdr.numElements_,req.starts_,req.indices_)) {
+	  sent = replyEmpty(sock,-1,hdr.handle_) ;
+	  break ;
+	}
+	queue_.push_back(std::move(req)) ;
+      }
+      catch (std::bad_alloc &) {
+	std::cout
+	  << "SolverDaemon: out of memory for a request of " << m
+	  << " rows and " << n << " columns." << std::endl ;
+	sent = replyEmpty(sock,-1,hdr.handle_) ;
+      }
+      break ; }
+  }
+  return ((sent == 0)?1:-1) ;
+}
+
+/*
+  Settings go in before the model so that the model's objective sense
+  isn't overridden by the default one.
+*/
+int SolverDaemon::applySettings (int k, const Pending &req)
+{
+  const bool haveSettings = !(req.intSettings_.empty() &&
+			      req.dblSettings_.empty() &&
+			      req.strSettings_.empty()) ;
+  if (!haveSettings && !dirty_[k]) return (0) ;
+  if (runParams_ == nullptr) return (-1) ;
+  for (const std::pair<std::string,int> &dflt : dfltInts_)
+    runParams_->setIntParam(dflt.first,dflt.second) ;
+  for (const std::pair<std::string,double> &dflt : dfltDbls_)
+    runParams_->setDblParam(dflt.first,dflt.second) ;
+  for (const std::pair<std::string,std::string> &dflt : dfltStrs_)
+    runParams_->setStrParam(dflt.first,dflt.second) ;
+  for (const std::pair<std::string,int> &setting : req.intSettings_)
+    runParams_->setIntParam(setting.first,setting.second) ;
+  for (const std::pair<std::string,double> &setting : req.dblSettings_)
+    runParams_->setDblParam(setting.first,setting.second) ;
+  for (const std::pair<std::string,std::string> &setting : req.strSettings_)
+    runParams_->setStrParam(setting.first,setting.second) ;
+  pool_[k]->loadParams(*runParams_) ;
+  dirty_[k] = haveSettings ;
+  return (0) ;
+}
+
+/*
+  Loading, settings, and queueing the replies happen here in the serving
+  thread; only the solves run in parallel.
+*/
+void SolverDaemon::runBatch (std::vector<Pending> &batch)
+{
+  const int numReqs = static_cast<int>(batch.size()) ;
+  std::vector<int> retval(numReqs,0) ;
+  for (int k = 0 ; k < numReqs ; k++) {
+    Pending &req = batch[k] ;
+    ClpSimplexAPI *clp = pool_[k] ;
+    if (applySettings(k,req) != 0) {
+      std::cout
+	<< "SolverDaemon: settings sent but no RunParamsAPI object to apply "
+	<< "them." << std::endl ;
+      retval[k] = -1 ;
+      continue ;
+    }
+    const int m = req.hdr_.numRows_ ;
+    const int n = req.hdr_.numCols_ ;
+    try {
+      clp->loadProblem(n,m,req.starts_.data(),req.indices_.data(),
+		       req.elements_.data(),optPtr(req.colLower_),
+		       optPtr(req.colUpper_),optPtr(req.obj_),
+		       optPtr(req.rowLower_),optPtr(req.rowUpper_)) ;
+    }
+    catch (std::bad_alloc &) {
+      retval[k] = -1 ;
+      continue ;
+    }
+    clp->setObjSense(req.hdr_.objSense_) ;
+    std::map<int,HandleInfo>::const_iterator iter =
+	handles_.find(req.hdr_.handle_) ;
+    if (iter != handles_.end()) {
+      const HandleInfo &info = iter->second ;
+      if (info.numRows_ == m && info.numCols_ == n && !info.basis_.empty())
+	clp->copyinStatus(info.basis_.data()) ;
+    }
+  }
+  parallelFor(numReqs,numReqs,
+	      [&](int first, int last, int) {
+		for (int k = first ; k < last ; k++) {
+		  if (retval[k] != 0) continue ;
+		  try {
+		    switch (batch[k].hdr_.method_) {
+		      case SolverHost::dualMethod:
+		      { pool_[k]->dual() ;
+			break ; }
+		      case SolverHost::primalMethod:
+		      { pool_[k]->primal() ;
+			break ; }
+		      default:
+		      { pool_[k]->initialSolve() ;
+			break ; }
+		    }
+		  }
+		  catch (std::bad_alloc &) {
+		    retval[k] = -1 ;
+		  }
+		}
+	      }) ;
+  SolveResult result ;
+  for (int k = 0 ; k < numReqs ; k++) {
+    const Pending &req = batch[k] ;
+    if (retval[k] != 0) {
+      if (replyEmpty(req.sock_,retval[k],req.hdr_.handle_) != 0)
+	dropConnection(req.sock_) ;
+      continue ;
+    }
+    ClpSimplexAPI *clp = pool_[k] ;
+    const int m = req.hdr_.numRows_ ;
+    const int n = req.hdr_.numCols_ ;
+    Reply reply ;
+    std::memset(&reply,0,sizeof(reply)) ;
+    try {
+      reply.retval_ = clp->fetchResult(result,req.hdr_.fields_) ;
+    }
+    catch (std::bad_alloc &) {
+      if (replyEmpty(req.sock_,-1,req.hdr_.handle_) != 0)
+	dropConnection(req.sock_) ;
+      continue ;
+    }
+    reply.handle_ = req.hdr_.handle_ ;
+    reply.fields_ = result.fields() ;
+    reply.status_ = result.status() ;
+    reply.secondaryStatus_ = result.secondaryStatus() ;
+    reply.iterations_ = result.iterations() ;
+    reply.objValue_ = result.objectiveValue() ;
+    reply.numRows_ = m ;
+    reply.numCols_ = n ;
+/*
+  Keep the basis for the handle's next solve, unless the handle was
+  destroyed while the request waited.
+*/
+    std::map<int,HandleInfo>::iterator iter = handles_.find(req.hdr_.handle_) ;
+    if (iter != handles_.end()) {
+      HandleInfo &info = iter->second ;
+      const unsigned char *stat = clp->statusArray() ;
+      info.numRows_ = m ;
+      info.numCols_ = n ;
+      if (stat)
+	info.basis_.assign(stat,stat+(static_cast<size_t>(n)+m)) ;
+      else
+	info.basis_.clear() ;
+    }
+/*
+  Queue the reply; it goes out as the client takes it.
+*/
+    const unsigned int got = reply.fields_ ;
+    if (queueReply(req.sock_,&reply,sizeof(reply)) != 0 ||
+	queueOpt(req.sock_,got&SolveResult::colSolutionField,
+		 result.getColSolution(),n) != 0 ||
+	queueOpt(req.sock_,got&SolveResult::rowActivityField,
+		 result.getRowActivity(),m) != 0 ||
+	queueOpt(req.sock_,got&SolveResult::rowPriceField,
+		 result.getRowPrice(),m) != 0 ||
+	queueOpt(req.sock_,got&SolveResult::reducedCostField,
+		 result.getReducedCost(),n) != 0)
+      dropConnection(req.sock_) ;
+  }
+}
+
+}  // end namespace Osi2
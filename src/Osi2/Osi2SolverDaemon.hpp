@@ -0,0 +1,305 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolverDaemon.hpp
+    \brief Serve ClpSimplexAPI solves over a Unix-domain socket.
+*/
+#ifndef Osi2SolverDaemon_HPP
+#define Osi2SolverDaemon_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CoinTypes.h"
+
+#include "Osi2SolveResult.hpp"
+#include "Osi2SolverHost.hpp"
+
+namespace Osi2 {
+
+class API ;
+class ControlAPI ;
+class ClpSimplexAPI ;
+class RunParamsAPI ;
+
+/*! \brief Long-running solver daemon
+
+  Keeps a plugin library loaded and a pool of ClpSimplexAPI objects ready,
+  and solves models sent by SolverClient over a Unix-domain socket, so that
+  short jobs don't pay for loading plugins and creating solvers.
+
+  A client first asks for a handle (SolverClient::createObject). The daemon
+  keeps the final basis of each handle's last solve and uses it to warm
+  start the handle's next solve if the dimensions match. Handles go away
+  with SolverClient::destroyObject or when the connection closes.
+
+  Requests are batched: each pass of #serve reads whatever requests have
+  arrived, up to one per pooled object, loads each into its own object,
+  solves the batch in parallel, and queues the replies. Neither reads nor
+  writes block. Each connection has its own receive buffer, and a request
+  joins the queue only once the whole of it has arrived; each also has its
+  own queue of replies, sent as the socket will take them. So a client slow
+  to send or to read holds up no one else.
+  Admission control is a cap on the number of requests waiting for a batch;
+  a request that arrives when the queue is full is refused at once
+  (SolverClient::solve returns 1) rather than left to wait.
+
+  A request whose header asks for more than #setLimits allows (rows,
+  columns, coefficients, settings, or string length) is taken as malformed
+  and the connection is dropped before anything is allocated for it. A
+  request the daemon runs out of memory for is answered with an error.
+
+  Settings sent with a request (see SolverClient::setIntParam, etc.) are
+  applied through a RunParamsAPI object supplied with #setRunParams. Every
+  request starts from the solver's default settings, captured when the
+  daemon opens. Names the solver doesn't know are ignored. The objective
+  sense always comes from the model, not from the settings.
+
+  #serve runs in the thread that calls it until #shutdown is called from
+  another thread, and may be called again after it returns.
+*/
+class SolverDaemon {
+
+public:
+
+  /*! \name Wire format
+
+    A message is a fixed-size header followed by the arrays it describes.
+    Used by SolverClient; of no interest otherwise.
+  */
+  //@{
+  /// Request codes
+  enum Op {
+    opCreate = 1,
+    opDestroy,
+    opSolve
+  } ;
+  /// Bits of Request::present_, for the optional arrays of a model
+  enum Present {
+    colLowerPresent = 0x01,
+    colUpperPresent = 0x02,
+    objPresent = 0x04,
+    rowLowerPresent = 0x08,
+    rowUpperPresent = 0x10
+  } ;
+  /// Types of settings
+  enum SettingType {
+    intSetting = 0,
+    dblSetting,
+    strSetting
+  } ;
+  /*! \brief Request header
+
+    opCreate is followed by the API name and short name as strings;
+    opSolve by the starts, indices, and elements of the packed column-major
+    matrix, the arrays flagged in present_, and numSettings_ settings (type,
+    name, value).
+  */
+  struct Request {
+    int op_ ;
+    int handle_ ;
+    int method_ ;
+    unsigned int fields_ ;
+    int numRows_ ;
+    int numCols_ ;
+    CoinBigIndex numElements_ ;
+    unsigned int present_ ;
+    double objSense_ ;
+    int numSettings_ ;
+  } ;
+  /// Reply header; followed by the solution vectors flagged in fields_
+  struct Reply {
+    int retval_ ;
+    int handle_ ;
+    unsigned int fields_ ;
+    int status_ ;
+    int secondaryStatus_ ;
+    int iterations_ ;
+    double objValue_ ;
+    int numRows_ ;
+    int numCols_ ;
+  } ;
+  //@}
+
+  /// Largest request the daemon will accept
+  struct Limits {
+    Limits ()
+      : maxRows_(10000000), maxCols_(10000000), maxElements_(100000000),
+	maxSettings_(1024), maxStrLen_(4096)
+    { }
+    int maxRows_ ;
+    int maxCols_ ;
+    CoinBigIndex maxElements_ ;
+    int maxSettings_ ;
+    int maxStrLen_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor; \p ctrl must outlive the daemon
+  SolverDaemon (ControlAPI &ctrl, int poolSize) ;
+  /// Destructor; closes the socket and destroys the pool
+  ~SolverDaemon () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Object used to apply settings; without one, settings are refused
+  inline void setRunParams (RunParamsAPI *runParams)
+  { runParams_ = runParams ; }
+  /// Most requests that may wait for a batch (default 64)
+  inline void setMaxQueued (int maxQueued) { maxQueued_ = maxQueued ; }
+  /// Size limits for requests; maxCols_ is held below INT_MAX
+  inline void setLimits (const Limits &limits)
+  { limits_ = limits ;
+    limits_.maxCols_ = std::min(limits_.maxCols_,INT_MAX-1) ; }
+  /// Size limits for requests
+  inline const Limits &getLimits () const { return (limits_) ; }
+  //@}
+
+  /*! \name Operation */
+  //@{
+  /*! \brief Create the pool and listen on \p path
+
+    Solver objects come from the plugin library registered as \p shortName,
+    or from any library that supplies ClpSimplexAPI if \p shortName is null.
+    If a RunParamsAPI object has been supplied, the default settings are
+    captured here. An existing socket at \p path is replaced. Returns -1 on
+    error, 0 otherwise.
+  */
+  int open (const std::string &path, const std::string *shortName = nullptr) ;
+  /// Serve requests until #shutdown; returns -1 on error, 0 otherwise
+  int serve () ;
+  /// Ask #serve to return; safe to call from any thread
+  void shutdown () ;
+  /// Close the socket and destroy the pool
+  void close () ;
+  /*! \brief Read requests until \p numReqs are queued, solving nothing
+
+    For tests that need a batch of known size. Must not be called while
+    #serve is running. Gives up after \p timeoutMs. Returns 0 if the queue
+    holds \p numReqs requests, -1 otherwise.
+  */
+  int waitForQueued (int numReqs, int timeoutMs) ;
+  /// Number of requests refused by admission control
+  inline int getNumRefused () const { return (numRefused_) ; }
+  /// Number of batches solved
+  inline int getNumBatches () const { return (numBatches_) ; }
+  /// Most requests solved in one batch
+  inline int getLargestBatch () const { return (largestBatch_) ; }
+  //@}
+
+private:
+
+  /// A solve request waiting for a batch
+  struct Pending {
+    int sock_ ;
+    Request hdr_ ;
+    std::vector<CoinBigIndex> starts_ ;
+    std::vector<int> indices_ ;
+    std::vector<double> elements_ ;
+    std::vector<double> colLower_ ;
+    std::vector<double> colUpper_ ;
+    std::vector<double> obj_ ;
+    std::vector<double> rowLower_ ;
+    std::vector<double> rowUpper_ ;
+    std::vector<std::pair<std::string,int> > intSettings_ ;
+    std::vector<std::pair<std::string,double> > dblSettings_ ;
+    std::vector<std::pair<std::string,std::string> > strSettings_ ;
+  } ;
+
+  /// What the daemon keeps for a handle
+  struct HandleInfo {
+    /// Connection that owns the handle
+    int sock_ ;
+    /// Dimensions and final basis of the last solve
+    int numRows_ ;
+    int numCols_ ;
+    std::vector<unsigned char> basis_ ;
+  } ;
+
+  /// A client connection
+  struct Conn {
+    Conn () : outPos_(0) { }
+    /// Bytes received but not yet used
+    std::vector<char> in_ ;
+    /// Replies queued; those before outPos_ have gone
+    std::vector<char> out_ ;
+    size_t outPos_ ;
+  } ;
+
+  /// Wait at most \p timeoutMs (-1 for ever) for activity, then accept,
+  /// read, and write whatever is ready; -1 if poll fails
+  int pollConnections (int timeoutMs) ;
+  /// Read what has arrived on \p sock and act on whole requests; -1 if
+  /// the connection is done
+  int readInput (int sock) ;
+  /// Act on the request at \p pos in \p buf; 1 if there was a whole one
+  /// (\p pos moves past it), 0 if more must arrive, -1 to drop \p sock
+  int takeRequest (int sock, const std::vector<char> &buf, size_t &pos) ;
+  /// Solve and answer a batch of requests
+  void runBatch (std::vector<Pending> &batch) ;
+  /// Apply the defaults and the settings of \p req to pooled object \p k
+  int applySettings (int k, const Pending &req) ;
+  /// Queue \p len bytes of reply for \p sock; -1 if the connection must
+  /// be dropped
+  int queueReply (int sock, const void *buf, size_t len) ;
+  /// Queue a solution vector, if \p valid
+  int queueOpt (int sock, bool valid, const double *vec, int len) ;
+  /// Queue a reply with no solution
+  int replyEmpty (int sock, int retval, int handle) ;
+  /// Send queued replies on \p sock without blocking; -1 if the
+  /// connection is done
+  int writeOutput (int sock) ;
+  /// Drop a connection and its handles
+  void dropConnection (int sock) ;
+
+  /// Plugin library management
+  ControlAPI &ctrl_ ;
+  /// Pool of solver objects
+  std::vector<API *> poolObjs_ ;
+  std::vector<ClpSimplexAPI *> pool_ ;
+  /// Pooled objects whose settings differ from the defaults
+  std::vector<char> dirty_ ;
+  /// Plugin library for the pool (empty for any)
+  std::string shortName_ ;
+  /// Settings
+  RunParamsAPI *runParams_ ;
+  std::vector<std::pair<std::string,int> > dfltInts_ ;
+  std::vector<std::pair<std::string,double> > dfltDbls_ ;
+  std::vector<std::pair<std::string,std::string> > dfltStrs_ ;
+  /// Admission limit and count of refusals
+  int maxQueued_ ;
+  int numRefused_ ;
+  /// Request size limits
+  Limits limits_ ;
+  /// Batch statistics
+  int numBatches_ ;
+  int largestBatch_ ;
+  /// Socket path and descriptors
+  std::string path_ ;
+  int listenSock_ ;
+  /// Connections
+  std::map<int,Conn> conns_ ;
+  /// Self-pipe used by #shutdown to wake #serve
+  int wake_[2] ;
+  std::atomic<bool> stopping_ ;
+  /// Requests waiting for a batch
+  std::deque<Pending> queue_ ;
+  /// Handles
+  std::map<int,HandleInfo> handles_ ;
+  int nextHandle_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
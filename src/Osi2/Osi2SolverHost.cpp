@@ -0,0 +1,616 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::SolverHost.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ControlAPI.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2SocketIO.hpp"
+#include "Osi2SolverHost.hpp"
+
+namespace {
+
+/*
+  Requests from the host to a worker. A solve request carries the current
+  size of the segment so the worker can remap it when it has grown.
+*/
+enum Op {
+  opSolve = 1,
+  opQuit
+} ;
+
+/// How long #stop waits for a worker to leave before killing it
+const int quitWaitMs = 5000 ;
+
+struct Request {
+  int op_ ;
+  size_t segSize_ ;
+} ;
+
+/*
+  Requests from the host to the zygote, and its replies. A request carries
+  the worker's shared memory descriptor, a reply the host's end of the
+  worker's socket pair (unless the fork failed, in which case pid_ is -1).
+*/
+struct SpawnRequest {
+  size_t memLimit_ ;
+} ;
+
+struct SpawnReply {
+  pid_t pid_ ;
+} ;
+
+/*
+  The head of each segment. The host fills in the problem part, the worker
+  the result part.
+*/
+struct Header {
+  int numRows_ ;
+  int numCols_ ;
+  CoinBigIndex numElements_ ;
+  int method_ ;
+  unsigned int fields_ ;
+  int haveStatus_ ;
+  double objSense_ ;
+
+  int retval_ ;
+  unsigned int resultFields_ ;
+  int status_ ;
+  int secondaryStatus_ ;
+  int iterations_ ;
+  double objValue_ ;
+} ;
+
+/*
+  Byte offsets of the arrays that follow the header. Every array starts on
+  an 8 byte boundary.
+*/
+struct Layout {
+  size_t starts_ ;
+  size_t indices_ ;
+  size_t elements_ ;
+  size_t colLower_ ;
+  size_t colUpper_ ;
+  size_t obj_ ;
+  size_t rowLower_ ;
+  size_t rowUpper_ ;
+  size_t status_ ;
+  size_t colSolution_ ;
+  size_t rowActivity_ ;
+  size_t rowPrice_ ;
+  size_t reducedCost_ ;
+  size_t size_ ;
+} ;
+
+Layout layout (int m, int n, CoinBigIndex nz)
+{
+  Layout lay ;
+  size_t off = 0 ;
+  auto place = [&off] (size_t bytes) {
+    const size_t at = off ;
+    off += (bytes+7)&~static_cast<size_t>(7) ;
+    return (at) ;
+  } ;
+  place(sizeof(Header)) ;
+  lay.starts_ = place((static_cast<size_t>(n)+1)*sizeof(CoinBigIndex)) ;
+  lay.indices_ = place(static_cast<size_t>(nz)*sizeof(int)) ;
+  lay.elements_ = place(static_cast<size_t>(nz)*sizeof(double)) ;
+  lay.colLower_ = place(n*sizeof(double)) ;
+  lay.colUpper_ = place(n*sizeof(double)) ;
+  lay.obj_ = place(n*sizeof(double)) ;
+  lay.rowLower_ = place(m*sizeof(double)) ;
+  lay.rowUpper_ = place(m*sizeof(double)) ;
+  lay.status_ = place(static_cast<size_t>(n)+m) ;
+  lay.colSolution_ = place(n*sizeof(double)) ;
+  lay.rowActivity_ = place(m*sizeof(double)) ;
+  lay.rowPrice_ = place(m*sizeof(double)) ;
+  lay.reducedCost_ = place(n*sizeof(double)) ;
+  lay.size_ = off ;
+  return (lay) ;
+}
+
+template <class T>
+inline T *at (void *seg, size_t off)
+{
+  return (reinterpret_cast<T *>(static_cast<char *>(seg)+off)) ;
+}
+
+/*
+  Create an anonymous shared memory object. The name is unlinked at once;
+  the descriptor is all that's needed, and it's inherited by the worker.
+*/
+int makeShm ()
+{
+  static std::atomic<int> serial(0) ;
+  std::ostringstream name ;
+  name << "/osi2host." << ::getpid() << "." << serial++ ;
+  const int fd = ::shm_open(name.str().c_str(),O_RDWR|O_CREAT|O_EXCL,0600) ;
+  if (fd >= 0) ::shm_unlink(name.str().c_str()) ;
+  return (fd) ;
+}
+
+/*
+  Copy a solution vector out to the segment, if the worker's fetch filled
+  it.
+*/
+void putVec (const double *src, int len, void *seg, size_t off)
+{
+  if (src) std::copy(src,src+len,at<double>(seg,off)) ;
+}
+
+/*
+  The worker. It owns one solver object for its lifetime and loads each
+  model straight from the segment. It leaves when told to, or when the host
+  end of the socket closes.
+*/
+void workerMain (Osi2::ControlAPI &ctrl, const std::string *shortName,
+		 int sock, int shmFd)
+{
+  Osi2::API *obj = nullptr ;
+  if (ctrl.createObject(obj,Osi2::ClpSimplexAPI::getAPIIDString(),
+			shortName) < 0 || obj == nullptr)
+    ::_exit(1) ;
+  Osi2::ClpSimplexAPI *clp = static_cast<Osi2::ClpSimplexAPI *>
+      (obj->getAPIPtr(Osi2::ClpSimplexAPI::getAPIIDString())) ;
+  clp->setLogLevel(0) ;
+
+  void *seg = nullptr ;
+  size_t segSize = 0 ;
+  Osi2::SolveResult result ;
+  Request req ;
+  while (Osi2::recvAll(sock,&req,sizeof(req)) == 0 && req.op_ == opSolve) {
+    if (req.segSize_ != segSize) {
+      if (seg != nullptr) ::munmap(seg,segSize) ;
+      seg = ::mmap(nullptr,req.segSize_,PROT_READ|PROT_WRITE,MAP_SHARED,
+		   shmFd,0) ;
+      if (seg == MAP_FAILED) ::_exit(1) ;
+      segSize = req.segSize_ ;
+    }
+    Header *hdr = at<Header>(seg,0) ;
+    const int m = hdr->numRows_ ;
+    const int n = hdr->numCols_ ;
+    const Layout lay = layout(m,n,hdr->numElements_) ;
+    clp->loadProblem(n,m,at<CoinBigIndex>(seg,lay.starts_),
+		     at<int>(seg,lay.indices_),at<double>(seg,lay.elements_),
+		     at<double>(seg,lay.colLower_),at<double>(seg,lay.colUpper_),
+		     at<double>(seg,lay.obj_),
+		     at<double>(seg,lay.rowLower_),at<double>(seg,lay.rowUpper_)) ;
+    clp->setObjSense(hdr->objSense_) ;
+    if (hdr->haveStatus_)
+      clp->copyinStatus(at<unsigned char>(seg,lay.status_)) ;
+    switch (hdr->method_) {
+      case Osi2::SolverHost::dualMethod:
+      { clp->dual() ;
+	break ; }
+      case Osi2::SolverHost::primalMethod:
+      { clp->primal() ;
+	break ; }
+      default:
+      { clp->initialSolve() ;
+	break ; }
+    }
+    hdr->retval_ = clp->fetchResult(result,hdr->fields_) ;
+    hdr->resultFields_ = result.fields() ;
+    hdr->status_ = result.status() ;
+    hdr->secondaryStatus_ = result.secondaryStatus() ;
+    hdr->iterations_ = result.iterations() ;
+    hdr->objValue_ = result.objectiveValue() ;
+    putVec(result.getColSolution(),n,seg,lay.colSolution_) ;
+    putVec(result.getRowActivity(),m,seg,lay.rowActivity_) ;
+    putVec(result.getRowPrice(),m,seg,lay.rowPrice_) ;
+    putVec(result.getReducedCost(),n,seg,lay.reducedCost_) ;
+    const unsigned char *stat = clp->statusArray() ;
+    hdr->haveStatus_ = (stat != nullptr) ;
+    if (stat)
+      std::copy(stat,stat+(static_cast<size_t>(n)+m),
+		at<unsigned char>(seg,lay.status_)) ;
+    const int done = 0 ;
+    if (Osi2::sendAll(sock,&done,sizeof(done)) != 0) break ;
+  }
+  ctrl.destroyObject(obj) ;
+  ::_exit(0) ;
+}
+
+/*
+  The zygote. It's forked from the host by SolverHost::start, before the
+  client has threads of its own, and never starts any, so it can fork
+  safely at any time. For each request it makes a socket pair and forks a
+  worker, which caps its address space if asked and goes to workerMain.
+  Workers are the zygote's children; with SIGCHLD ignored they're reaped
+  automatically. The zygote leaves when the host end of its socket closes.
+*/
+void zygoteMain (Osi2::ControlAPI &ctrl, const std::string *shortName,
+		 int sock)
+{
+  ::signal(SIGCHLD,SIG_IGN) ;
+  SpawnRequest req ;
+  int shmFd = -1 ;
+  while (Osi2::recvWithFd(sock,&req,sizeof(req),shmFd) == 0) {
+    SpawnReply reply ;
+    reply.pid_ = -1 ;
+    int socks[2] = { -1, -1 } ;
+    if (shmFd >= 0 && ::socketpair(AF_UNIX,SOCK_STREAM,0,socks) == 0) {
+      std::cout.flush() ;
+      reply.pid_ = ::fork() ;
+      if (reply.pid_ == 0) {
+	::close(sock) ;
+	::close(socks[0]) ;
+	::signal(SIGCHLD,SIG_DFL) ;
+	if (req.memLimit_ > 0) {
+	  struct rlimit lim ;
+	  lim.rlim_cur = req.memLimit_ ;
+	  lim.rlim_max = req.memLimit_ ;
+	  ::setrlimit(RLIMIT_AS,&lim) ;
+	}
+	workerMain(ctrl,shortName,socks[1],shmFd) ;
+      }
+      ::close(socks[1]) ;
+    }
+    if (shmFd >= 0) ::close(shmFd) ;
+    int sent ;
+    if (reply.pid_ > 0)
+      sent = Osi2::sendWithFd(sock,&reply,sizeof(reply),socks[0]) ;
+    else
+      sent = Osi2::sendAll(sock,&reply,sizeof(reply)) ;
+    if (socks[0] >= 0) ::close(socks[0]) ;
+    if (sent != 0) break ;
+  }
+  ::_exit(0) ;
+}
+
+/// Copy a solution vector from the segment into the result buffer
+void getVec (double *dst, int len, void *seg, size_t off)
+{
+  const double *src = at<double>(seg,off) ;
+  std::copy(src,src+len,dst) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+SolverHost::SolverHost (ControlAPI &ctrl, int numWorkers)
+  : ctrl_(ctrl),
+    shortName_(),
+    haveShortName_(false),
+    workers_(std::max(numWorkers,1)),
+    memLimit_(0),
+    solveTimeout_(0.0),
+    numCrashes_(0),
+    numTimeouts_(0),
+    started_(false),
+    zygotePid_(0),
+    zygoteSock_(-1)
+{
+  for (Worker &worker : workers_) {
+    worker.pid_ = 0 ;
+    worker.sock_ = -1 ;
+    worker.shmFd_ = -1 ;
+    worker.seg_ = nullptr ;
+    worker.segSize_ = 0 ;
+    worker.busy_ = false ;
+  }
+}
+
+SolverHost::~SolverHost ()
+{
+  stop() ;
+}
+
+/*
+  The zygote is forked first, while the client is (we hope) still single
+  threaded; every worker, now and after a crash, is forked from it.
+*/
+int SolverHost::start (const std::string *shortName)
+{
+  if (started_) return (0) ;
+  haveShortName_ = (shortName != nullptr) ;
+  if (haveShortName_) shortName_ = *shortName ;
+  int socks[2] ;
+  if (::socketpair(AF_UNIX,SOCK_STREAM,0,socks) != 0) {
+    std::cout
+      << "SolverHost: cannot create a socket for the zygote: "
+      << std::strerror(errno) << "." << std::endl ;
+    return (-1) ;
+  }
+  std::cout.flush() ;
+  const pid_t pid = ::fork() ;
+  if (pid < 0) {
+    std::cout
+      << "SolverHost: cannot fork the zygote: " << std::strerror(errno)
+      << "." << std::endl ;
+    ::close(socks[0]) ;
+    ::close(socks[1]) ;
+    return (-1) ;
+  }
+  if (pid == 0) {
+    ::close(socks[0]) ;
+    zygoteMain(ctrl_,(haveShortName_)?&shortName_:nullptr,socks[1]) ;
+  }
+  ::close(socks[1]) ;
+  zygotePid_ = pid ;
+  zygoteSock_ = socks[0] ;
+  for (int k = 0 ; k < getNumWorkers() ; k++) {
+    if (spawn(k) != 0) {
+      stop() ;
+      return (-1) ;
+    }
+  }
+  started_ = true ;
+  return (0) ;
+}
+
+/*
+  Ask each worker to quit and wait (a while) for it to close its end of the
+  socket, then let the zygote go.
+*/
+void SolverHost::stop ()
+{
+  std::unique_lock<std::mutex> guard(lock_) ;
+  for (int k = 0 ; k < getNumWorkers() ; k++) {
+    Worker &worker = workers_[k] ;
+    if (worker.pid_ > 0) {
+      Request req = { opQuit, 0 } ;
+      char eof ;
+      const bool gone = (sendAll(worker.sock_,&req,sizeof(req)) == 0 &&
+			 recvAllBy(worker.sock_,&eof,1,quitWaitMs) == -1) ;
+      reap(k,!gone) ;
+    }
+    if (worker.seg_ != nullptr) ::munmap(worker.seg_,worker.segSize_) ;
+    if (worker.shmFd_ >= 0) ::close(worker.shmFd_) ;
+    worker.seg_ = nullptr ;
+    worker.segSize_ = 0 ;
+    worker.shmFd_ = -1 ;
+  }
+  if (zygoteSock_ >= 0) ::close(zygoteSock_) ;
+  zygoteSock_ = -1 ;
+  if (zygotePid_ > 0) {
+    int status ;
+    while (::waitpid(zygotePid_,&status,0) < 0 && errno == EINTR) ;
+  }
+  zygotePid_ = 0 ;
+  started_ = false ;
+}
+
+/*
+  Ask the zygote for a worker. Client threads may restart workers at the
+  same time, so the exchange with the zygote is serialised; nothing else is
+  locked, and there's no fork in this process.
+*/
+int SolverHost::spawn (int k)
+{
+  Worker &worker = workers_[k] ;
+  if (worker.shmFd_ < 0) {
+    worker.shmFd_ = makeShm() ;
+    if (worker.shmFd_ < 0) {
+      std::cout
+	<< "SolverHost: cannot create shared memory for worker " << k
+	<< ": " << std::strerror(errno) << "." << std::endl ;
+      return (-1) ;
+    }
+  }
+  SpawnRequest req ;
+  req.memLimit_ = memLimit_ ;
+  SpawnReply reply ;
+  reply.pid_ = -1 ;
+  int sock = -1 ;
+  int retval = 0 ;
+  {
+    std::lock_guard<std::mutex> guard(zygoteLock_) ;
+    if (zygoteSock_ < 0 ||
+	sendWithFd(zygoteSock_,&req,sizeof(req),worker.shmFd_) != 0 ||
+	recvWithFd(zygoteSock_,&reply,sizeof(reply),sock) != 0)
+      retval = -1 ;
+  }
+  if (retval != 0 || reply.pid_ <= 0 || sock < 0) {
+    std::cout
+      << "SolverHost: cannot start worker " << k << "." << std::endl ;
+    if (sock >= 0) ::close(sock) ;
+    return (-1) ;
+  }
+  worker.pid_ = reply.pid_ ;
+  worker.sock_ = sock ;
+  return (0) ;
+}
+
+/*
+  Workers are the zygote's children and it reaps them. Here we only close
+  our end of the socket and, if the worker may still be running, kill it.
+*/
+void SolverHost::reap (int k, bool kill)
+{
+  Worker &worker = workers_[k] ;
+  if (worker.sock_ >= 0) ::close(worker.sock_) ;
+  worker.sock_ = -1 ;
+  if (kill && worker.pid_ > 0) ::kill(worker.pid_,SIGKILL) ;
+  worker.pid_ = 0 ;
+}
+
+/*
+  Grow by at least half again, so a sequence of slowly growing models
+  doesn't remap on every solve.
+*/
+int SolverHost::growSegment (int k, size_t size)
+{
+  Worker &worker = workers_[k] ;
+  if (size <= worker.segSize_) return (0) ;
+  size = std::max(size,worker.segSize_+worker.segSize_/2) ;
+  if (worker.seg_ != nullptr) ::munmap(worker.seg_,worker.segSize_) ;
+  worker.seg_ = nullptr ;
+  worker.segSize_ = 0 ;
+  if (::ftruncate(worker.shmFd_,size) != 0) return (-1) ;
+  void *seg = ::mmap(nullptr,size,PROT_READ|PROT_WRITE,MAP_SHARED,
+		     worker.shmFd_,0) ;
+  if (seg == MAP_FAILED) return (-1) ;
+  worker.seg_ = seg ;
+  worker.segSize_ = size ;
+  return (0) ;
+}
+
+int SolverHost::solve (ClpSimplexAPI &clp, SolveResult &result,
+		       Method method, unsigned int fields)
+{
+  if (!started_) {
+    std::cout << "SolverHost::solve: host is not started." << std::endl ;
+    return (-1) ;
+  }
+/*
+  Claim a free worker, restarting it if it was lost.
+*/
+  int k = -1 ;
+  {
+    std::unique_lock<std::mutex> guard(lock_) ;
+    for (;;) {
+      for (int j = 0 ; j < getNumWorkers() && k < 0 ; j++)
+	if (!workers_[j].busy_) k = j ;
+      if (k >= 0) break ;
+      freed_.wait(guard) ;
+    }
+    workers_[k].busy_ = true ;
+  }
+  Worker &worker = workers_[k] ;
+  if (worker.pid_ == 0 && spawn(k) != 0) {
+    {
+      std::lock_guard<std::mutex> guard(lock_) ;
+      worker.busy_ = false ;
+    }
+    freed_.notify_one() ;
+    return (-1) ;
+  }
+/*
+  Write the model into the segment. The matrix may have gaps; the copy
+  packs it.
+*/
+  const int m = clp.numberRows() ;
+  const int n = clp.numberColumns() ;
+  const CoinBigIndex *starts = clp.getVectorStarts() ;
+  const int *lengths = clp.getVectorLengths() ;
+  CoinBigIndex nz = 0 ;
+  for (int j = 0 ; j < n ; j++)
+    nz += (lengths)?lengths[j]:starts[j+1]-starts[j] ;
+  const Layout lay = layout(m,n,nz) ;
+  int retval = growSegment(k,lay.size_) ;
+  if (retval != 0) {
+    std::cout
+      << "SolverHost::solve: cannot size shared memory to " << lay.size_
+      << " bytes." << std::endl ;
+  } else {
+    void *seg = worker.seg_ ;
+    Header *hdr = at<Header>(seg,0) ;
+    hdr->numRows_ = m ;
+    hdr->numCols_ = n ;
+    hdr->numElements_ = nz ;
+    hdr->method_ = method ;
+    hdr->fields_ = fields ;
+    hdr->objSense_ = clp.objSense() ;
+    const int *indices = clp.getIndices() ;
+    const double *elements = clp.getElements() ;
+    CoinBigIndex *packedStarts = at<CoinBigIndex>(seg,lay.starts_) ;
+    int *packedIndices = at<int>(seg,lay.indices_) ;
+    double *packedElements = at<double>(seg,lay.elements_) ;
+    packedStarts[0] = 0 ;
+    for (int j = 0 ; j < n ; j++) {
+      const CoinBigIndex first = starts[j] ;
+      const CoinBigIndex last = (lengths)?first+lengths[j]:starts[j+1] ;
+      std::copy(indices+first,indices+last,packedIndices+packedStarts[j]) ;
+      std::copy(elements+first,elements+last,
+		packedElements+packedStarts[j]) ;
+      packedStarts[j+1] = packedStarts[j]+(last-first) ;
+    }
+    std::copy(clp.columnLower(),clp.columnLower()+n,
+	      at<double>(seg,lay.colLower_)) ;
+    std::copy(clp.columnUpper(),clp.columnUpper()+n,
+	      at<double>(seg,lay.colUpper_)) ;
+    std::copy(clp.objective(),clp.objective()+n,at<double>(seg,lay.obj_)) ;
+    std::copy(clp.rowLower(),clp.rowLower()+m,at<double>(seg,lay.rowLower_)) ;
+    std::copy(clp.rowUpper(),clp.rowUpper()+m,at<double>(seg,lay.rowUpper_)) ;
+    hdr->haveStatus_ = clp.statusExists() ;
+    if (hdr->haveStatus_)
+      std::copy(clp.statusArray(),clp.statusArray()+(static_cast<size_t>(n)+m),
+		at<unsigned char>(seg,lay.status_)) ;
+/*
+  Hand it over and wait, no longer than the time limit. A failure to talk to
+  the worker means it died; a worker that runs out of time is killed. The
+  next solve that takes this worker will start a new one.
+*/
+    Request req = { opSolve, worker.segSize_ } ;
+    int done = -1 ;
+    const int waitMs =
+	(solveTimeout_ > 0.0)?static_cast<int>(solveTimeout_*1000.0):-1 ;
+    int got = sendAll(worker.sock_,&req,sizeof(req)) ;
+    if (got == 0) got = recvAllBy(worker.sock_,&done,sizeof(done),waitMs) ;
+    if (got != 0) {
+      if (got == -2) {
+	std::cout
+	  << "SolverHost::solve: worker " << k << " (pid " << worker.pid_
+	  << ") passed the time limit; killed." << std::endl ;
+      } else {
+	std::cout
+	  << "SolverHost::solve: worker " << k << " (pid " << worker.pid_
+	  << ") died during the solve." << std::endl ;
+      }
+      reap(k,true) ;
+      {
+	std::lock_guard<std::mutex> guard(lock_) ;
+	if (got == -2)
+	  numTimeouts_++ ;
+	else
+	  numCrashes_++ ;
+      }
+      retval = -1 ;
+    } else {
+      result.startFill(m,n) ;
+      const unsigned int got = hdr->resultFields_ ;
+      if (got&SolveResult::statusField)
+	result.setStatus(hdr->status_,hdr->secondaryStatus_,hdr->iterations_) ;
+      if (got&SolveResult::objectiveField)
+	result.setObjectiveValue(hdr->objValue_) ;
+      if (got&SolveResult::colSolutionField)
+	getVec(result.colSolutionBuffer(),n,seg,lay.colSolution_) ;
+      if (got&SolveResult::rowActivityField)
+	getVec(result.rowActivityBuffer(),m,seg,lay.rowActivity_) ;
+      if (got&SolveResult::rowPriceField)
+	getVec(result.rowPriceBuffer(),m,seg,lay.rowPrice_) ;
+      if (got&SolveResult::reducedCostField)
+	getVec(result.reducedCostBuffer(),n,seg,lay.reducedCost_) ;
+      if (hdr->haveStatus_)
+	clp.copyinStatus(at<unsigned char>(seg,lay.status_)) ;
+      retval = hdr->retval_ ;
+    }
+  }
+/*
+  Release the worker.
+*/
+  {
+    std::lock_guard<std::mutex> guard(lock_) ;
+    worker.busy_ = false ;
+  }
+  freed_.notify_one() ;
+  return (retval) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,185 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2SolverHost.hpp
+    \brief Run ClpSimplexAPI solves in a pool of worker processes.
+*/
+#ifndef Osi2SolverHost_HPP
+#define Osi2SolverHost_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "Osi2SolveResult.hpp"
+
+namespace Osi2 {
+
+class ControlAPI ;
+class ClpSimplexAPI ;
+
+/*! \brief Out-of-process solver host
+
+  Runs solves of a ClpSimplexAPI model in separate worker processes, so that
+  a crash or runaway allocation inside the solver takes down only the
+  worker, and so that solves in different workers share no solver global
+  state. Each worker is forked from the client and creates its own
+  ClpSimplexAPI object through the client's ControlAPI, so the plugin
+  library must be loaded before #start.
+
+  Each worker has a shared memory segment. #solve writes the model (packed
+  column-major matrix, bounds, objective, and basis if there is one)
+  straight into the segment; the worker loads it from there, solves, and
+  leaves the status and requested solution vectors in the segment for
+  #solve to copy into a SolveResult. The segment grows as needed and is
+  reused from one solve to the next. A short message over a socket pair
+  starts each solve and reports its completion.
+
+  #solve may be called from several client threads at once; each call takes
+  a free worker, waiting if there is none. If a worker dies during a solve,
+  or runs past #setSolveTimeout and is killed, the call returns -1 and the
+  worker is started afresh for the next solve that needs it. A worker's
+  address space can be capped with #setWorkerMemoryLimit.
+
+  #start forks a zygote process, and every worker, including one restarted
+  after a crash, is forked by the zygote, never by the client. The zygote
+  has a single thread, so forking from it is safe however many threads the
+  client has by then; #start itself should be called before the client
+  starts threads of its own.
+*/
+class SolverHost {
+
+public:
+
+  /// Algorithm used by the worker
+  enum Method {
+    initialSolveMethod = 0,
+    dualMethod,
+    primalMethod
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor; \p ctrl must outlive the host
+  SolverHost (ControlAPI &ctrl, int numWorkers) ;
+  /// Destructor; stops the workers
+  ~SolverHost () ;
+  //@}
+
+  /*! \name Worker management */
+  //@{
+  /*! \brief Start the workers
+
+    Workers create their solver objects from the plugin library registered
+    as \p shortName, or from any library that supplies ClpSimplexAPI if
+    \p shortName is null. Returns -1 if a worker could not be started, 0
+    otherwise.
+  */
+  int start (const std::string *shortName = nullptr) ;
+  /*! \brief Stop the workers and release the shared memory
+
+    Must not be called while a #solve is in progress.
+  */
+  void stop () ;
+  /// Number of workers
+  inline int getNumWorkers () const
+  { return (static_cast<int>(workers_.size())) ; }
+  /// Number of times a worker was lost during a solve
+  inline int getNumCrashes () const { return (numCrashes_) ; }
+  /// Number of times a worker was killed for passing the time limit
+  inline int getNumTimeouts () const { return (numTimeouts_) ; }
+  //@}
+
+  /*! \name Limits */
+  //@{
+  /*! \brief Cap each worker's address space at \p bytes (0, the default,
+	     for no cap)
+
+    Applied with setrlimit(RLIMIT_AS) to workers started after the call. A
+    solve that needs more fails in the worker.
+  */
+  inline void setWorkerMemoryLimit (size_t bytes) { memLimit_ = bytes ; }
+  /// Address space cap for workers (0 for none)
+  inline size_t getWorkerMemoryLimit () const { return (memLimit_) ; }
+  /*! \brief Wait at most \p secs for a worker to finish a solve (0 or less,
+	     the default, to wait for ever)
+
+    A worker that takes longer is killed and #solve returns -1.
+  */
+  inline void setSolveTimeout (double secs) { solveTimeout_ = secs ; }
+  /// Time limit for a solve in a worker, in seconds
+  inline double getSolveTimeout () const { return (solveTimeout_) ; }
+  //@}
+
+  /*! \brief Solve the model held by \p clp in a worker
+
+    The model, objective sense, and basis (if \p clp has one) are sent to a
+    worker, which solves with \p method and returns the \p fields of the
+    solution (see SolveResult::Field) in \p result. The final basis is
+    copied back into \p clp, so a following solve, here or in process,
+    starts from it; nothing else in \p clp changes.
+
+    Returns -1 if the host is not started or the worker failed, otherwise
+    the value returned by the worker's fetchResult.
+  */
+  int solve (ClpSimplexAPI &clp, SolveResult &result,
+	     Method method = initialSolveMethod,
+	     unsigned int fields = SolveResult::allFields) ;
+
+private:
+
+  /// One worker process
+  struct Worker {
+    /// Process id; 0 if not running
+    pid_t pid_ ;
+    /// Our end of the socket pair
+    int sock_ ;
+    /// Shared memory segment
+    int shmFd_ ;
+    void *seg_ ;
+    size_t segSize_ ;
+    /// In use by a client thread
+    bool busy_ ;
+  } ;
+
+  /// Have the zygote fork worker \p k
+  int spawn (int k) ;
+  /// Let go of worker \p k, killing it if \p kill
+  void reap (int k, bool kill) ;
+  /// Make worker \p k's segment at least \p size bytes
+  int growSegment (int k, size_t size) ;
+
+  /// Plugin library management
+  ControlAPI &ctrl_ ;
+  /// Plugin library for the workers (empty for any)
+  std::string shortName_ ;
+  bool haveShortName_ ;
+  /// Workers
+  std::vector<Worker> workers_ ;
+  /// Limits
+  size_t memLimit_ ;
+  double solveTimeout_ ;
+  /// Number of workers lost, and killed for time
+  int numCrashes_ ;
+  int numTimeouts_ ;
+  /// Started?
+  bool started_ ;
+  /// Guards workers_ between client threads
+  std::mutex lock_ ;
+  std::condition_variable freed_ ;
+  /// The zygote and our end of its socket pair
+  pid_t zygotePid_ ;
+  int zygoteSock_ ;
+  /// Serialises requests to the zygote
+  std::mutex zygoteLock_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -0,0 +1,136 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::StrongBranch.
+*/
+
+#include <cmath>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2StrongBranch.hpp"
+
+namespace Osi2 {
+
+StrongBranch::StrongBranch (int numThreads, int iterLimit)
+  : numThreads_(numThreads),
+    iterLimit_(iterLimit),
+    nodeInfeasible_(false)
+{ }
+
+StrongBranch::~StrongBranch () { }
+
+/*
+  Classify the outcome of a solve from the hot start. Infeasibility is
+  checked first: a branch that is both infeasible and past the cutoff should
+  be reported as infeasible.
+*/
+void StrongBranch::solveBranch (Osi1API &clone, double &obj,
+				BranchStatus &status, int &iters) const
+{
+  clone.solveFromHotStart() ;
+  iters = clone.getIterationCount() ;
+  obj = clone.getObjValue() ;
+  if (clone.isProvenPrimalInfeasible())
+    status = infeasible ;
+  else if (clone.isDualObjectiveLimitReached())
+    status = cutoff ;
+  else if (clone.isProvenOptimal())
+    status = optimal ;
+  else if (clone.isIterationLimitReached())
+    status = iterLimit ;
+  else
+    status = abandoned ;
+}
+
+/*
+  The clones are made here, in the calling thread, one per chunk; clone() is
+  not assumed to be safe against concurrent use of the original. Each worker
+  then owns its clone outright and writes only the results for its own
+  candidates.
+*/
+int StrongBranch::evaluate (const Osi1API &si,
+			    const std::vector<Candidate> &candidates)
+{
+  const int numCands = static_cast<int>(candidates.size()) ;
+  results_.resize(numCands) ;
+  changes_.clear() ;
+  nodeInfeasible_ = false ;
+  if (numCands == 0) return (0) ;
+
+  const int chunks = numChunks(numCands,numThreads_) ;
+  std::vector<Osi1API *> clones(chunks) ;
+  for (int k = 0 ; k < chunks ; k++) clones[k] = si.clone() ;
+
+  const int limit = iterLimit_ ;
+  parallelFor(numCands,numThreads_,
+	      [this,&candidates,&clones,limit](int first, int last, int chunk) {
+		Osi1API &clone = *clones[chunk] ;
+		clone.resolve() ;
+		clone.setIntParam(OsiMaxNumIterationHotStart,limit) ;
+		clone.markHotStart() ;
+		for (int k = first ; k < last ; k++) {
+		  const Candidate &cand = candidates[k] ;
+		  Result &res = results_[k] ;
+		  res.col_ = cand.col_ ;
+		  res.value_ = cand.value_ ;
+		  const double lb = clone.getColLower()[cand.col_] ;
+		  const double ub = clone.getColUpper()[cand.col_] ;
+
+		  clone.setColUpper(cand.col_,std::floor(cand.value_)) ;
+		  solveBranch(clone,res.downObj_,res.downStatus_,res.downIters_) ;
+		  clone.setColUpper(cand.col_,ub) ;
+
+		  clone.setColLower(cand.col_,std::ceil(cand.value_)) ;
+		  solveBranch(clone,res.upObj_,res.upStatus_,res.upIters_) ;
+		  clone.setColLower(cand.col_,lb) ;
+		}
+		clone.unmarkHotStart() ;
+	      }) ;
+
+  for (Osi1API *clone : clones) delete clone ;
+/*
+  Derive bound changes in candidate order. If the down branch is dead, the
+  variable can be fixed up; if the up branch is dead, fixed down. If both are
+  dead, the node is infeasible.
+*/
+  for (int k = 0 ; k < numCands ; k++) {
+    const Result &res = results_[k] ;
+    const bool downDead =
+      (res.downStatus_ == infeasible || res.downStatus_ == cutoff) ;
+    const bool upDead =
+      (res.upStatus_ == infeasible || res.upStatus_ == cutoff) ;
+    if (downDead && upDead) {
+      nodeInfeasible_ = true ;
+      continue ;
+    }
+    if (!downDead && !upDead) continue ;
+    BoundChange change ;
+    change.col_ = res.col_ ;
+    change.lower_ = si.getColLower()[res.col_] ;
+    change.upper_ = si.getColUpper()[res.col_] ;
+    if (downDead)
+      change.lower_ = std::ceil(res.value_) ;
+    else
+      change.upper_ = std::floor(res.value_) ;
+    changes_.push_back(change) ;
+  }
+  if (nodeInfeasible_) return (-1) ;
+  return (static_cast<int>(changes_.size())) ;
+}
+
+int StrongBranch::applyBoundChanges (Osi1API &si) const
+{
+  for (const BoundChange &change : changes_)
+    si.setColBounds(change.col_,change.lower_,change.upper_) ;
+  return (static_cast<int>(changes_.size())) ;
+}
+
+}  // end namespace Osi2
@@ -0,0 +1,149 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2StrongBranch.hpp
+    \brief Parallel strong branching over Osi1API hot starts.
+*/
+#ifndef Osi2StrongBranch_HPP
+#define Osi2StrongBranch_HPP
+
+#include <vector>
+
+namespace Osi2 {
+
+class Osi1API ;
+
+/*! \brief Strong branching engine
+
+  Given a solved Osi1API object and a list of branching candidates, evaluate
+  the down (x <= floor(v)) and up (x >= ceil(v)) branch of each candidate
+  with an iteration-limited solve from a hot start.
+
+  The work is spread over worker threads. Each worker gets its own clone of
+  the solver (Osi1API::clone), marks a hot start on it, and evaluates a
+  contiguous block of candidates. The original solver is not touched by
+  #evaluate. Because each branch is solved from the marked hot start with
+  the candidate's bounds restored afterward, the result for a candidate does
+  not depend on which other candidates share its worker; results, and the
+  bound changes derived from them, are the same for any number of threads.
+
+  Cloning copies the solver's data; for small candidate lists it may be
+  cheaper to use fewer threads.
+*/
+class StrongBranch {
+
+public:
+
+  /// Outcome of one branch
+  enum BranchStatus {
+    /// Solved to optimality within the iteration limit
+    optimal = 0,
+    /// Proven primal infeasible
+    infeasible,
+    /// Dual objective limit reached (branch can be pruned)
+    cutoff,
+    /// Iteration limit reached; objective is a bound only
+    iterLimit,
+    /// Solver gave up
+    abandoned
+  } ;
+
+  /// A branching candidate
+  struct Candidate {
+    /// Column index
+    int col_ ;
+    /// Current (fractional) value
+    double value_ ;
+  } ;
+
+  /// Result of evaluating one candidate
+  struct Result {
+    /// Column index
+    int col_ ;
+    /// Value at the parent
+    double value_ ;
+    /// Objective after the down branch
+    double downObj_ ;
+    /// Objective after the up branch
+    double upObj_ ;
+    /// Outcome of the down branch
+    BranchStatus downStatus_ ;
+    /// Outcome of the up branch
+    BranchStatus upStatus_ ;
+    /// Iterations for the down branch
+    int downIters_ ;
+    /// Iterations for the up branch
+    int upIters_ ;
+  } ;
+
+  /// A bound change implied by strong branching
+  struct BoundChange {
+    /// Column index
+    int col_ ;
+    /// New lower bound
+    double lower_ ;
+    /// New upper bound
+    double upper_ ;
+  } ;
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  StrongBranch (int numThreads = 1, int iterLimit = 100) ;
+  /// Destructor
+  ~StrongBranch () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Number of worker threads (and solver clones)
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /// Iteration limit for each branch
+  inline void setIterationLimit (int limit) { iterLimit_ = limit ; }
+  //@}
+
+  /*! \brief Evaluate the candidates
+
+    \p si must hold an optimal solution. Returns the number of bound changes
+    found, or -1 if some candidate has both branches infeasible (the node
+    can be pruned).
+  */
+  int evaluate (const Osi1API &si, const std::vector<Candidate> &candidates) ;
+
+  /// Results, in candidate order
+  inline const std::vector<Result> &getResults () const { return (results_) ; }
+
+  /// Bound changes, in candidate order
+  inline const std::vector<BoundChange> &getBoundChanges () const
+  { return (changes_) ; }
+
+  /// True if the last evaluation proved the node infeasible
+  inline bool nodeInfeasible () const { return (nodeInfeasible_) ; }
+
+  /// Apply the bound changes to \p si; returns the number applied
+  int applyBoundChanges (Osi1API &si) const ;
+
+private:
+
+  /// Solve one branch on a hot-started clone and classify the outcome
+  void solveBranch (Osi1API &clone, double &obj, BranchStatus &status,
+		    int &iters) const ;
+
+  /// Worker threads
+  int numThreads_ ;
+  /// Iteration limit per branch
+  int iterLimit_ ;
+  /// Results of the last evaluation
+  std::vector<Result> results_ ;
+  /// Bound changes from the last evaluation
+  std::vector<BoundChange> changes_ ;
+  /// Node infeasible?
+  bool nodeInfeasible_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
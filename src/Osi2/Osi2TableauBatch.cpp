@@ -0,0 +1,146 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains the implementation of the methods for Osi2::TableauBatch.
+*/
+
+#include <cmath>
+#include <iostream>
+
+#include "Osi2Config.h"
+
+#include "Osi2API.hpp"
+#include "Osi2Osi1API.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2TableauBatch.hpp"
+
+namespace {
+
+/*
+  Append the entries of dense[0..len-1] with absolute value above tol, with
+  index offset base. Returns the number appended.
+*/
+int appendSparse (const double *dense, int len, int base, double tol,
+		  std::vector<int> &indices, std::vector<double> &elements)
+{
+  int cnt = 0 ;
+  for (int i = 0 ; i < len ; i++) {
+    if (std::fabs(dense[i]) > tol) {
+      indices.push_back(base+i) ;
+      elements.push_back(dense[i]) ;
+      cnt++ ;
+    }
+  }
+  return (cnt) ;
+}
+
+}  // end anonymous namespace
+
+
+namespace Osi2 {
+
+TableauBatch::TableauBatch (int numThreads)
+  : numThreads_(numThreads),
+    minChunk_(16),
+    zeroTol_(1.0e-12),
+    starts_(1,0)
+{ }
+
+TableauBatch::~TableauBatch () { }
+
+int TableauBatch::getBInvARows (const Osi1API &si, int num, const int *rows,
+				bool withSlacks)
+{
+  return (extract(si,num,rows,true,withSlacks)) ;
+}
+
+int TableauBatch::getBInvACols (const Osi1API &si, int num, const int *cols)
+{
+  return (extract(si,num,cols,false,false)) ;
+}
+
+/*
+  Check the indices, make one clone for each chunk after the first, and let
+  each chunk extract its vectors into its own buffers. The buffers are then
+  concatenated in chunk order.
+*/
+int TableauBatch::extract (const Osi1API &si, int num, const int *which,
+			   bool doRows, bool withSlacks)
+{
+  starts_.resize(1) ;
+  indices_.clear() ;
+  elements_.clear() ;
+  const int m = si.getNumRows() ;
+  const int n = si.getNumCols() ;
+  const int limit = (doRows)?m:n ;
+  for (int k = 0 ; k < num ; k++) {
+    if (which[k] < 0 || which[k] >= limit) {
+      std::cout
+	<< "TableauBatch: " << ((doRows)?"row":"column") << " index "
+	<< which[k] << " is out of range [0," << limit << ")." << std::endl ;
+      return (-1) ;
+    }
+  }
+  if (num == 0) return (0) ;
+
+  const int chunks = numChunks(num,numThreads_,minChunk_) ;
+  std::vector<Osi1API *> clones(chunks,nullptr) ;
+  for (int c = 1 ; c < chunks ; c++) clones[c] = si.clone() ;
+  chunkOut_.resize(chunks) ;
+
+  const double tol = zeroTol_ ;
+  parallelFor(num,numThreads_,
+	      [&,tol](int first, int last, int chunk) {
+/*
+  A clone has the basis but not necessarily the factorization. Resolve (zero
+  iterations from an optimal basis) before enabling the factorization.
+*/
+		const Osi1API *solver = &si ;
+		if (chunk > 0) {
+		  clones[chunk]->resolve() ;
+		  solver = clones[chunk] ;
+		}
+		solver->enableFactorization() ;
+		ChunkOut &out = chunkOut_[chunk] ;
+		out.lengths_.clear() ;
+		out.indices_.clear() ;
+		out.elements_.clear() ;
+		std::vector<double> dense((doRows)?n:m) ;
+		std::vector<double> slack((doRows && withSlacks)?m:0) ;
+		for (int k = first ; k < last ; k++) {
+		  int len = 0 ;
+		  if (doRows) {
+		    solver->getBInvARow(which[k],dense.data(),
+					(withSlacks)?slack.data():nullptr) ;
+		    len = appendSparse(dense.data(),n,0,tol,
+				       out.indices_,out.elements_) ;
+		    if (withSlacks)
+		      len += appendSparse(slack.data(),m,n,tol,
+					  out.indices_,out.elements_) ;
+		  } else {
+		    solver->getBInvACol(which[k],dense.data()) ;
+		    len = appendSparse(dense.data(),m,0,tol,
+				       out.indices_,out.elements_) ;
+		  }
+		  out.lengths_.push_back(len) ;
+		}
+		solver->disableFactorization() ;
+	      },minChunk_) ;
+
+  for (Osi1API *clone : clones) delete clone ;
+
+  for (int c = 0 ; c < chunks ; c++) {
+    const ChunkOut &out = chunkOut_[c] ;
+    for (int len : out.lengths_) starts_.push_back(starts_.back()+len) ;
+    indices_.insert(indices_.end(),out.indices_.begin(),out.indices_.end()) ;
+    elements_.insert(elements_.end(),
+		     out.elements_.begin(),out.elements_.end()) ;
+  }
+  return (num) ;
+}
+
+}  // end namespace Osi2
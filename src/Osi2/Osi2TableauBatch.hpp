@@ -0,0 +1,127 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+*/
+/*! \file Osi2TableauBatch.hpp
+    \brief Batched, sparse extraction of rows and columns of B-inverse A.
+*/
+#ifndef Osi2TableauBatch_HPP
+#define Osi2TableauBatch_HPP
+
+#include <vector>
+
+namespace Osi2 {
+
+class Osi1API ;
+
+/*! \brief Batched tableau extraction
+
+  Osi1API::getBInvARow and Osi1API::getBInvACol return one dense vector per
+  call. A Gomory-style separator wants many of them, and wants them sparse.
+  TableauBatch takes a list of row (or column) indices, extracts the
+  corresponding vectors in parallel, and returns them packed in row-major
+  (CSR) form: vector k occupies positions [getStarts()[k],getStarts()[k+1])
+  of getIndices() and getElements(). Entries with absolute value at or below
+  the zero tolerance are dropped.
+
+  For rows, indices [0,n) refer to structural columns and [n,n+m) to
+  slacks. For columns, indices are basis positions, as for
+  Osi1API::getBInvACol.
+
+  The solver's factorization is not safe to use from several threads at
+  once: the solve routines use the factorization's work arrays. Each
+  additional thread therefore works on a clone of the solver, which is
+  brought back to the same optimal basis and factored, giving every thread
+  an identical factorization of its own. The first chunk of indices is
+  handled by the original solver in the calling thread, so a single-threaded
+  call makes no clones. Results are returned in the order requested and do
+  not depend on the number of threads.
+*/
+class TableauBatch {
+
+public:
+
+  /*! \name Constructors and destructor */
+  //@{
+  /// Constructor
+  TableauBatch (int numThreads = 1) ;
+  /// Destructor
+  ~TableauBatch () ;
+  //@}
+
+  /*! \name Parameters */
+  //@{
+  /// Number of threads
+  inline void setNumThreads (int numThreads) { numThreads_ = numThreads ; }
+  /*! \brief Smallest number of vectors worth giving to a thread
+
+    A thread costs a clone and a factorization; there's no point in paying
+    that for a handful of solves. The default is 16.
+  */
+  inline void setMinChunk (int minChunk) { minChunk_ = minChunk ; }
+  /// Entries with absolute value at or below this are dropped (default 1e-12)
+  inline void setZeroTol (double tol) { zeroTol_ = tol ; }
+  //@}
+
+  /*! \name Extraction
+
+    \p si must hold an optimal basis. These methods call
+    Osi1API::enableFactorization and Osi1API::disableFactorization on \p si;
+    the client should not have the factorization enabled when calling.
+    Each returns the number of vectors extracted, or -1 if an index is out
+    of range.
+  */
+  //@{
+  /// Rows \p rows[0..num-1] of B-inverse A, with slacks if \p withSlacks
+  int getBInvARows (const Osi1API &si, int num, const int *rows,
+		    bool withSlacks = true) ;
+  /// Columns \p cols[0..num-1] of B-inverse A
+  int getBInvACols (const Osi1API &si, int num, const int *cols) ;
+  //@}
+
+  /*! \name Results */
+  //@{
+  /// Number of vectors from the last extraction
+  inline int getNumVectors () const
+  { return (static_cast<int>(starts_.size())-1) ; }
+  /// Vector starts (getNumVectors()+1 entries)
+  inline const int *getStarts () const { return (starts_.data()) ; }
+  /// Indices of the nonzeros
+  inline const int *getIndices () const { return (indices_.data()) ; }
+  /// Values of the nonzeros
+  inline const double *getElements () const { return (elements_.data()) ; }
+  //@}
+
+private:
+
+  /// Nonzeros collected by one chunk
+  struct ChunkOut {
+    std::vector<int> lengths_ ;
+    std::vector<int> indices_ ;
+    std::vector<double> elements_ ;
+  } ;
+
+  /// Common driver for rows and columns
+  int extract (const Osi1API &si, int num, const int *which,
+	       bool doRows, bool withSlacks) ;
+
+  /// Number of threads
+  int numThreads_ ;
+  /// Minimum vectors per thread
+  int minChunk_ ;
+  /// Drop tolerance
+  double zeroTol_ ;
+
+  /// Results
+  std::vector<int> starts_ ;
+  std::vector<int> indices_ ;
+  std::vector<double> elements_ ;
+  /// Per-chunk results, combined in chunk order
+  std::vector<ChunkOut> chunkOut_ ;
+} ;
+
+}  // end namespace Osi2
+
+#endif
@@ -1,13 +1,64 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 #include "OsiXForm.h"
 
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+namespace {
+
+// OS writes a missing bound as an IEEE infinity; Clp wants DBL_MAX
+double clpBound(double value)
+{
+    if (value > DBL_MAX) return DBL_MAX;
+    if (value < -DBL_MAX) return -DBL_MAX;
+    return value;
+}//end clpBound
+
+}
+
+
 OsiXForm::OsiXForm()
 {
+    opid = OSIXFORM_UNKNOWN;
 }
 
 OsiXForm::~OsiXForm()
 {
 }
 
+bool OsiXForm::coalesce(OsiXForm* later)
+{
+    return false;
+}//end coalesce
+
+OsiXForm* OsiXForm::clone() const
+{
+    return NULL;
+}//end clone
+
+bool OsiXForm::apply(OSInstance* instance)
+{
+    return false;
+}//end apply
+
+bool OsiXForm::apply(Osi2::ClpSimplexAPI* clp)
+{
+    return false;
+}//end apply
+
+OsiXForm* OsiXForm::inverse(Osi2::ClpSimplexAPI* clp) const
+{
+    return NULL;
+}//end inverse
+
+int OsiXForm::size() const
+{
+    return 1;
+}//end size
+
 
 void ModifyConstraintBounds::record( )
 {
@@ -18,10 +69,205 @@ void ModifyConstraintBounds::record( )
 void ModifyConstraintBounds::modify()
 {
     cout << "performing modification: " << opid << endl;
-    osinstance->setConstraints(number, names, lowerBounds, upperBounds, constants);
+    apply(osinstance);
 }// end modify
 
 
+// a full replacement supersedes whatever came before it, so it is taken over
+// whole, as a copy. Sparse edits merge into sparse edits. Sparse edits after
+// a full replacement are left as they are.
+bool ModifyConstraintBounds::coalesce(OsiXForm* later)
+{
+    if (later->opid != opid) return false;
+    ModifyConstraintBounds* other = static_cast<ModifyConstraintBounds*>(later);
+    if (other->osinstance != osinstance) return false;
+    if (!other->sparse) {
+        edits.clear();
+        copyFull(*other);
+        return true;
+    }
+    if (!sparse) return false;
+    std::map<int, BoundEdit>::const_iterator iter;
+    for (iter = other->edits.begin(); iter != other->edits.end(); iter++) {
+        BoundEdit& edit = edits[iter->first];
+        if (iter->second.hasLower) {
+            edit.hasLower = true;
+            edit.lower = iter->second.lower;
+        }
+        if (iter->second.hasUpper) {
+            edit.hasUpper = true;
+            edit.upper = iter->second.upper;
+        }
+    }
+    return true;
+}//end coalesce
+
+
+// the sparse form writes the constraints directly and marks them modified, so
+// that the instance rebuilds its processed bound arrays on next use. Its
+// bounds are on ax; the instance's are on ax + c.
+bool ModifyConstraintBounds::apply(OSInstance* instance)
+{
+    if (instance == NULL) return false;
+    if (!sparse)
+        return instance->setConstraints(number, names, lowerBounds, upperBounds, constants);
+    Constraints* cons = instance->instanceData->constraints;
+    if (cons == NULL) return false;
+    std::map<int, BoundEdit>::const_iterator iter;
+    for (iter = edits.begin(); iter != edits.end(); iter++) {
+        if (iter->first < 0 || iter->first >= cons->numberOfConstraints) {
+            cout << "constraint " << iter->first << " does not exist" << endl;
+            return false;
+        }
+    }
+    for (iter = edits.begin(); iter != edits.end(); iter++) {
+        Constraint* con = cons->con[iter->first];
+        if (iter->second.hasLower) con->lb = iter->second.lower + con->constant;
+        if (iter->second.hasUpper) con->ub = iter->second.upper + con->constant;
+    }
+    instance->bConstraintsModified = true;
+    return true;
+}//end apply
+
+
+// Clp takes bounds an array at a time, so either form ends in one call per
+// bound array. A constraint constant c of the full form moves the row:
+// lb <= ax + c <= ub is lb - c <= ax <= ub - c. The sparse form's bounds are
+// on ax already.
+bool ModifyConstraintBounds::apply(Osi2::ClpSimplexAPI* clp)
+{
+    if (clp == NULL) return false;
+    const int m = clp->numberRows();
+    std::vector<double> lower(clp->rowLower(), clp->rowLower() + m);
+    std::vector<double> upper(clp->rowUpper(), clp->rowUpper() + m);
+    bool lowerChanged = false;
+    bool upperChanged = false;
+    if (!sparse) {
+        if (number != m) {
+            cout << number << " constraints given for " << m << " rows" << endl;
+            return false;
+        }
+        for (int i = 0; i < m; i++) {
+            const double c = (constants != NULL) ? constants[i] : 0.0;
+            lower[i] = (lowerBounds != NULL) ? clpBound(lowerBounds[i]) - c : -DBL_MAX;
+            upper[i] = (upperBounds != NULL) ? clpBound(upperBounds[i]) - c : DBL_MAX;
+            if (names != NULL) clp->setRowName(i, names[i].c_str());
+        }
+        lowerChanged = true;
+        upperChanged = true;
+    } else {
+        std::map<int, BoundEdit>::const_iterator iter;
+        for (iter = edits.begin(); iter != edits.end(); iter++) {
+            if (iter->first < 0 || iter->first >= m) {
+                cout << "constraint " << iter->first << " does not exist" << endl;
+                return false;
+            }
+            if (iter->second.hasLower) {
+                lower[iter->first] = clpBound(iter->second.lower);
+                lowerChanged = true;
+            }
+            if (iter->second.hasUpper) {
+                upper[iter->first] = clpBound(iter->second.upper);
+                upperChanged = true;
+            }
+        }
+    }
+    if (lowerChanged) clp->chgRowLower(&lower[0]);
+    if (upperChanged) clp->chgRowUpper(&upper[0]);
+    return true;
+}//end apply
+
+
+OsiXForm* ModifyConstraintBounds::inverse(Osi2::ClpSimplexAPI* clp) const
+{
+    if (clp == NULL) return NULL;
+    const int m = clp->numberRows();
+    const double* lower = clp->rowLower();
+    const double* upper = clp->rowUpper();
+    ModifyConstraintBounds* undo = new ModifyConstraintBounds();
+    undo->osinstance = osinstance;
+    // the full form is undone by a full form with no constants, so its bounds
+    // are the row bounds. Names are read through a buffer long enough for the
+    // names Clp makes up for unnamed rows.
+    if (!sparse) {
+        undo->number = m;
+        undo->lowerStore.assign(lower, lower + m);
+        undo->upperStore.assign(upper, upper + m);
+        if (names != NULL) {
+            std::vector<char> buf(std::max(clp->lengthNames(), 255) + 1);
+            undo->nameStore.resize(m);
+            for (int i = 0; i < m; i++) {
+                clp->rowName(i, &buf[0]);
+                undo->nameStore[i] = &buf[0];
+            }
+        }
+        if (m > 0) {
+            undo->lowerBounds = &undo->lowerStore[0];
+            undo->upperBounds = &undo->upperStore[0];
+            if (names != NULL) undo->names = &undo->nameStore[0];
+        }
+        return undo;
+    }
+    undo->sparse = true;
+    std::map<int, BoundEdit>::const_iterator iter;
+    for (iter = edits.begin(); iter != edits.end(); iter++) {
+        if (iter->first < 0 || iter->first >= m) {
+            delete undo;
+            return NULL;
+        }
+        BoundEdit& edit = undo->edits[iter->first];
+        if (iter->second.hasLower) {
+            edit.hasLower = true;
+            edit.lower = lower[iter->first];
+        }
+        if (iter->second.hasUpper) {
+            edit.hasUpper = true;
+            edit.upper = upper[iter->first];
+        }
+    }
+    return undo;
+}//end inverse
+
+
+int ModifyConstraintBounds::size() const
+{
+    return sparse ? (int)edits.size() : number;
+}//end size
+
+
+OsiXForm* ModifyConstraintBounds::clone() const
+{
+    ModifyConstraintBounds* copy = new ModifyConstraintBounds();
+    copy->osinstance = osinstance;
+    copy->edits = edits;
+    if (sparse)
+        copy->sparse = true;
+    else
+        copy->copyFull(*this);
+    return copy;
+}//end clone
+
+
+void ModifyConstraintBounds::copyFull(const ModifyConstraintBounds& other)
+{
+    sparse = false;
+    number = other.number;
+    const int n = (number > 0) ? number : 0;
+    nameStore.clear();
+    lowerStore.clear();
+    upperStore.clear();
+    constantStore.clear();
+    if (other.names != NULL) nameStore.assign(other.names, other.names + n);
+    if (other.lowerBounds != NULL) lowerStore.assign(other.lowerBounds, other.lowerBounds + n);
+    if (other.upperBounds != NULL) upperStore.assign(other.upperBounds, other.upperBounds + n);
+    if (other.constants != NULL) constantStore.assign(other.constants, other.constants + n);
+    names = (other.names != NULL && n > 0) ? &nameStore[0] : NULL;
+    lowerBounds = (other.lowerBounds != NULL && n > 0) ? &lowerStore[0] : NULL;
+    upperBounds = (other.upperBounds != NULL && n > 0) ? &upperStore[0] : NULL;
+    constants = (other.constants != NULL && n > 0) ? &constantStore[0] : NULL;
+}//end copyFull
+
+
 ModifyConstraintBounds::ModifyConstraintBounds(OSInstance* _osinstance, int _number,
         std::string* _names, double* _lowerBounds, double* _upperBounds, double* _constants)
 {
@@ -31,14 +277,46 @@ ModifyConstraintBounds::ModifyConstraintBounds(OSInstance* _osinstance, int _num
     lowerBounds = _lowerBounds;
     upperBounds = _upperBounds;
     constants = _constants;
-    opid = 17;
-}//end ModifyConstraintRhs
+    sparse = false;
+    opid = OSIXFORM_CONSTRAINT_BOUNDS;
+}//end ModifyConstraintBounds
+
+ModifyConstraintBounds::ModifyConstraintBounds(OSInstance* _osinstance, int _number,
+        const int* _indices, const double* _lowerBounds, const double* _upperBounds)
+{
+    osinstance = _osinstance;
+    number = 0;
+    names = NULL;
+    lowerBounds = NULL;
+    upperBounds = NULL;
+    constants = NULL;
+    sparse = true;
+    opid = OSIXFORM_CONSTRAINT_BOUNDS;
+    for (int k = 0; k < _number; k++) {
+        BoundEdit& edit = edits[_indices[k]];
+        if (_lowerBounds != NULL) {
+            edit.hasLower = true;
+            edit.lower = _lowerBounds[k];
+        }
+        if (_upperBounds != NULL) {
+            edit.hasUpper = true;
+            edit.upper = _upperBounds[k];
+        }
+    }
+}//end ModifyConstraintBounds
 
 ModifyConstraintBounds::ModifyConstraintBounds()
 {
-    opid = 17;
-}//end ModifyConstraintRhs
+    osinstance = NULL;
+    number = 0;
+    names = NULL;
+    lowerBounds = NULL;
+    upperBounds = NULL;
+    constants = NULL;
+    sparse = false;
+    opid = OSIXFORM_CONSTRAINT_BOUNDS;
+}//end ModifyConstraintBounds
 
 ModifyConstraintBounds::~ModifyConstraintBounds()
 {
-}//end ~ModifyConstraintRhs
+}//end ~ModifyConstraintBounds
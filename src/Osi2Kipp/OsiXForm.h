@@ -11,6 +11,16 @@
 using std::cout;
 using std::endl;
 
+namespace Osi2 {
+class ClpSimplexAPI;
+}
+
+// the kinds of transform; the value of OsiXForm::opid
+enum OsiXFormKind {
+    OSIXFORM_UNKNOWN = 0,
+    OSIXFORM_CONSTRAINT_BOUNDS = 17
+};
+
 // this is the virtual class that all command modification classes inherite from
 class OsiXForm {
 public:
@@ -18,8 +28,49 @@ public:
     virtual void record() = 0;
     // this method will execute the operations that have been accumulated in the queue
     virtual void modify() = 0;
+    /**
+     * fold a later transform of the same kind into this one, so that the pair can
+     * be applied as one. The later transform is unchanged, and is dropped from the
+     * queue by the caller. OsiXFormMgr only merges into copies it made with
+     * clone(), never into a transform it was given.
+     *
+     * @return false if the two can't be merged (the default); this one is then
+     * unchanged.
+     */
+    virtual bool coalesce(OsiXForm* later);
+    /**
+     * make an independent copy, holding its own copies of any arrays. The caller
+     * owns the copy.
+     *
+     * @return NULL if this kind of transform can't be copied (the default).
+     */
+    virtual OsiXForm* clone() const;
+    /**
+     * apply the transform to an instance in a single pass.
+     *
+     * @return false if this kind of transform can't be applied to an instance
+     * (the default) or the transform doesn't fit the instance.
+     */
+    virtual bool apply(OSInstance* instance);
+    /**
+     * apply the transform to a live solver in a single pass.
+     *
+     * @return false if this kind of transform can't be applied to a solver (the
+     * default) or the transform doesn't fit the model.
+     */
+    virtual bool apply(Osi2::ClpSimplexAPI* clp);
+    /**
+     * build the transform that undoes this one on a solver as it stands now,
+     * before this one is applied. The inverse holds only what this transform
+     * changes. The caller owns the inverse.
+     *
+     * @return NULL if this kind of transform can't be inverted (the default).
+     */
+    virtual OsiXForm* inverse(Osi2::ClpSimplexAPI* clp) const;
+    // the number of elementary edits held, for reporting (default 1)
+    virtual int size() const;
     // opid is an integer that identifies each kind of operation, e.g. delete a constraint,
-    // add a variable etc.
+    // add a variable etc. One of OsiXFormKind.
     int opid;
     // the constructor and destructor
     OsiXForm();
@@ -27,16 +78,36 @@ public:
 }; //class OsiXForm
 
 
-// an example command class, delete a bunch of constraints
-// modify a single constraint one-at-a-time
+// an example command class: change constraint bounds. There are two forms.
+// The full form replaces every constraint, through OSInstance::setConstraints;
+// its bounds are on ax + c, c the constraint constant it gives. The sparse
+// form changes the bounds of the listed constraints only, and sparse edits
+// coalesce: any number of them merge into one sparse update, a later edit of
+// the same bound of the same constraint winning. Its bounds are on the row
+// activity ax, as a solver holds them, on every target: on an OSInstance each
+// is shifted by the constraint's constant.
+//
+// The full form given to the constructor refers to the caller's arrays; a
+// copy made by clone(), or a full form merged in by coalesce(), holds its own.
 class ModifyConstraintBounds : public OsiXForm {
 public:
+    // a sparse edit of one constraint
+    struct BoundEdit {
+        bool hasLower;
+        bool hasUpper;
+        double lower;
+        double upper;
+    };
     OSInstance *osinstance;
     int number;
     std::string* names;
     double* lowerBounds;
     double* upperBounds;
     double* constants;
+    // true for the sparse form
+    bool sparse;
+    // the sparse edits, by constraint index
+    std::map<int, BoundEdit> edits;
 // constructors and destructors
     /**
      * set all the constraint related elements. All the previous constraint-related elements will be deleted.
@@ -50,14 +121,45 @@ public:
      * @return whether the constraints are set successfully.
      */
     ModifyConstraintBounds(OSInstance* _osinstance, int number, std::string* names, double* lowerBounds, double* upperBounds, double* constants);
+    /**
+     * change the bounds of some constraints, leaving the rest alone. The arrays
+     * are copied.
+     *
+     * @param number holds the number of constraints to change.
+     * @param indices holds the indices of the constraints to change.
+     * @param lowerBounds holds the new lower bounds; use null to leave the lower bounds alone.
+     * @param upperBounds holds the new upper bounds; use null to leave the upper bounds alone.
+     */
+    ModifyConstraintBounds(OSInstance* _osinstance, int number, const int* indices, const double* lowerBounds, const double* upperBounds);
     ModifyConstraintBounds();
     virtual ~ModifyConstraintBounds();
 
     // other methods
     void record();
     void modify();
+    bool coalesce(OsiXForm* later);
+    OsiXForm* clone() const;
+    bool apply(OSInstance* instance);
+    bool apply(Osi2::ClpSimplexAPI* clp);
+    // the transform restoring the current bounds of the constraints this one
+    // changes: a sparse edit for the sparse form, a full form, with the
+    // current row names if this one sets names, for the full form
+    OsiXForm* inverse(Osi2::ClpSimplexAPI* clp) const;
+    int size() const;
+
+private:
+    // take over the full form of other, copying its arrays into our own
+    void copyFull(const ModifyConstraintBounds& other);
+    // our own copies of the full form's arrays
+    std::vector<std::string> nameStore;
+    std::vector<double> lowerStore;
+    std::vector<double> upperStore;
+    std::vector<double> constantStore;
+    // copies are made with clone()
+    ModifyConstraintBounds(const ModifyConstraintBounds&);
+    ModifyConstraintBounds& operator=(const ModifyConstraintBounds&);
 
-}; //class DeleteConstraints
+}; //class ModifyConstraintBounds
 
 
 
@@ -1,11 +1,42 @@
+#include <algorithm>
+#include <chrono>
+
 #include "OsiXFormMgr.h"
 
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+namespace {
+
+// the solver's basis, or nothing if it has none
+void saveBasis( Osi2::ClpSimplexAPI* clp, std::vector<unsigned char>& basis)
+{
+    basis.clear();
+    if (!clp->statusExists()) return;
+    const unsigned char* status = clp->statusArray();
+    basis.assign( status, status + clp->numberRows() + clp->numberColumns());
+}//saveBasis
+
+// put back a saved basis, if there is one and it fits
+void restoreBasis( Osi2::ClpSimplexAPI* clp, const std::vector<unsigned char>& basis)
+{
+    if (basis.empty()) return;
+    if ((int)basis.size() != clp->numberRows() + clp->numberColumns()) return;
+    clp->copyinStatus( &basis[0]);
+}//restoreBasis
+
+}
+
+
 OsiXFormMgr::OsiXFormMgr()
 {
+    journalPos = 0;
 }
 
 OsiXFormMgr::~OsiXFormMgr()
 {
+    clearJournal();
+    clearCopies();
 }
 
 
@@ -14,21 +45,216 @@ OsiXFormMgr::~OsiXFormMgr()
 void OsiXFormMgr::record( OsiXForm* osmod)
 {
     modObjects.push_back( osmod);
+    mergeCounts.push_back( 1);
 }//record
 
 
+// each transform is offered to the latest kept transform of its kind, which
+// is the only one it can be merged with without reordering edits of that kind.
+// A kept transform the manager doesn't own is copied before the merge, and the
+// copy kept instead; a copy that refuses the merge is thrown away.
+int OsiXFormMgr::coalesce()
+{
+    // transforms pushed straight onto modObjects stand for themselves
+    mergeCounts.resize( modObjects.size(), 1);
+    std::vector<OsiXForm*> kept;
+    std::vector<int> keptCounts;
+    for (size_t k = 0; k < modObjects.size(); k++) {
+        OsiXForm* xform = modObjects[k];
+        int target = -1;
+        for (int r = (int)kept.size() - 1; r >= 0; r--) {
+            if (kept[r]->opid == xform->opid) {
+                target = r;
+                break;
+            }
+        }
+        OsiXForm* into = NULL;
+        if (target >= 0) {
+            const bool owned =
+                std::find( copies.begin(), copies.end(), kept[target]) != copies.end();
+            into = owned ? kept[target] : kept[target]->clone();
+            if (into != NULL && into->coalesce( xform)) {
+                if (!owned) {
+                    copies.push_back( into);
+                    kept[target] = into;
+                }
+            } else {
+                if (!owned) delete into;
+                into = NULL;
+            }
+        }
+        if (into != NULL) {
+            keptCounts[target] += mergeCounts[k];
+        } else {
+            kept.push_back( xform);
+            keptCounts.push_back( mergeCounts[k]);
+        }
+    }
+    modObjects.swap( kept);
+    mergeCounts.swap( keptCounts);
+    return (int)modObjects.size();
+}//coalesce
+
+
+bool OsiXFormMgr::runPass( OSInstance* instance, Osi2::ClpSimplexAPI* clp, bool journalled)
+{
+    typedef std::chrono::steady_clock Clock;
+    coalesce();
+    timings.clear();
+    if (journalled) truncateJournal( journalPos);
+    bool ok = true;
+    for (size_t k = 0; k < modObjects.size(); k++) {
+        OsiXForm* xform = modObjects[k];
+        Clock::time_point start = Clock::now();
+        OsiXFormJournalEntry entry;
+        entry.forward = NULL;
+        entry.backward = NULL;
+        if (journalled) {
+            // the journal takes over a copy made by coalesce, or makes one
+            std::vector<OsiXForm*>::iterator copy =
+                std::find( copies.begin(), copies.end(), xform);
+            if (copy != copies.end()) {
+                copies.erase( copy);
+                entry.forward = xform;
+            } else {
+                entry.forward = xform->clone();
+            }
+            if (entry.forward != NULL) entry.backward = xform->inverse( clp);
+            if (entry.backward == NULL) {
+                cout << "modification operation " << xform->opid << " cannot be undone" << endl;
+                delete entry.forward;
+                ok = false;
+                break;
+            }
+            saveBasis( clp, entry.basisBefore);
+        }
+        bool applied = true;
+        if (clp != NULL)
+            applied = xform->apply( clp);
+        else if (instance != NULL)
+            applied = xform->apply( instance);
+        else
+            xform->modify();
+        if (journalled) {
+            if (applied) {
+                journal.push_back( entry);
+                journalPos++;
+            } else {
+                delete entry.forward;
+                delete entry.backward;
+            }
+        }
+        OsiXFormTiming timing;
+        timing.opid = xform->opid;
+        timing.merged = mergeCounts[k];
+        timing.edits = xform->size();
+        timing.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        timings.push_back( timing);
+        if (!applied) {
+            cout << "modification operation " << xform->opid << " could not be applied" << endl;
+            ok = false;
+            if (journalled) break;
+        }
+    }
+    modObjects.clear();
+    mergeCounts.clear();
+    clearCopies();
+    return ok;
+}//runPass
+
+
 void OsiXFormMgr::callXFormClasses()
 {
-    std::vector<OsiXForm*>::iterator iter =  modObjects.begin();
-    while(iter != modObjects.end()) {
-        //(*iter)->record()
-        switch( (*iter)->opid) {
-        case 17:
-            (*iter)->modify();
+    runPass( NULL, NULL, false);
+}//callXFormClasses
+
+
+bool OsiXFormMgr::apply( OSInstance* instance)
+{
+    if (instance == NULL) return false;
+    return runPass( instance, NULL, false);
+}//apply
+
+
+bool OsiXFormMgr::apply( Osi2::ClpSimplexAPI* clp)
+{
+    if (clp == NULL) return false;
+    return runPass( NULL, clp, false);
+}//apply
+
+
+bool OsiXFormMgr::commit( Osi2::ClpSimplexAPI* clp)
+{
+    if (clp == NULL) return false;
+    return runPass( NULL, clp, true);
+}//commit
+
+
+int OsiXFormMgr::undo( Osi2::ClpSimplexAPI* clp, int n)
+{
+    int done = 0;
+    while (done < n && journalPos > 0) {
+        OsiXFormJournalEntry& entry = journal[journalPos - 1];
+        saveBasis( clp, entry.basisAfter);
+        if (!entry.backward->apply( clp)) {
+            cout << "modification operation " << entry.forward->opid << " could not be undone" << endl;
             break;
-        default:
-            cout << "unkown modification operation" << endl;
         }
-        iter++;
+        restoreBasis( clp, entry.basisBefore);
+        journalPos--;
+        done++;
     }
-}
+    return done;
+}//undo
+
+
+int OsiXFormMgr::redo( Osi2::ClpSimplexAPI* clp, int n)
+{
+    int done = 0;
+    while (done < n && journalPos < (int)journal.size()) {
+        OsiXFormJournalEntry& entry = journal[journalPos];
+        saveBasis( clp, entry.basisBefore);
+        if (!entry.forward->apply( clp)) {
+            cout << "modification operation " << entry.forward->opid << " could not be redone" << endl;
+            break;
+        }
+        restoreBasis( clp, entry.basisAfter);
+        journalPos++;
+        done++;
+    }
+    return done;
+}//redo
+
+
+void OsiXFormMgr::truncateJournal( int k)
+{
+    for (size_t r = k; r < journal.size(); r++) {
+        delete journal[r].forward;
+        delete journal[r].backward;
+    }
+    journal.resize( k);
+    if (journalPos > k) journalPos = k;
+}//truncateJournal
+
+
+void OsiXFormMgr::clearJournal()
+{
+    truncateJournal( 0);
+}//clearJournal
+
+
+void OsiXFormMgr::clearCopies()
+{
+    for (size_t k = 0; k < copies.size(); k++) delete copies[k];
+    copies.clear();
+}//clearCopies
+
+
+void OsiXFormMgr::printTimings() const
+{
+    for (size_t k = 0; k < timings.size(); k++) {
+        cout << "operation " << timings[k].opid << ": " << timings[k].merged
+             << " recorded, " << timings[k].edits << " edits, "
+             << timings[k].seconds << " s" << endl;
+    }
+}//printTimings
@@ -12,17 +12,101 @@
 using std::cout;
 using std::endl;
 
+// time taken by one transform of a pass
+struct OsiXFormTiming {
+    // the kind of transform
+    int opid;
+    // how many recorded transforms were coalesced into it
+    int merged;
+    // the number of elementary edits it made
+    int edits;
+    // wall clock seconds to apply it
+    double seconds;
+};
+
+// one step of the journal
+struct OsiXFormJournalEntry {
+    // a copy of the transform applied; owned by the journal
+    OsiXForm* forward;
+    // its inverse; owned by the journal
+    OsiXForm* backward;
+    // the basis before and after the step, empty if there was none
+    std::vector<unsigned char> basisBefore;
+    std::vector<unsigned char> basisAfter;
+};
+
+// the transform pipeline. Transforms are recorded into a queue. A pass first
+// coalesces the queue, folding each transform into the latest earlier one of
+// the same kind when that transform's coalesce() accepts it, then applies
+// what is left in order, timing each. Transforms of different kinds are taken
+// to be independent. The manager doesn't own the recorded transforms and
+// never changes them: the first merge into a recorded transform is made in a
+// copy of it (OsiXForm::clone), which the manager owns and which takes its
+// place in the queue. A pass empties the queue.
+//
+// commit() is a pass on a live solver that also keeps a journal: for each
+// transform, its inverse (built from the solver just before it is applied)
+// and the solver's basis at that point. undo() and redo() then move the
+// solver back and forward along the journal a step at a time, applying only
+// the inverse or the transform itself, and put back the basis saved at the
+// journal point reached, so that the next solve is warm. The basis saved at a
+// point is the one the solver had when it last left that point, so re-solves
+// made there are kept. Committing after an undo drops the steps that were
+// undone. The journal keeps its own copy of each step (OsiXForm::clone), so
+// the transforms recorded can go once commit() returns; a transform that
+// can't be copied can't be committed.
 class OsiXFormMgr {
 public:
     // the vector modObjects stores operations used to modify the instance
 public:
     // members
     std::vector<OsiXForm*> modObjects;
+    // for each entry of modObjects, the number of recorded transforms it stands for
+    std::vector<int> mergeCounts;
+    // the timings of the last pass
+    std::vector<OsiXFormTiming> timings;
     // methods
     OsiXFormMgr();
     virtual ~OsiXFormMgr();
+    // apply each transform to its own instance
     void callXFormClasses();
     void record( OsiXForm* osmod);
+    // coalesce the queue; returns the number of transforms left
+    int coalesce();
+    // apply the queue to an instance; false if any transform could not be applied
+    bool apply( OSInstance* instance);
+    // apply the queue to a live solver; false if any transform could not be applied
+    bool apply( Osi2::ClpSimplexAPI* clp);
+    // print the timings of the last pass
+    void printTimings() const;
+    // apply the queue to a live solver and journal it; false if a transform
+    // could not be inverted or applied, in which case the rest are dropped
+    bool commit( Osi2::ClpSimplexAPI* clp);
+    // undo up to n journalled steps; returns the number undone
+    int undo( Osi2::ClpSimplexAPI* clp, int n = 1);
+    // redo up to n undone steps; returns the number redone
+    int redo( Osi2::ClpSimplexAPI* clp, int n = 1);
+    // the number of steps applied, and the number in the journal
+    int journalPosition() const { return journalPos; }
+    int journalSize() const { return (int)journal.size(); }
+    // forget the journal
+    void clearJournal();
+private:
+    // a pass: coalesce, then apply to instance, clp, or (both null) the
+    // transform's own instance; journal the steps if asked
+    bool runPass( OSInstance* instance, Osi2::ClpSimplexAPI* clp, bool journalled);
+    // drop the journal from step k on
+    void truncateJournal( int k);
+    // delete the copies made by coalesce
+    void clearCopies();
+    // the copies made by coalesce, owned by the manager
+    std::vector<OsiXForm*> copies;
+    // the journal, and the number of its steps applied
+    std::vector<OsiXFormJournalEntry> journal;
+    int journalPos;
+    // the journal owns its steps, so the manager is not copied
+    OsiXFormMgr( const OsiXFormMgr&);
+    OsiXFormMgr& operator=( const OsiXFormMgr&);
 };
 
 #endif /*OSIXFORMMGR_H_*/
@@ -0,0 +1,264 @@
+// A test of the transform pipeline on a live Clp model, through the
+// ClpSimplexAPI of the Clp plugin. `make test' builds and runs it.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "OsiXForm.h"
+#include "OsiXFormMgr.h"
+
+#include "Osi2API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+#include "Osi2ControlAPI_Imp.hpp"
+
+namespace {
+
+// count a failed check
+void check(bool ok, const char* what, int& errCnt)
+{
+    if (ok) return;
+    cout << "check failed: " << what << endl;
+    errCnt++;
+}//check
+
+// min x0 + x1 over
+//   row 0:  1 <= x0 + x1
+//   row 1:       x0 - x1 <= 2
+//   row 2:       x0      <= 3
+// with 0 <= x0, x1 <= 10
+void loadModel(Osi2::ClpSimplexAPI* clp)
+{
+    const CoinBigIndex starts[] = { 0, 3, 5 };
+    const int indices[] = { 0, 1, 2, 0, 1 };
+    const double elements[] = { 1.0, 1.0, 1.0, 1.0, -1.0 };
+    const double colLower[] = { 0.0, 0.0 };
+    const double colUpper[] = { 10.0, 10.0 };
+    const double obj[] = { 1.0, 1.0 };
+    const double rowLower[] = { 1.0, -DBL_MAX, -DBL_MAX };
+    const double rowUpper[] = { DBL_MAX, 2.0, 3.0 };
+    clp->loadProblem(2, 3, starts, indices, elements, colLower, colUpper, obj,
+                     rowLower, rowUpper);
+}//loadModel
+
+// coalesce and apply sparse and full edits
+int testCoalesce(Osi2::ClpSimplexAPI* clp)
+{
+    int errCnt = 0;
+    loadModel(clp);
+/*
+  Three sparse edits merge into one. The first is merged into a copy; the
+  transforms recorded are left as they were.
+*/
+    const int rowsA[] = { 0 };
+    const double lowerA[] = { 2.0 };
+    const int rowsB[] = { 0, 1 };
+    const double lowerB[] = { 4.0, -5.0 };
+    const double upperB[] = { 8.0, 5.0 };
+    const int rowsC[] = { 2 };
+    const double upperC[] = { 6.0 };
+    ModifyConstraintBounds a(NULL, 1, rowsA, lowerA, NULL);
+    ModifyConstraintBounds b(NULL, 2, rowsB, lowerB, upperB);
+    ModifyConstraintBounds c(NULL, 1, rowsC, NULL, upperC);
+    OsiXFormMgr mgr;
+    mgr.record(&a);
+    mgr.record(&b);
+    mgr.record(&c);
+    check(mgr.coalesce() == 1, "three sparse edits coalesce to one", errCnt);
+    check(mgr.modObjects[0] != &a, "the merge is made in a copy", errCnt);
+    check(mgr.mergeCounts[0] == 3, "the merged edit stands for three", errCnt);
+    check(a.edits.size() == 1 && a.edits[0].lower == 2.0 && !a.edits[0].hasUpper,
+          "the recorded edit is unchanged", errCnt);
+    check(mgr.apply(clp), "the merged edit applies", errCnt);
+    const double* lower = clp->rowLower();
+    const double* upper = clp->rowUpper();
+    check(lower[0] == 4.0 && upper[0] == 8.0, "the later edit of row 0 wins", errCnt);
+    check(lower[1] == -5.0 && upper[1] == 5.0, "row 1 takes both bounds", errCnt);
+    check(lower[2] <= -1.0e30 && upper[2] == 6.0, "row 2 keeps its lower bound", errCnt);
+    check(mgr.timings.size() == 1 && mgr.timings[0].merged == 3 &&
+          mgr.timings[0].edits == 3, "one timing for three edits", errCnt);
+    check(mgr.modObjects.empty(), "a pass empties the queue", errCnt);
+/*
+  A full replacement after a sparse edit supersedes it. Its bounds are on
+  ax + c, so the constants shift the rows. The caller's arrays are copied:
+  changing them after the merge changes nothing.
+*/
+    std::string names[] = { "cover", "spread", "cap" };
+    double fullLower[] = { 1.0, -DBL_MAX, -DBL_MAX };
+    double fullUpper[] = { DBL_MAX, 2.0, 3.0 };
+    double constants[] = { 0.5, 0.0, -1.0 };
+    ModifyConstraintBounds d(NULL, 1, rowsA, lowerA, NULL);
+    ModifyConstraintBounds e(NULL, 3, names, fullLower, fullUpper, constants);
+    mgr.record(&d);
+    mgr.record(&e);
+    check(mgr.coalesce() == 1, "a full replacement absorbs a sparse edit", errCnt);
+    check(d.sparse && d.edits.size() == 1, "the recorded sparse edit is unchanged", errCnt);
+    fullUpper[1] = 99.0;
+    check(mgr.apply(clp), "the full replacement applies", errCnt);
+    lower = clp->rowLower();
+    upper = clp->rowUpper();
+    check(lower[0] == 0.5 && upper[1] == 2.0 && upper[2] == 4.0,
+          "the full form's bounds are on ax + c", errCnt);
+    char name[256];
+    clp->rowName(1, name);
+    check(std::strcmp(name, "spread") == 0, "the full form sets row names", errCnt);
+/*
+  A full replacement must cover every row.
+*/
+    ModifyConstraintBounds f(NULL, 2, names, fullLower, fullUpper, NULL);
+    mgr.record(&f);
+    check(!mgr.apply(clp), "a full form of the wrong size is refused", errCnt);
+    return errCnt;
+}//testCoalesce
+
+
+// the name of row i
+std::string rowName(Osi2::ClpSimplexAPI* clp, int i)
+{
+    std::vector<char> buf(std::max(clp->lengthNames(), 255) + 1);
+    clp->rowName(i, &buf[0]);
+    return std::string(&buf[0]);
+}//rowName
+
+// solve, and check that the solve started from an optimal basis
+void checkWarm(Osi2::ClpSimplexAPI* clp, const char* what, int& errCnt)
+{
+    clp->dual();
+    check(clp->numberIterations() == 0, what, errCnt);
+}//checkWarm
+
+// commit, undo, redo, and truncation of the journal, with the basis put back
+// at each step. The transforms committed go out of scope before they're
+// undone or redone; the journal works from its own copies.
+int testJournal(Osi2::ClpSimplexAPI* clp)
+{
+    int errCnt = 0;
+    loadModel(clp);
+    clp->dual();
+    const std::string oldName = rowName(clp, 1);
+    OsiXFormMgr mgr;
+/*
+  Two steps: a sparse edit, then a full replacement that renames the rows.
+  Solve after each.
+*/
+    {
+        const int rows[] = { 0 };
+        const double lower[] = { 2.0 };
+        ModifyConstraintBounds a(NULL, 1, rows, lower, NULL);
+        mgr.record(&a);
+        check(mgr.commit(clp), "step 1 commits", errCnt);
+        a.edits[0].lower = 100.0;
+    }
+    clp->dual();
+    {
+        std::string names[] = { "cover", "spread", "cap" };
+        double lower[] = { 1.5, -DBL_MAX, -DBL_MAX };
+        double upper[] = { DBL_MAX, 2.0, 3.0 };
+        ModifyConstraintBounds b(NULL, 3, names, lower, upper, NULL);
+        mgr.record(&b);
+        check(mgr.commit(clp), "step 2 commits", errCnt);
+        lower[0] = 100.0;
+    }
+    clp->dual();
+    check(mgr.journalSize() == 2 && mgr.journalPosition() == 2,
+          "two steps journalled", errCnt);
+    check(rowName(clp, 1) == "spread", "step 2 renames the rows", errCnt);
+/*
+  Undo one step: step 1's bounds and basis, and the old names.
+*/
+    check(mgr.undo(clp) == 1 && mgr.journalPosition() == 1, "undo one step", errCnt);
+    check(clp->rowLower()[0] == 2.0, "undo restores step 1's bounds", errCnt);
+    check(rowName(clp, 1) == oldName, "undo restores the row names", errCnt);
+    checkWarm(clp, "undo restores step 1's basis", errCnt);
+/*
+  Undo more steps than there are: back to the loaded model.
+*/
+    check(mgr.undo(clp, 5) == 1 && mgr.journalPosition() == 0,
+          "undo stops at the start of the journal", errCnt);
+    check(clp->rowLower()[0] == 1.0, "undo restores the loaded bounds", errCnt);
+    checkWarm(clp, "undo restores the loaded model's basis", errCnt);
+    check(mgr.undo(clp) == 0, "nothing left to undo", errCnt);
+/*
+  Redo both, from the journal's own copies.
+*/
+    check(mgr.redo(clp, 2) == 2 && mgr.journalPosition() == 2, "redo two steps", errCnt);
+    check(clp->rowLower()[0] == 1.5 && rowName(clp, 1) == "spread",
+          "redo reapplies the steps as committed", errCnt);
+    checkWarm(clp, "redo restores step 2's basis", errCnt);
+    check(mgr.redo(clp) == 0, "nothing left to redo", errCnt);
+/*
+  Undo a step and commit another: the undone step is dropped.
+*/
+    check(mgr.undo(clp) == 1, "undo before a new commit", errCnt);
+    {
+        const int rows[] = { 2 };
+        const double upper[] = { 2.5 };
+        ModifyConstraintBounds c(NULL, 1, rows, NULL, upper);
+        mgr.record(&c);
+        check(mgr.commit(clp), "step 3 commits", errCnt);
+    }
+    check(mgr.journalSize() == 2 && mgr.journalPosition() == 2,
+          "a commit after an undo drops the undone step", errCnt);
+    check(clp->rowLower()[0] == 2.0 && clp->rowUpper()[2] == 2.5,
+          "step 3 follows step 1", errCnt);
+    check(mgr.redo(clp) == 0, "the dropped step can't be redone", errCnt);
+    mgr.clearJournal();
+    check(mgr.journalSize() == 0 && mgr.journalPosition() == 0,
+          "the journal can be cleared", errCnt);
+    return errCnt;
+}//testJournal
+
+
+// the sparse form's bounds are on ax on an instance too: a constraint with
+// constant c is given lb + c
+int testInstance()
+{
+    int errCnt = 0;
+    OSInstance instance;
+    instance.setConstraintNumber(1);
+    instance.addConstraint(0, "row", 0.0, 10.0, 1.5);
+    const int rows[] = { 0 };
+    const double lower[] = { 2.0 };
+    ModifyConstraintBounds g(&instance, 1, rows, lower, NULL);
+    check(g.apply(&instance), "a sparse edit applies to an instance", errCnt);
+    const Constraint* con = instance.instanceData->constraints->con[0];
+    check(con->lb == 3.5 && con->ub == 10.0,
+          "the sparse form's bounds are on ax on an instance", errCnt);
+    return errCnt;
+}//testInstance
+
+}
+
+
+int main(int argc, char* argv[])
+{
+    Osi2::ControlAPI_Imp ctrlAPI;
+    std::string shortName = "Clp";
+    Osi2::API* clpApiObj = NULL;
+    if (ctrlAPI.load(shortName) < 0 ||
+        ctrlAPI.createObject(clpApiObj, Osi2::ClpSimplexAPI::getAPIIDString()) != 0) {
+        cout << "failed to create a ClpSimplexAPI object" << endl;
+        return 1;
+    }
+    Osi2::ClpSimplexAPI* clp = static_cast<Osi2::ClpSimplexAPI*>
+        (clpApiObj->getAPIPtr(Osi2::ClpSimplexAPI::getAPIIDString()));
+    clp->setLogLevel(0);
+    int errCnt = 0;
+    cout << "Testing coalesce and apply." << endl;
+    const int errs = testCoalesce(clp);
+    cout << "End test of coalesce and apply, " << errs << " errors." << endl;
+    errCnt += errs;
+    cout << "Testing the journal." << endl;
+    const int journalErrs = testJournal(clp);
+    cout << "End test of the journal, " << journalErrs << " errors." << endl;
+    errCnt += journalErrs;
+    cout << "Testing sparse edits on an instance." << endl;
+    const int instErrs = testInstance();
+    cout << "End test of sparse edits on an instance, " << instErrs << " errors." << endl;
+    errCnt += instErrs;
+    ctrlAPI.destroyObject(clpApiObj);
+    return (errCnt == 0) ? 0 : 1;
+}//main
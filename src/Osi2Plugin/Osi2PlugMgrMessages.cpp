@@ -55,6 +55,7 @@ static OnePlugMgrMessage us_english[] = {
       "Unregistered API \"%s\" for plugin library \"%s\"." },
   { PLUGMGR_APICREATEOK, 12, 5, "Created object \"%s\" (%s)." },
   { PLUGMGR_APIDELOK, 13, 5, "Destroyed object \"%s\"." },
+  { PLUGMGR_APIPOOLED, 14, 5, "Returned object \"%s\" to the pool." },
 
   // Warning: 3000 -- 5999
   { PLUGMGR_LIBLDDUP, 3000, 3, "Plugin library \"%s\" is already loaded." },
@@ -29,6 +29,7 @@ enum PlugMgrMsg {
     PLUGMGR_APIUNREG,
     PLUGMGR_APICREATEOK,
     PLUGMGR_APIDELOK,
+    PLUGMGR_APIPOOLED,
     PLUGMGR_LIBLDDUP,
     PLUGMGR_LIBNOTFOUND,
     PLUGMGR_LIBLDFAIL,
@@ -147,6 +147,23 @@ typedef void *(*CreateFunc)(const ObjectParams *parms) ;
 */
 typedef int32_t (*DestroyFunc)(void *victim, const ObjectParams *parms) ;
 
+/*! \brief Reset an API object for reuse
+
+  This function is implemented by the plugin and invoked by the
+  Osi2::PluginManager when an object is returned to the manager's object
+  pool instead of being destroyed. It must put the object back in the state
+  of a newly created object, so that the object can be handed out again by
+  a later create request. A \c ResetFunc is optional; objects of an API
+  registered without one are never pooled.
+
+  \param obj the object to be reset.
+  \param parms \link Osi2::ObjectParams parameters \endlink for use
+       by the plugin.
+  \returns 0 for success, nonzero for failure. An object that cannot be
+       reset is destroyed.
+*/
+typedef int32_t (*ResetFunc)(void *obj, const ObjectParams *parms) ;
+
 /*! \brief API registration function
 
   This function is implemented by the Osi2::PluginManager and passed to the
@@ -262,6 +279,8 @@ struct APIRegInfo {
   CreateFunc createFunc_ ;
   /// Destructor for API being registered
   DestroyFunc destroyFunc_ ;
+  /// Reset function for pooled objects (null if objects can't be pooled)
+  ResetFunc resetFunc_ ;
 } ;
 
 /*! \brief Parameters passed to a plugin for object creation and destruction.
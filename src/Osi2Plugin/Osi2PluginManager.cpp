@@ -440,6 +440,7 @@ int32_t PluginManager::registerAPI (const CharString *apiStr,
 	tmp.lang_ = params->lang_ ;
 	tmp.createFunc_ = params->createFunc_ ;
 	tmp.destroyFunc_ = params->destroyFunc_ ;
+	tmp.resetFunc_ = params->resetFunc_ ;
         (pm.*wcVec).push_back(tmp) ;
       }
     } else {
@@ -455,6 +456,7 @@ int32_t PluginManager::registerAPI (const CharString *apiStr,
 	tmp.lang_ = params->lang_ ;
 	tmp.createFunc_ = params->createFunc_ ;
 	tmp.destroyFunc_ = params->destroyFunc_ ;
+	tmp.resetFunc_ = params->resetFunc_ ;
 	(pm.*regMap).insert(std::pair<std::string,APIInfo>(tmp.api_,tmp)) ;
       }
     }
@@ -727,6 +729,10 @@ int PluginManager::unloadOneLib (const std::string &libName,
     return (1) ; }
   PluginUniqueID id = lpiIter->second ;
   LibraryInfo &lib = libraryMap_[id] ;
+/*
+  Destroy any pooled objects while the library can still do it.
+*/
+  drainPools(id) ;
 /*
   Step through the exact match map and remove any entries that are registered
   to this library. Regrettably, erase for a map is defined to invalidate
@@ -826,6 +832,10 @@ void PluginManager::addPreloadLib (std::string lib, InitFunc initFunc)
 int PluginManager::shutdown()
 {
   int overallResult = 0 ;
+/*
+  Pooled objects go first, while their libraries are still loaded.
+*/
+  drainPools(0) ;
 
   for (LibraryMap::iterator lmIter = libraryMap_.begin() ;
        lmIter != libraryMap_.end() ;
@@ -927,7 +937,7 @@ void PluginManager::setMsgHandler (CoinMessageHandler *newHandler)
   is state for the plugin as a whole, while the state object in ObjectParams
   is state for the API.
 */
-ObjectParams *PluginManager::buildObjectParams (const std::string apiStr,
+ObjectParams *PluginManager::buildObjectParams (const std::string &apiStr,
         const APIInfo &apiInfo)
 {
   ObjectParams *objParms = new ObjectParams() ;
@@ -968,6 +978,22 @@ void *PluginManager::createObject (const std::string &apiStr,
       apiEntryExists(exactMatchMap_,apiStr,libID) ;
   if (apiIter != exactMatchMap_.end()) {
     const APIInfo &apiInfo = apiIter->second ;
+/*
+  If the API is pooled, try the pool first.
+*/
+    if (poolable(apiInfo)) {
+      ObjPool &pool = getPool(apiStr,apiInfo) ;
+      if (!pool.objs_.empty()) {
+	void *object = pool.objs_.back() ;
+	pool.objs_.pop_back() ;
+	pool.stats_.hits_++ ;
+	msgHandler_->message(PLUGMGR_APICREATEOK, msgs_)
+	    << apiStr << "pooled" << CoinMessageEol ;
+	if (libID == 0) libID = apiInfo.id_ ;
+	return (object) ;
+      }
+      pool.stats_.misses_++ ;
+    }
     ObjectParams *objParms = buildObjectParams(apiStr, apiInfo) ;
     void *object = apiInfo.createFunc_(objParms) ;
     delete objParms ;
@@ -1006,6 +1032,7 @@ void *PluginManager::createObject (const std::string &apiStr,
 	exactMatchMap_.insert(std::pair<std::string,APIInfo>(tmp.api_,tmp)) ;
 	apiIter = apiEntryExists(exactMatchMap_,apiStr,libID) ;
 	apiInfo = &apiIter->second ;
+	if (poolable(*apiInfo)) getPool(apiStr,*apiInfo).stats_.misses_++ ;
       }
       if (libID == 0) libID = apiInfo->id_ ;
       if (apiInfo->lang_ == Plugin_C)
@@ -1079,6 +1106,9 @@ T *PluginManager::createObject(const std::string & apiStr, IObjectAdapter<T, U>
   suppose that the plugin wants to do more than just invoke the destructor?
   This provides a way to invoke an arbitrary function. The only requirement is
   that the specified object be destroyed as part of the execution.
+
+  If the API is pooled and the pool has room, the object is reset and kept
+  instead. An object that fails to reset is destroyed.
 */
 int PluginManager::destroyObject (const std::string &apiStr,
                                   PluginUniqueID libID, void *victim)
@@ -1093,7 +1123,20 @@ int PluginManager::destroyObject (const std::string &apiStr,
   } else {
     const APIInfo &apiInfo = apiIter->second ;
     ObjectParams *objParms = buildObjectParams(apiStr,apiInfo) ;
+    if (poolable(apiInfo)) {
+      ObjPool &pool = getPool(apiStr,apiInfo) ;
+      if (static_cast<int>(pool.objs_.size()) < getPoolLimit(apiStr) &&
+	  apiInfo.resetFunc_(victim,objParms) == 0) {
+	pool.objs_.push_back(victim) ;
+	pool.stats_.returns_++ ;
+	msgHandler_->message(PLUGMGR_APIPOOLED, msgs_)
+	    << apiStr << CoinMessageEol ;
+	delete objParms ;
+	return (0) ;
+      }
+    }
     result = apiInfo.destroyFunc_(victim,objParms) ;
+    delete objParms ;
     if (result < 0) {
       msgHandler_->message(PLUGMGR_APIDELFAIL, msgs_)
 	  << apiStr << "DestroyFunc failed" << CoinMessageEol ;
@@ -1107,6 +1150,147 @@ int PluginManager::destroyObject (const std::string &apiStr,
 }
 
 
+/*
+  Object pools.
+
+  An API is pooled if the plugin supplied a reset function, the plugin is a
+  C++ plugin (objects from C plugins are wrapped by the adapter on the way
+  out), and the API has a nonzero limit.
+*/
+bool PluginManager::poolable (const APIInfo &apiInfo) const
+{
+  return (apiInfo.resetFunc_ != nullptr && apiInfo.lang_ == Plugin_CPP &&
+	  getPoolLimit(apiInfo.api_) > 0) ;
+}
+
+PluginManager::ObjPool &PluginManager::getPool (const std::string &apiStr,
+						const APIInfo &apiInfo)
+{
+  const std::pair<std::string,PluginUniqueID> key(apiStr,apiInfo.id_) ;
+  PoolMap::iterator poolIter = pools_.find(key) ;
+  if (poolIter == pools_.end()) {
+    ObjPool pool ;
+    pool.info_ = apiInfo ;
+    pool.info_.api_ = apiStr ;
+    pool.stats_.hits_ = 0 ;
+    pool.stats_.misses_ = 0 ;
+    pool.stats_.returns_ = 0 ;
+    pool.stats_.pooled_ = 0 ;
+    poolIter = pools_.insert(std::make_pair(key,pool)).first ;
+  }
+  return (poolIter->second) ;
+}
+
+int PluginManager::drainPool (ObjPool &pool, size_t keep)
+{
+  int destroyed = 0 ;
+  while (pool.objs_.size() > keep) {
+    void *victim = pool.objs_.back() ;
+    pool.objs_.pop_back() ;
+    ObjectParams *objParms = buildObjectParams(pool.info_.api_,pool.info_) ;
+    int result = pool.info_.destroyFunc_(victim,objParms) ;
+    delete objParms ;
+    if (result < 0) {
+      msgHandler_->message(PLUGMGR_APIDELFAIL, msgs_)
+	  << pool.info_.api_ << "DestroyFunc failed" << CoinMessageEol ;
+    } else {
+      msgHandler_->message(PLUGMGR_APIDELOK, msgs_)
+	  << pool.info_.api_ << CoinMessageEol ;
+    }
+    destroyed++ ;
+  }
+  return (destroyed) ;
+}
+
+void PluginManager::drainPools (PluginUniqueID libID)
+{
+  PoolMap::iterator poolIter = pools_.begin() ;
+  while (poolIter != pools_.end()) {
+    if (libID == 0 || poolIter->second.info_.id_ == libID) {
+      drainPool(poolIter->second,0) ;
+      PoolMap::iterator tmpIter = poolIter ;
+      poolIter++ ;
+      pools_.erase(tmpIter) ;
+    } else {
+      poolIter++ ;
+    }
+  }
+}
+
+void PluginManager::setPoolLimit (const std::string &apiStr, int limit)
+{
+  if (limit < 0) limit = 0 ;
+  poolLimits_[apiStr] = limit ;
+/*
+  Bring existing pools within their (possibly new) limits. A change to the
+  wildcard limit affects every API that doesn't have its own.
+*/
+  for (PoolMap::iterator poolIter = pools_.begin() ;
+       poolIter != pools_.end() ;
+       poolIter++) {
+    const std::string &api = poolIter->first.first ;
+    if (apiStr == "*" || api == apiStr)
+      drainPool(poolIter->second,getPoolLimit(api)) ;
+  }
+}
+
+int PluginManager::getPoolLimit (const std::string &apiStr) const
+{
+  std::map<std::string,int>::const_iterator limIter =
+      poolLimits_.find(apiStr) ;
+  if (limIter == poolLimits_.end()) limIter = poolLimits_.find("*") ;
+  return ((limIter == poolLimits_.end())?0:limIter->second) ;
+}
+
+int PluginManager::trimPools (int keep, const std::string *apiStr)
+{
+  if (keep < 0) keep = 0 ;
+  int destroyed = 0 ;
+  for (PoolMap::iterator poolIter = pools_.begin() ;
+       poolIter != pools_.end() ;
+       poolIter++) {
+    if (apiStr == nullptr || poolIter->first.first == *apiStr)
+      destroyed += drainPool(poolIter->second,keep) ;
+  }
+  return (destroyed) ;
+}
+
+PluginManager::PoolStats
+    PluginManager::getPoolStats (const std::string &apiStr,
+				 PluginUniqueID libID) const
+{
+  PoolStats stats ;
+  stats.hits_ = 0 ;
+  stats.misses_ = 0 ;
+  stats.returns_ = 0 ;
+  stats.pooled_ = 0 ;
+  for (PoolMap::const_iterator poolIter = pools_.begin() ;
+       poolIter != pools_.end() ;
+       poolIter++) {
+    if (poolIter->first.first != apiStr) continue ;
+    if (libID != 0 && poolIter->first.second != libID) continue ;
+    const ObjPool &pool = poolIter->second ;
+    stats.hits_ += pool.stats_.hits_ ;
+    stats.misses_ += pool.stats_.misses_ ;
+    stats.returns_ += pool.stats_.returns_ ;
+    stats.pooled_ += static_cast<int>(pool.objs_.size()) ;
+  }
+  return (stats) ;
+}
+
+void PluginManager::clearPoolStats ()
+{
+  for (PoolMap::iterator poolIter = pools_.begin() ;
+       poolIter != pools_.end() ;
+       poolIter++) {
+    PoolStats &stats = poolIter->second.stats_ ;
+    stats.hits_ = 0 ;
+    stats.misses_ = 0 ;
+    stats.returns_ = 0 ;
+  }
+}
+
+
 PlatformServices &PluginManager::getPlatformServices ()
 {
     return (platformServices_) ;
@@ -17,6 +17,8 @@
 
 #include <vector>
 #include <map>
+#include <string>
+#include <utility>
 #include "Osi2Config.h"
 #include "Osi2nullptr.hpp"
 #include "Osi2PlugMgrMessages.hpp"
@@ -231,6 +233,66 @@ public:
 
     //@}
 
+    /*! \name Object pools
+
+      An object handed to #destroyObject can be kept for reuse rather than
+      destroyed, if the plugin registered a \link Osi2::ResetFunc reset
+      function \endlink for the API and the pool for the API has room. A
+      later #createObject for the same API and library hands out a pooled
+      object before asking the plugin for a new one. There is a pool for each
+      <API,library> pair. Pooled objects are destroyed when their library is
+      unloaded.
+
+      Pools are limited per API. The limit set for "*" applies to any API
+      without a limit of its own. The default is 0, no pooling.
+
+      Only C++ plugins are pooled; objects from C plugins are wrapped by the
+      adapter as they are handed out.
+    */
+    //@{
+
+    /// Pool statistics
+    struct PoolStats {
+        /// Create requests satisfied from the pool
+        int hits_ ;
+        /// Create requests for a pooled API that needed a new object
+        int misses_ ;
+        /// Objects returned to the pool by #destroyObject
+        int returns_ ;
+        /// Objects now in the pool
+        int pooled_ ;
+    } ;
+
+    /*! \brief Set the pool limit for an API
+
+      Pools for \p apiStr that are over the new limit are trimmed.
+    */
+    void setPoolLimit(const std::string &apiStr, int limit) ;
+
+    /// Get the pool limit for an API
+    int getPoolLimit(const std::string &apiStr) const ;
+
+    /*! \brief Destroy pooled objects
+
+      Destroys pooled objects until no more than \p keep remain in each pool
+      for \p apiStr, or in every pool if \p apiStr is null. Returns the number
+      of objects destroyed.
+    */
+    int trimPools(int keep = 0, const std::string *apiStr = nullptr) ;
+
+    /*! \brief Get pool statistics for an API
+
+      A nonzero value for \p libID restricts the statistics to the pool for
+      that library; otherwise they're summed over all libraries.
+    */
+    PoolStats getPoolStats(const std::string &apiStr,
+                           PluginUniqueID libID = 0) const ;
+
+    /// Zero the hit, miss, and return counts of all pools
+    void clearPoolStats() ;
+
+    //@}
+
     /*! \name Plugin manager control methods
 
       Miscellaneous methods that control the behaviour of the plugin manager.
@@ -317,7 +379,7 @@ private:
       or destruction.
     */
     class APIInfo ;
-    ObjectParams *buildObjectParams(const std::string apiStr,
+    ObjectParams *buildObjectParams(const std::string &apiStr,
                                     const APIInfo &rp) ;
 
     /*! \brief Generate a unique plugin ID */
@@ -393,6 +455,8 @@ private:
 	CreateFunc createFunc_ ;
 	/// Destructor for API objects
 	DestroyFunc destroyFunc_ ;
+	/// Reset function for pooled API objects
+	ResetFunc resetFunc_ ;
     } ;
 
     /// Map type for API management
@@ -422,6 +486,45 @@ private:
     */
     APIRegVec wildCardVec_ ;
 
+    /*! \brief Object pool
+
+      Objects kept for reuse, with a copy of the registration information
+      needed to destroy them.
+    */
+    struct ObjPool {
+	/// Registration information for the API
+	APIInfo info_ ;
+	/// Pooled objects
+	std::vector<void *> objs_ ;
+	/// Statistics (pooled_ is not maintained; see #objs_)
+	PoolStats stats_ ;
+    } ;
+
+    /// Map type for object pools, keyed by <API,library>
+    typedef std::map<std::pair<std::string,PluginUniqueID>,ObjPool> PoolMap ;
+
+    /// Object pools
+    PoolMap pools_ ;
+
+    /// Pool limits, by API
+    std::map<std::string,int> poolLimits_ ;
+
+    /// True if objects of this API are to be pooled
+    bool poolable(const APIInfo &apiInfo) const ;
+
+    /// Get the pool for \p apiStr from the library in \p apiInfo
+    ObjPool &getPool(const std::string &apiStr, const APIInfo &apiInfo) ;
+
+    /// Destroy objects from \p pool until \p keep remain
+    int drainPool(ObjPool &pool, size_t keep) ;
+
+    /*! \brief Destroy the pooled objects of a library
+
+      All libraries if \p libID is 0. Must be called while the library is
+      still loaded.
+    */
+    void drainPools(PluginUniqueID libID) ;
+
     /*! \brief Initialising a plugin?
 
       True during initialisation of a plugin library. Used to determine if
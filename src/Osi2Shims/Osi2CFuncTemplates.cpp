@@ -49,10 +49,29 @@
   \todo Think of a way to implement a cache for function addresses so we're
   not invoking dlsym every time we use a function. Really, this cache ought to
   be a service of DynamicLibrary. Keep a map in the DynamicLibrary object?
+
+  In the meantime, cachedFunc is available for methods that are worth the
+  trouble of keeping a (static) function pointer. It looks up the function
+  only if the pointer is null.
 */
 
 using Osi2::DynamicLibrary ;
 
+template <class FuncSig>
+bool cachedFunc (DynamicLibrary *lib, FuncSig &func, const char *funcName)
+{
+  if (func == nullptr) {
+    std::string errStr ;
+    func = lib->getFunc<FuncSig>(funcName,errStr) ;
+    if (func == nullptr) {
+      std::cout
+	<< "  cachedFunc: lookup failed for \"" << funcName << "\": "
+	<< errStr << std::endl ;
+    }
+  }
+  return (func != nullptr) ;
+}
+
 template <class ObjType, class RetType>
 RetType simpleGetter (DynamicLibrary *lib, ObjType *obj,
 	      std::string funcName)
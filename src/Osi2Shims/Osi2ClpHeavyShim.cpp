@@ -120,6 +120,7 @@ ExitFunc initPlugin (PlatformServices *services)
   reginfo.ctrlObj_ = static_cast<APIState *>(shim) ;
   reginfo.createFunc_ = ClpHeavyShim::create ;
   reginfo.destroyFunc_ = ClpHeavyShim::destroy ;
+  reginfo.resetFunc_ = nullptr ;
   int retval = services->registerAPI_(
 	  reinterpret_cast<const CharString*>("ProbMgmt"), &reginfo) ;
   if (retval < 0) {
@@ -11,6 +11,8 @@
   a container for objects implementing specific APIs.
 */
 
+#include <cstring>
+
 #include "Osi2ClpLite_Wrap.hpp"
 #include "Osi2ClpSimplexAPI_ClpLite.hpp"
 #include "Osi2ClpSolveParamsAPI_ClpLite.hpp"
@@ -20,7 +22,8 @@ namespace Osi2 {
 /// Default constructor
 ClpLite_Wrap::ClpLite_Wrap ()
   : clp_(nullptr),
-    clpSolve_(nullptr)
+    clpSolve_(nullptr),
+    libClp_(nullptr)
 { }
 /// Destructor
 ClpLite_Wrap::~ClpLite_Wrap ()
@@ -32,13 +35,51 @@ ClpLite_Wrap::~ClpLite_Wrap ()
 void ClpLite_Wrap::addClpSimplex (DynamicLibrary *libClp)
 {
 /*
-  Install a ClpSimplexAPI object and a ClpSolveParams object and add them to
-  the set of supported APIs.
+  Add the ClpSimplex and ClpSolveParams APIs to the set of supported APIs,
+  but leave building the objects that implement them to getAPIPtr. A null
+  implementing object marks an API that's supported but not yet built.
+*/
+  libClp_ = libClp ;
+  apiMgr_.addAPIID(ClpSimplexAPI::getAPIIDString(),nullptr) ;
+  apiMgr_.addAPIID(ClpSolveParamsAPI::getAPIIDString(),nullptr) ;
+}
+
+void *ClpLite_Wrap::getAPIPtr (const char *ident)
+{
+  std::lock_guard<std::mutex> lock(buildMutex_) ;
+  void *obj = apiMgr_.getAPIPtr(ident) ;
+  if (obj != nullptr || libClp_ == nullptr) return (obj) ;
+/*
+  Build the object on first request.
+*/
+  if (strcmp(ident,ClpSimplexAPI::getAPIIDString()) == 0) {
+    clp_ = new ClpSimplexAPI_ClpLite(libClp_) ;
+    obj = clp_ ;
+  } else if (strcmp(ident,ClpSolveParamsAPI::getAPIIDString()) == 0) {
+    clpSolve_ = new ClpSolveParamsAPI_ClpLite(libClp_) ;
+    obj = clpSolve_ ;
+  } else {
+    return (nullptr) ;
+  }
+  apiMgr_.setAPIPtr(ident,obj) ;
+  return (obj) ;
+}
+
+int ClpLite_Wrap::reset ()
+{
+  std::lock_guard<std::mutex> lock(buildMutex_) ;
+/*
+  The simplex object, if built, swaps its clp model for a new one. The solve
+  parameters object is cheap to build and holds nothing but settings, so just
+  drop it.
 */
-  clp_ = new ClpSimplexAPI_ClpLite(libClp) ;
-  apiMgr_.addAPIID(ClpSimplexAPI::getAPIIDString(),clp_) ;
-  clpSolve_ = new ClpSolveParamsAPI_ClpLite(libClp) ;
-  apiMgr_.addAPIID(ClpSolveParamsAPI::getAPIIDString(),clpSolve_) ;
+  if (clp_ != nullptr && clp_->reset() != 0) return (-1) ;
+  if (clpSolve_ != nullptr) {
+    delete clpSolve_ ;
+    clpSolve_ = nullptr ;
+    apiMgr_.setAPIPtr(ClpSolveParamsAPI::getAPIIDString(),nullptr) ;
+  }
+  return (0) ;
 }
 
 }
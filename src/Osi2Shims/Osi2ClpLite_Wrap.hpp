@@ -15,6 +15,8 @@
 #ifndef Osi2ClpLite_Wrap_HPP
 #define Osi2ClpLite_Wrap_HPP
 
+#include <mutex>
+
 #include "Osi2API.hpp"
 #include "Osi2APIMgmt_Imp.hpp"
 // #include "Osi2ClpSimplexAPI_ClpLite.hpp"
@@ -30,6 +32,9 @@ class ClpSolveParamsAPI_ClpLite ;
   This is a wrapper class for objects constructed by ClpShim (the `lite'
   shim). It is intended as a container for objects that implement individual
   APIs.
+
+  The objects are built on first request through #getAPIPtr, so a wrapper
+  costs little until it's used, and only the APIs actually used take memory.
 */
 class ClpLite_Wrap : public API {
 
@@ -48,17 +53,28 @@ public:
   /// Return supported APIs
   inline int getAPIs (const char **&idents)
   { return (apiMgr_.getAPIs(idents)) ; }
-  /// Return object supporting the specified %API
-  inline void *getAPIPtr (const char *ident)
-  { return (apiMgr_.getAPIPtr(ident)) ; }
+  /// Return object supporting the specified %API, building it if necessary
+  void *getAPIPtr (const char *ident) ;
 //@}
 
 /*! \name Methods to add support for an %API */
 //@{
-  /// Add a ClpSimplex object
+  /// Add support for the ClpSimplex and ClpSolveParams APIs
   void addClpSimplex(DynamicLibrary *libClp) ;
 //@}
 
+/*! \name Reuse */
+//@{
+  /*! \brief Return to the state of a new object
+
+    Discards the model and any parameter settings. A ClpSimplex object
+    that has been built is kept, with a new model; a ClpSolveParams object is
+    dropped, to be built again on request. Returns 0 on success, -1 on
+    failure.
+  */
+  int reset () ;
+//@}
+
 private:
 
   /// API managment object
@@ -70,6 +86,12 @@ private:
   /// Object to implement the ClpSolveParams %API.
   ClpSolveParamsAPI_ClpLite *clpSolve_ ;
 
+  /// libClp handle, needed to build #clp_ and #clpSolve_
+  DynamicLibrary *libClp_ ;
+
+  /// Serialises building #clp_ and #clpSolve_
+  std::mutex buildMutex_ ;
+
 } ;
 
 
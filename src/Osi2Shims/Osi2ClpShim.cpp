@@ -55,7 +55,8 @@ void *ClpShim::create (const ObjectParams *params)
   std::cout << "Clp create: " << what << " API requested." << std::endl ;
 /*
   For an object that supports the ClpSimplex API, create a ClpLite_Wrap object
-  and add a ClpSimplexAPI_ClpLite object to it.
+  and tell it to support the ClpSimplex API. The wrapper builds the
+  ClpSimplexAPI_ClpLite object when it's first requested.
 */
   if (what == "ClpSimplex" || what == "WildClpSimplex") {
     std::cout
@@ -89,6 +90,17 @@ int32_t ClpShim::destroy (void *victim, const ObjectParams *objParms)
     return (0) ;
 }
 
+/*! \brief Object reset
+
+  ClpShim only hands out ClpLite_Wrap objects. The wrapper knows how to drop
+  its model and settings.
+*/
+int32_t ClpShim::reset (void *obj, const ObjectParams *objParms)
+{
+    ClpLite_Wrap *clpliteWrapper = static_cast<ClpLite_Wrap *>(obj) ;
+    return (clpliteWrapper->reset()) ;
+}
+
 
 /*
   Plugin cleanup method. Does whatever is needed to clean up after the plugin
@@ -176,6 +188,7 @@ ExitFunc initPlugin (PlatformServices *services)
   reginfo.ctrlObj_ = static_cast<APIState *>(shim) ;
   reginfo.createFunc_ = ClpShim::create ;
   reginfo.destroyFunc_ = ClpShim::destroy ;
+  reginfo.resetFunc_ = ClpShim::reset ;
   int retval = services->registerAPI_(
 	  reinterpret_cast<const CharString*>("ClpSimplex"),&reginfo) ;
   if (retval < 0) {
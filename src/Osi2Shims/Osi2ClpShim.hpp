@@ -46,6 +46,13 @@ public:
   */
   static int32_t destroy (void *victim, const ObjectParams *params) ;
 
+  /*! \brief Object reset
+
+    Returns an object created by this shim to the state of a new object, so
+    that the plugin manager can pool it.
+  */
+  static int32_t reset (void *obj, const ObjectParams *params) ;
+
   /// Set our unique ID (supplied by the plugin manager)
   inline void setPluginID (PluginUniqueID id) { ourID_ = id ; }
   /// Get our unique ID
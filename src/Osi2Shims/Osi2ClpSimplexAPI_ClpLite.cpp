@@ -12,7 +12,10 @@
   on demand.
 */
 
+#include <cstring>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 #include "Osi2Config.h"
 #include "Osi2nullptr.hpp"
@@ -65,6 +68,45 @@ KnownMemberMap doubleSimplexParams = {
 */
 KnownMemberMap stringSimplexParams = { } ;
 
+/*
+  Settings put back to their defaults by CSA_CL::reset, besides the ones
+  above.
+*/
+KnownMemberMap integerResetParams = {
+  mapEntry3("log level","Clp_logLevel","Clp_setLogLevel"),
+  mapEntry3("status","Clp_status","Clp_setProblemStatus"),
+  mapEntry3("secondary status","Clp_secondaryStatus","Clp_setSecondaryStatus")
+} ;
+
+KnownMemberMap doubleResetParams = {
+  mapEntry3("max secs","Clp_maximumSeconds","Clp_setMaximumSeconds")
+} ;
+
+/*
+  Look up the getter and setter of each member of membMap and record the
+  setter with the value read from obj. False if a lookup fails.
+*/
+template <class ValType>
+bool captureDefaults (DynamicLibrary *lib, Clp_Simplex *obj,
+		      const KnownMemberMap &membMap,
+		      std::vector<std::pair<void (*)(Clp_Simplex *,ValType),
+					    ValType> > &dflts)
+{
+  typedef ValType (*GetFunc)(Clp_Simplex *) ;
+  typedef void (*SetFunc)(Clp_Simplex *,ValType) ;
+  for (KnownMemberMap::const_iterator iter = membMap.begin() ;
+       iter != membMap.end() ;
+       iter++) {
+    GetFunc getter = nullptr ;
+    SetFunc setter = nullptr ;
+    if (!cachedFunc(lib,getter,iter->second.getter_.c_str()) ||
+	!cachedFunc(lib,setter,iter->second.setter_.c_str()))
+      return (false) ;
+    dflts.push_back(std::make_pair(setter,getter(obj))) ;
+  }
+  return (true) ;
+}
+
 
 /*
   Static map for known presolve transform names. The first string is the name
@@ -101,7 +143,11 @@ typedef ClpSimplexAPI_ClpLite CSA_CL ;
 CSA_CL::ClpSimplexAPI_ClpLite (DynamicLibrary *libClp)
     : paramMgr_(ParamBEAPI_Imp<CSA_CL>(this)),
       libClp_(libClp),
-      clpC_(nullptr)
+      clpC_(nullptr),
+      bulk_(),
+      bulkReady_(false),
+      resetFuncs_(),
+      resetReady_(false)
 {
   std::string errStr ;
 /*
@@ -208,6 +254,153 @@ CSA_CL::~ClpSimplexAPI_ClpLite ()
   }
 }
 
+/*
+  Empty the model in place: no rows or columns, no integer information or
+  names, default settings. If the functions for that couldn't all be found,
+  or the model isn't empty afterwards, get a new model before giving up the
+  old one, so that on failure the object is left as it was.
+*/
+int CSA_CL::reset ()
+{
+  if (!resetReady_) lookupResetFuncs() ;
+  const ResetFuncs &funcs = resetFuncs_ ;
+  invalidateViews() ;
+  if (funcs.inPlace_ && clpC_ != nullptr) {
+    funcs.resize_(clpC_,0,0) ;
+    funcs.deleteIntInfo_(clpC_) ;
+    funcs.dropNames_(clpC_) ;
+    for (const std::pair<IntSetFunc,int> &dflt : funcs.intDefaults_)
+      dflt.first(clpC_,dflt.second) ;
+    for (const std::pair<DblSetFunc,double> &dflt : funcs.dblDefaults_)
+      dflt.first(clpC_,dflt.second) ;
+    funcs.setProbName_(clpC_,static_cast<int>(funcs.probName_.length()),
+		       funcs.probName_.c_str()) ;
+    const BulkFuncs &bulk = bulkFuncs() ;
+    if (bulk.numRows_ != nullptr && bulk.numCols_ != nullptr &&
+	bulk.numRows_(clpC_) == 0 && bulk.numCols_(clpC_) == 0)
+      return (0) ;
+  }
+  if (funcs.newModel_ == nullptr || funcs.deleteModel_ == nullptr)
+    return (-1) ;
+  Clp_Simplex *fresh = funcs.newModel_() ;
+  if (fresh == nullptr) return (-1) ;
+  funcs.deleteModel_(clpC_) ;
+  clpC_ = fresh ;
+  return (0) ;
+}
+
+/*
+  The defaults are whatever a new model has. Any failed lookup leaves
+  inPlace_ false, and reset falls back to replacing the model.
+*/
+void CSA_CL::lookupResetFuncs ()
+{
+  ResetFuncs &funcs = resetFuncs_ ;
+  resetReady_ = true ;
+  funcs.inPlace_ = false ;
+  if (!cachedFunc(libClp_,funcs.newModel_,"Clp_newModel") ||
+      !cachedFunc(libClp_,funcs.deleteModel_,"Clp_deleteModel") ||
+      !cachedFunc(libClp_,funcs.resize_,"Clp_resize") ||
+      !cachedFunc(libClp_,funcs.deleteIntInfo_,
+		  "Clp_deleteIntegerInformation") ||
+      !cachedFunc(libClp_,funcs.dropNames_,"Clp_dropNames") ||
+      !cachedFunc(libClp_,funcs.setProbName_,"Clp_setProblemName"))
+    return ;
+  Clp_Simplex *scratch = funcs.newModel_() ;
+  if (scratch == nullptr) return ;
+  const bool found =
+      captureDefaults(libClp_,scratch,integerSimplexParams,
+		      funcs.intDefaults_) &&
+      captureDefaults(libClp_,scratch,integerResetParams,
+		      funcs.intDefaults_) &&
+      captureDefaults(libClp_,scratch,doubleSimplexParams,
+		      funcs.dblDefaults_) &&
+      captureDefaults(libClp_,scratch,doubleResetParams,
+		      funcs.dblDefaults_) ;
+  if (found) {
+    const int buflen = 256 ;
+    char buffer[buflen] ;
+    simpleSetter<Clp_Simplex,int,char *>
+	(libClp_,scratch,"Clp_problemName",buflen,buffer) ;
+    funcs.probName_ = buffer ;
+  }
+  funcs.deleteModel_(scratch) ;
+  funcs.inPlace_ = found ;
+}
+
+/*
+  Clone. The C interface has no way to copy a Clp_Simplex, so the clone gets
+  a new model loaded from ours, then our settings and basis.
+*/
+ClpSimplexAPI *CSA_CL::clone () const
+{
+  ClpSimplexAPI_ClpLite *clone = new ClpSimplexAPI_ClpLite(libClp_) ;
+  if (clone->clpC_ == nullptr) {
+    delete clone ;
+    return (nullptr) ;
+  }
+  const int m =
+      simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_numberRows") ;
+  const int n =
+      simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_numberColumns") ;
+  const CoinBigIndex *starts = (n > 0)?getVectorStarts():nullptr ;
+  if (starts != nullptr) {
+    const int *lengths = getVectorLengths() ;
+    const int *indices = getIndices() ;
+    const double *elements = getElements() ;
+/*
+  loadProblem wants a matrix without gaps. Clp normally keeps one that way,
+  but pack it if not.
+*/
+    std::vector<CoinBigIndex> packedStarts ;
+    std::vector<int> packedIndices ;
+    std::vector<double> packedElements ;
+    bool gaps = false ;
+    for (int j = 0 ; j < n && !gaps ; j++)
+      gaps = (starts[j]+lengths[j] != starts[j+1]) ;
+    if (gaps) {
+      packedStarts.resize(n+1) ;
+      packedStarts[0] = 0 ;
+      for (int j = 0 ; j < n ; j++) {
+	packedIndices.insert(packedIndices.end(),
+			     indices+starts[j],indices+starts[j]+lengths[j]) ;
+	packedElements.insert(packedElements.end(),
+			      elements+starts[j],elements+starts[j]+lengths[j]) ;
+	packedStarts[j+1] = static_cast<CoinBigIndex>(packedIndices.size()) ;
+      }
+      starts = packedStarts.data() ;
+      indices = packedIndices.data() ;
+      elements = packedElements.data() ;
+    }
+    clone->loadProblem(n,m,starts,indices,elements,
+		       columnLower(),columnUpper(),objective(),
+		       rowLower(),rowUpper()) ;
+    const char *intInfo = integerInformation() ;
+    if (intInfo != nullptr) clone->copyInIntegerInformation(intInfo) ;
+  }
+/*
+  Settings, then the basis.
+*/
+  clone->setObjSense(objSense()) ;
+  clone->setObjectiveOffset(objectiveOffset()) ;
+  clone->setPrimalTolerance(primalTolerance()) ;
+  clone->setDualTolerance(dualTolerance()) ;
+  clone->setDualObjectiveLimit(dualObjectiveLimit()) ;
+  clone->setDualBound(dualBound()) ;
+  clone->scaling(scalingFlag()) ;
+  clone->setMaximumIterations(maximumIterations()) ;
+  clone->setMaximumSeconds(maximumSeconds()) ;
+  clone->setInfeasibilityCost(infeasibilityCost()) ;
+  clone->setPerturbation(perturbation()) ;
+  clone->setAlgorithm(algorithm()) ;
+  clone->setSmallElementValue(getSmallElementValue()) ;
+  clone->setLogLevel(logLevel()) ;
+  clone->setProblemName(problemName()) ;
+  if (starts != nullptr && statusExists())
+    clone->copyinStatus(statusArray()) ;
+  return (clone) ;
+}
+
 /*
   Load a problem in packed matrix format.
 */
@@ -231,6 +424,7 @@ void CSA_CL::loadProblem (const int numcols, const int numrows,
     loadProblem(clpC_,numcols,numrows,start,index,value,
     		collb,colub,obj,rowlb,rowub) ;
   }
+  invalidateViews() ;
 }
 
 /*
@@ -278,6 +472,7 @@ void CSA_CL::resize (int newNumberRows, int newNumberColumns)
 {
   simpleSetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_resize",
   				newNumberRows,newNumberColumns) ;
+  invalidateViews() ;
 }
 
 /*
@@ -302,12 +497,14 @@ void CSA_CL::addRows (int number, const double *rowlb, const double *rowub,
   if (addRows != nullptr) {
     addRows(clpC_,number,rowlb,rowub,rowStart,index,value) ;
   }
+  invalidateViews() ;
 }
 
 void CSA_CL::deleteRows (int number, const int *which)
 {
   simpleSetter<Clp_Simplex,int,const int *>
       (libClp_,clpC_,"Clp_deleteRows",number,which) ;
+  invalidateViews() ;
 }
 
 double *CSA_CL::rowLower () const
@@ -356,12 +553,14 @@ void CSA_CL::addColumns (int number,
   if (addCols != nullptr) {
     addCols(clpC_,number,collb,colub,obj,colStart,index,value) ;
   }
+  invalidateViews() ;
 }
 
 void CSA_CL::deleteColumns (int number, const int *which)
 {
   simpleSetter<Clp_Simplex,int,const int *>
       (libClp_,clpC_,"Clp_deleteColumns",number,which) ;
+  invalidateViews() ;
 }
 
 double *CSA_CL::columnLower () const
@@ -446,6 +645,31 @@ void CSA_CL::modifyCoefficient (int row, int col, double val, bool keepZero)
   if (modCoeff != nullptr) {
     modCoeff(clpC_,row,col,val,keepZero) ;
   }
+  invalidateViews() ;
+}
+
+/*
+  The row-major view is built under the lock so that concurrent first
+  requests build it once. After that it is only read.
+*/
+const RowMajorView &CSA_CL::getRowMajorView (int numThreads) const
+{
+  std::lock_guard<std::mutex> lock(rowViewMutex_) ;
+  if (!rowView_.isValid()) {
+    const int m =
+      simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_numberRows") ;
+    const int n =
+      simpleGetter<Clp_Simplex,int>(libClp_,clpC_,"Clp_numberColumns") ;
+    rowView_.build(m,n,getVectorStarts(),getVectorLengths(),
+		   getIndices(),getElements(),numThreads) ;
+  }
+  return (rowView_) ;
+}
+
+void CSA_CL::invalidateViews ()
+{
+  std::lock_guard<std::mutex> lock(rowViewMutex_) ;
+  rowView_.invalidate() ;
 }
 
 /*
@@ -561,6 +785,7 @@ int CSA_CL::readMps (const char *filename, bool keepNames, bool ignoreErrors)
 	    << "Read " << filename << " without error." << std::endl ;
     }
   }
+  invalidateViews() ;
   return (retval) ;
 }
 
@@ -598,6 +823,7 @@ int CSA_CL::saveModel (const char *fileName)
 
 int CSA_CL::restoreModel (const char *fileName)
 {
+  invalidateViews() ;
   return (simpleGetter<Clp_Simplex,int,const char *>
   	      (libClp_,clpC_,"Clp_restoreModel",fileName)) ;
 }
@@ -1049,6 +1275,38 @@ void CSA_CL::freeRay(double *ray) const
   simpleSetter<Clp_Simplex,double *>(libClp_,clpC_,"Clp_freeRay",ray) ;
 }
 
+/*
+  Rays into caller storage. The C interface offers only the allocate-and-copy
+  form, so the best we can do is copy into the caller's buffer and free
+  clp's copy on the spot. The client sees no allocation once the buffer has
+  grown to size, and need not worry about freeRay.
+*/
+int CSA_CL::fetchRay (RayFunc getRay, int dim, RayBuffer &ray) const
+{
+  ray.startFill(dim) ;
+  const BulkFuncs &bulk = bulkFuncs() ;
+  if (getRay == nullptr || bulk.freeRay_ == nullptr) return (-1) ;
+  double *clpRay = getRay(clpC_) ;
+  if (clpRay == nullptr) return (0) ;
+  ray.appendRay(clpRay) ;
+  bulk.freeRay_(clpC_,clpRay) ;
+  return (1) ;
+}
+
+int CSA_CL::fetchUnboundedRay (RayBuffer &ray) const
+{
+  const BulkFuncs &bulk = bulkFuncs() ;
+  if (bulk.numCols_ == nullptr) return (-1) ;
+  return (fetchRay(bulk.unboundedRay_,bulk.numCols_(clpC_),ray)) ;
+}
+
+int CSA_CL::fetchInfeasibilityRay (RayBuffer &ray) const
+{
+  const BulkFuncs &bulk = bulkFuncs() ;
+  if (bulk.numRows_ == nullptr) return (-1) ;
+  return (fetchRay(bulk.infeasibilityRay_,bulk.numRows_(clpC_),ray)) ;
+}
+
 int CSA_CL::numberPrimalInfeasibilities() const
 {
   return (simpleGetter<Clp_Simplex,int>
@@ -1078,6 +1336,102 @@ void CSA_CL::checkSolution()
   simpleSetter<Clp_Simplex>(libClp_,clpC_,"Clp_checkSolution") ;
 }
 
+/*
+  Look up the C interface functions used by the bulk fetch methods, the
+  first time one of them is called. Each object keeps its own copies; the
+  lock covers two threads fetching from the same object.
+*/
+const CSA_CL::BulkFuncs &CSA_CL::bulkFuncs () const
+{
+  std::lock_guard<std::mutex> lock(bulkMutex_) ;
+  if (!bulkReady_) {
+    cachedFunc(libClp_,bulk_.numRows_,"Clp_numberRows") ;
+    cachedFunc(libClp_,bulk_.numCols_,"Clp_numberColumns") ;
+    cachedFunc(libClp_,bulk_.status_,"Clp_status") ;
+    cachedFunc(libClp_,bulk_.secStatus_,"Clp_secondaryStatus") ;
+    cachedFunc(libClp_,bulk_.numIters_,"Clp_numberIterations") ;
+    cachedFunc(libClp_,bulk_.objValue_,"Clp_objectiveValue") ;
+    cachedFunc(libClp_,bulk_.colSolution_,"Clp_getColSolution") ;
+    cachedFunc(libClp_,bulk_.rowActivity_,"Clp_getRowActivity") ;
+    cachedFunc(libClp_,bulk_.rowPrice_,"Clp_getRowPrice") ;
+    cachedFunc(libClp_,bulk_.reducedCost_,"Clp_getReducedCost") ;
+    cachedFunc(libClp_,bulk_.unboundedRay_,"Clp_unboundedRay") ;
+    cachedFunc(libClp_,bulk_.infeasibilityRay_,"Clp_infeasibilityRay") ;
+    cachedFunc(libClp_,bulk_.freeRay_,"Clp_freeRay") ;
+    bulkReady_ = true ;
+  }
+  return (bulk_) ;
+}
+
+/*
+  Bulk export of the solution. Going through the individual methods costs a
+  dlsym per call, plus whatever the client does to copy the vectors. Here the
+  C interface functions come from #bulk_, looked up on the first fetch,
+  and the vectors are copied straight into the buffers held by the
+  SolveResult. Those buffers are resized only if the problem has grown
+  since the last fetch.
+*/
+int CSA_CL::fetchResult (SolveResult &result, unsigned int fields) const
+{
+  const BulkFuncs &bulk = bulkFuncs() ;
+  if (bulk.numRows_ == nullptr || bulk.numCols_ == nullptr) {
+    result.startFill(0,0) ;
+    return (-1) ;
+  }
+  const int m = bulk.numRows_(clpC_) ;
+  const int n = bulk.numCols_(clpC_) ;
+  result.startFill(m,n) ;
+  int retval = 0 ;
+
+  if (fields&SolveResult::statusField) {
+    if (bulk.status_ && bulk.secStatus_ && bulk.numIters_) {
+      result.setStatus(bulk.status_(clpC_),bulk.secStatus_(clpC_),
+		       bulk.numIters_(clpC_)) ;
+    } else {
+      retval = -1 ;
+    }
+  }
+  if (fields&SolveResult::objectiveField) {
+    if (bulk.objValue_) {
+      result.setObjectiveValue(bulk.objValue_(clpC_)) ;
+    } else {
+      retval = -1 ;
+    }
+  }
+/*
+  The vectors. A null return from clp means there's no solution to copy;
+  leave the field invalid.
+*/
+  struct VecSpec {
+    SolveResult::Field field_ ;
+    VecGetFunc func_ ;
+    double *(SolveResult::*buffer_)() ;
+    int len_ ;
+  } ;
+  const VecSpec vecSpecs[] = {
+    { SolveResult::colSolutionField, bulk.colSolution_,
+      &SolveResult::colSolutionBuffer, n },
+    { SolveResult::rowActivityField, bulk.rowActivity_,
+      &SolveResult::rowActivityBuffer, m },
+    { SolveResult::rowPriceField, bulk.rowPrice_,
+      &SolveResult::rowPriceBuffer, m },
+    { SolveResult::reducedCostField, bulk.reducedCost_,
+      &SolveResult::reducedCostBuffer, n }
+  } ;
+  for (const VecSpec &spec : vecSpecs) {
+    if ((fields&spec.field_) == 0) continue ;
+    const double *src = (spec.func_)?spec.func_(clpC_):nullptr ;
+    if (src == nullptr) {
+      retval = -1 ;
+      continue ;
+    }
+    double *dst = (result.*spec.buffer_)() ;
+    std::copy(src,src+spec.len_,dst) ;
+  }
+
+  return (retval) ;
+}
+
 /*
   User pointer
 */
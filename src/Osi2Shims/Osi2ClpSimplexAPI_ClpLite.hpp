@@ -10,6 +10,11 @@
 #ifndef Osi2ClpSimplexAPI_ClpLite_HPP
 #define Osi2ClpSimplexAPI_ClpLite_HPP
 
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "Osi2API.hpp"
 #define COIN_EXTERN_C
 #include "Osi2ClpSimplexAPI.hpp"
@@ -35,6 +40,19 @@ public:
 
   /// Destructor
   ~ClpSimplexAPI_ClpLite() ;
+
+  /*! \brief Empty the clp model and restore the default settings
+
+    Used to recycle the object. The model is resized to 0 x 0 in place and
+    its settings (log level included) put back to those of a new model;
+    only if that can't be done is it replaced with a new one. Parameter
+    registration and libClp lookups are kept. Returns 0 on success, -1 on
+    failure.
+  */
+  int reset() ;
+
+  /// Clone; see ClpSimplexAPI::clone
+  ClpSimplexAPI *clone() const ;
 //@}
 
 /*! \name Methods to load, modify, and retrieve a problem. */
@@ -115,6 +133,8 @@ public:
   /// Modify one element of the matrix.
   void modifyCoefficient(int row, int column,
   			 double val, bool keepZero = false) ;
+  /// Get the (cached) row-major copy of the matrix.
+  const RowMajorView &getRowMajorView(int numThreads = 1) const ;
 
   /// Check if status array exists.
   bool statusExists() const ;
@@ -297,6 +317,10 @@ public:
   double *infeasibilityRay() const ;
   /// Free a ray
   void freeRay(double *ray) const ;
+  /// Unbounded ray into caller storage
+  int fetchUnboundedRay(RayBuffer &ray) const ;
+  /// Infeasibility ray into caller storage
+  int fetchInfeasibilityRay(RayBuffer &ray) const ;
 
   // /// Number of primal infeasibilities
   int numberPrimalInfeasibilities() const ;
@@ -310,6 +334,10 @@ public:
 
   /// Check the solution
   void checkSolution() ;
+
+  /// Fetch the solution in one operation
+  int fetchResult(SolveResult &result,
+		  unsigned int fields = SolveResult::allFields) const ;
 //@}
 
 /*! \name User pointer */
@@ -371,12 +399,97 @@ private:
     Clp_Simplex *clpC_ ;
   //@}
 
+  /*! \name C interface functions for the bulk fetch methods
+
+    Looked up on the first call of #fetchResult or a ray fetch method, not
+    in the constructor, so that objects that never fetch (and pooled
+    objects being recycled) pay nothing. Each object keeps its own copies,
+    so the fetch methods write no shared state and can run in several
+    threads at once on different objects. A pointer is null if its lookup
+    failed.
+  */
+  //@{
+    typedef int (*IntGetFunc)(Clp_Simplex *) ;
+    typedef double (*DblGetFunc)(Clp_Simplex *) ;
+    typedef const double *(*VecGetFunc)(Clp_Simplex *) ;
+    typedef double *(*RayFunc)(Clp_Simplex *) ;
+    typedef void (*FreeRayFunc)(Clp_Simplex *,double *) ;
+    struct BulkFuncs {
+      IntGetFunc numRows_ ;
+      IntGetFunc numCols_ ;
+      IntGetFunc status_ ;
+      IntGetFunc secStatus_ ;
+      IntGetFunc numIters_ ;
+      DblGetFunc objValue_ ;
+      VecGetFunc colSolution_ ;
+      VecGetFunc rowActivity_ ;
+      VecGetFunc rowPrice_ ;
+      VecGetFunc reducedCost_ ;
+      RayFunc unboundedRay_ ;
+      RayFunc infeasibilityRay_ ;
+      FreeRayFunc freeRay_ ;
+    } ;
+    mutable BulkFuncs bulk_ ;
+    /// True once #bulk_ has been looked up
+    mutable bool bulkReady_ ;
+    /// Serialises the lookup
+    mutable std::mutex bulkMutex_ ;
+  //@}
+
+  /*! \name C interface functions and default settings for #reset
+
+    Looked up on the first reset, when the defaults are also read from a
+    scratch Clp_Simplex, so later resets need neither a lookup nor a new
+    model. A pointer is null if its lookup failed.
+  */
+  //@{
+    typedef Clp_Simplex *(*NewModelFunc)() ;
+    typedef void (*ModelFunc)(Clp_Simplex *) ;
+    typedef void (*ResizeFunc)(Clp_Simplex *,int,int) ;
+    typedef void (*IntSetFunc)(Clp_Simplex *,int) ;
+    typedef void (*DblSetFunc)(Clp_Simplex *,double) ;
+    typedef int (*NameSetFunc)(Clp_Simplex *,int,const char *) ;
+    struct ResetFuncs {
+      NewModelFunc newModel_ ;
+      ModelFunc deleteModel_ ;
+      ResizeFunc resize_ ;
+      ModelFunc deleteIntInfo_ ;
+      ModelFunc dropNames_ ;
+      NameSetFunc setProbName_ ;
+      /// Setter and default value of each setting
+      std::vector<std::pair<IntSetFunc,int> > intDefaults_ ;
+      std::vector<std::pair<DblSetFunc,double> > dblDefaults_ ;
+      std::string probName_ ;
+      /// True if the model can be emptied in place
+      bool inPlace_ ;
+    } ;
+    ResetFuncs resetFuncs_ ;
+    /// True once #resetFuncs_ has been looked up
+    bool resetReady_ ;
+  //@}
+
+  /*! \name Cached views of the model */
+  //@{
+    /// Row-major copy of the matrix
+    mutable RowMajorView rowView_ ;
+    /// Serialises building the row-major copy
+    mutable std::mutex rowViewMutex_ ;
+  //@}
+
   /*! \name Auxilliary methods */
   //@{
+    /// The functions in #bulk_, looked up on first use
+    const BulkFuncs &bulkFuncs() const ;
+    /// Fill in #resetFuncs_
+    void lookupResetFuncs() ;
+    /// Copy a clp ray into a RayBuffer and free the clp ray
+    int fetchRay(RayFunc getRay, int dim, RayBuffer &ray) const ;
     /// Get problem name using struct {int,char*}
     void getProbNameVoid(void *blob) const ;
     /// Set problem name using struct {int,char*}
     void setProbNameVoid(const void *blob) ;
+    /// Mark cached views of the model out of date
+    void invalidateViews() ;
   //@}
 } ;
 
@@ -115,6 +115,7 @@ ExitFunc initPlugin (PlatformServices *services)
   reginfo.ctrlObj_ = static_cast<PluginState *>(shim) ;
   reginfo.createFunc_ = GlpkHeavyShim::create ;
   reginfo.destroyFunc_ = GlpkHeavyShim::destroy ;
+  reginfo.resetFunc_ = nullptr ;
   int retval = services->registerAPI_(
 	  reinterpret_cast<const unsigned char*>("Osi1"), &reginfo) ;
   if (retval < 0) {
@@ -12,6 +12,7 @@
   direct access to clp objects.
 */
 
+#include <algorithm>
 #include <iostream>
 
 #include "ClpConfig.h"
@@ -61,6 +62,49 @@ Osi1API_ClpHeavy::~Osi1API_ClpHeavy ()
   */
 }
 
+/*
+  Rays into caller storage. OsiClpSolverInterface::getDualRays and
+  getPrimalRays hand back the copies made by ClpModel::infeasibilityRay and
+  ClpModel::unboundedRay. Those are copies of ClpModel::ray(), with no change
+  of sign, valid only when the problem status says the ray is the right kind
+  (1, primal infeasible, for a dual ray; 2, dual infeasible, for a primal
+  ray). Here we copy from ray() directly into the caller's buffer. Clp keeps
+  only one ray, so at most one is loaded.
+
+  For the full dual ray, the column part is -A'y, as in
+  ClpModel::infeasibilityRay; it's built in rayWork_ so that a reused buffer
+  sees no allocation.
+*/
+int Osi1API_ClpHeavy::fetchDualRays (RayBuffer &rays, int maxNumRays,
+				     bool fullRay) const
+{
+  const ClpSimplex *clp = getModelPtr() ;
+  const int m = clp->numberRows() ;
+  const int n = clp->numberColumns() ;
+  rays.startFill(fullRay?m+n:m) ;
+  const double *ray = clp->ray() ;
+  if (maxNumRays < 1 || clp->status() != 1 || ray == nullptr) return (0) ;
+  if (!fullRay) {
+    rays.appendRay(ray) ;
+  } else {
+    rayWork_.resize(m+n) ;
+    std::copy(ray,ray+m,rayWork_.begin()) ;
+    std::fill(rayWork_.begin()+m,rayWork_.end(),0.0) ;
+    clp->transposeTimes(-1.0,&rayWork_[0],&rayWork_[m]) ;
+    rays.appendRay(&rayWork_[0]) ;
+  }
+  return (rays.getNumRays()) ;
+}
+
+int Osi1API_ClpHeavy::fetchPrimalRays (RayBuffer &rays, int maxNumRays) const
+{
+  const ClpSimplex *clp = getModelPtr() ;
+  rays.startFill(clp->numberColumns()) ;
+  const double *ray = clp->ray() ;
+  if (maxNumRays < 1 || clp->status() != 2 || ray == nullptr) return (0) ;
+  rays.appendRay(ray) ;
+  return (rays.getNumRays()) ;
+}
 
 }    // end Osi2 namespace
 
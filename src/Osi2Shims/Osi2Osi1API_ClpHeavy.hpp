@@ -266,6 +266,16 @@ public:
   inline std::vector<double*> getPrimalRays(int maxCnt) const
   { return (OsiClpSolverInterface::getPrimalRays(maxCnt)) ; }
 
+  /*! \brief Dual rays into caller storage
+
+    Copies straight from clp's internal ray; see the .cpp file.
+  */
+  int fetchDualRays(RayBuffer &rays, int maxNumRays,
+  		    bool fullRay = false) const ;
+
+  /// Primal rays into caller storage, straight from clp's internal ray
+  int fetchPrimalRays(RayBuffer &rays, int maxNumRays) const ;
+
   inline OsiVectorInt getFractionalIndices(double tol) const
   { return (OsiClpSolverInterface::getFractionalIndices(tol)) ; }
   //@}
@@ -806,6 +816,11 @@ public:
   						   outStatus,t,dx)) ; }
   //@}
 
+private:
+
+  /// Scratch for the column part of a full dual ray
+  mutable std::vector<double> rayWork_ ;
+
 } ;
 
 }    // end namespace Osi2
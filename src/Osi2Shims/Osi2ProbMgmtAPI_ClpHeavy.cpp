@@ -42,6 +42,11 @@ ProbMgmtAPI_ClpHeavy::~ProbMgmtAPI_ClpHeavy ()
   std::cout << "ProbMgmtAPI_Clp object destroyed." << std::endl ;
 }
 
+ProbMgmtAPI *ProbMgmtAPI_ClpHeavy::clone () const
+{
+  return (new ProbMgmtAPI_ClpHeavy(new ClpSimplex(*clpSimplex_))) ;
+}
+
 /*
   Read a problem file in mps format.
 */
@@ -32,6 +32,9 @@ public:
     /// Destructor
     virtual ~ProbMgmtAPI_ClpHeavy() ;
 
+    /// Clone, a full copy made with the ClpSimplex copy constructor
+    ProbMgmtAPI *clone() const ;
+
     /// Read an mps file from the given filename
     int readMps(const char *filename, bool keepNames = false,
                 bool ignoreErrors = false) ;
@@ -0,0 +1,355 @@
+/*
+  Copyright 2011 Lou Hafer, Matt Saltzman
+  This code is licensed under the terms of the Eclipse Public License (EPL)
+
+  $Id$
+
+  This file contains benchmarks for the OSI2 solver utilities. It is not part
+  of the unit test; build and run it with `make bench'.
+
+  Usage: osi2Bench [shim [rows [cols [threads]]]]
+  The default shim is clpHeavy; any shim that supplies an Osi1 object will
+  do. The clone benchmark always uses the clp (lite) shim, which supplies
+  ClpSimplex objects.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Osi2Config.h"
+#include "Osi2nullptr.hpp"
+#include "Osi2PluginManager.hpp"
+#include "Osi2ControlAPI_Imp.hpp"
+#include "Osi2Osi1API.hpp"
+#include "Osi2ClpSimplexAPI.hpp"
+
+#include "Osi2Parallel.hpp"
+#include "Osi2TableauBatch.hpp"
+
+using namespace Osi2 ;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock ;
+
+inline double secsSince (const Clock::time_point &start)
+{
+  return (std::chrono::duration<double>(Clock::now()-start).count()) ;
+}
+
+/*
+  Resident set size in bytes, from /proc/self/statm; -1 if that isn't
+  available.
+*/
+long residentBytes ()
+{
+  std::ifstream statm("/proc/self/statm") ;
+  long pages = -1 ;
+  long resident = -1 ;
+  if (!(statm >> pages >> resident)) return (-1) ;
+  return (resident*sysconf(_SC_PAGESIZE)) ;
+}
+
+/// A model in the form loadProblem takes
+struct GenModel {
+  int m_ ;
+  int n_ ;
+  std::vector<CoinBigIndex> starts_ ;
+  std::vector<int> rows_ ;
+  std::vector<double> coeffs_ ;
+  std::vector<double> collb_ ;
+  std::vector<double> colub_ ;
+  std::vector<double> obj_ ;
+  std::vector<double> rowlb_ ;
+  std::vector<double> rowub_ ;
+} ;
+
+/*
+  Generate a random covering-style MIP: m rows, n general integer columns in
+  [0,10], roughly 8 nonzeros per column with coefficients in [1,10], row
+  lower bounds chosen so the LP relaxation has a fractional optimum. The
+  generator is seeded, so every run sees the same model.
+*/
+void buildMip (GenModel &model, int m, int n, unsigned int seed,
+	       double infinity)
+{
+  std::mt19937 gen(seed) ;
+  std::uniform_int_distribution<int> pickRow(0,m-1) ;
+  std::uniform_int_distribution<int> pickCoeff(1,10) ;
+  const int perCol = (m < 8)?m:8 ;
+
+  std::vector<CoinBigIndex> &starts = model.starts_ ;
+  std::vector<int> &rows = model.rows_ ;
+  std::vector<double> &coeffs = model.coeffs_ ;
+  model.m_ = m ;
+  model.n_ = n ;
+  starts.assign(1,0) ;
+  rows.clear() ;
+  coeffs.clear() ;
+  std::vector<double> rowSum(m,0.0) ;
+  std::vector<char> used(m,0) ;
+  for (int j = 0 ; j < n ; j++) {
+    for (int k = 0 ; k < perCol ; k++) {
+      int i = pickRow(gen) ;
+      if (used[i]) continue ;
+      used[i] = 1 ;
+      double a = pickCoeff(gen) ;
+      rows.push_back(i) ;
+      coeffs.push_back(a) ;
+      rowSum[i] += a ;
+    }
+    for (CoinBigIndex ndx = starts.back() ;
+	 ndx < static_cast<CoinBigIndex>(rows.size()) ; ndx++)
+      used[rows[ndx]] = 0 ;
+    starts.push_back(static_cast<CoinBigIndex>(rows.size())) ;
+  }
+  model.collb_.assign(n,0.0) ;
+  model.colub_.assign(n,10.0) ;
+  model.obj_.resize(n) ;
+  for (int j = 0 ; j < n ; j++) model.obj_[j] = pickCoeff(gen)+0.5 ;
+  model.rowlb_.resize(m) ;
+  model.rowub_.assign(m,infinity) ;
+  for (int i = 0 ; i < m ; i++)
+    model.rowlb_[i] = std::floor(0.37*rowSum[i])+0.5 ;
+}
+
+void generateMip (Osi1API &si, int m, int n, unsigned int seed)
+{
+  GenModel model ;
+  buildMip(model,m,n,seed,si.getInfinity()) ;
+  si.loadProblem(n,m,model.starts_.data(),model.rows_.data(),
+		 model.coeffs_.data(),model.collb_.data(),model.colub_.data(),
+		 model.obj_.data(),model.rowlb_.data(),model.rowub_.data()) ;
+  for (int j = 0 ; j < n ; j++) si.setInteger(j) ;
+}
+
+/*
+  Rows of the tableau a Gomory separator would ask for: those whose basic
+  variable is an integer column at a fractional value.
+*/
+void gomoryRows (const Osi1API &si, std::vector<int> &rows)
+{
+  const int m = si.getNumRows() ;
+  const int n = si.getNumCols() ;
+  const double *x = si.getColSolution() ;
+  std::vector<int> basics(m) ;
+  si.enableFactorization() ;
+  si.getBasics(basics.data()) ;
+  si.disableFactorization() ;
+  rows.clear() ;
+  for (int i = 0 ; i < m ; i++) {
+    const int j = basics[i] ;
+    if (j < n && si.isInteger(j) && std::fabs(x[j]-std::floor(x[j]+0.5)) > 1.0e-6)
+      rows.push_back(i) ;
+  }
+}
+
+/*
+  Time one dense getBInvARow call per row (what a separator does today)
+  against TableauBatch with increasing thread counts.
+*/
+void benchTableau (Osi1API &si, int maxThreads)
+{
+  std::vector<int> rows ;
+  gomoryRows(si,rows) ;
+  const int num = static_cast<int>(rows.size()) ;
+  const int m = si.getNumRows() ;
+  const int n = si.getNumCols() ;
+  std::cout
+    << "B-inverse A rows: " << num << " fractional basic rows, "
+    << m << " x " << n << "." << std::endl ;
+  if (num == 0) return ;
+
+  Clock::time_point start = Clock::now() ;
+  std::vector<double> z(n) ;
+  std::vector<double> slack(m) ;
+  si.enableFactorization() ;
+  for (int k = 0 ; k < num ; k++)
+    si.getBInvARow(rows[k],z.data(),slack.data()) ;
+  si.disableFactorization() ;
+  const double serial = secsSince(start) ;
+  std::cout
+    << "  " << std::setw(20) << std::left << "dense, one by one"
+    << std::right << std::setw(10) << std::fixed << std::setprecision(4)
+    << serial << "s" << std::endl ;
+
+  TableauBatch batch ;
+  batch.setMinChunk(1) ;
+  for (int threads = 1 ; threads <= maxThreads ; threads *= 2) {
+    batch.setNumThreads(threads) ;
+    start = Clock::now() ;
+    batch.getBInvARows(si,num,rows.data()) ;
+    const double secs = secsSince(start) ;
+    std::cout
+      << "  " << std::setw(12) << std::left << "batch, " << std::right
+      << std::setw(2) << threads << " thr"
+      << std::setw(10) << secs << "s  speedup "
+      << std::setprecision(2) << serial/secs
+      << ", " << batch.getStarts()[num] << " nonzeros."
+      << std::setprecision(4) << std::endl ;
+  }
+}
+
+/*
+  Make numClones copies of a solved ClpSimplex object two ways: load the
+  model into new objects from ControlAPI, and clone. Report the time and the
+  growth in resident memory per copy, and the cost of the first re-solve.
+*/
+void benchClone (ControlAPI &ctrlAPI, int m, int n, int numClones)
+{
+  const std::string clpName = "clp" ;
+  if (ctrlAPI.load(clpName) != 0) {
+    std::cout << "Clone benchmark skipped; no clp shim." << std::endl ;
+    return ;
+  }
+  API *origObj = nullptr ;
+  if (ctrlAPI.createObject(origObj,ClpSimplexAPI::getAPIIDString(),
+			   &clpName) != 0) {
+    std::cout
+      << "Clone benchmark skipped; no ClpSimplex object." << std::endl ;
+    return ;
+  }
+  ClpSimplexAPI *orig = static_cast<ClpSimplexAPI *>
+      (origObj->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  orig->setLogLevel(0) ;
+  GenModel model ;
+  buildMip(model,m,n,20110401,std::numeric_limits<double>::max()) ;
+  orig->loadProblem(n,m,model.starts_.data(),model.rows_.data(),
+		    model.coeffs_.data(),model.collb_.data(),
+		    model.colub_.data(),model.obj_.data(),
+		    model.rowlb_.data(),model.rowub_.data()) ;
+  orig->initialSolve() ;
+  orig->getRowMajorView() ;
+  const double modelMB =
+      (model.coeffs_.size()*(sizeof(double)+sizeof(int))+
+       (n+1)*sizeof(CoinBigIndex)+(4.0*n+2.0*m)*sizeof(double))/1048576.0 ;
+  std::cout
+    << "Full copies of a solved ClpSimplex object, " << m << " x " << n
+    << ", " << model.coeffs_.size() << " nonzeros (" << std::setprecision(2)
+    << modelMB << " MB of model data). Nothing is shared between copies, so"
+    << std::endl
+    << "  the growth in resident memory per copy should be about the size"
+    << " of the model." << std::setprecision(4) << std::endl ;
+/*
+  Reload into fresh objects. These start without a basis.
+*/
+  std::vector<API *> freshObjs(numClones,nullptr) ;
+  long before = residentBytes() ;
+  Clock::time_point start = Clock::now() ;
+  for (int k = 0 ; k < numClones ; k++) {
+    if (ctrlAPI.createObject(freshObjs[k],ClpSimplexAPI::getAPIIDString(),
+			     &clpName) != 0 || freshObjs[k] == nullptr) {
+      std::cout
+	<< "Clone benchmark stopped; cannot create ClpSimplex object " << k
+	<< "." << std::endl ;
+      for (API *obj : freshObjs)
+	if (obj != nullptr) ctrlAPI.destroyObject(obj) ;
+      ctrlAPI.destroyObject(origObj) ;
+      return ;
+    }
+    ClpSimplexAPI *fresh = static_cast<ClpSimplexAPI *>
+	(freshObjs[k]->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+    fresh->setLogLevel(0) ;
+    fresh->loadProblem(n,m,orig->getVectorStarts(),orig->getIndices(),
+		       orig->getElements(),orig->columnLower(),
+		       orig->columnUpper(),orig->objective(),
+		       orig->rowLower(),orig->rowUpper()) ;
+  }
+  double secs = secsSince(start) ;
+  long after = residentBytes() ;
+  ClpSimplexAPI *first = static_cast<ClpSimplexAPI *>
+      (freshObjs[0]->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  start = Clock::now() ;
+  first->dual() ;
+  const double freshSolve = secsSince(start) ;
+  const int freshIters = first->numberIterations() ;
+  std::cout
+    << "  " << std::setw(8) << std::left << "reload" << std::right
+    << std::setw(10) << std::fixed << secs << "s for " << numClones
+    << ", " << std::setprecision(2) << std::setw(8)
+    << (after-before)/1048576.0/numClones << " MB per copy; re-solve "
+    << std::setprecision(4) << freshSolve << "s, " << freshIters
+    << " iterations." << std::endl ;
+  for (API *obj : freshObjs) ctrlAPI.destroyObject(obj) ;
+/*
+  Clone. These carry the basis; each is a full copy of the model (there's
+  no copy-on-write sharing).
+*/
+  std::vector<ClpSimplexAPI *> clones(numClones,nullptr) ;
+  before = residentBytes() ;
+  start = Clock::now() ;
+  for (int k = 0 ; k < numClones ; k++) {
+    clones[k] = orig->clone() ;
+    if (clones[k] == nullptr) {
+      std::cout
+	<< "Clone benchmark stopped; clone " << k << " failed." << std::endl ;
+      for (ClpSimplexAPI *clone : clones) delete clone ;
+      ctrlAPI.destroyObject(origObj) ;
+      return ;
+    }
+  }
+  secs = secsSince(start) ;
+  after = residentBytes() ;
+  start = Clock::now() ;
+  clones[0]->dual() ;
+  const double cloneSolve = secsSince(start) ;
+  const int cloneIters = clones[0]->numberIterations() ;
+  std::cout
+    << "  " << std::setw(8) << std::left << "clone" << std::right
+    << std::setw(10) << secs << "s for " << numClones
+    << ", " << std::setprecision(2) << std::setw(8)
+    << (after-before)/1048576.0/numClones << " MB per copy; re-solve "
+    << std::setprecision(4) << cloneSolve << "s, " << cloneIters
+    << " iterations." << std::endl ;
+  for (ClpSimplexAPI *clone : clones) delete clone ;
+  ctrlAPI.destroyObject(origObj) ;
+}
+
+}  // end anonymous namespace
+
+
+int main (int argC, char *argV[])
+{
+  std::string shortName = (argC > 1)?argV[1]:"clpHeavy" ;
+  int m = (argC > 2)?std::stoi(argV[2]):2000 ;
+  int n = (argC > 3)?std::stoi(argV[3]):4000 ;
+  int maxThreads = (argC > 4)?std::stoi(argV[4]):defaultNumThreads() ;
+
+  ControlAPI_Imp ctrlAPI ;
+  ctrlAPI.setLogLvl(0) ;
+  if (ctrlAPI.load(shortName) != 0) {
+    std::cout << "Failed to load the " << shortName << " shim." << std::endl ;
+    return (1) ;
+  }
+  API *apiObj = nullptr ;
+  if (ctrlAPI.createObject(apiObj,"Osi1",&shortName) != 0) {
+    std::cout
+      << "Failed to create an Osi1 object from " << shortName << "."
+      << std::endl ;
+    return (1) ;
+  }
+  Osi1API *si = dynamic_cast<Osi1API *>(apiObj) ;
+  si->setHintParam(OsiDoReducePrint,true,OsiHintDo) ;
+
+  generateMip(*si,m,n,20110401) ;
+  si->initialSolve() ;
+  if (!si->isProvenOptimal()) {
+    std::cout << "LP relaxation of the generated MIP is not optimal." << std::endl ;
+  } else {
+    benchTableau(*si,maxThreads) ;
+  }
+
+  ctrlAPI.destroyObject(apiObj) ;
+  benchClone(ctrlAPI,m,n,16) ;
+  PluginManager::getInstance().shutdown() ;
+  return (0) ;
+}
@@ -7,6 +7,11 @@
   This file contains the unit test for the OSI2 PluginManager and OSI2 APIs.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
 #include "CoinHelperFunctions.hpp"
 
 
@@ -25,6 +30,24 @@
 #include "Osi2ClpSolveParamsAPI.hpp"
 
 #include "Osi2RunParamsAPI.hpp"
+#include "Osi2CutBatch.hpp"
+#include "Osi2CutPool.hpp"
+#include "Osi2StrongBranch.hpp"
+#include "Osi2TableauBatch.hpp"
+#include "Osi2RedCostFix.hpp"
+#include "Osi2SolutionVerifier.hpp"
+#include "Osi2ModelBuilder.hpp"
+#include "Osi2ModelDiff.hpp"
+#include "Osi2ColumnGenerator.hpp"
+#include "Osi2RowGenerator.hpp"
+#include "Osi2BendersSolver.hpp"
+#include "Osi2BlockDecomposer.hpp"
+#include "Osi2ScenarioBatch.hpp"
+#include "Osi2ParametricSweep.hpp"
+#include "Osi2LexiSolver.hpp"
+#include "Osi2SolverHost.hpp"
+#include "Osi2SolverDaemon.hpp"
+#include "Osi2SolverClient.hpp"
 
 #ifndef OSI2UTSAMPLEDIR
 # define SAMPLEDATADIR "/usr/local/share/coin-or-sample"
@@ -47,6 +70,7 @@ namespace {
     * Load a plugin library.
     * Create ClpSimplex objects: exact match and wild card. Also check that
       we fail correctly for a nonexistent object.
+    * Check that a pooled object is recycled.
 
   The test is (sort of) clp-specific, but only in the sense that the test clp
   plugin will return a ClpSimpex object via the wildcard mechanism when asked
@@ -147,6 +171,22 @@ int testPluginManager ()
     ClpSimplexAPI *clp =
 	static_cast<ClpSimplexAPI *>(clpWrap->getAPIPtr("ClpSimplex")) ;
     clp->readMps("exmip1.mps",true) ;
+/*
+  The wrapper builds the objects for its APIs on request. Check that a
+  second request gets the same object.
+*/
+    const char **idents = nullptr ;
+    int numAPIs = clpWrap->getAPIs(idents) ;
+    void *solveParams =
+	clpWrap->getAPIPtr(ClpSolveParamsAPI::getAPIIDString()) ;
+    if (numAPIs != 2 || solveParams == nullptr ||
+	clpWrap->getAPIPtr(ClpSolveParamsAPI::getAPIIDString()) != solveParams ||
+	clpWrap->getAPIPtr("ClpSimplex") != clp) {
+      errcnt++ ;
+      std::cout
+	<< "Apparent failure to build ClpLite_Wrap APIs on request."
+	<< std::endl ;
+    }
     int retval = plugMgr.destroyObject("ClpSimplex",0,clp) ;
     if (retval < 0) {
       errcnt++ ;
@@ -200,6 +240,65 @@ int testPluginManager ()
       }
       clp = nullptr ;
   }
+  /*
+    Check object pooling. With a pool limit of 1, a destroyed ClpSimplex
+    object should be reset (emptied, default settings) and handed out again
+    by the next create. Setting the limit back to 0 destroys the object left
+    in the pool.
+  */
+  plugMgr.setPoolLimit("ClpSimplex",1) ;
+  libID = 0 ;
+  clpWrap = static_cast<ClpLite_Wrap *>
+      (plugMgr.createObject("ClpSimplex",libID,dummy)) ;
+  if (clpWrap == nullptr) {
+    errcnt++ ;
+    std::cout
+      << "Apparent failure to create a ClpLite_Wrap object." << std::endl ;
+  } else {
+    ClpLite_Wrap *firstWrap = clpWrap ;
+    ClpSimplexAPI *clp =
+	static_cast<ClpSimplexAPI *>(clpWrap->getAPIPtr("ClpSimplex")) ;
+    const int dfltLogLevel = clp->logLevel() ;
+    const int dfltMaxIters = clp->maximumIterations() ;
+    clp->readMps("exmip1.mps",true) ;
+    clp->setLogLevel(dfltLogLevel+2) ;
+    clp->setMaximumIterations(7) ;
+    if (clp->numberRows() == 0) {
+      errcnt++ ;
+      std::cout << "Apparent failure to read exmip1.mps." << std::endl ;
+    }
+    plugMgr.destroyObject("ClpSimplex",libID,clpWrap) ;
+    clpWrap = static_cast<ClpLite_Wrap *>
+	(plugMgr.createObject("ClpSimplex",libID,dummy)) ;
+    clp = (clpWrap == nullptr)?nullptr:
+	static_cast<ClpSimplexAPI *>(clpWrap->getAPIPtr("ClpSimplex")) ;
+    PluginManager::PoolStats stats = plugMgr.getPoolStats("ClpSimplex") ;
+    if (clpWrap != firstWrap || stats.hits_ != 1 || clp == nullptr) {
+      errcnt++ ;
+      std::cout
+	<< "Apparent failure to recycle a pooled ClpSimplex object."
+	<< std::endl ;
+    } else if (clp->numberRows() != 0 || clp->numberColumns() != 0 ||
+	       clp->logLevel() != dfltLogLevel ||
+	       clp->maximumIterations() != dfltMaxIters) {
+      errcnt++ ;
+      std::cout
+	<< "Recycled ClpSimplex object has " << clp->numberRows()
+	<< " rows, " << clp->numberColumns() << " columns, log level "
+	<< clp->logLevel() << ", iteration limit "
+	<< clp->maximumIterations() << "; expected an empty model with "
+	<< "default settings." << std::endl ;
+    }
+    if (clpWrap != nullptr)
+      plugMgr.destroyObject("ClpSimplex",libID,clpWrap) ;
+    if (plugMgr.getPoolStats("ClpSimplex").pooled_ != 1) {
+      errcnt++ ;
+      std::cout
+	<< "Apparent failure to return a ClpSimplex object to the pool."
+	<< std::endl ;
+    }
+  }
+  plugMgr.setPoolLimit("ClpSimplex",0) ;
   /*
     Unload the plugin library.
   */
@@ -227,6 +326,227 @@ int testPluginManager ()
   return (errcnt) ;
 }
 
+/*
+  Check TableauBatch against one dense getBInvARow or getBInvACol call per
+  vector, with one thread and with several. A minimum chunk of 1 makes the
+  several-thread case use clones even on a small batch.
+*/
+int checkTableauBatch (TableauBatch &batch, bool doRows, int num, int dim,
+		       const std::vector<double> &dense)
+{ int errCnt = 0 ;
+
+  if (batch.getNumVectors() != num) {
+    std::cout
+      << "TableauBatch returned " << batch.getNumVectors()
+      << " vectors, expected " << num << "." << std::endl ;
+    return (1) ;
+  }
+  std::vector<double> vec(dim) ;
+  for (int k = 0 ; k < num ; k++) {
+    std::fill(vec.begin(),vec.end(),0.0) ;
+    for (int ndx = batch.getStarts()[k] ; ndx < batch.getStarts()[k+1] ; ndx++)
+      vec[batch.getIndices()[ndx]] = batch.getElements()[ndx] ;
+    for (int i = 0 ; i < dim ; i++) {
+      if (std::fabs(vec[i]-dense[k*static_cast<size_t>(dim)+i]) > 1.0e-9) {
+	std::cout
+	  << "TableauBatch " << ((doRows)?"row ":"column ") << k
+	  << " differs at " << i << ": " << vec[i] << " vs "
+	  << dense[k*static_cast<size_t>(dim)+i] << "." << std::endl ;
+	errCnt++ ;
+	break ;
+      }
+    }
+  }
+
+  return (errCnt) ;
+}
+
+int testTableauBatch (const Osi1API &si)
+{ int errCnt = 0 ;
+
+  const int m = si.getNumRows() ;
+  const int n = si.getNumCols() ;
+  const int num = std::min(m,40) ;
+  std::vector<int> which(num) ;
+  for (int k = 0 ; k < num ; k++) which[k] = k ;
+
+  std::vector<double> rows(num*static_cast<size_t>(n+m)) ;
+  std::vector<double> cols(num*static_cast<size_t>(m)) ;
+  si.enableFactorization() ;
+  for (int k = 0 ; k < num ; k++) {
+    double *row = &rows[k*static_cast<size_t>(n+m)] ;
+    si.getBInvARow(k,row,row+n) ;
+    si.getBInvACol(k,&cols[k*static_cast<size_t>(m)]) ;
+  }
+  si.disableFactorization() ;
+
+  TableauBatch batch ;
+  batch.setMinChunk(1) ;
+  const int threads[] = { 1, 4 } ;
+  for (int numThreads : threads) {
+    batch.setNumThreads(numThreads) ;
+    batch.getBInvARows(si,num,which.data()) ;
+    errCnt += checkTableauBatch(batch,true,num,n+m,rows) ;
+    batch.getBInvACols(si,num,which.data()) ;
+    errCnt += checkTableauBatch(batch,false,num,m,cols) ;
+  }
+  if (errCnt == 0) {
+    std::cout
+      << "    batched B-inverse A rows and columns match the dense ones"
+      << " with 1 and 4 threads." << std::endl ;
+  }
+
+  return (errCnt) ;
+}
+
+// Defined below, next to the ClpSimplexAPI tests they parallel.
+int testRowGeneratorOsi1 (Osi1API &si) ;
+int testRayFetchOsi1 (Osi1API &si) ;
+
+/*
+  Check strong branching against explicit branch solves. min 2x+y over
+  x, y in [0,1] with x >= 0.3 and x+y >= 0.9 has its optimum at
+  (0.3,0.6), objective 1.2. Branching on x: down (x <= 0) is infeasible, up
+  (x >= 1) gives 2. Branching on y: down gives 1.8, up 1.6. So the one
+  bound change is to fix x at 1, and the node resolves to 2.
+*/
+int testStrongBranchOsi1 (Osi1API &si)
+{ int errCnt = 0 ;
+
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const int rowsX[] = { 0, 1 } ;
+  const int rowsY[] = { 1 } ;
+  const double ones[] = { 1.0, 1.0 } ;
+  bldr.addCol(2,rowsX,ones,0.0,1.0,2.0) ;
+  bldr.addCol(1,rowsY,ones,0.0,1.0,1.0) ;
+  const double rowlb[] = { 0.3, 0.9 } ;
+  bldr.setRowData(2,rowlb,nullptr) ;
+  bldr.loadInto(si) ;
+  si.initialSolve() ;
+  if (!si.isProvenOptimal() || std::fabs(si.getObjValue()-1.2) > 1.0e-7) {
+    std::cout
+      << "Strong branching model solves to " << si.getObjValue()
+      << ", expected 1.2." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  const double *x = si.getColSolution() ;
+  std::vector<StrongBranch::Candidate> cands ;
+  for (int j = 0 ; j < 2 ; j++) {
+    StrongBranch::Candidate cand = { j, x[j] } ;
+    cands.push_back(cand) ;
+  }
+  StrongBranch sb(2,50) ;
+  const int numChanges = sb.evaluate(si,cands) ;
+/*
+  Each branch again, by hand: change the bound, resolve, put it back.
+*/
+  const double expObj[2][2] = { { 0.0, 2.0 }, { 1.8, 1.6 } } ;
+  for (int j = 0 ; j < 2 ; j++) {
+    const StrongBranch::Result &res = sb.getResults()[j] ;
+    for (int up = 0 ; up < 2 ; up++) {
+      if (up)
+	si.setColLower(j,std::ceil(cands[j].value_)) ;
+      else
+	si.setColUpper(j,std::floor(cands[j].value_)) ;
+      si.resolve() ;
+      const bool infeas = si.isProvenPrimalInfeasible() ;
+      const double obj = si.getObjValue() ;
+      si.setColBounds(j,0.0,1.0) ;
+      si.resolve() ;
+      const StrongBranch::BranchStatus status =
+	  (up)?res.upStatus_:res.downStatus_ ;
+      const double sbObj = (up)?res.upObj_:res.downObj_ ;
+      const bool expInfeas = (j == 0 && !up) ;
+      bool ok ;
+      if (expInfeas)
+	ok = (infeas && (status == StrongBranch::infeasible ||
+			 status == StrongBranch::cutoff)) ;
+      else
+	ok = (!infeas && status == StrongBranch::optimal &&
+	      std::fabs(sbObj-obj) < 1.0e-7 &&
+	      std::fabs(obj-expObj[j][up]) < 1.0e-7) ;
+      if (!ok) {
+	std::cout
+	  << "Strong branching on column " << j << ((up)?" up":" down")
+	  << " gave status " << status << ", objective " << sbObj
+	  << "; the explicit solve gave "
+	  << ((infeas)?"infeasible":"optimal") << ", objective " << obj
+	  << "." << std::endl ;
+	errCnt++ ;
+      }
+    }
+  }
+  const std::vector<StrongBranch::BoundChange> &changes =
+      sb.getBoundChanges() ;
+  if (numChanges != 1 || sb.nodeInfeasible() || changes.size() != 1 ||
+      changes[0].col_ != 0 || changes[0].lower_ != 1.0 ||
+      changes[0].upper_ != 1.0) {
+    std::cout
+      << "Strong branching found " << numChanges
+      << " bound changes, expected one fixing column 0 at 1." << std::endl ;
+    errCnt++ ;
+  } else {
+    sb.applyBoundChanges(si) ;
+    si.resolve() ;
+    if (!si.isProvenOptimal() || std::fabs(si.getObjValue()-2.0) > 1.0e-7) {
+      std::cout
+	<< "After the strong branching bound change the model solves to "
+	<< si.getObjValue() << ", expected 2." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  if (errCnt == 0) {
+    std::cout
+      << "    strong branching matches explicit branch solves and fixes"
+      << " the column with an infeasible branch." << std::endl ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  A ProbMgmt clone is a full copy. It solves on its own to the same result,
+  and an infeasible model (galenet) loaded into it leaves the original, and
+  the original's solve, alone.
+*/
+int testProbMgmtClone (ProbMgmtAPI &orig, const std::string &sampleDir)
+{ int errCnt = 0 ;
+
+  const int origStatus = orig.initialSolve() ;
+  ProbMgmtAPI *clone = orig.clone() ;
+  if (clone == nullptr) {
+    std::cout << "Apparent failure to clone a ProbMgmt object." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  const int cloneStatus = clone->initialSolve() ;
+  if (cloneStatus != origStatus) {
+    std::cout
+      << "ProbMgmt clone solved with status " << cloneStatus
+      << ", the original with " << origStatus << "." << std::endl ;
+    errCnt++ ;
+  }
+  const std::string galenetPath =
+      sampleDir+CoinFindDirSeparator()+"galenet.mps" ;
+  if (clone->readMps(galenetPath.c_str(),true) != 0) {
+    errCnt++ ;
+  } else {
+    const int infStatus = clone->initialSolve() ;
+    const int status = orig.initialSolve() ;
+    if (infStatus != 1 || status != origStatus) {
+      std::cout
+	<< "After loading galenet into the clone, the clone solved with "
+	<< "status " << infStatus << " and the original with " << status
+	<< "; expected 1 and " << origStatus << "." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  delete clone ;
+
+  return (errCnt) ;
+}
+
 /*
   Test the control API and various aspects of object creation and destruction.
   The method creates various objects, works with them, and finally destroys
@@ -278,6 +598,11 @@ int testControlAPI (const std::string &shortName,
     std::string exmip1Path = dfltSampleDir+dirSep+"brandy.mps" ;
     clp->readMps(exmip1Path.c_str(),true) ;
     clp->initialSolve() ;
+/*
+  Only the ClpHeavy shim supplies ProbMgmt clones.
+*/
+    if (shortName == "clpHeavy")
+      errcnt += testProbMgmtClone(*clp,dfltSampleDir) ;
   }
 /*
   Create an Osi1 object and invoke a nontrivial method.  The clone test
@@ -305,6 +630,49 @@ int testControlAPI (const std::string &shortName,
     o2->initialSolve() ;
     if (o2->isProvenOptimal())
       std::cout << "    solved to optimality." << std::endl ;
+/*
+  Strong branch on the first few fractional columns, first with one thread,
+  then with several. The results should be identical.
+*/
+    std::vector<StrongBranch::Candidate> cands ;
+    const double *x = o2->getColSolution() ;
+    for (int j = 0 ; j < o2->getNumCols() && cands.size() < 8 ; j++) {
+      if (x[j]-static_cast<int>(x[j]) > 1.0e-6) {
+	StrongBranch::Candidate cand = { j, x[j] } ;
+	cands.push_back(cand) ;
+      }
+    }
+    StrongBranch serial(1,50) ;
+    StrongBranch parallel(4,50) ;
+    int serialChg = serial.evaluate(*o2,cands) ;
+    int parallelChg = parallel.evaluate(*o2,cands) ;
+    bool same = (serialChg == parallelChg) ;
+    for (size_t k = 0 ; k < cands.size() && same ; k++) {
+      const StrongBranch::Result &r1 = serial.getResults()[k] ;
+      const StrongBranch::Result &r2 = parallel.getResults()[k] ;
+      same = (r1.downStatus_ == r2.downStatus_ &&
+	      r1.upStatus_ == r2.upStatus_ &&
+	      r1.downObj_ == r2.downObj_ && r1.upObj_ == r2.upObj_) ;
+    }
+    if (same) {
+      std::cout
+	<< "    strong branching on " << cands.size()
+	<< " candidates is independent of thread count." << std::endl ;
+    } else {
+      errcnt++ ;
+      std::cout
+	<< "Strong branching results differ between one and four threads!"
+	<< std::endl ;
+    }
+    errcnt += testTableauBatch(*o2) ;
+    errcnt += testStrongBranchOsi1(*o2) ;
+    errcnt += testRowGeneratorOsi1(*o2) ;
+/*
+  The ray fetch overrides belong to the ClpHeavy shim; other solvers use the
+  default, written in terms of getDualRays and getPrimalRays, which they
+  may not implement.
+*/
+    if (shortName == "clpHeavy") errcnt += testRayFetchOsi1(*o2) ;
     apiObj = o2 ;
     retval = ctrlAPI.destroyObject(apiObj) ;
     if (retval < 0) {
@@ -555,6 +923,63 @@ int testParamMgmtAPI (std::string sampleDir)
   return (errCnt) ;
 }
 
+/*
+  Pricing oracle for the column generation test: a fixed list of candidate
+  columns with 0/1 coefficients, returning those with negative reduced
+  cost. A minimisation master is assumed.
+*/
+class ListPricer : public ColumnGenerator::Pricer {
+public:
+  void addCandidate (const std::vector<int> &rows, double cost)
+  {
+    rows_.push_back(rows) ;
+    costs_.push_back(cost) ;
+  }
+  int price (int numRows, const double *duals, ModelBuilder &cols)
+  {
+    int added = 0 ;
+    for (size_t k = 0 ; k < rows_.size() ; k++) {
+      double redCost = costs_[k] ;
+      for (int i : rows_[k]) redCost -= duals[i] ;
+      if (redCost >= -1.0e-9) continue ;
+      const std::vector<double> ones(rows_[k].size(),1.0) ;
+      cols.addCol(static_cast<int>(rows_[k].size()),rows_[k].data(),
+		  ones.data(),0.0,1.0e30,costs_[k]) ;
+      added++ ;
+    }
+    return (added) ;
+  }
+private:
+  std::vector<std::vector<int> > rows_ ;
+  std::vector<double> costs_ ;
+} ;
+
+/*
+  Separator for the row generation test: a fixed list of rows ax <= ub,
+  all handed back every time; the driver keeps the violated ones.
+*/
+class ListSeparator : public RowGenerator::Separator {
+public:
+  void addRow (const std::vector<int> &cols,
+	       const std::vector<double> &coeffs, double ub)
+  {
+    cols_.push_back(cols) ;
+    coeffs_.push_back(coeffs) ;
+    ubs_.push_back(ub) ;
+  }
+  int separate (int, const double *, CutBatch &cuts)
+  {
+    for (size_t k = 0 ; k < cols_.size() ; k++)
+      cuts.addCut(static_cast<int>(cols_[k].size()),cols_[k].data(),
+		  coeffs_[k].data(),-1.0e30,ubs_[k]) ;
+    return (static_cast<int>(cols_.size())) ;
+  }
+private:
+  std::vector<std::vector<int> > cols_ ;
+  std::vector<std::vector<double> > coeffs_ ;
+  std::vector<double> ubs_ ;
+} ;
+
 int testRunParamsAPI (std::string netlibDir)
 
 { int errCnt = 0 ;
@@ -661,6 +1086,84 @@ int testRunParamsAPI (std::string netlibDir)
   std::cout
     << "Solve took " << clpObj->numberIterations() << " iterations."
     << std::endl ;
+/*
+  Fetch the solution in one operation and check it against the individual
+  methods.
+*/
+  SolveResult result ;
+  retval = clpObj->fetchResult(result) ;
+  if (retval != 0 || !result.has(SolveResult::allFields)) {
+    std::cout
+      << "Error " << retval << " fetching solution; fields "
+      << std::hex << result.fields() << std::dec << "." << std::endl ;
+    errCnt++ ;
+  } else {
+    const int n = result.getNumCols() ;
+    const double *x = clpObj->getColSolution() ;
+    const double *xr = result.getColSolution() ;
+    bool same = (n == clpObj->numberColumns()) &&
+		(result.objectiveValue() == clpObj->objectiveValue()) &&
+		(result.status() == clpObj->status()) ;
+    for (int j = 0 ; j < n && same ; j++) same = (x[j] == xr[j]) ;
+    if (!same) {
+      std::cout << "Fetched solution does not match solver." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  Clone the solved model. The clone is a full copy: it has a row-major view
+  of its own, reaches the same objective from the copied basis, and a change
+  to its matrix leaves the original's view intact.
+*/
+  {
+    const RowMajorView &view = clpObj->getRowMajorView() ;
+    ClpSimplexAPI *clone = clpObj->clone() ;
+    if (clone == nullptr) {
+      std::cout << "Failed to clone the ClpSimplex object." << std::endl ;
+      errCnt++ ;
+    } else {
+      const bool separate = (&clone->getRowMajorView() != &view) ;
+      clone->dual() ;
+      const double objOrig = clpObj->objectiveValue() ;
+      const double objClone = clone->objectiveValue() ;
+      const int col = view.getIndices()[view.getStarts()[0]] ;
+      const double oldVal = view.getElements()[view.getStarts()[0]] ;
+      clone->modifyCoefficient(0,col,2*oldVal) ;
+      const RowMajorView &cloneView = clone->getRowMajorView() ;
+      if (!separate || clone->numberRows() != clpObj->numberRows() ||
+	  clone->getNumElements() != clpObj->getNumElements() ||
+	  std::fabs(objClone-objOrig) > 1.0e-6*(1.0+std::fabs(objOrig)) ||
+	  !view.isValid() ||
+	  view.getElements()[view.getStarts()[0]] != oldVal ||
+	  cloneView.getElements()[cloneView.getStarts()[0]] != 2*oldVal) {
+	std::cout << "Clone does not behave as expected." << std::endl ;
+	errCnt++ ;
+      }
+      delete clone ;
+    }
+  }
+/*
+  Check the row-major view: same number of coefficients as the column-major
+  matrix, and a change to a coefficient shows up after the view is rebuilt.
+*/
+  const RowMajorView &rowView = clpObj->getRowMajorView(4) ;
+  if (rowView.getNumElements() != clpObj->getNumElements() ||
+      rowView.getNumRows() != clpObj->numberRows() ||
+      rowView.getRowLength(0) == 0) {
+    std::cout << "Row-major view does not match the matrix." << std::endl ;
+    errCnt++ ;
+  } else {
+    const int col = rowView.getIndices()[rowView.getStarts()[0]] ;
+    const double newVal = 2*rowView.getElements()[rowView.getStarts()[0]] ;
+    clpObj->modifyCoefficient(0,col,newVal) ;
+    const RowMajorView &newView = clpObj->getRowMajorView() ;
+    if (newView.getIndices()[newView.getStarts()[0]] != col ||
+	newView.getElements()[newView.getStarts()[0]] != newVal) {
+      std::cout
+	<< "Row-major view not rebuilt after modifyCoefficient." << std::endl ;
+      errCnt++ ;
+    }
+  }
   std::cout << "Flipping objective sense to maximisation." << std::endl ;
   rpObj->setDblParam("obj sense",-1.0) ;
   clpObj->readMps(probPath.c_str()) ;
@@ -696,66 +1199,1733 @@ int testRunParamsAPI (std::string netlibDir)
   return errCnt ;
 }
 
-} // end unnamed file-local namespace
-
-
-int main(int argC,char* argV[])
+/*
+  Load a model with two independent blocks, in interleaved order: columns 0
+  and 2 use row 0, columns 1 and 3 use row 1. Several of the solver utility
+  tests start from it.
+*/
+void loadTwoBlocks (ClpSimplexAPI &clp)
 {
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const int rows0[] = { 0 } ;
+  const int rows1[] = { 1 } ;
+  const double one[] = { 1.0 } ;
+  const double two[] = { 2.0 } ;
+  bldr.addCol(1,rows0,one,0.0,10.0,1.0) ;
+  bldr.addCol(1,rows1,one,0.0,1.5,3.0) ;
+  bldr.addCol(1,rows0,two,0.0,10.0,1.0) ;
+  bldr.addCol(1,rows1,one,0.0,1.5,1.0) ;
+  const double rowlb[] = { -1.0e30, -1.0e30 } ;
+  const double rowub[] = { 4.0, 2.0 } ;
+  bldr.setRowData(2,rowlb,rowub) ;
+  bldr.loadInto(clp) ;
+}
 
-  std::cout << "START UNIT TEST" << std::endl ;
 /*
-  Test the bare PluginManager. There's no sense proceeding to the API
-  tests if the PluginManager isn't working.
+  Solve pilot as a maximisation problem, then rebuild it row by row in two
+  builders (as two threads would), merge them, load the result in one
+  call, and check that it solves to the same objective.
 */
-  std::cout << "Testing bare PluginManager." << std::endl ;
-  int retval = testPluginManager() ;
-  std::cout
-    << "End test of bare PluginManager, " << retval << " errors."
-    << std::endl << std::endl ;
-  if (retval != 0) {
+int testModelBuilder (ClpSimplexAPI &clp, const std::string &netlibDir)
+{ int errCnt = 0 ;
+
+  char dirSep = CoinFindDirSeparator() ;
+  std::string probPath = netlibDir+dirSep+"pilot.mps" ;
+  clp.readMps(probPath.c_str()) ;
+  clp.setObjSense(-1.0) ;
+  clp.initialSolve() ;
+  const double maxObj = clp.objectiveValue() ;
+  const RowMajorView &view = clp.getRowMajorView() ;
+  const int m = clp.numberRows() ;
+  const int n = clp.numberColumns() ;
+  const double *rowlb = clp.rowLower() ;
+  const double *rowub = clp.rowUpper() ;
+  ModelBuilder top, bottom ;
+  top.reserve(m/2,view.getStarts()[m/2]) ;
+  for (int i = 0 ; i < m ; i++) {
+    ModelBuilder &bldr = (i < m/2)?top:bottom ;
+    const CoinBigIndex k = view.getStarts()[i] ;
+    bldr.addRow(view.getRowLength(i),view.getIndices()+k,
+		view.getElements()+k,rowlb[i],rowub[i]) ;
+  }
+  top.append(bottom) ;
+  top.setColumnData(n,clp.columnLower(),clp.columnUpper(),
+		    clp.objective()) ;
+  if (top.getNumVectors() != m || top.loadInto(clp) != m ||
+      top.getNumVectors() != 0 || clp.numberColumns() != n) {
+    std::cout << "ModelBuilder failed to load the model." << std::endl ;
+    errCnt++ ;
+  } else {
+    clp.initialSolve() ;
+    if (std::fabs(clp.objectiveValue()-maxObj) >
+	  1.0e-7*std::max(1.0,std::fabs(maxObj))) {
       std::cout
-	<< "Aborting unitTest; errors in PluginManager." << std::endl ;
-      return (retval) ;
+	<< "Model from ModelBuilder solves to " << clp.objectiveValue()
+	<< ", expected " << maxObj << "." << std::endl ;
+      errCnt++ ;
+    }
   }
 /*
-  Construct the location of installed data files.
+  Append an unnamed row to a named one. The unnamed row must stay unnamed,
+  so clp gives it a default name, rather than being named "".
 */
-  std::string sampleDir = SAMPLEDATADIR ;
-  std::string netlibDir = NETLIBDATADIR ;
-  std::cout << "coin-or-sample is at " << sampleDir << std::endl ;
-  std::cout << "coin-or-netlib is at " << netlibDir << std::endl << std::endl ;
+  loadTwoBlocks(clp) ;
+  ModelBuilder named(ModelBuilder::rowWise) ;
+  ModelBuilder unnamed(ModelBuilder::rowWise) ;
+  const int cols01[] = { 0, 1 } ;
+  const double ones[] = { 1.0, 1.0 } ;
+  named.addRow(2,cols01,ones,-1.0e30,5.0,"named") ;
+  unnamed.addRow(2,cols01,ones,-1.0e30,6.0) ;
+  named.append(unnamed) ;
+  named.addTo(clp) ;
+  std::vector<char> rowName(std::max(clp.lengthNames(),8)+1) ;
+  clp.rowName(3,rowName.data()) ;
+  if (rowName[0] == '\0') {
+    std::cout
+      << "ModelBuilder gave an appended unnamed row an empty name."
+      << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
 /*
-  Grab the plugin manager instance.
+  Check that the block solve of the two-block model agrees with a solve of
+  the whole. The model is given an objective offset, which must be counted
+  once in the block objective.
 */
-  PluginManager &plugMgr = PluginManager::getInstance() ;
+int testBlockDecomposer (ControlAPI &ctrlAPI, ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  loadTwoBlocks(clp) ;
+  clp.setObjectiveOffset(2.5) ;
+  BlockDecomposer blocks(2) ;
+  SolveResult blockResult ;
+  if (blocks.analyse(clp) != 2 || blocks.getColBlock(2) != 0 ||
+      blocks.getRowBlock(1) != 1) {
+    std::cout << "BlockDecomposer did not find two blocks." << std::endl ;
+    errCnt++ ;
+  } else if (blocks.solve(clp,ctrlAPI,blockResult) != 0) {
+    std::cout << "BlockDecomposer failed to solve the blocks." << std::endl ;
+    errCnt++ ;
+  } else {
+    clp.initialSolve() ;
+    const double *x = clp.getColSolution() ;
+    bool same = (blockResult.status() == clp.status()) &&
+	(std::fabs(blockResult.objectiveValue()-
+		   clp.objectiveValue()) < 1.0e-9) ;
+    for (int j = 0 ; j < 4 && same ; j++)
+      same = (std::fabs(blockResult.getColSolution()[j]-x[j]) < 1.0e-9) ;
+    if (!same) {
+      std::cout
+	<< "Block solve objective " << blockResult.objectiveValue()
+	<< " does not match " << clp.objectiveValue() << "."
+	<< std::endl ;
+      errCnt++ ;
+    }
+  }
+  clp.setObjectiveOffset(0.0) ;
+
+  return (errCnt) ;
+}
+
 /*
-  Construct a vector of shims for testing, then open a loop to test each shim.
+  Solve three right-hand side scenarios in two runs and check each against
+  a solve from scratch.
 */
-  int totalErrs = 0 ;
-  typedef std::pair<std::string,int> TestVec ;
-  std::vector<TestVec> solvers ;
-  solvers.push_back(TestVec("clp",3)) ;
-# ifdef OSI2_HAS_OSICLP
-  solvers.push_back(TestVec("clpHeavy",0)) ;
-# endif
-# ifdef OSI2_HAS_OSIGLPK
-  solvers.push_back(TestVec("glpkHeavy",2)) ;
-# endif
-  std::vector<TestVec>::const_iterator iter ;
-  for (iter = solvers.begin() ; iter != solvers.end() ; iter++) {
-    std::string solverName = iter->first ;
+int testScenarioBatch (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  loadTwoBlocks(clp) ;
+  const double rhs[] = { 4.0, 2.0,  2.0, 2.0,  4.0, 1.0 } ;
+  ScenarioBatch batch(2) ;
+  batch.setFields(SolveResult::colSolutionField|SolveResult::rowPriceField) ;
+  if (batch.solve(clp,3,nullptr,rhs,nullptr) != 0 ||
+      batch.getRowPrices() == nullptr || batch.getReducedCosts() != nullptr) {
+    std::cout << "ScenarioBatch failed to solve the scenarios." << std::endl ;
+    errCnt++ ;
+  } else {
+    std::vector<double> saveRhs(clp.rowUpper(),clp.rowUpper()+2) ;
+    for (int k = 0 ; k < 3 ; k++) {
+      clp.chgRowUpper(&rhs[2*k]) ;
+      clp.initialSolve() ;
+      if (batch.getStatus()[k] != clp.status() ||
+	  std::fabs(batch.getObjValues()[k]-clp.objectiveValue()) >
+	    1.0e-9) {
+	std::cout
+	  << "Scenario " << k << " objective " << batch.getObjValues()[k]
+	  << " does not match " << clp.objectiveValue() << "."
+	  << std::endl ;
+	errCnt++ ;
+      }
+    }
+    clp.chgRowUpper(saveRhs.data()) ;
+  }
+
+  return (errCnt) ;
+}
+
 /*
-  First test the Osi2 control API. This test will try to create
-  ProbMgmt and Osi1 API objects in unrestricted mode (i.e., without
-  restriction to a particular library), followed by a ProbMgmt object in
-  restricted mode. Clp(Lite) doesn't support either one. ClpHeavy supports
-  both. GlpkHeavy supports only Osi1.
+  Sweep the cost of column 0 down over [0,1]. The sweep should skip most
+  of the solves, and agree with a solve from scratch at every point.
 */
+int testParametricSweep (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  loadTwoBlocks(clp) ;
+  const int numT = 11 ;
+  double t[numT] ;
+  for (int k = 0 ; k < numT ; k++) t[k] = 0.1*k ;
+  const double objDir[] = { -1.0, 0.0, 0.0, 0.0 } ;
+  ParametricSweep sweep ;
+  if (sweep.sweepObjective(clp,numT,t,objDir) != 0 ||
+      sweep.getNumSolves() >= numT || sweep.getNumPieces() < 1) {
     std::cout
-      << "Testing ControlAPI (" << solverName << ")." << std::endl ;
-    retval = testControlAPI(solverName,sampleDir) ;
-    std::cout
-      << "End test of ControlAPI (" << solverName << "), "
+      << "Parametric sweep made " << sweep.getNumSolves() << " solves for "
+      << numT << " points." << std::endl ;
+    errCnt++ ;
+  } else {
+    std::vector<double> saveObj(clp.objective(),clp.objective()+4) ;
+    std::vector<double> obj(saveObj) ;
+    for (int k = 0 ; k < numT ; k++) {
+      obj[0] = saveObj[0]+t[k]*objDir[0] ;
+      clp.chgObjCoefficients(obj.data()) ;
+      clp.initialSolve() ;
+      if (std::fabs(sweep.getObjValues()[k]-clp.objectiveValue()) >
+	    1.0e-7) {
+	std::cout
+	  << "Sweep objective at t = " << t[k] << " is "
+	  << sweep.getObjValues()[k] << ", expected "
+	  << clp.objectiveValue() << "." << std::endl ;
+	errCnt++ ;
+      }
+    }
+    clp.chgObjCoefficients(saveObj.data()) ;
+  }
+/*
+  Row bound sweep: min 2x + y, x + y >= 0.45 + t, y <= 1. Up to t = 0.55
+  the row is met with y (objective 0.45 + t), after that with x at the
+  margin (objective 2t - 0.1), so the profile has two pieces with slopes 1
+  and 2 and a breakpoint at 0.55, between two values of t. Solves after the
+  first run dual simplex from the previous basis.
+*/
+  { ModelBuilder bldr(ModelBuilder::colWise) ;
+    const int rows0[] = { 0 } ;
+    const double one[] = { 1.0 } ;
+    bldr.addCol(1,rows0,one,0.0,1.0e30,2.0) ;
+    bldr.addCol(1,rows0,one,0.0,1.0,1.0) ;
+    const double rowlb[] = { 0.45 } ;
+    const double rowub[] = { 1.0e30 } ;
+    bldr.setRowData(1,rowlb,rowub) ;
+    bldr.loadInto(clp) ;
+  }
+  const double lowerDir[] = { 1.0 } ;
+  ParametricSweep rowSweep ;
+  if (rowSweep.sweepRowBounds(clp,numT,t,lowerDir,nullptr) != 0 ||
+      rowSweep.getNumPieces() != 2) {
+    std::cout
+      << "Row bound sweep has " << rowSweep.getNumPieces()
+      << " pieces, expected 2." << std::endl ;
+    errCnt++ ;
+  } else {
+    for (int k = 0 ; k < numT ; k++) {
+      const double rowlb = 0.45+t[k] ;
+      clp.chgRowLower(&rowlb) ;
+      clp.initialSolve() ;
+      if (std::fabs(rowSweep.getObjValues()[k]-clp.objectiveValue()) >
+	    1.0e-7) {
+	std::cout
+	  << "Row bound sweep objective at t = " << t[k] << " is "
+	  << rowSweep.getObjValues()[k] << ", expected "
+	  << clp.objectiveValue() << "." << std::endl ;
+	errCnt++ ;
+      }
+    }
+    const double rowlb = 0.45 ;
+    clp.chgRowLower(&rowlb) ;
+    const ParametricSweep::Piece &p0 = rowSweep.getPiece(0) ;
+    const ParametricSweep::Piece &p1 = rowSweep.getPiece(1) ;
+    if (std::fabs(p0.slope_-1.0) > 1.0e-7 ||
+	std::fabs(p1.slope_-2.0) > 1.0e-7 ||
+	std::fabs(p0.tEnd_-0.55) > 1.0e-7 ||
+	std::fabs(p1.tStart_-0.55) > 1.0e-7 ||
+	std::fabs(p1.objStart_-1.0) > 1.0e-7) {
+      std::cout
+	<< "Row bound sweep profile: slopes " << p0.slope_ << ", "
+	<< p1.slope_ << ", breakpoint " << p0.tEnd_ << ", expected 1, 2, "
+	<< "0.55." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  With only the two end points, each piece has one solved point and takes
+  its slope from the duals. A wrong sign on y*dir puts the crossing
+  outside [0,1] and the breakpoint falls back to 0.5.
+*/
+  const double tEnds[] = { 0.0, 1.0 } ;
+  if (rowSweep.sweepRowBounds(clp,2,tEnds,lowerDir,nullptr) != 0 ||
+      rowSweep.getNumPieces() != 2) {
+    std::cout
+      << "Two point row bound sweep has " << rowSweep.getNumPieces()
+      << " pieces, expected 2." << std::endl ;
+    errCnt++ ;
+  } else {
+    const ParametricSweep::Piece &p0 = rowSweep.getPiece(0) ;
+    const ParametricSweep::Piece &p1 = rowSweep.getPiece(1) ;
+    if (std::fabs(p0.slope_-1.0) > 1.0e-7 ||
+	std::fabs(p1.slope_-2.0) > 1.0e-7 ||
+	std::fabs(p0.tEnd_-0.55) > 1.0e-7) {
+      std::cout
+	<< "Two point row bound sweep: slopes " << p0.slope_ << ", "
+	<< p1.slope_ << ", breakpoint " << p0.tEnd_ << ", expected 1, 2, "
+	<< "0.55." << std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Lexicographic solve of min x0+x1, then min x1-x0, over x0+x1 >= 2 with
+  0 <= x <= 3. Stage 0 has a whole edge of optimal solutions, value 2;
+  stage 1 picks the end with x1 = 0, value -2 (less the tolerance on the
+  stage 0 row). Run once cold and once from the basis of a plain solve;
+  both must give the same stages, and the objective rows should be gone
+  afterward.
+*/
+int testLexiSolver (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const int row0[] = { 0 } ;
+  const double one[] = { 1.0 } ;
+  bldr.addCol(1,row0,one,0.0,3.0,0.0) ;
+  bldr.addCol(1,row0,one,0.0,3.0,0.0) ;
+  const double rowlb[] = { 2.0 } ;
+  bldr.setRowData(1,rowlb,nullptr) ;
+  const double objs[] = { 1.0, 1.0,
+			  -1.0, 1.0 } ;
+  const double saveSense = clp.objSense() ;
+  for (int pass = 0 ; pass < 2 ; pass++) {
+    ModelBuilder copy(bldr) ;
+    copy.loadInto(clp) ;
+    clp.setObjSense(1.0) ;
+    if (pass == 1) {
+      clp.chgObjCoefficients(objs) ;
+      clp.initialSolve() ;
+    }
+    LexiSolver lexi ;
+    if (lexi.solve(clp,2,objs) != 2 || clp.numberRows() != 1 ||
+	std::fabs(lexi.getStage(0).objValue_-2.0) > 1.0e-7 ||
+	std::fabs(lexi.getStage(1).objValue_+2.0) > 1.0e-5 ||
+	std::fabs(clp.getColSolution()[1]) > 1.0e-7) {
+      std::cout
+	<< "Lexicographic solve (" << ((pass == 0)?"cold":"warm")
+	<< ") failed; stages "
+	<< ((lexi.getNumStages() > 0)?lexi.getStage(0).objValue_:0.0) << ", "
+	<< ((lexi.getNumStages() > 1)?lexi.getStage(1).objValue_:0.0)
+	<< ", expected 2, -2." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  clp.setObjSense(saveSense) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Load a small named model and solve it, then update it in place to a new
+  model, given in a different order, that drops column c2, adds column c4
+  and row r2, tightens the bound on c3, and changes coefficient (r1,c1).
+  The update should find exactly those changes, and a warm dual solve
+  should match a solve of the new model from scratch (-9).
+*/
+int testModelDiff (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const int rows0[] = { 0 } ;
+  const int rows1[] = { 1 } ;
+  const double one[] = { 1.0 } ;
+  const double two[] = { 2.0 } ;
+  bldr.addCol(1,rows0,one,0.0,10.0,-1.0,"c0") ;
+  bldr.addCol(1,rows1,one,0.0,1.5,-3.0,"c1") ;
+  bldr.addCol(1,rows0,two,0.0,10.0,-1.0,"c2") ;
+  bldr.addCol(1,rows1,one,0.0,1.5,-1.0,"c3") ;
+  const double oldRowub[] = { 4.0, 2.0 } ;
+  bldr.setRowData(2,nullptr,oldRowub) ;
+  bldr.loadInto(clp) ;
+  clp.setRowName(0,"r0") ;
+  clp.setRowName(1,"r1") ;
+  clp.initialSolve() ;
+
+  const char *rowNames[] = { "r2", "r1", "r0" } ;
+  const char *colNames[] = { "c4", "c3", "c1", "c0" } ;
+  const CoinBigIndex starts[] = { 0, 2, 3, 4, 6 } ;
+  const int indices[] = { 2, 0,  1,  1,  2, 0 } ;
+  const double elements[] = { 1.0, 1.0,  1.0,  2.0,  1.0, 1.0 } ;
+  const double colub[] = { 5.0, 1.0, 1.5, 10.0 } ;
+  const double obj[] = { -2.0, -1.0, -3.0, -1.0 } ;
+  const double rowub[] = { 3.0, 2.0, 4.0 } ;
+  ModelDiff::Model model ;
+  model.numRows_ = 3 ;
+  model.numCols_ = 4 ;
+  model.starts_ = starts ;
+  model.indices_ = indices ;
+  model.elements_ = elements ;
+  model.colUpper_ = colub ;
+  model.obj_ = obj ;
+  model.rowUpper_ = rowub ;
+  model.rowNames_ = rowNames ;
+  model.colNames_ = colNames ;
+  ModelDiff diff ;
+  if (diff.update(clp,model) != 5 || diff.getNumRowsAdded() != 1 ||
+      diff.getNumColsAdded() != 1 || diff.getNumColsDeleted() != 1 ||
+      diff.getNumBoundChanges() != 1 || diff.getNumCoeffChanges() != 1 ||
+      clp.numberRows() != 3 || clp.numberColumns() != 4 ||
+      diff.getColIndex(0) != 3 || diff.getRowIndex(0) != 2) {
+    std::cout
+      << "ModelDiff found " << diff.getNumChanges()
+      << " changes, expected 5." << std::endl ;
+    errCnt++ ;
+  } else {
+    clp.dual() ;
+    if (clp.status() != 0 ||
+	std::fabs(clp.objectiveValue()+9.0) > 1.0e-7) {
+      std::cout
+	<< "Model updated by ModelDiff solves to "
+	<< clp.objectiveValue() << ", expected -9." << std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Column generation on a covering master, min sum c(j)x(j) s.t. each of
+  three rows covered at least once, starting from singletons at cost 1.
+  Two oracles price a list of pair and triple columns between them. The
+  LP optimum uses the three pairs at 1/2 each, 1.75.
+*/
+void loadCoverMaster (ClpSimplexAPI &clp, ListPricer &pairs,
+		      ListPricer &triples)
+{
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const double one[] = { 1.0 } ;
+  for (int i = 0 ; i < 3 ; i++)
+    bldr.addCol(1,&i,one,0.0,1.0e30,1.0) ;
+  const double rowlb[] = { 1.0, 1.0, 1.0 } ;
+  bldr.setRowData(3,rowlb,nullptr) ;
+  bldr.loadInto(clp) ;
+  pairs.addCandidate(std::vector<int>{0,1},1.2) ;
+  pairs.addCandidate(std::vector<int>{1,2},1.2) ;
+  pairs.addCandidate(std::vector<int>{0,2},1.1) ;
+  triples.addCandidate(std::vector<int>{0,1,2},2.0) ;
+}
+
+int testColumnGenerator (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  ListPricer pairs, triples ;
+  loadCoverMaster(clp,pairs,triples) ;
+  ColumnGenerator colGen(2) ;
+  colGen.addPricer(&pairs) ;
+  colGen.addPricer(&triples) ;
+  if (colGen.solve(clp) != 0 || colGen.getNumAdded() < 3 ||
+      std::fabs(clp.objectiveValue()-1.75) > 1.0e-7) {
+    std::cout
+      << "Column generation ended at " << clp.objectiveValue()
+      << " after " << colGen.getNumRounds() << " rounds, expected 1.75."
+      << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Purging on the covering master. All four candidates price out in the
+  first round; at the optimum the triple (reduced cost 1/4) is nonbasic at
+  zero. With setMaxIdle(0) it goes after the re-solve of that round. The
+  run with purging off (setMaxIdle(-1)) gives the objective to match, and
+  the columns left must be the ones added less the ones purged.
+*/
+int testColumnPurge (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  double objNoPurge = 0.0 ;
+  for (int pass = 0 ; pass < 2 ; pass++) {
+    const int maxIdle = (pass == 0)?-1:0 ;
+    ListPricer pairs, triples ;
+    loadCoverMaster(clp,pairs,triples) ;
+    ColumnGenerator colGen(2) ;
+    colGen.addPricer(&pairs) ;
+    colGen.addPricer(&triples) ;
+    colGen.setMaxIdle(maxIdle) ;
+    const int retval = colGen.solve(clp) ;
+    int roundPurged = 0 ;
+    for (int r = 0 ; r < colGen.getNumRounds() ; r++)
+      roundPurged += colGen.getRound(r).purged_ ;
+    if (pass == 0) {
+      objNoPurge = clp.objectiveValue() ;
+      if (retval != 0 || colGen.getNumPurged() != 0) {
+	std::cout
+	  << "Column generation with purging off returned " << retval
+	  << " and purged " << colGen.getNumPurged() << " columns."
+	  << std::endl ;
+	errCnt++ ;
+      }
+    } else if (retval != 0 || colGen.getNumPurged() <= 0 ||
+	       roundPurged != colGen.getNumPurged() ||
+	       clp.numberColumns() !=
+		   3+colGen.getNumAdded()-colGen.getNumPurged() ||
+	       std::fabs(clp.objectiveValue()-objNoPurge) > 1.0e-7) {
+      std::cout
+	<< "Column generation with setMaxIdle(" << maxIdle << ") purged "
+	<< colGen.getNumPurged() << " of " << colGen.getNumAdded()
+	<< " columns, leaving " << clp.numberColumns() << ", and ended at "
+	<< clp.objectiveValue() << ", expected " << objNoPurge << "."
+	<< std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Row generation: min -x-y over 0 <= x, y <= 3 with one loose row
+  x+y <= 100, and two lazy families, x+2y <= 4 and 3x+y <= 6, each with
+  its own separator. Both lazy rows are needed; the optimum is (1.6,1.2),
+  objective -2.8. The model loads the same way into either API.
+*/
+template <class Solver>
+void loadLazyModel (Solver &solver, ListSeparator &famA, ListSeparator &famB)
+{
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const int row0[] = { 0 } ;
+  const double one[] = { 1.0 } ;
+  bldr.addCol(1,row0,one,0.0,3.0,-1.0) ;
+  bldr.addCol(1,row0,one,0.0,3.0,-1.0) ;
+  const double rowub[] = { 100.0 } ;
+  bldr.setRowData(1,nullptr,rowub) ;
+  bldr.loadInto(solver) ;
+  famA.addRow(std::vector<int>{0,1},std::vector<double>{1.0,2.0},4.0) ;
+  famB.addRow(std::vector<int>{0,1},std::vector<double>{3.0,1.0},6.0) ;
+}
+
+int testRowGenerator (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  ListSeparator famA, famB ;
+  loadLazyModel(clp,famA,famB) ;
+  RowGenerator rowGen(2) ;
+  rowGen.addSeparator(&famA) ;
+  rowGen.addSeparator(&famB) ;
+  if (rowGen.solve(clp) != 0 || rowGen.getNumAdded() != 2 ||
+      clp.numberRows() != 3 ||
+      std::fabs(clp.objectiveValue()+2.8) > 1.0e-7) {
+    std::cout
+      << "Row generation ended at " << clp.objectiveValue()
+      << " with " << rowGen.getNumAdded() << " rows added, expected -2.8"
+      << " with 2." << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  The same row generation through the Osi1 API, which re-solves with
+  resolve() and reads the basis with getBasisStatus.
+*/
+int testRowGeneratorOsi1 (Osi1API &si)
+{ int errCnt = 0 ;
+
+  ListSeparator famA, famB ;
+  loadLazyModel(si,famA,famB) ;
+  RowGenerator rowGen(2) ;
+  rowGen.addSeparator(&famA) ;
+  rowGen.addSeparator(&famB) ;
+  if (rowGen.solve(si) != 0 || rowGen.getNumAdded() != 2 ||
+      si.getNumRows() != 3 || !si.isProvenOptimal() ||
+      std::fabs(si.getObjValue()+2.8) > 1.0e-7) {
+    std::cout
+      << "Row generation (Osi1) ended at " << si.getObjValue()
+      << " with " << rowGen.getNumAdded() << " rows added, expected -2.8"
+      << " with 2." << std::endl ;
+    errCnt++ ;
+  } else {
+    std::cout
+      << "    row generation through Osi1 reaches -2.8 with 2 rows."
+      << std::endl ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Removal of slack rows: min -2x-y over 0 <= x, y <= 3 with one loose row
+  x+y <= 100 and one separator holding x+y <= 5 and x <= 1. Both are
+  violated at (3,3) and both go in the first round; at the new optimum
+  (1,3), objective -5, x <= 1 binds and x+y <= 5 has a basic slack of 1.
+  With setMaxSlack(0) that row is removed right after the re-solve, and
+  isn't violated again. With removal off (setMaxSlack(-1)) it stays.
+*/
+int testRowRemoval (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  for (int pass = 0 ; pass < 2 ; pass++) {
+    const int maxSlack = (pass == 0)?-1:0 ;
+    const int expRemoved = (pass == 0)?0:1 ;
+    ModelBuilder bldr(ModelBuilder::colWise) ;
+    const int row0[] = { 0 } ;
+    const double one[] = { 1.0 } ;
+    bldr.addCol(1,row0,one,0.0,3.0,-2.0) ;
+    bldr.addCol(1,row0,one,0.0,3.0,-1.0) ;
+    const double rowub[] = { 100.0 } ;
+    bldr.setRowData(1,nullptr,rowub) ;
+    bldr.loadInto(clp) ;
+    ListSeparator sep ;
+    sep.addRow(std::vector<int>{0,1},std::vector<double>{1.0,1.0},5.0) ;
+    sep.addRow(std::vector<int>{0},std::vector<double>{1.0},1.0) ;
+    RowGenerator rowGen ;
+    rowGen.addSeparator(&sep) ;
+    rowGen.setMaxSlack(maxSlack) ;
+    const int retval = rowGen.solve(clp) ;
+    if (retval != 0 || rowGen.getNumAdded() != 2 ||
+	rowGen.getNumRemoved() != expRemoved ||
+	rowGen.getNumRounds() < 1 ||
+	rowGen.getRound(0).removed_ != expRemoved ||
+	clp.numberRows() != 3-expRemoved ||
+	std::fabs(clp.objectiveValue()+5.0) > 1.0e-7) {
+      std::cout
+	<< "Row generation with setMaxSlack(" << maxSlack << ") removed "
+	<< rowGen.getNumRemoved() << " of " << rowGen.getNumAdded()
+	<< " rows, leaving " << clp.numberRows() << ", and ended at "
+	<< clp.objectiveValue() << "; expected " << expRemoved
+	<< " of 2, leaving " << 3-expRemoved << ", at -5." << std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Check ray extraction into caller storage against the allocating getters.
+  x+y >= 5 with 0 <= x, y <= 1 is primal infeasible; min -x-y with
+  x-y <= 1 and x, y unbounded above is dual infeasible. The fetch methods
+  must load the same ray as infeasibilityRay and unboundedRay return, and
+  load nothing when the status is the other kind.
+*/
+int compareRay (const ClpSimplexAPI &clp, const RayBuffer &buf, double *ray,
+		int dim, const char *what)
+{ int errCnt = 0 ;
+
+  if (ray == nullptr) {
+    std::cout << "No " << what << " ray from the allocating getter." << std::endl ;
+    errCnt++ ;
+  } else if (buf.getNumRays() != 1 || buf.getDim() != dim) {
+    std::cout
+      << "Fetched " << buf.getNumRays() << " " << what << " rays of length "
+      << buf.getDim() << ", expected 1 of length " << dim << "." << std::endl ;
+    errCnt++ ;
+  } else {
+    const double *fetched = buf.getDense(0) ;
+    for (int i = 0 ; i < dim ; i++) {
+      if (fetched[i] != ray[i]) {
+	std::cout
+	  << "Fetched " << what << " ray differs at " << i << ": "
+	  << fetched[i] << " vs " << ray[i] << "." << std::endl ;
+	errCnt++ ;
+	break ;
+      }
+    }
+  }
+  if (ray != nullptr) clp.freeRay(ray) ;
+
+  return (errCnt) ;
+}
+
+int testRayFetch (ClpSimplexAPI &clp)
+{ int errCnt = 0 ;
+
+  ModelBuilder infeas(ModelBuilder::colWise) ;
+  const int row0[] = { 0 } ;
+  const double one[] = { 1.0 } ;
+  const double minusOne[] = { -1.0 } ;
+  infeas.addCol(1,row0,one,0.0,1.0,0.0) ;
+  infeas.addCol(1,row0,one,0.0,1.0,0.0) ;
+  const double rowlb[] = { 5.0 } ;
+  infeas.setRowData(1,rowlb,nullptr) ;
+  infeas.loadInto(clp) ;
+  clp.dual() ;
+  RayBuffer buf ;
+  if (clp.status() != 1) {
+    std::cout
+      << "Status " << clp.status() << " on the infeasible model." << std::endl ;
+    errCnt++ ;
+  } else {
+    clp.fetchInfeasibilityRay(buf) ;
+    errCnt += compareRay(clp,buf,clp.infeasibilityRay(),1,"infeasibility") ;
+    if (clp.fetchUnboundedRay(buf) != 0) {
+      std::cout << "Unbounded ray from an infeasible model." << std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  ModelBuilder unbdd(ModelBuilder::colWise) ;
+  unbdd.addCol(1,row0,one,0.0,1.0e30,-1.0) ;
+  unbdd.addCol(1,row0,minusOne,0.0,1.0e30,-1.0) ;
+  const double rowub[] = { 1.0 } ;
+  unbdd.setRowData(1,nullptr,rowub) ;
+  unbdd.loadInto(clp) ;
+  clp.primal() ;
+  if (clp.status() != 2) {
+    std::cout
+      << "Status " << clp.status() << " on the unbounded model." << std::endl ;
+    errCnt++ ;
+  } else {
+    clp.fetchUnboundedRay(buf) ;
+    errCnt += compareRay(clp,buf,clp.unboundedRay(),2,"unbounded") ;
+    if (clp.fetchInfeasibilityRay(buf) != 0) {
+      std::cout << "Infeasibility ray from an unbounded model." << std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Ray fetch through the Osi1 API, on the same two models as testRayFetch.
+  Each fetch must load the non-null rays of the matching allocating getter,
+  in the same order and with the same values, and a fetch of the other kind
+  must load nothing. Presolve is off for the initial solve, so that clp
+  keeps the ray of the original model.
+*/
+int compareRays (const std::vector<double *> &raw, const RayBuffer &buf,
+		 int numFetched, int dim, const char *what)
+{ int errCnt = 0 ;
+
+  std::vector<const double *> rays ;
+  for (double *ray : raw)
+    if (ray != nullptr) rays.push_back(ray) ;
+  if (numFetched != static_cast<int>(rays.size()) ||
+      buf.getNumRays() != numFetched || buf.getDim() != dim) {
+    std::cout
+      << "Fetched " << numFetched << " " << what << " rays of length "
+      << buf.getDim() << ", expected " << rays.size() << " of length "
+      << dim << "." << std::endl ;
+    errCnt++ ;
+  } else {
+    for (int k = 0 ; k < numFetched && errCnt == 0 ; k++) {
+      const double *fetched = buf.getDense(k) ;
+      for (int i = 0 ; i < dim ; i++) {
+	if (std::fabs(fetched[i]-rays[k][i]) > 1.0e-9) {
+	  std::cout
+	    << "Fetched " << what << " ray " << k << " differs at " << i
+	    << ": " << fetched[i] << " vs " << rays[k][i] << "." << std::endl ;
+	  errCnt++ ;
+	  break ;
+	}
+      }
+    }
+  }
+  for (double *ray : raw) delete[] ray ;
+
+  return (errCnt) ;
+}
+
+int testRayFetchOsi1 (Osi1API &si)
+{ int errCnt = 0 ;
+
+  si.setHintParam(OsiDoPresolveInInitial,false,OsiHintDo) ;
+  ModelBuilder infeas(ModelBuilder::colWise) ;
+  const int row0[] = { 0 } ;
+  const double one[] = { 1.0 } ;
+  const double minusOne[] = { -1.0 } ;
+  infeas.addCol(1,row0,one,0.0,1.0,0.0) ;
+  infeas.addCol(1,row0,one,0.0,1.0,0.0) ;
+  const double rowlb[] = { 5.0 } ;
+  infeas.setRowData(1,rowlb,nullptr) ;
+  infeas.loadInto(si) ;
+  si.initialSolve() ;
+  RayBuffer buf ;
+  if (!si.isProvenPrimalInfeasible()) {
+    std::cout << "Osi1 solve did not find the model infeasible." << std::endl ;
+    errCnt++ ;
+  } else {
+    int numFetched = si.fetchDualRays(buf,1) ;
+    errCnt += compareRays(si.getDualRays(1),buf,numFetched,1,"dual") ;
+    numFetched = si.fetchDualRays(buf,1,true) ;
+    errCnt += compareRays(si.getDualRays(1,true),buf,numFetched,3,
+			  "full dual") ;
+    if (si.fetchPrimalRays(buf,1) != 0) {
+      std::cout << "Primal ray from an infeasible model." << std::endl ;
+      errCnt++ ;
+    }
+  }
+
+  ModelBuilder unbdd(ModelBuilder::colWise) ;
+  unbdd.addCol(1,row0,one,0.0,1.0e30,-1.0) ;
+  unbdd.addCol(1,row0,minusOne,0.0,1.0e30,-1.0) ;
+  const double rowub[] = { 1.0 } ;
+  unbdd.setRowData(1,nullptr,rowub) ;
+  unbdd.loadInto(si) ;
+  si.initialSolve() ;
+  if (!si.isProvenDualInfeasible()) {
+    std::cout << "Osi1 solve did not find the model unbounded." << std::endl ;
+    errCnt++ ;
+  } else {
+    const int numFetched = si.fetchPrimalRays(buf,1) ;
+    errCnt += compareRays(si.getPrimalRays(1),buf,numFetched,2,"primal") ;
+    if (si.fetchDualRays(buf,1) != 0) {
+      std::cout << "Dual ray from an unbounded model." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  if (errCnt == 0) {
+    std::cout
+      << "    Osi1 ray fetch matches getDualRays and getPrimalRays."
+      << std::endl ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Benders: min x + 2y1 + 3y2 over 0 <= x <= 10, with y1 >= 4-x and
+  y2 >= 6-x, y2 <= 1. At the first master x is 0 and the second subproblem
+  is infeasible, so both kinds of cut are needed. The optimum is x = 6,
+  objective 6.
+*/
+int testBendersSolver (ControlAPI &ctrlAPI, ClpSimplexAPI &clp,
+		       const std::string &shortName)
+{ int errCnt = 0 ;
+
+  ModelBuilder bldr(ModelBuilder::colWise) ;
+  const int row0[] = { 0 } ;
+  const double one[] = { 1.0 } ;
+  bldr.addCol(1,row0,one,0.0,10.0,1.0) ;
+  const double rowub[] = { 100.0 } ;
+  bldr.setRowData(1,nullptr,rowub) ;
+  bldr.loadInto(clp) ;
+  const CoinBigIndex starts[] = { 0, 1 } ;
+  const double cost1[] = { 2.0 } ;
+  const double cost2[] = { 3.0 } ;
+  const double h1[] = { 4.0 } ;
+  const double h2[] = { 6.0 } ;
+  BendersSolver::Subproblem sub ;
+  sub.numRows_ = 1 ;
+  sub.numCols_ = 1 ;
+  sub.starts_ = starts ;
+  sub.indices_ = row0 ;
+  sub.elements_ = one ;
+  sub.techStarts_ = starts ;
+  sub.techIndices_ = row0 ;
+  sub.techElements_ = one ;
+  BendersSolver benders(ctrlAPI,2) ;
+  sub.obj_ = cost1 ;
+  sub.rowLower_ = h1 ;
+  benders.addSubproblem(sub,&shortName) ;
+  sub.obj_ = cost2 ;
+  sub.rowLower_ = h2 ;
+  sub.colUpper_ = one ;
+  benders.addSubproblem(sub,&shortName) ;
+  int feasCuts = 0 ;
+  const int result = (benders.getNumSubproblems() == 2)?
+			benders.solve(clp):-1 ;
+  for (int k = 0 ; k < benders.getNumIterations() ; k++)
+    feasCuts += benders.getIteration(k).feasibilityCuts_ ;
+  if (result != 0 || feasCuts == 0 ||
+      std::fabs(clp.objectiveValue()-6.0) > 1.0e-6 ||
+      std::fabs(clp.getColSolution()[0]-6.0) > 1.0e-6) {
+    std::cout
+      << "Benders ended at " << clp.objectiveValue() << " after "
+      << benders.getNumIterations() << " iterations with " << feasCuts
+      << " feasibility cuts, expected 6." << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Solve in a worker process and check that we get the same answer as an
+  in-process solve.
+*/
+int testSolverHost (ControlAPI &ctrlAPI, ClpSimplexAPI &clp,
+		    const std::string &shortName)
+{ int errCnt = 0 ;
+
+/*
+  Install the all-slack basis (columns at lower bound, rows basic), so that
+  a solve has work to do and its final basis differs from the starting one.
+*/
+  auto slackBasis = [] (ClpSimplexAPI &model) {
+    const int m = model.numberRows() ;
+    const int n = model.numberColumns() ;
+    std::vector<unsigned char> stat(static_cast<size_t>(n)+m,3) ;
+    std::fill(stat.begin()+n,stat.end(),1) ;
+    model.copyinStatus(stat.data()) ;
+  } ;
+/*
+  Maximise, so the optimal basis isn't the slack basis. The solve in the
+  worker starts from the slack basis; its final basis must come back, so
+  that primal simplex in process finds nothing to do.
+*/
+  loadTwoBlocks(clp) ;
+  clp.setObjSense(-1.0) ;
+  clp.initialSolve() ;
+  const double zMax = clp.objectiveValue() ;
+  slackBasis(clp) ;
+  SolverHost host(ctrlAPI,2) ;
+  SolveResult result ;
+  if (host.start(&shortName) != 0 ||
+      host.solve(clp,result,SolverHost::primalMethod) != 0 ||
+      !result.has(SolveResult::statusField|SolveResult::objectiveField) ||
+      result.status() != 0 ||
+      std::fabs(result.objectiveValue()-zMax) > 1.0e-7) {
+    std::cout
+      << "Out-of-process solve failed; objective "
+      << result.objectiveValue() << ", expected " << zMax << "." << std::endl ;
+    errCnt++ ;
+  } else {
+    clp.primal() ;
+    if (clp.numberIterations() != 0) {
+      std::cout
+	<< "Primal took " << clp.numberIterations() << " iterations from "
+	<< "the basis copied back from the worker, expected 0." << std::endl ;
+      errCnt++ ;
+    }
+  }
+/*
+  Two client threads at once, one per worker: the maximisation above and
+  the minimisation of the same model in a second object. Objects are
+  created here; ControlAPI isn't thread-safe.
+*/
+  API *apiObj = nullptr ;
+  if (ctrlAPI.createObject(apiObj,ClpSimplexAPI::getAPIIDString(),
+			   &shortName) != 0 || apiObj == nullptr) {
+    std::cout << "Cannot create a second ClpSimplexAPI object." << std::endl ;
+    errCnt++ ;
+  } else {
+    ClpSimplexAPI &clp2 = *static_cast<ClpSimplexAPI *>
+	(apiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+    clp2.setLogLevel(0) ;
+    loadTwoBlocks(clp2) ;
+    clp2.initialSolve() ;
+    const double zMin = clp2.objectiveValue() ;
+    slackBasis(clp) ;
+    slackBasis(clp2) ;
+    SolveResult result1 ;
+    SolveResult result2 ;
+    int retval1 = -1 ;
+    int retval2 = -1 ;
+    std::thread solver1([&] () { retval1 = host.solve(clp,result1) ; }) ;
+    std::thread solver2([&] () { retval2 = host.solve(clp2,result2) ; }) ;
+    solver1.join() ;
+    solver2.join() ;
+    if (retval1 != 0 || retval2 != 0 ||
+	std::fabs(result1.objectiveValue()-zMax) > 1.0e-7 ||
+	std::fabs(result2.objectiveValue()-zMin) > 1.0e-7) {
+      std::cout
+	<< "Concurrent out-of-process solves returned " << retval1 << " and "
+	<< retval2 << ", objectives " << result1.objectiveValue() << " and "
+	<< result2.objectiveValue() << ", expected " << zMax << " and "
+	<< zMin << "." << std::endl ;
+      errCnt++ ;
+    }
+    ctrlAPI.destroyObject(apiObj) ;
+  }
+  host.stop() ;
+/*
+  A worker capped at 1 MB of address space can't map its segment, let alone
+  solve, and dies. That counts as a crash; lifting the cap, the next solve
+  restarts the worker and succeeds.
+*/
+  SolverHost host2(ctrlAPI,1) ;
+  host2.setWorkerMemoryLimit(1<<20) ;
+  if (host2.start(&shortName) != 0) {
+    std::cout << "Cannot start a memory-capped solver host." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  slackBasis(clp) ;
+  if (host2.solve(clp,result) != -1 || host2.getNumCrashes() != 1) {
+    std::cout
+      << "Memory-capped worker: " << host2.getNumCrashes()
+      << " crashes, expected 1." << std::endl ;
+    errCnt++ ;
+  }
+  host2.setWorkerMemoryLimit(0) ;
+  if (host2.solve(clp,result) != 0 ||
+      std::fabs(result.objectiveValue()-zMax) > 1.0e-7) {
+    std::cout
+      << "Solve after a worker crash failed; objective "
+      << result.objectiveValue() << ", expected " << zMax << "." << std::endl ;
+    errCnt++ ;
+  }
+/*
+  A dense 400 x 400 LP from the slack basis takes far longer than the 1 ms
+  time limit. The worker is killed, and again the next solve, with no
+  limit, restarts it.
+*/
+  const int dim = 400 ;
+  { ModelBuilder bldr(ModelBuilder::colWise) ;
+    std::vector<int> rows(dim) ;
+    std::vector<double> elements(dim) ;
+    for (int j = 0 ; j < dim ; j++) {
+      for (int i = 0 ; i < dim ; i++) {
+	rows[i] = i ;
+	elements[i] = 1.0+((7*i+13*j)%17) ;
+      }
+      bldr.addCol(dim,rows.data(),elements.data(),0.0,1.0e30,-1.0-(j%5)) ;
+    }
+    std::vector<double> rowlb(dim,-1.0e30) ;
+    std::vector<double> rowub(dim) ;
+    for (int i = 0 ; i < dim ; i++) rowub[i] = 100.0+(i%11) ;
+    bldr.setRowData(dim,rowlb.data(),rowub.data()) ;
+    bldr.loadInto(clp) ;
+  }
+  clp.initialSolve() ;
+  const double zBig = clp.objectiveValue() ;
+  slackBasis(clp) ;
+  host2.setSolveTimeout(0.001) ;
+  if (host2.solve(clp,result) != -1 || host2.getNumTimeouts() != 1 ||
+      host2.getNumCrashes() != 1) {
+    std::cout
+      << "Solve past the time limit: " << host2.getNumTimeouts()
+      << " timeouts, " << host2.getNumCrashes() << " crashes, expected 1 "
+      << "and 1." << std::endl ;
+    errCnt++ ;
+  }
+  host2.setSolveTimeout(0.0) ;
+  if (host2.solve(clp,result) != 0 ||
+      std::fabs(result.objectiveValue()-zBig) > 1.0e-6*(1.0+std::fabs(zBig))) {
+    std::cout
+      << "Solve after a timeout failed; objective "
+      << result.objectiveValue() << ", expected " << zBig << "." << std::endl ;
+    errCnt++ ;
+  }
+  host2.stop() ;
+
+  return (errCnt) ;
+}
+
+/*
+  Start a solver daemon on a local socket and solve a small LP through a
+  client: min -x-y s.t. x+2y <= 4, 3x+y <= 6, x, y >= 0. The optimum is
+  (1.6,1.2), objective -2.8; scaling the right-hand sides by s scales both.
+
+  - The second solve is warm started from the handle's basis, so dual
+    simplex has nothing to do.
+  - An iteration limit of 0 sent as a setting stops primal at once; after
+    clearParams the same handle solves to optimality.
+  - Three clients solve while the daemon is stopped; when it starts again
+    their requests arrive together and go in one batch (of two, the pool
+    size) and a second.
+  - With no room in the queue the daemon refuses the request.
+*/
+int testSolverDaemon (ControlAPI &ctrlAPI, RunParamsAPI *rpObj,
+		      const std::string &shortName)
+{ int errCnt = 0 ;
+
+  const std::string sockPath = "osi2unitTest.sock" ;
+  SolverDaemon daemon(ctrlAPI,2) ;
+  daemon.setRunParams(rpObj) ;
+  if (daemon.open(sockPath,&shortName) != 0) {
+    std::cout << "Failed to open the solver daemon." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  std::thread server([&daemon] () { daemon.serve() ; }) ;
+  const CoinBigIndex starts[] = { 0, 2, 4 } ;
+  const int indices[] = { 0, 1, 0, 1 } ;
+  const double elements[] = { 1.0, 3.0, 2.0, 1.0 } ;
+  const double obj[] = { -1.0, -1.0 } ;
+  const int numClients = 3 ;
+  double rowub[numClients][2] ;
+  SolverClient::Model model[numClients] ;
+  for (int c = 0 ; c < numClients ; c++) {
+    rowub[c][0] = 4.0*(c+1) ;
+    rowub[c][1] = 6.0*(c+1) ;
+    model[c].numRows_ = 2 ;
+    model[c].numCols_ = 2 ;
+    model[c].starts_ = starts ;
+    model[c].indices_ = indices ;
+    model[c].elements_ = elements ;
+    model[c].obj_ = obj ;
+    model[c].rowUpper_ = rowub[c] ;
+  }
+  SolverClient client[numClients] ;
+  int handle[numClients] = { 0, 0, 0 } ;
+  SolveResult result[numClients] ;
+  for (int c = 0 ; c < numClients ; c++) {
+    if (client[c].connect(sockPath) != 0 ||
+	client[c].createObject(handle[c],
+			       ClpSimplexAPI::getAPIIDString()) != 0) {
+      std::cout << "Failed to reach the solver daemon." << std::endl ;
+      errCnt++ ;
+    }
+  }
+  if (errCnt == 0) {
+/*
+  Cold solve, then warm.
+*/
+    for (int pass = 0 ; pass < 2 ; pass++) {
+      const SolverHost::Method method =
+	(pass == 0)?SolverHost::initialSolveMethod:SolverHost::dualMethod ;
+      SolveResult &res = result[0] ;
+      if (client[0].solve(handle[0],model[0],res,method) != 0 ||
+	  res.status() != 0 ||
+	  std::fabs(res.objectiveValue()+2.8) > 1.0e-7 ||
+	  std::fabs(res.getColSolution()[0]-1.6) > 1.0e-7) {
+	std::cout
+	  << "Daemon solve " << pass << " failed; objective "
+	  << res.objectiveValue() << ", expected -2.8." << std::endl ;
+	errCnt++ ;
+      } else if (pass == 1 && res.iterations() != 0) {
+	std::cout
+	  << "Warm daemon solve took " << res.iterations()
+	  << " iterations, expected 0." << std::endl ;
+	errCnt++ ;
+      }
+    }
+/*
+  Settings.
+*/
+    client[1].setIntParam("iter max",0) ;
+    if (client[1].solve(handle[1],model[1],result[1],
+			SolverHost::primalMethod) != 0 ||
+	result[1].status() == 0) {
+      std::cout
+	<< "Daemon solve with an iteration limit of 0 returned status "
+	<< result[1].status() << ", expected not optimal." << std::endl ;
+      errCnt++ ;
+    }
+    client[1].clearParams() ;
+    if (client[1].solve(handle[1],model[1],result[1],
+			SolverHost::primalMethod) != 0 ||
+	result[1].status() != 0 ||
+	std::fabs(result[1].objectiveValue()+5.6) > 1.0e-7) {
+      std::cout
+	<< "Daemon solve after clearParams failed; objective "
+	<< result[1].objectiveValue() << ", expected -5.6." << std::endl ;
+      errCnt++ ;
+    }
+/*
+  Batching across clients. With the daemon stopped, read until all three
+  requests are queued, so the first batch is a full one (two, the pool
+  size) and the second takes the third.
+*/
+    daemon.shutdown() ;
+    server.join() ;
+    const int batchesBefore = daemon.getNumBatches() ;
+    int retval[numClients] ;
+    std::vector<std::thread> solvers ;
+    for (int c = 0 ; c < numClients ; c++) {
+      solvers.push_back(std::thread([&,c] () {
+	retval[c] = client[c].solve(handle[c],model[c],result[c]) ;
+      })) ;
+    }
+    if (daemon.waitForQueued(numClients,10000) != 0) {
+      std::cout
+	<< "Daemon did not queue " << numClients << " requests." << std::endl ;
+      errCnt++ ;
+    }
+    server = std::thread([&daemon] () { daemon.serve() ; }) ;
+    for (std::thread &solver : solvers) solver.join() ;
+    for (int c = 0 ; c < numClients ; c++) {
+      const double z = -2.8*(c+1) ;
+      if (retval[c] != 0 || result[c].status() != 0 ||
+	  std::fabs(result[c].objectiveValue()-z) > 1.0e-7) {
+	std::cout
+	  << "Batched daemon solve for client " << c << " failed; objective "
+	  << result[c].objectiveValue() << ", expected " << z << "."
+	  << std::endl ;
+	errCnt++ ;
+      }
+    }
+    daemon.shutdown() ;
+    server.join() ;
+    if (daemon.getNumBatches()-batchesBefore != 2 ||
+	daemon.getLargestBatch() != 2) {
+      std::cout
+	<< "Daemon ran " << daemon.getNumBatches()-batchesBefore
+	<< " batches, largest " << daemon.getLargestBatch()
+	<< ", for " << numClients << " requests; expected 2 and 2."
+	<< std::endl ;
+      errCnt++ ;
+    }
+/*
+  Admission control. The queue limit is changed only while the daemon is
+  stopped.
+*/
+    daemon.setMaxQueued(0) ;
+    server = std::thread([&daemon] () { daemon.serve() ; }) ;
+    const int refused = client[2].solve(handle[2],model[2],result[2]) ;
+    if (refused != 1 || daemon.getNumRefused() != 1) {
+      std::cout
+	<< "Daemon with a full queue returned " << refused << " and counted "
+	<< daemon.getNumRefused() << " refusals; expected 1 and 1."
+	<< std::endl ;
+      errCnt++ ;
+    }
+  }
+  for (int c = 0 ; c < numClients ; c++) {
+    if (handle[c] != 0) client[c].destroyObject(handle[c]) ;
+    client[c].disconnect() ;
+  }
+  daemon.shutdown() ;
+  server.join() ;
+  daemon.close() ;
+
+  return (errCnt) ;
+}
+/*
+  Object pooling through ControlAPI. destroyObject detaches the control
+  information before the object goes into the pool; the create that
+  recycles it must attach new information, or the object could not be
+  destroyed again. The recycled object must come back empty, with default
+  settings.
+*/
+int testObjectPool (ControlAPI_Imp &ctrlAPI)
+{ int errCnt = 0 ;
+
+  const std::string apiName = ClpSimplexAPI::getAPIIDString() ;
+  int hits0, misses0, pooled0 ;
+  ctrlAPI.getPoolStats(apiName,hits0,misses0,pooled0) ;
+  ctrlAPI.setPoolLimit(apiName,1) ;
+  API *apiObj = nullptr ;
+  if (ctrlAPI.createObject(apiObj,apiName) < 0 || apiObj == nullptr) {
+    std::cout << "Failed to create a ClpSimplexAPI object." << std::endl ;
+    errCnt++ ;
+    ctrlAPI.setPoolLimit(apiName,0) ;
+    return (errCnt) ;
+  }
+  const API *first = apiObj ;
+  ClpSimplexAPI *clp = static_cast<ClpSimplexAPI *>
+      (apiObj->getAPIPtr(apiName.c_str())) ;
+  const int dfltLogLevel = clp->logLevel() ;
+  loadTwoBlocks(*clp) ;
+  clp->setLogLevel(dfltLogLevel+2) ;
+  clp->initialSolve() ;
+  int hits, misses, pooled ;
+  if (ctrlAPI.destroyObject(apiObj) < 0 || apiObj != nullptr) {
+    std::cout << "Failed to destroy a pooled object." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.getPoolStats(apiName,hits,misses,pooled) ;
+  if (pooled != pooled0+1) {
+    std::cout
+      << "Pool holds " << pooled << " objects after a destroy, expected "
+      << pooled0+1 << "." << std::endl ;
+    errCnt++ ;
+  }
+  if (ctrlAPI.createObject(apiObj,apiName) < 0 || apiObj == nullptr) {
+    std::cout << "Failed to create a recycled object." << std::endl ;
+    errCnt++ ;
+    ctrlAPI.setPoolLimit(apiName,0) ;
+    return (errCnt) ;
+  }
+  ctrlAPI.getPoolStats(apiName,hits,misses,pooled) ;
+  clp = static_cast<ClpSimplexAPI *>(apiObj->getAPIPtr(apiName.c_str())) ;
+  if (apiObj != first || hits != hits0+1 || apiObj->getCtrlInfo() == nullptr) {
+    std::cout
+      << "Create did not recycle the pooled object with fresh control "
+      << "information; " << hits-hits0 << " pool hits." << std::endl ;
+    errCnt++ ;
+  } else if (clp->numberRows() != 0 || clp->numberColumns() != 0 ||
+	     clp->logLevel() != dfltLogLevel) {
+    std::cout
+      << "Recycled object has " << clp->numberRows() << " rows, "
+      << clp->numberColumns() << " columns, log level " << clp->logLevel()
+      << "; expected an empty model at log level " << dfltLogLevel << "."
+      << std::endl ;
+    errCnt++ ;
+  }
+  if (ctrlAPI.destroyObject(apiObj) < 0) {
+    std::cout << "Failed to destroy a recycled object." << std::endl ;
+    errCnt++ ;
+  }
+  ctrlAPI.setPoolLimit(apiName,0) ;
+  ctrlAPI.getPoolStats(apiName,hits,misses,pooled) ;
+  if (pooled != 0) {
+    std::cout
+      << "Pool holds " << pooled << " objects after the limit went to 0."
+      << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Test the solver utilities built on ClpSimplexAPI. Each test loads its own
+  model into the same ClpSimplex (lite) object. The daemon test also needs a
+  RunParams object to apply settings.
+*/
+int testSolverUtilities (std::string netlibDir)
+
+{ int errCnt = 0 ;
+  int retval = 0 ;
+
+  ControlAPI_Imp ctrlAPI ;
+  std::string rpDir = "" ;
+  std::string rpShortName = "RunParams" ;
+  std::string shortName = "Clp" ;
+  if (ctrlAPI.load(rpShortName,rpShortName,&rpDir) < 0 ||
+      ctrlAPI.load(shortName) < 0) {
+    std::cout << "Failed to load the RunParams and Clp plugins." << std::endl ;
+    errCnt++ ;
+    return (errCnt) ;
+  }
+  API *rpApiObj = nullptr ;
+  API *clpApiObj = nullptr ;
+  retval = ctrlAPI.createObject(rpApiObj,RunParamsAPI::getAPIIDString()) ;
+  if (retval == 0)
+    retval = ctrlAPI.createObject(clpApiObj,ClpSimplexAPI::getAPIIDString()) ;
+  if (retval != 0) {
+    std::cout
+      << "Error " << retval << " creating the RunParamsAPI and "
+      << "ClpSimplexAPI objects." << std::endl ;
+    errCnt++ ;
+    if (rpApiObj != nullptr) ctrlAPI.destroyObject(rpApiObj) ;
+    return (errCnt) ;
+  }
+  RunParamsAPI *rpObj = dynamic_cast<RunParamsAPI *>(rpApiObj) ;
+  ClpSimplexAPI *clp = static_cast<ClpSimplexAPI *>
+      (clpApiObj->getAPIPtr(ClpSimplexAPI::getAPIIDString())) ;
+  clp->setLogLevel(0) ;
+
+  typedef std::pair<std::string,std::function<int ()> > UtilTest ;
+  std::vector<UtilTest> tests ;
+  tests.push_back(UtilTest("ModelBuilder",
+      [&] () { return (testModelBuilder(*clp,netlibDir)) ; })) ;
+  tests.push_back(UtilTest("BlockDecomposer",
+      [&] () { return (testBlockDecomposer(ctrlAPI,*clp)) ; })) ;
+  tests.push_back(UtilTest("ScenarioBatch",
+      [&] () { return (testScenarioBatch(*clp)) ; })) ;
+  tests.push_back(UtilTest("ParametricSweep",
+      [&] () { return (testParametricSweep(*clp)) ; })) ;
+  tests.push_back(UtilTest("LexiSolver",
+      [&] () { return (testLexiSolver(*clp)) ; })) ;
+  tests.push_back(UtilTest("ModelDiff",
+      [&] () { return (testModelDiff(*clp)) ; })) ;
+  tests.push_back(UtilTest("ColumnGenerator",
+      [&] () { return (testColumnGenerator(*clp)) ; })) ;
+  tests.push_back(UtilTest("ColumnPurge",
+      [&] () { return (testColumnPurge(*clp)) ; })) ;
+  tests.push_back(UtilTest("RowGenerator",
+      [&] () { return (testRowGenerator(*clp)) ; })) ;
+  tests.push_back(UtilTest("RowRemoval",
+      [&] () { return (testRowRemoval(*clp)) ; })) ;
+  tests.push_back(UtilTest("RayFetch",
+      [&] () { return (testRayFetch(*clp)) ; })) ;
+  tests.push_back(UtilTest("BendersSolver",
+      [&] () { return (testBendersSolver(ctrlAPI,*clp,shortName)) ; })) ;
+  tests.push_back(UtilTest("SolverHost",
+      [&] () { return (testSolverHost(ctrlAPI,*clp,shortName)) ; })) ;
+  tests.push_back(UtilTest("SolverDaemon",
+      [&] () { return (testSolverDaemon(ctrlAPI,rpObj,shortName)) ; })) ;
+  tests.push_back(UtilTest("ObjectPool",
+      [&] () { return (testObjectPool(ctrlAPI)) ; })) ;
+  for (const UtilTest &test : tests) {
+    std::cout << "  Testing " << test.first << "." << std::endl ;
+    const int errs = test.second() ;
+    std::cout
+      << "  End test of " << test.first << ", " << errs << " errors."
+      << std::endl ;
+    errCnt += errs ;
+  }
+
+  ctrlAPI.destroyObject(clpApiObj) ;
+  ctrlAPI.destroyObject(rpApiObj) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test the CutBatch utility. This needs no solver: build a small batch with a
+  duplicate (presented in a different column order) and a satisfied cut, then
+  check that duplicate removal and violation filtering leave the right cut
+  with the right bounds.
+*/
+int testCutBatch ()
+{ int errCnt = 0 ;
+
+  CutBatch batch ;
+  const int idx1[] = { 2, 0, 1 } ;
+  const int idx2[] = { 0, 1, 2 } ;
+  const double coeffs[] = { 1.0, 1.0, 1.0 } ;
+  const int idx3[] = { 0 } ;
+  batch.addCut(3,idx1,coeffs,-1.0e30,1.0) ;
+  batch.addCut(3,idx2,coeffs,-1.0e30,0.5) ;
+  batch.addCut(1,idx3,coeffs,-1.0e30,5.0) ;
+  const double x[] = { 0.5, 0.5, 0.5 } ;
+
+  if (batch.removeDuplicates() != 2 || batch.getUpper()[0] != 0.5) {
+    std::cout << "CutBatch failed to merge duplicate cuts." << std::endl ;
+    errCnt++ ;
+  }
+  if (batch.filterViolated(x,1.0e-6,2) != 1 ||
+      batch.getStarts()[1] != 3 || batch.getIndices()[0] != 0) {
+    std::cout << "CutBatch failed to filter satisfied cuts." << std::endl ;
+    errCnt++ ;
+  }
+  const CutBatch::RoundStats &stats = batch.getStats() ;
+  if (stats.added_ != 3 || stats.duplicates_ != 1 || stats.satisfied_ != 1) {
+    std::cout << "CutBatch statistics are incorrect." << std::endl ;
+    errCnt++ ;
+  }
+  batch.printStats(std::cout) ;
+
+  return (errCnt) ;
+}
+
+/*
+  Test the CutPool utility without a solver. Cut a is x0+x1 <= 1, then
+  added again as 2x0+2x1 <= 1.5, which must come back as a duplicate with
+  the normalised bound tightened to 0.75. Cut c is x2 <= 1 and cut d is
+  x0-x2 >= 0. At (1,1,2) all three are violated, a most, c and d tied.
+  At (1,1,0) only a is violated; with a maximum pool age of 1, c and d are
+  discarded on the second evaluation and the arena is compacted on the
+  third. Cut a must keep its index throughout, and a new cut must take a
+  free slot. Last, two cuts whose coefficients differ by less than the
+  duplicate tolerance, but round to different multiples of it, must be
+  recognised as duplicates.
+*/
+int testCutPool ()
+{ int errCnt = 0 ;
+
+  CutPool pool ;
+  pool.setMaxPoolAge(1) ;
+  const int idx01[] = { 0, 1 } ;
+  const int idx02[] = { 0, 2 } ;
+  const int idx2[] = { 2 } ;
+  const int idx12[] = { 1, 2 } ;
+  const double ones[] = { 1.0, 1.0 } ;
+  const double twos[] = { 2.0, 2.0 } ;
+  const double plusMinus[] = { 1.0, -1.0 } ;
+  const int a = pool.addCut(2,idx01,ones,-1.0e30,1.0) ;
+  if (pool.addCut(2,idx01,twos,-1.0e30,1.5) != a || pool.getNumCuts() != 1) {
+    std::cout << "CutPool failed to recognise a scaled duplicate." << std::endl ;
+    errCnt++ ;
+  }
+  const int c = pool.addCut(1,idx2,ones,-1.0e30,1.0) ;
+  const int d = pool.addCut(2,idx02,plusMinus,0.0,1.0e30) ;
+
+  const double x1[] = { 1.0, 1.0, 2.0 } ;
+  std::vector<int> which ;
+  if (pool.evaluate(x1) != 3 ||
+      std::fabs(pool.getViolation(a)-1.25) > 1.0e-12 ||
+      pool.selectViolated(2,1.0e-6,which) != 2 ||
+      which[0] != a || which[1] != c) {
+    std::cout << "CutPool selected the wrong violated cuts." << std::endl ;
+    errCnt++ ;
+  }
+
+  const double x2[] = { 1.0, 1.0, 0.0 } ;
+  for (int pass = 0 ; pass < 3 ; pass++) pool.evaluate(x2) ;
+  if (pool.getNumCuts() != 1 || !pool.isLive(a) ||
+      pool.isLive(c) || pool.isLive(d) ||
+      std::fabs(pool.getViolation(a)-1.25) > 1.0e-12) {
+    std::cout << "CutPool ageing or compaction went wrong." << std::endl ;
+    errCnt++ ;
+  }
+  const int f = pool.addCut(2,idx12,ones,-1.0e30,1.0) ;
+  const double x3[] = { 0.0, 1.0, 1.0 } ;
+  pool.evaluate(x3) ;
+  if ((f != c && f != d) || !pool.isLive(a) || pool.getNumCuts() != 2 ||
+      std::fabs(pool.getViolation(a)-0.25) > 1.0e-12 ||
+      std::fabs(pool.getViolation(f)-1.0) > 1.0e-12) {
+    std::cout << "CutPool indices changed across evaluate." << std::endl ;
+    errCnt++ ;
+  }
+
+  CutPool nearPool ;
+  const double near1[] = { 1.0, 0.50000000049 } ;
+  const double near2[] = { 1.0, 0.50000000051 } ;
+  const int g = nearPool.addCut(2,idx01,near1,-1.0e30,1.0) ;
+  if (nearPool.addCut(2,idx01,near2,-1.0e30,1.0) != g) {
+    std::cout
+      << "CutPool missed a duplicate within the tolerance." << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Test reduced cost fixing on plain arrays. With a gap of 2, column 0 (at
+  lower bound, d = 3) is fixed at 0 and column 1 (at upper bound, d = -0.5)
+  has its lower bound raised to 6. Column 2 is continuous and is tightened
+  only when continuous columns are considered. Column 3 is basic.
+*/
+int testRedCostFix ()
+{ int errCnt = 0 ;
+
+  const double x[] = { 0.0, 10.0, 0.0, 3.5 } ;
+  const double dj[] = { 3.0, -0.5, 4.0, 0.0 } ;
+  const double lb[] = { 0.0, 0.0, 0.0, 0.0 } ;
+  const double ub[] = { 10.0, 10.0, 10.0, 10.0 } ;
+  const char colType[] = { 2, 2, 0, 2 } ;
+
+  RedCostFixer fixer ;
+  if (fixer.compute(4,x,dj,lb,ub,colType,2.0) != 2 ||
+      fixer.getNumFixed() != 1 ||
+      fixer.getIndices()[0] != 0 || fixer.getNewUpper(0) != 0.0 ||
+      fixer.getIndices()[1] != 1 || fixer.getNewLower(1) != 6.0) {
+    std::cout << "RedCostFixer computed incorrect integer bounds." << std::endl ;
+    errCnt++ ;
+  }
+  if (fixer.compute(4,x,dj,lb,ub,colType,2.0,false) != 3 ||
+      fixer.getIndices()[2] != 2 || fixer.getNewUpper(2) != 0.5) {
+    std::cout
+      << "RedCostFixer computed incorrect continuous bounds." << std::endl ;
+    errCnt++ ;
+  }
+/*
+  Integer column with a fractional lower bound: at lb 0.3 with d = 4 and a
+  gap of 2 the implied upper bound is 0.8, which floors to 0, below the
+  lower bound. The new upper bound must be 1.
+*/
+  const double xf[] = { 0.3 } ;
+  const double djf[] = { 4.0 } ;
+  const double lbf[] = { 0.3 } ;
+  const double ubf[] = { 10.0 } ;
+  if (fixer.compute(1,xf,djf,lbf,ubf,colType,2.0) != 1 ||
+      fixer.getNewUpper(0) != 1.0) {
+    std::cout
+      << "RedCostFixer rounded an upper bound below a fractional lower bound."
+      << std::endl ;
+    errCnt++ ;
+  }
+  if (fixer.compute(4,x,dj,lb,ub,colType,1.0e30) != 0) {
+    std::cout
+      << "RedCostFixer should do nothing with an infinite gap." << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Compare the reports from one thread and several. Max norms and the worst
+  index don't depend on the blocking; sums may differ in the last bits.
+*/
+int compareVerifierNorms (const char *what, const SolutionVerifier::Norms &n1,
+			  const SolutionVerifier::Norms &nk)
+{
+  if (n1.max_ != nk.max_ || n1.worst_ != nk.worst_ ||
+      std::fabs(n1.sum_-nk.sum_) > 1.0e-9*std::max(1.0,std::fabs(n1.sum_))) {
+    std::cout
+      << "SolutionVerifier " << what << " differs between one thread ("
+      << n1.max_ << ", " << n1.sum_ << ", " << n1.worst_ << ") and several ("
+      << nk.max_ << ", " << nk.sum_ << ", " << nk.worst_ << ")." << std::endl ;
+    return (1) ;
+  }
+  return (0) ;
+}
+
+int compareVerifiers (const SolutionVerifier &v1, const SolutionVerifier &vk,
+		      int m)
+{ int errCnt = 0 ;
+
+  const SolutionVerifier::Report &r1 = v1.getReport() ;
+  const SolutionVerifier::Report &rk = vk.getReport() ;
+  errCnt += compareVerifierNorms("row infeasibility",r1.rowInf_,rk.rowInf_) ;
+  errCnt += compareVerifierNorms("column infeasibility",r1.colInf_,rk.colInf_) ;
+  errCnt += compareVerifierNorms("dual residual",
+				 r1.dualResidual_,rk.dualResidual_) ;
+  errCnt += compareVerifierNorms("dual infeasibility",
+				 r1.dualInf_,rk.dualInf_) ;
+  errCnt += compareVerifierNorms("complementary slackness",
+				 r1.compSlack_,rk.compSlack_) ;
+  if (std::fabs(r1.objective_-rk.objective_) >
+	1.0e-9*std::max(1.0,std::fabs(r1.objective_))) {
+    std::cout << "SolutionVerifier objective differs." << std::endl ;
+    errCnt++ ;
+  }
+  for (int i = 0 ; i < m ; i++) {
+    if (std::fabs(v1.getRowActivity()[i]-vk.getRowActivity()[i]) > 1.0e-12) {
+      std::cout
+	<< "SolutionVerifier row activity " << i << " differs." << std::endl ;
+      errCnt++ ;
+      break ;
+    }
+  }
+
+  return (errCnt) ;
+}
+
+/*
+  Test the solution verifier on
+    min x0 + x1  s.t.  x0 + x1 >= 2,  x0 - x1 <= 1,  0 <= x <= 10
+  at the optimum x = (1,1), y = (1,0), d = (0,0), then with x0 moved to 1.5,
+  which is still feasible but breaks complementary slackness on row 0.
+  Then check that the parallel path agrees with the serial one: on the small
+  model with a block size of 1, and on a generated model larger than the
+  default block size.
+*/
+int testSolutionVerifier ()
+{ int errCnt = 0 ;
+
+  const CoinBigIndex starts[] = { 0, 2, 4 } ;
+  const int indices[] = { 0, 1, 0, 1 } ;
+  const double elements[] = { 1.0, 1.0, 1.0, -1.0 } ;
+  const double obj[] = { 1.0, 1.0 } ;
+  const double collb[] = { 0.0, 0.0 } ;
+  const double colub[] = { 10.0, 10.0 } ;
+  const double rowlb[] = { 2.0, -1.0e30 } ;
+  const double rowub[] = { 1.0e30, 1.0 } ;
+  double x[] = { 1.0, 1.0 } ;
+  const double y[] = { 1.0, 0.0 } ;
+  const double d[] = { 0.0, 0.0 } ;
+
+  SolutionVerifier verifier(2) ;
+  verifier.verify(2,2,starts,nullptr,indices,elements,obj,collb,colub,
+		  rowlb,rowub,x,y,d) ;
+  if (!verifier.isAcceptable() || verifier.getReport().objective_ != 2.0 ||
+      verifier.getRowActivity()[1] != 0.0) {
+    std::cout << "SolutionVerifier rejected an optimal solution." << std::endl ;
+    verifier.printReport(std::cout) ;
+    errCnt++ ;
+  }
+  x[0] = 1.5 ;
+  verifier.verify(2,2,starts,nullptr,indices,elements,obj,collb,colub,
+		  rowlb,rowub,x,y,d) ;
+  const SolutionVerifier::Report &rpt = verifier.getReport() ;
+  if (verifier.isAcceptable() || rpt.rowInf_.max_ != 0.0 ||
+      rpt.compSlack_.worst_ != 2 || rpt.compSlack_.max_ != 0.5) {
+    std::cout
+      << "SolutionVerifier missed a complementary slackness violation."
+      << std::endl ;
+    verifier.printReport(std::cout) ;
+    errCnt++ ;
+  }
+
+  SolutionVerifier serial(1) ;
+  serial.verify(2,2,starts,nullptr,indices,elements,obj,collb,colub,
+		rowlb,rowub,x,y,d) ;
+  verifier.setMinBlock(1) ;
+  verifier.verify(2,2,starts,nullptr,indices,elements,obj,collb,colub,
+		  rowlb,rowub,x,y,d) ;
+  errCnt += compareVerifiers(serial,verifier,2) ;
+/*
+  3000 columns and 2000 rows, three coefficients per column, with a
+  solution that violates a bit of everything. With the default block size
+  the column pass gets two blocks and the row pass one or two.
+*/
+  const int bigM = 2000 ;
+  const int bigN = 3000 ;
+  std::vector<CoinBigIndex> bigStarts(bigN+1) ;
+  std::vector<int> bigIndices ;
+  std::vector<double> bigElements ;
+  std::vector<double> bigObj(bigN), bigCollb(bigN,0.0), bigColub(bigN,1.0) ;
+  std::vector<double> bigX(bigN), bigD(bigN) ;
+  for (int j = 0 ; j < bigN ; j++) {
+    bigStarts[j] = static_cast<CoinBigIndex>(bigIndices.size()) ;
+    const int rows[] = { j%bigM, (j+1)%bigM, (j+500)%bigM } ;
+    for (int i : rows) {
+      bigIndices.push_back(i) ;
+      bigElements.push_back(1.0+0.25*(j%5)) ;
+    }
+    bigObj[j] = 1.0+0.1*(j%7) ;
+    bigX[j] = 0.4*(j%4) ;
+    bigD[j] = 0.05*((j%9)-4) ;
+  }
+  bigStarts[bigN] = static_cast<CoinBigIndex>(bigIndices.size()) ;
+  std::vector<double> bigRowlb(bigM,-1.0e30), bigRowub(bigM,2.0), bigY(bigM) ;
+  for (int i = 0 ; i < bigM ; i++) bigY[i] = 0.1*((i%5)-3) ;
+  SolutionVerifier bigSerial(1) ;
+  SolutionVerifier bigParallel(4) ;
+  bigSerial.verify(bigM,bigN,bigStarts.data(),nullptr,bigIndices.data(),
+		   bigElements.data(),bigObj.data(),bigCollb.data(),
+		   bigColub.data(),bigRowlb.data(),bigRowub.data(),
+		   bigX.data(),bigY.data(),bigD.data()) ;
+  bigParallel.verify(bigM,bigN,bigStarts.data(),nullptr,bigIndices.data(),
+		     bigElements.data(),bigObj.data(),bigCollb.data(),
+		     bigColub.data(),bigRowlb.data(),bigRowub.data(),
+		     bigX.data(),bigY.data(),bigD.data()) ;
+  errCnt += compareVerifiers(bigSerial,bigParallel,bigM) ;
+  if (bigSerial.getReport().rowInf_.max_ == 0.0 ||
+      bigSerial.getReport().colInf_.max_ == 0.0) {
+    std::cout
+      << "SolutionVerifier found no infeasibility in the generated model."
+      << std::endl ;
+    errCnt++ ;
+  }
+
+  return (errCnt) ;
+}
+
+} // end unnamed file-local namespace
+
+
+int main(int argC,char* argV[])
+{
+
+  std::cout << "START UNIT TEST" << std::endl ;
+/*
+  Test the bare PluginManager. There's no sense proceeding to the API
+  tests if the PluginManager isn't working.
+*/
+  std::cout << "Testing bare PluginManager." << std::endl ;
+  int retval = testPluginManager() ;
+  std::cout
+    << "End test of bare PluginManager, " << retval << " errors."
+    << std::endl << std::endl ;
+  if (retval != 0) {
+      std::cout
+	<< "Aborting unitTest; errors in PluginManager." << std::endl ;
+      return (retval) ;
+  }
+/*
+  Construct the location of installed data files.
+*/
+  std::string sampleDir = SAMPLEDATADIR ;
+  std::string netlibDir = NETLIBDATADIR ;
+  std::cout << "coin-or-sample is at " << sampleDir << std::endl ;
+  std::cout << "coin-or-netlib is at " << netlibDir << std::endl << std::endl ;
+/*
+  Grab the plugin manager instance.
+*/
+  PluginManager &plugMgr = PluginManager::getInstance() ;
+/*
+  Construct a vector of shims for testing, then open a loop to test each shim.
+*/
+  int totalErrs = 0 ;
+  typedef std::pair<std::string,int> TestVec ;
+  std::vector<TestVec> solvers ;
+  solvers.push_back(TestVec("clp",3)) ;
+# ifdef OSI2_HAS_OSICLP
+  solvers.push_back(TestVec("clpHeavy",0)) ;
+# endif
+# ifdef OSI2_HAS_OSIGLPK
+  solvers.push_back(TestVec("glpkHeavy",2)) ;
+# endif
+  std::vector<TestVec>::const_iterator iter ;
+  for (iter = solvers.begin() ; iter != solvers.end() ; iter++) {
+    std::string solverName = iter->first ;
+/*
+  First test the Osi2 control API. This test will try to create
+  ProbMgmt and Osi1 API objects in unrestricted mode (i.e., without
+  restriction to a particular library), followed by a ProbMgmt object in
+  restricted mode. Clp(Lite) doesn't support either one. ClpHeavy supports
+  both. GlpkHeavy supports only Osi1.
+*/
+    std::cout
+      << "Testing ControlAPI (" << solverName << ")." << std::endl ;
+    retval = testControlAPI(solverName,sampleDir) ;
+    std::cout
+      << "End test of ControlAPI (" << solverName << "), "
       << retval << " errors, expected " << iter->second << "."
       << std::endl << std::endl ;
     totalErrs += retval-(iter->second) ;
@@ -780,6 +2950,55 @@ int main(int argC,char* argV[])
   std::cout
     << "End test of RunParamsAPI, " << errCnt << " errors, expected "
     << expectedErrs << "." << std::endl ;
+/*
+  Test the solver utilities built on ClpSimplexAPI.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing solver utilities." << std::endl ;
+  errCnt = testSolverUtilities(netlibDir) ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of solver utilities, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+  totalErrs += errCnt-expectedErrs ;
+/*
+  Test the solver utilities that don't need a solver.
+*/
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing CutBatch." << std::endl ;
+  errCnt = testCutBatch() ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of CutBatch, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+  totalErrs += errCnt-expectedErrs ;
+
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing CutPool." << std::endl ;
+  errCnt = testCutPool() ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of CutPool, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+  totalErrs += errCnt-expectedErrs ;
+
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing RedCostFixer." << std::endl ;
+  errCnt = testRedCostFix() ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of RedCostFixer, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+  totalErrs += errCnt-expectedErrs ;
+
+  std::cout << std::endl << std::endl ;
+  std::cout << "Testing SolutionVerifier." << std::endl ;
+  errCnt = testSolutionVerifier() ;
+  expectedErrs = 0 ;
+  std::cout
+    << "End test of SolutionVerifier, " << errCnt << " errors, expected "
+    << expectedErrs << "." << std::endl ;
+  totalErrs += errCnt-expectedErrs ;
 /*
   Shut down the plugin manager. This will call the plugin library exit
   functions and unload the libraries.